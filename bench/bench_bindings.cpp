@@ -0,0 +1,138 @@
+/**
+ * @file bench_bindings.cpp
+ * @brief Per-event cost of binding lookup as the rule count grows.
+ *
+ * Usage: bench_bindings [events]
+ *
+ * Compiles 1 to 1000 random rules (source button, modifier mask, action)
+ * and replays a move-heavy stream of presses with random buttons and
+ * modifiers through the engine. The engine resolves a press with one
+ * indexed load into the compiled table, so ns/event stays flat; a linear
+ * scan over the rule list is timed alongside for contrast.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "arc/gesture.h"
+
+using arc::gesture::Binding;
+using arc::gesture::Button;
+using arc::gesture::Event;
+using arc::gesture::EventType;
+
+namespace {
+
+/** Small deterministic PRNG so runs are comparable. */
+struct XorShift {
+    std::uint64_t s = 0x9E3779B97F4A7C15ull;
+    std::uint32_t next() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return static_cast<std::uint32_t>(s >> 32);
+    }
+};
+
+std::vector<Binding> make_rules(std::size_t n, XorShift &rng) {
+    std::vector<Binding> rules(n);
+    for (auto &r : rules) {
+        r.source = static_cast<Button>(1 + rng.next() % 5);
+        r.mods = 1u + rng.next() % 15;  // at least one modifier
+        r.action.button = static_cast<Button>(1 + rng.next() % 5);
+        r.action.double_click = rng.next() % 4 == 0;
+    }
+    return rules;
+}
+
+/** Moves with a press/release of a random button and modifier mask every 32 events. */
+std::vector<Event> make_stream(std::size_t n, XorShift &rng) {
+    std::vector<Event> out;
+    out.reserve(n + 2);
+    std::uint32_t t = 0;
+    while (out.size() < n) {
+        Event e;
+        e.time_ms = ++t;
+        e.x = 500 + static_cast<std::int32_t>(rng.next() % 3);
+        e.y = 500;
+        if (out.size() % 32 == 0) {
+            e.type = EventType::Down;
+            e.button = static_cast<Button>(1 + rng.next() % 5);
+            e.mods = rng.next() % 16;
+            out.push_back(e);
+            e.type = EventType::Up;
+            e.mods = 0;
+            e.time_ms = ++t;
+        } else {
+            e.type = EventType::Move;
+        }
+        out.push_back(e);
+    }
+    return out;
+}
+
+/** First most-specific match by scanning the rules (what a table avoids). */
+bool scan(const std::vector<Binding> &rules, Button b, std::uint32_t mods) {
+    int best = -1;
+    for (const Binding &r : rules) {
+        if (r.source != b || (mods & r.mods) != r.mods)
+            continue;
+        int spec = static_cast<int>((r.mods & 1) + ((r.mods >> 1) & 1) + ((r.mods >> 2) & 1) + ((r.mods >> 3) & 1));
+        if (spec > best)
+            best = spec;
+    }
+    return best >= 0;
+}
+
+double elapsed_ns(std::chrono::steady_clock::time_point t0) {
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+}
+
+}  // namespace
+
+/** @brief Entry point: ns/event per rule count, table vs. scan. */
+int main(int argc, char **argv) {
+    std::size_t n = 4000000;
+    if (argc > 1)
+        n = static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10));
+    XorShift rng;
+    std::vector<Event> stream = make_stream(n, rng);
+    std::vector<Event> presses;
+    for (const Event &e : stream)
+        if (e.type == EventType::Down)
+            presses.push_back(e);
+
+    std::printf("[BENCH] %6s %12s %14s %14s\n", "rules", "compile_us", "engine_ns/ev", "scan_ns/press");
+    for (std::size_t count : {1, 10, 100, 300, 1000}) {
+        std::vector<Binding> rules = make_rules(count, rng);
+        auto t0 = std::chrono::steady_clock::now();
+        arc::gesture::Settings s;
+        s.bindings = arc::gesture::compile_bindings(rules.data(), rules.size());
+        double compile_ns = elapsed_ns(t0);
+
+        arc::gesture::Engine engine(s);
+        std::uint64_t sink = 0;
+        for (const Event &e : stream)  // warm-up
+            sink += engine.on_event(e).count;
+        t0 = std::chrono::steady_clock::now();
+        for (const Event &e : stream)
+            sink += engine.on_event(e).count;
+        double engine_ns = elapsed_ns(t0);
+
+        t0 = std::chrono::steady_clock::now();
+        for (const Event &e : presses)
+            sink += scan(rules, e.button, e.mods);
+        double scan_ns = elapsed_ns(t0);
+
+        std::printf("[BENCH] %6zu %12.1f %14.2f %14.1f\n", count, compile_ns / 1e3,
+                    engine_ns / static_cast<double>(stream.size()),
+                    presses.empty() ? 0.0 : scan_ns / static_cast<double>(presses.size()));
+        if (sink == 0)
+            std::printf("[BENCH] (no injections)\n");
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file bench_dispatch.cpp
+ * @brief Generic vs. per-trigger message translation on a move-heavy stream.
+ *
+ * Usage: bench_dispatch [events]
+ *
+ * Builds a stream of raw WH_MOUSE_LL messages (mostly moves, with clicks of
+ * every button and some wheel input) and, for each trigger button, times
+ * the generic arc::dispatch::translate against the specialized instance,
+ * both called through a function pointer as the hook does: translation
+ * alone, and translation followed by the engine. Decisions of the two paths
+ * are compared on the way.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "arc/dispatch.h"
+#include "arc/gesture.h"
+
+using arc::dispatch::Kind;
+using arc::dispatch::TranslateFn;
+using arc::gesture::Button;
+
+namespace {
+
+/** Small deterministic PRNG so runs are comparable. */
+struct XorShift {
+    std::uint64_t s = 0x9E3779B97F4A7C15ull;
+    std::uint32_t next() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return static_cast<std::uint32_t>(s >> 32);
+    }
+};
+
+/// @brief One raw hook message with the fields the hook reads.
+struct Raw {
+    unsigned int msg;
+    unsigned int xbutton;
+    std::int32_t x, y;
+    std::uint32_t time_ms;
+    std::uint32_t mods;
+};
+
+/** 1 kHz moves; every 64 events a click of a random button, every 200 a wheel notch. */
+std::vector<Raw> make_stream(std::size_t n, XorShift &rng) {
+    static const unsigned int kDowns[] = {arc::dispatch::kLButtonDown, arc::dispatch::kRButtonDown,
+                                          arc::dispatch::kMButtonDown, arc::dispatch::kXButtonDown};
+    std::vector<Raw> out;
+    out.reserve(n + 2);
+    std::uint32_t t = 0;
+    std::int32_t x = 800, y = 600;
+    while (out.size() < n) {
+        x += static_cast<std::int32_t>(rng.next() % 5) - 2;
+        y += static_cast<std::int32_t>(rng.next() % 5) - 2;
+        Raw r{arc::dispatch::kMouseMove, 0, x, y, ++t, rng.next() % 8 ? 0u : arc::gesture::kModAlt};
+        if (out.size() % 64 == 0) {
+            unsigned int down = kDowns[rng.next() % 4];
+            r.msg = down;
+            r.xbutton = 1 + rng.next() % 2;
+            r.mods = rng.next() % 2 ? arc::gesture::kModAlt : 0u;
+            out.push_back(r);
+            r.msg = down + 1;
+            r.time_ms = (t += 40 + rng.next() % 200);
+        } else if (out.size() % 200 == 0) {
+            r.msg = arc::dispatch::kMouseWheel;
+        }
+        out.push_back(r);
+    }
+    return out;
+}
+
+double elapsed_ns(std::chrono::steady_clock::time_point t0) {
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+}
+
+/** ns/event of translating the stream through @p fn (an opaque pointer, as in the hook). */
+double time_translate(const std::vector<Raw> &stream, TranslateFn fn, std::uint64_t &sink) {
+    TranslateFn volatile slot = fn;
+    TranslateFn f = slot;
+    for (const Raw &r : stream)  // warm-up
+        sink += static_cast<unsigned>(f(r.msg, r.xbutton).type);
+    auto t0 = std::chrono::steady_clock::now();
+    for (const Raw &r : stream)
+        sink += static_cast<unsigned>(f(r.msg, r.xbutton).type);
+    return elapsed_ns(t0) / static_cast<double>(stream.size());
+}
+
+/** ns/event of translating and deciding; fills @p out with each decision's injection count. */
+double time_engine(const std::vector<Raw> &stream, TranslateFn fn, const arc::gesture::Settings &s,
+                   std::vector<std::uint8_t> &out) {
+    TranslateFn volatile slot = fn;
+    TranslateFn f = slot;
+    arc::gesture::Engine engine(s);
+    out.assign(stream.size(), 0);
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < stream.size(); ++i) {
+        const Raw &r = stream[i];
+        Kind k = f(r.msg, r.xbutton);
+        arc::gesture::Event e{k.type, k.button, r.x, r.y, r.time_ms, r.mods};
+        arc::gesture::Decision d = engine.on_event(e);
+        out[i] = static_cast<std::uint8_t>(d.count | (d.verdict == arc::gesture::Verdict::Swallow ? 0x80 : 0));
+    }
+    return elapsed_ns(t0) / static_cast<double>(stream.size());
+}
+
+}  // namespace
+
+/** @brief Entry point: per-trigger ns/event, generic vs. specialized. */
+int main(int argc, char **argv) {
+    std::size_t n = 8000000;
+    if (argc > 1)
+        n = static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10));
+    XorShift rng;
+    std::vector<Raw> stream = make_stream(n, rng);
+    std::size_t moves = 0;
+    for (const Raw &r : stream)
+        moves += r.msg == arc::dispatch::kMouseMove;
+    std::printf("[BENCH] %zu events, %.1f%% moves\n", stream.size(),
+                100.0 * static_cast<double>(moves) / static_cast<double>(stream.size()));
+    std::printf("[BENCH] %-8s %14s %14s %16s %16s\n", "trigger", "generic_ns", "special_ns", "generic+eng_ns",
+                "special+eng_ns");
+
+    static const Button kTriggers[] = {Button::Left, Button::Middle, Button::X1, Button::X2};
+    static const char *kNames[] = {"left", "middle", "x1", "x2"};
+    std::uint64_t sink = 0;
+    int mismatches = 0;
+    for (int i = 0; i < 4; ++i) {
+        arc::gesture::Settings s;
+        s.trigger = kTriggers[i];
+        TranslateFn special = arc::dispatch::select(s);
+        double gen_ns = time_translate(stream, &arc::dispatch::translate, sink);
+        double spec_ns = time_translate(stream, special, sink);
+        std::vector<std::uint8_t> gen_out, spec_out;
+        double gen_eng = time_engine(stream, &arc::dispatch::translate, s, gen_out);
+        double spec_eng = time_engine(stream, special, s, spec_out);
+        mismatches += gen_out != spec_out;
+        std::printf("[BENCH] %-8s %14.2f %14.2f %16.2f %16.2f\n", kNames[i], gen_ns, spec_ns, gen_eng, spec_eng);
+    }
+    if (mismatches)
+        std::printf("[BENCH] decisions differ for %d trigger(s)\n", mismatches);
+    if (sink == 0)
+        std::printf("[BENCH] (empty stream)\n");
+    return mismatches ? 1 : 0;
+}
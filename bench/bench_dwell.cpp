@@ -0,0 +1,211 @@
+/**
+ * @file bench_dwell.cpp
+ * @brief CPU cost of dwell-click detection under continuous pointer motion.
+ *
+ * Usage: bench_dwell [events]
+ *
+ * The stream is a mouse moving all the time with Alt held, at 1000 and 8000
+ * reports per second: stretches of wandering (the pointer leaves the radius
+ * every few reports) alternate with rests where it only jitters by a pixel,
+ * some long enough to dwell. Each run drives the engine the way the hook
+ * does, with one arc::timer::Wheel timer kept at the engine's deadline, and
+ * times:
+ * - off: dwell disabled, every move takes the engine's idle fast path;
+ * - dwell: the engine's O(1) anchor check with its lazily re-armed deadline;
+ * - naive: the same anchor check outside the engine, but the timer is
+ *   cancelled and scheduled again on every move, the usual "restart the
+ *   idle timer" pattern.
+ * Besides ns/event it reports timer changes per 1000 events and the number
+ * of dwell clicks, which must match between the dwell and naive runs. In
+ * the hook a timer change that moves the earliest deadline also re-arms the
+ * thread timer (SetTimer), a system call the in-process wheel here does not
+ * pay, so the change rate matters more than the ns/event difference.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "arc/gesture.h"
+#include "arc/timer_wheel.h"
+
+using arc::gesture::Event;
+using arc::gesture::EventType;
+
+namespace {
+
+constexpr std::uint32_t kDwellMs = 600;
+constexpr std::int32_t kRadius = 6;
+
+/** Small deterministic PRNG so runs are comparable. */
+struct XorShift {
+    std::uint64_t s = 0x9E3779B97F4A7C15ull;
+    std::uint32_t next() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return static_cast<std::uint32_t>(s >> 32);
+    }
+};
+
+/** Builds @p n moves at @p rate reports per second (timestamps have 1 ms resolution). */
+std::vector<Event> make_stream(std::size_t n, int rate) {
+    std::vector<Event> out;
+    out.reserve(n);
+    XorShift rng;
+    std::int32_t x = 500, y = 500;
+    std::uint64_t report = 0;
+    const std::uint64_t per_ms = static_cast<std::uint64_t>(rate / 1000);
+    auto push = [&] {
+        Event e;
+        e.type = EventType::Move;
+        e.x = x;
+        e.y = y;
+        e.time_ms = static_cast<std::uint32_t>(report++ / per_ms);
+        e.mods = arc::gesture::kModAlt;
+        out.push_back(e);
+    };
+    while (out.size() < n) {
+        // Wander: a few pixels per millisecond in a random direction
+        std::int32_t vx = static_cast<std::int32_t>(rng.next() % 9) - 4;
+        std::int32_t vy = static_cast<std::int32_t>(rng.next() % 9) - 4;
+        std::uint64_t wander = (200 + rng.next() % 1300) * per_ms;
+        for (std::uint64_t i = 0; i < wander && out.size() < n; ++i) {
+            if (i % per_ms == 0) {
+                x += vx;
+                y += vy;
+            }
+            push();
+        }
+        // Rest: one-pixel jitter around a point, sometimes past the dwell time
+        std::int32_t cx = x, cy = y;
+        std::uint64_t rest = (300 + rng.next() % 1200) * per_ms;
+        for (std::uint64_t i = 0; i < rest && out.size() < n; ++i) {
+            x = cx + static_cast<std::int32_t>(rng.next() % 3) - 1;
+            y = cy + static_cast<std::int32_t>(rng.next() % 3) - 1;
+            push();
+        }
+    }
+    return out;
+}
+
+/** The hook's event loop: engine, one wheel timer at the engine's deadline (see sync_deadline in hook.cpp). */
+struct Hook {
+    arc::gesture::Engine engine;
+    arc::timer::Wheel wheel{16};
+    arc::timer::TimerId timer = 0;
+    std::uint32_t timer_at = 0;
+    std::uint64_t rearms = 0;
+    std::uint64_t injected = 0;
+
+    explicit Hook(const arc::gesture::Settings &s) : engine(s) {}
+
+    static void on_deadline(void *ctx, std::uint64_t) {
+        auto *h = static_cast<Hook *>(ctx);
+        h->timer = 0;
+        std::uint32_t at;
+        if (h->engine.deadline(at))
+            h->injected += h->engine.on_timer(at).count;
+        h->sync();
+    }
+
+    void sync() {
+        std::uint32_t at = 0;
+        bool want = engine.deadline(at);
+        if (want == (timer != 0) && (!want || at == timer_at))
+            return;
+        if (timer)
+            wheel.cancel(timer);
+        timer = want ? wheel.schedule(at, on_deadline, this) : 0;
+        timer_at = at;
+        ++rearms;
+    }
+
+    void feed(const Event &e) {
+        wheel.advance(e.time_ms);
+        injected += engine.on_event(e).count;
+        sync();
+    }
+};
+
+/** Dwell outside the engine, restarting its timer on every move. */
+struct Naive {
+    arc::timer::Wheel wheel{16};
+    arc::timer::TimerId timer = 0;
+    bool fired = true;
+    std::int32_t ax = 0, ay = 0;
+    std::uint32_t since = 0;
+    std::uint64_t rearms = 0;
+    std::uint64_t injected = 0;
+
+    static void on_deadline(void *ctx, std::uint64_t now) {
+        auto *n = static_cast<Naive *>(ctx);
+        n->timer = 0;
+        if (!n->fired && now - n->since >= kDwellMs) {
+            n->injected += 2;
+            n->fired = true;
+        }
+    }
+
+    void feed(const Event &e) {
+        wheel.advance(e.time_ms);
+        std::int64_t dx = e.x - ax, dy = e.y - ay;
+        if (dx * dx + dy * dy > static_cast<std::int64_t>(kRadius) * kRadius) {
+            ax = e.x;
+            ay = e.y;
+            since = e.time_ms;
+            fired = false;
+        }
+        if (timer)
+            wheel.cancel(timer);
+        timer = fired ? 0 : wheel.schedule(since + kDwellMs, on_deadline, this);
+        ++rearms;
+    }
+};
+
+template <typename Runner> double run(Runner &r, const std::vector<Event> &stream) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (const Event &e : stream)
+        r.feed(e);
+    auto t1 = std::chrono::steady_clock::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+}
+
+void report(const char *name, int rate, double ns, std::uint64_t rearms, std::uint64_t injected, std::size_t n) {
+    std::printf("[BENCH] %4d Hz %-5s: %6.2f ns/event, %8.2f timer changes/1000 events, %llu dwell clicks\n", rate,
+                name, ns / static_cast<double>(n), static_cast<double>(rearms) * 1000.0 / static_cast<double>(n),
+                static_cast<unsigned long long>(injected / 2));
+}
+
+}  // namespace
+
+/** @brief Entry point: runs each strategy at both report rates. */
+int main(int argc, char **argv) {
+    std::size_t n = 4000000;
+    if (argc > 1)
+        n = static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10));
+
+    for (int rate : {1000, 8000}) {
+        std::vector<Event> stream = make_stream(n, rate);
+        arc::gesture::Settings s;
+        s.move_radius_px = kRadius;
+
+        Hook off(s);
+        double ns_off = run(off, stream);
+        report("off", rate, ns_off, off.rearms, off.injected, n);
+
+        s.dwell_ms = kDwellMs;
+        Hook dwell(s);
+        double ns_dwell = run(dwell, stream);
+        report("dwell", rate, ns_dwell, dwell.rearms, dwell.injected, n);
+
+        Naive naive;
+        double ns_naive = run(naive, stream);
+        report("naive", rate, ns_naive, naive.rearms, naive.injected, n);
+        if (naive.injected != dwell.injected)
+            std::printf("[BENCH] warning: dwell clicks differ from the naive strategy\n");
+    }
+    return 0;
+}
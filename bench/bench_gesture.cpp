@@ -0,0 +1,113 @@
+/**
+ * @file bench_gesture.cpp
+ * @brief Replays synthetic input through arc::gesture::Engine and reports ns/event.
+ *
+ * Usage: bench_gesture [events]
+ *
+ * The synthetic stream is move-heavy like real input: bursts of pointer motion
+ * interleaved with Alt+Left clicks, Alt+Left drags and plain clicks. The
+ * stream is generated up front so only the engine is timed.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "arc/gesture.h"
+
+using arc::gesture::Button;
+using arc::gesture::Event;
+using arc::gesture::EventType;
+
+namespace {
+
+/** Small deterministic PRNG so runs are comparable. */
+struct XorShift {
+    std::uint64_t s = 0x9E3779B97F4A7C15ull;
+    std::uint32_t next() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return static_cast<std::uint32_t>(s >> 32);
+    }
+};
+
+/** Builds a synthetic event stream of at least @p n events. */
+std::vector<Event> make_stream(std::size_t n) {
+    std::vector<Event> out;
+    out.reserve(n + 64);
+    XorShift rng;
+    std::int32_t x = 500, y = 500;
+    std::uint32_t t = 0;
+    auto push = [&](EventType type, Button b, std::uint32_t mods) {
+        Event e;
+        e.type = type;
+        e.button = b;
+        e.x = x;
+        e.y = y;
+        e.time_ms = t;
+        e.mods = mods;
+        out.push_back(e);
+    };
+    while (out.size() < n) {
+        // Burst of motion
+        int moves = 16 + static_cast<int>(rng.next() % 64);
+        for (int i = 0; i < moves; ++i) {
+            x += static_cast<std::int32_t>(rng.next() % 5) - 2;
+            y += static_cast<std::int32_t>(rng.next() % 5) - 2;
+            t += 1;
+            push(EventType::Move, Button::None, 0);
+        }
+        // Then a gesture
+        std::uint32_t kind = rng.next() % 4;
+        std::uint32_t mods = (kind == 3) ? 0u : static_cast<std::uint32_t>(arc::gesture::kModAlt);
+        push(EventType::Down, Button::Left, mods);
+        int steps = (kind == 1) ? 24 : 3;  // kind 1: drag
+        for (int i = 0; i < steps; ++i) {
+            x += (kind == 1) ? 2 : 0;
+            t += 2;
+            push(EventType::Move, Button::None, 0);
+        }
+        t += (kind == 2) ? 400 : 20;  // kind 2: long press
+        push(EventType::Up, Button::Left, mods);
+    }
+    return out;
+}
+
+}  // namespace
+
+/** @brief Entry point: replays the stream and prints throughput. */
+int main(int argc, char **argv) {
+    std::size_t n = 5000000;
+    if (argc > 1)
+        n = static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10));
+    std::vector<Event> stream = make_stream(n);
+
+    arc::gesture::Engine engine;
+    std::uint64_t swallowed = 0, injected = 0;
+    // Warm-up pass
+    for (const Event &e : stream) {
+        auto d = engine.on_event(e);
+        swallowed += (d.verdict == arc::gesture::Verdict::Swallow);
+        injected += d.count;
+    }
+    engine.reset();
+    swallowed = injected = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (const Event &e : stream) {
+        auto d = engine.on_event(e);
+        swallowed += (d.verdict == arc::gesture::Verdict::Swallow);
+        injected += d.count;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+
+    std::printf("[BENCH] gesture engine: %zu events, %.2f ns/event, %.1f Mevents/s\n", stream.size(),
+                ns / static_cast<double>(stream.size()), static_cast<double>(stream.size()) * 1e3 / ns);
+    std::printf("[BENCH] swallowed=%llu injected=%llu\n", static_cast<unsigned long long>(swallowed),
+                static_cast<unsigned long long>(injected));
+    return 0;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file bench_load.cpp
+ * @brief CPU time per second of input for a high-rate (8 kHz) mouse.
+ *
+ * Usage: bench_load [seconds] [--rate HZ] [--budget-us N]
+ *
+ * Synthesizes @c seconds of input from a mouse polling at @c rate Hz
+ * (default 60 s at 8000 Hz): continuous pointer motion with, every second,
+ * a few plain clicks, two bound Alt+Left clicks with jitter while held and
+ * one bound press that turns into a drag. The raw messages go through the
+ * snapshot's translation instance and the engine, as in the hook, and the
+ * process CPU time is reported per second of input (and as a share of one
+ * core) for a few engine configurations. With --budget-us the exit status
+ * is 1 if any configuration needs more CPU than that per input second.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include "arc/dispatch.h"
+#include "arc/gesture.h"
+
+using arc::dispatch::TranslateFn;
+
+namespace {
+
+/** Small deterministic PRNG so runs are comparable. */
+struct XorShift {
+    std::uint64_t s = 0x9E3779B97F4A7C15ull;
+    std::uint32_t next() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return static_cast<std::uint32_t>(s >> 32);
+    }
+};
+
+/// @brief One raw hook message; time in microseconds of input.
+struct Raw {
+    unsigned int msg;
+    std::int32_t x, y;
+    std::uint64_t time_us;
+    std::uint32_t mods;
+};
+
+/** What happens during the current stretch of input. */
+enum class Phase { Idle, Click, BoundClick, Drag };
+
+/**
+ * @p seconds of input at @p rate Hz: one message per poll (a move, or a
+ * button transition instead of the move at the start and end of a press).
+ */
+std::vector<Raw> make_session(unsigned seconds, unsigned rate, XorShift &rng) {
+    std::vector<Raw> out;
+    out.reserve(static_cast<std::size_t>(seconds) * rate + 16);
+    const std::uint64_t period_us = 1000000 / rate;
+    std::int32_t x = 960, y = 540;
+    std::uint64_t t = 0;
+    for (unsigned s = 0; s < seconds; ++s) {
+        // Four presses per second at random polls: plain, bound, bound, drag
+        std::uint32_t starts[4];
+        for (auto &v : starts)
+            v = rng.next() % rate;
+        Phase plan[4] = {Phase::Click, Phase::BoundClick, Phase::BoundClick, Phase::Drag};
+        Phase phase = Phase::Idle;
+        std::uint32_t left = 0;
+        for (unsigned i = 0; i < rate; ++i, t += period_us) {
+            Raw r{arc::dispatch::kMouseMove, x, y, t, 0};
+            if (phase == Phase::Idle) {
+                for (int k = 0; k < 4; ++k) {
+                    if (starts[k] == i) {
+                        phase = plan[k];
+                        left = rate / 10 + rng.next() % (rate / 20 + 1);  // ~100-150 ms press
+                        r.msg = arc::dispatch::kLButtonDown;
+                        r.mods = phase == Phase::Click ? 0u : static_cast<std::uint32_t>(arc::gesture::kModAlt);
+                        break;
+                    }
+                }
+                if (r.msg == arc::dispatch::kMouseMove) {
+                    x += static_cast<std::int32_t>(rng.next() % 3) - 1;  // 8 kHz: sub-pixel hand motion
+                    y += static_cast<std::int32_t>(rng.next() % 3) - 1;
+                    r.x = x;
+                    r.y = y;
+                }
+            } else if (--left == 0) {
+                r.msg = arc::dispatch::kLButtonUp;
+                phase = Phase::Idle;
+            } else {
+                if (phase == Phase::Drag)
+                    x += (i & 7) == 0;  // ~1 px/ms while dragging
+                else if ((rng.next() & 63) == 0)
+                    x += static_cast<std::int32_t>(rng.next() % 3) - 1;  // jitter while held
+                r.x = x;
+                r.y = y;
+                if (phase != Phase::Click)
+                    r.mods = arc::gesture::kModAlt;
+            }
+            out.push_back(r);
+        }
+    }
+    return out;
+}
+
+/** Replays @p session through translation and a fresh engine; returns the swallow count. */
+std::uint64_t replay(const std::vector<Raw> &session, TranslateFn f, const arc::gesture::Settings &s) {
+    arc::gesture::Engine engine(s);
+    std::uint64_t swallowed = 0;
+    for (const Raw &r : session) {
+        arc::dispatch::Kind k = f(r.msg, 0);
+        arc::gesture::Event e{k.type, k.button, r.x, r.y, static_cast<std::uint32_t>(r.time_us / 1000), r.mods};
+        swallowed += engine.on_event(e).verdict == arc::gesture::Verdict::Swallow;
+    }
+    return swallowed;
+}
+
+}  // namespace
+
+/** @brief Entry point: CPU microseconds per second of input, per configuration. */
+int main(int argc, char **argv) {
+    unsigned seconds = 60, rate = 8000;
+    double budget_us = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--rate") && i + 1 < argc)
+            rate = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--budget-us") && i + 1 < argc)
+            budget_us = std::strtod(argv[++i], nullptr);
+        else
+            seconds = static_cast<unsigned>(std::strtoul(argv[i], nullptr, 10));
+    }
+    if (seconds == 0 || rate < 100 || rate > 1000000) {
+        std::fprintf(stderr, "Usage: bench_load [seconds] [--rate HZ] [--budget-us N]\n");
+        return 2;
+    }
+    XorShift rng;
+    std::vector<Raw> session = make_session(seconds, rate, rng);
+
+    struct Config {
+        const char *name;
+        std::uint32_t predict_ms;
+        bool speculative;
+    };
+    static const Config kConfigs[] = {{"default", 0, false}, {"predict_ms=30", 30, false}, {"speculative", 0, true}};
+
+    std::printf("[BENCH] %u s at %u Hz (%zu events)\n", seconds, rate, session.size());
+    std::printf("[BENCH] %-14s %8s %12s %12s %10s\n", "config", "reps", "ns/event", "cpu_us/s", "core_%");
+    bool over = false;
+    for (const Config &c : kConfigs) {
+        arc::gesture::Settings s;
+        s.predict_ms = c.predict_ms;
+        s.speculative = c.speculative;
+        TranslateFn f = arc::dispatch::select(s);
+        std::uint64_t sink = replay(session, f, s);  // warm-up
+        // Repeat until the process clock has measured at least half a second
+        unsigned reps = 0;
+        std::clock_t c0 = std::clock(), c1 = c0;
+        do {
+            sink += replay(session, f, s);
+            ++reps;
+            c1 = std::clock();
+        } while (static_cast<double>(c1 - c0) < 0.5 * CLOCKS_PER_SEC);
+        double cpu_s = static_cast<double>(c1 - c0) / CLOCKS_PER_SEC;
+        double input_s = static_cast<double>(seconds) * reps;
+        double us_per_s = cpu_s * 1e6 / input_s;
+        std::printf("[BENCH] %-14s %8u %12.2f %12.1f %10.4f\n", c.name, reps,
+                    cpu_s * 1e9 / (static_cast<double>(session.size()) * reps), us_per_s, us_per_s / 1e4);
+        if (budget_us > 0 && us_per_s > budget_us) {
+            std::printf("[BENCH] %s exceeds the budget of %.1f us per second of input\n", c.name, budget_us);
+            over = true;
+        }
+        if (sink == 0)
+            std::printf("[BENCH] (nothing swallowed)\n");
+    }
+    return over ? 1 : 0;
+}
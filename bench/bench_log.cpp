@@ -0,0 +1,423 @@
+/**
+ * @file bench_log.cpp
+ * @brief Async logger: queue throughput and producer tail latency (ring vs
+ *        deque), write batching under each flush policy, and line formatting.
+ *
+ * Usage: bench_log [lines]
+ *
+ * 1, 4 and 16 producer threads share @p lines log lines of about 80 bytes
+ * and hand them to one consumer thread, which copies each line into a sink
+ * buffer (standing in for the console and file writes). Two queues run the
+ * same load:
+ * - ring: arc::log::Queue, the fixed-slot MPSC ring with its spill buffer;
+ * - deque: the previous scheme, a heap std::string per line pushed into a
+ *   std::deque under one mutex with a condition variable notified per line,
+ *   the consumer relocking the mutex for every line.
+ * Producers log in bursts of kBurst lines and yield in between, like a
+ * busy hook thread rather than a flood: a flood outruns any consumer, and
+ * the ring then spills and drops (reported) where the deque just grows.
+ * Reports lines/s from the first push until the consumer has everything,
+ * and the time one push call takes (every 8th push is timed) at p50, p99,
+ * p99.9 and max; the tail is where producers wait behind each other. On a
+ * single core the multi-producer rows mostly measure the scheduler.
+ *
+ * The flush rows then send @p lines / 4 lines from 4 producers into two
+ * temporary files (console and log file stand-ins): "per-line" writes and
+ * flushes each line on its own, as the worker did before batching; the
+ * others drain into one buffer and write it per flush under an
+ * arc::log::FlushPolicy (every wakeup, 5 ms, 64 KiB). Reports lines/s,
+ * stream flushes per line and, on Linux, write syscalls per line.
+ *
+ * The format rows build @p lines / 2 lines on one thread: "streams" the way
+ * the logger did before (a calendar conversion and two string streams per
+ * line), "cached" with arc::log::TimestampCache and format_line into a
+ * stack buffer, at second, millisecond and microsecond precision.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "arc/log_batch.h"
+#include "arc/log_format.h"
+#include "arc/log_queue.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kBurst = 32;  ///< Lines a producer logs before yielding.
+
+/** Nanoseconds since an arbitrary epoch on the steady clock. */
+inline std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+/** Returns the value at quantile @p q of a sorted sample. */
+std::int64_t quantile(const std::vector<std::int64_t> &sorted, double q) {
+    if (sorted.empty())
+        return 0;
+    std::size_t i = static_cast<std::size_t>(q * static_cast<double>(sorted.size() - 1));
+    return sorted[i];
+}
+
+/** Consumer side stand-in for the console/file writes: keeps the copy from being optimized away. */
+struct Sink {
+    char buf[4096];
+    std::size_t at = 0;
+    std::uint64_t lines = 0;
+
+    void put(const char *text, std::size_t size) {
+        if (at + size > sizeof buf)
+            at = 0;
+        std::memcpy(buf + at, text, size < sizeof buf ? size : sizeof buf);
+        at += size;
+    }
+};
+
+/** The previous logger queue: heap strings in a deque behind one mutex. */
+struct DequeQueue {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::string> lines;
+    bool stop = false;
+
+    void push(const char *text, std::size_t size) {
+        std::string s(text, size);
+        std::lock_guard<std::mutex> lk(mutex);
+        lines.emplace_back(std::move(s));
+        cv.notify_one();
+    }
+
+    void consume(Sink &sink) {
+        std::unique_lock<std::mutex> lk(mutex);
+        while (!stop || !lines.empty()) {
+            if (lines.empty()) {
+                cv.wait(lk, [this] { return stop || !lines.empty(); });
+                if (stop && lines.empty())
+                    break;
+            }
+            std::string s = std::move(lines.front());
+            lines.pop_front();
+            lk.unlock();
+            sink.put(s.data(), s.size());
+            ++sink.lines;
+            lk.lock();
+        }
+    }
+
+    void finish() {
+        std::lock_guard<std::mutex> lk(mutex);
+        stop = true;
+        cv.notify_one();
+    }
+};
+
+/**
+ * @brief Two stdio streams on temporary files, standing in for the console
+ *        and the log file; every put is one write and flush per stream.
+ */
+struct FileSink {
+    std::FILE *out[2];
+    std::uint64_t lines = 0;
+    std::uint64_t writes = 0;  ///< Stream flushes (each one write syscall for text up to the stdio buffer).
+
+    FileSink() {
+        for (auto &f : out) {
+            f = std::tmpfile();
+            if (f)
+                std::setvbuf(f, nullptr, _IOFBF, 1 << 16);
+        }
+    }
+    ~FileSink() {
+        for (auto *f : out)
+            if (f)
+                std::fclose(f);
+    }
+    FileSink(const FileSink &) = delete;
+    FileSink &operator=(const FileSink &) = delete;
+
+    void put(const char *text, std::size_t size) {
+        for (auto *f : out) {
+            if (!f)
+                continue;
+            std::fwrite(text, 1, size, f);
+            std::fflush(f);
+            ++writes;
+        }
+    }
+};
+
+/** Write syscalls this process has made (Linux /proc/self/io), or -1 where unavailable. */
+long long write_syscalls() {
+    std::FILE *f = std::fopen("/proc/self/io", "r");
+    if (!f)
+        return -1;
+    char key[32];
+    long long value = -1, found = -1;
+    while (std::fscanf(f, "%31s %lld", key, &value) == 2) {
+        if (std::strcmp(key, "syscw:") == 0)
+            found = value;
+    }
+    std::fclose(f);
+    return found;
+}
+
+/** The ring queue with the logger worker's drain loop, writing every line on its own. */
+struct RingQueue {
+    arc::log::Queue queue;
+
+    void push(const char *text, std::size_t size) { queue.push(text, size); }
+
+    template <typename S> void consume(S &sink) {
+        std::string line, spill;
+        for (;;) {
+            bool stopping = queue.stopping();
+            bool any = false;
+            while (queue.pop(line)) {
+                sink.put(line.data(), line.size());
+                line.clear();
+                ++sink.lines;
+                any = true;
+            }
+            spill.clear();
+            if (queue.take_spill(spill)) {
+                sink.put(spill.data(), spill.size());
+                sink.lines += static_cast<std::uint64_t>(std::count(spill.begin(), spill.end(), '\n'));
+                any = true;
+            }
+            if (any)
+                continue;
+            if (stopping)
+                break;
+            queue.wait();
+        }
+    }
+
+    void finish() { queue.stop(); }
+};
+
+/** The batching logger worker: one put per flush, under @ref policy. */
+struct BatchQueue {
+    arc::log::Queue queue;
+    arc::log::FlushPolicy policy;
+
+    void push(const char *text, std::size_t size) { queue.push(text, size); }
+
+    template <typename S> void consume(S &sink) {
+        arc::log::Batch batch;
+        batch.set_policy(policy);
+        for (;;) {
+            bool stopping = queue.stopping();
+            if (queue.take_urgent())
+                batch.force();
+            std::string &text = batch.text();
+            std::size_t before = text.size();
+            while (queue.pop(text)) {
+            }
+            queue.take_spill(text);
+            bool any = text.size() != before;
+            std::int64_t now = now_ns() / 1000000;
+            if (any)
+                batch.appended(now);
+            if ((stopping || batch.due(now)) && !batch.empty()) {
+                sink.put(text.data(), text.size());
+                sink.lines += static_cast<std::uint64_t>(std::count(text.begin(), text.end(), '\n'));
+                batch.clear();
+            }
+            if (any)
+                continue;
+            if (stopping)
+                break;
+            std::int64_t wait = batch.wait_ms(now);
+            if (wait < 0)
+                queue.wait();
+            else
+                queue.wait_for(static_cast<std::uint32_t>(wait));
+        }
+    }
+
+    void finish() { queue.stop(); }
+};
+
+struct Result {
+    double lines_per_s = 0;
+    std::vector<std::int64_t> push_ns;
+    std::uint64_t received = 0;
+    std::uint64_t writes = 0;
+};
+
+template <typename Q, typename S = Sink> Result run(Q &q, int producers, std::size_t lines) {
+    Result r;
+    std::size_t per = lines / static_cast<std::size_t>(producers);
+    std::vector<std::vector<std::int64_t>> samples(static_cast<std::size_t>(producers));
+    S sink;
+    std::atomic<bool> go{false};
+    std::thread consumer([&]() { q.consume(sink); });
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            std::vector<std::int64_t> &mine = samples[static_cast<std::size_t>(p)];
+            mine.reserve(per / 8 + 1);
+            char line[128];
+            int n = std::snprintf(line, sizeof line,
+                                  "[2024-01-01 12:00:00] [DEBUG] [T:%d] Hook: event processed in the bench loop\n", p);
+            while (!go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            for (std::size_t i = 0; i < per; ++i) {
+                if (i % kBurst == 0)
+                    std::this_thread::yield();
+                if (i % 8 == 0) {
+                    std::int64_t t0 = now_ns();
+                    q.push(line, static_cast<std::size_t>(n));
+                    mine.push_back(now_ns() - t0);
+                } else {
+                    q.push(line, static_cast<std::size_t>(n));
+                }
+            }
+        });
+    }
+    auto t0 = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto &t : threads)
+        t.join();
+    q.finish();
+    consumer.join();
+    double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+    r.received = sink.lines;
+    if constexpr (std::is_same<S, FileSink>::value)
+        r.writes = sink.writes;
+    r.lines_per_s = static_cast<double>(sink.lines) * 1e9 / ns;
+    for (auto &s : samples)
+        r.push_ns.insert(r.push_ns.end(), s.begin(), s.end());
+    std::sort(r.push_ns.begin(), r.push_ns.end());
+    return r;
+}
+
+void report(const char *name, int producers, const Result &r) {
+    std::printf("[BENCH] %-5s %2d producers: %6.2f Mlines/s, push ns p50=%lld p99=%lld p999=%lld max=%lld "
+                "(%llu lines)\n",
+                name, producers, r.lines_per_s / 1e6, static_cast<long long>(quantile(r.push_ns, 0.50)),
+                static_cast<long long>(quantile(r.push_ns, 0.99)), static_cast<long long>(quantile(r.push_ns, 0.999)),
+                static_cast<long long>(r.push_ns.empty() ? 0 : r.push_ns.back()),
+                static_cast<unsigned long long>(r.received));
+}
+
+/** Runs @p q into two temporary files and reports lines/s, flushes and write syscalls per line. */
+template <typename Q> void run_flush(const char *name, Q &q, std::size_t lines) {
+    q.queue.restart();
+    long long sys0 = write_syscalls();
+    Result r = run<Q, FileSink>(q, 4, lines);
+    long long sys1 = write_syscalls();
+    double per_line = r.received ? 1.0 / static_cast<double>(r.received) : 0.0;
+    std::printf("[BENCH] flush %-9s 4 producers: %6.2f Mlines/s, %.4f flushes/line", name, r.lines_per_s / 1e6,
+                static_cast<double>(r.writes) * per_line);
+    if (sys0 >= 0 && sys1 >= 0)
+        std::printf(", %.4f write syscalls/line", static_cast<double>(sys1 - sys0) * per_line);
+    std::printf(" (%llu lines)\n", static_cast<unsigned long long>(r.received));
+}
+
+/** The previous line formatting: localtime and put_time per line, two string streams. */
+std::string format_streams(const std::string &msg) {
+    auto now = std::chrono::system_clock::now();
+    std::time_t t = std::chrono::system_clock::to_time_t(now);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    std::ostringstream oss;
+    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
+    std::ostringstream line;
+    line << '[' << oss.str() << "] [" << "DEBUG" << ']' << " [T:" << 4072 << ']' << ' ' << msg << '\n';
+    return line.str();
+}
+
+/** Formats @p lines lines on one thread and reports formatted lines/s. */
+template <typename F> void run_format(const char *name, std::size_t lines, F &&format_one) {
+    Sink sink;
+    auto t0 = Clock::now();
+    for (std::size_t i = 0; i < lines; ++i)
+        format_one(sink);
+    double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+    std::printf("[BENCH] format %-8s %6.2f Mlines/s, %6.1f ns/line\n", name, static_cast<double>(lines) * 1e3 / ns,
+                ns / static_cast<double>(lines));
+}
+
+}  // namespace
+
+/** @brief Entry point: runs both queues at 1, 4 and 16 producers, then the flush policies and line formatting. */
+int main(int argc, char **argv) {
+    std::size_t lines = 2000000;
+    if (argc > 1)
+        lines = static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10));
+
+    for (int producers : {1, 4, 16}) {
+        static RingQueue ring;
+        ring.queue.restart();
+        std::uint64_t spilled = ring.queue.spilled(), dropped = ring.queue.dropped();
+        Result rr = run(ring, producers, lines);
+        report("ring", producers, rr);
+        std::printf("[BENCH]       spilled=%llu dropped=%llu\n",
+                    static_cast<unsigned long long>(ring.queue.spilled() - spilled),
+                    static_cast<unsigned long long>(ring.queue.dropped() - dropped));
+
+        DequeQueue deque;
+        Result rd = run(deque, producers, lines);
+        report("deque", producers, rd);
+    }
+
+    // Writing to files: per-line flushing against batches under each policy
+    std::size_t flush_lines = lines / 4;
+    static RingQueue per_line;
+    run_flush("per-line", per_line, flush_lines);
+    static BatchQueue batch;
+    const struct {
+        const char *name;
+        arc::log::FlushPolicy policy;
+    } policies[] = {{"wakeup", {0, 0}}, {"5ms", {5, 0}}, {"64KiB", {0, 1u << 16}}};
+    for (const auto &p : policies) {
+        batch.policy = p.policy;
+        run_flush(p.name, batch, flush_lines);
+    }
+
+    // Formatting one line: streams per line against the cached timestamp and a stack buffer
+    const std::string msg = "Hook: event processed in the bench loop";
+    std::size_t format_lines = lines / 2;
+    run_format("streams", format_lines, [&msg](Sink &sink) {
+        std::string s = format_streams(msg);
+        sink.put(s.data(), s.size());
+    });
+    const struct {
+        const char *name;
+        arc::log::Precision precision;
+    } precisions[] = {{"cached", arc::log::Precision::Seconds},
+                      {"cached.ms", arc::log::Precision::Millis},
+                      {"cached.us", arc::log::Precision::Micros}};
+    for (const auto &p : precisions) {
+        arc::log::TimestampCache cache;
+        run_format(p.name, format_lines, [&](Sink &sink) {
+            char stamp[arc::log::kTimestampBytes];
+            std::size_t stamp_len = cache.format(arc::log::wall_us(), p.precision, stamp);
+            char line[arc::log::kLineBytes];
+            std::size_t n = arc::log::format_line(line, sizeof line, {stamp, stamp_len}, "DEBUG", true, 4072, msg);
+            sink.put(line, n < sizeof line ? n : sizeof line);
+        });
+    }
+    return 0;
+}
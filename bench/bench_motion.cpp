@@ -0,0 +1,114 @@
+/**
+ * @file bench_motion.cpp
+ * @brief Cost of buffering pointer motion while tracking and of replaying it
+ *        on drag.
+ *
+ * Usage: bench_motion [drags]
+ *
+ * Each drag is an Alt+Left press, a jiggle inside the move radius of a
+ * random length (short taps up to long slow presses that overflow the
+ * buffer), then an exit move. Reports ns per tracked move (the buffering
+ * cost on the hot path) and ns per drag exit, including building the
+ * absolute-move inputs the hook hands to SendInput.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "arc/gesture.h"
+
+using arc::gesture::Button;
+using arc::gesture::Event;
+using arc::gesture::EventType;
+
+namespace {
+
+/** Small deterministic PRNG so runs are comparable. */
+struct XorShift {
+    std::uint64_t s = 0x9E3779B97F4A7C15ull;
+    std::uint32_t next() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return static_cast<std::uint32_t>(s >> 32);
+    }
+};
+
+/** Same shape as the hook's absolute SendInput move. */
+struct AbsMove {
+    std::int32_t dx, dy;
+    std::uint32_t flags;
+};
+
+Event make(EventType type, Button b, std::int32_t x, std::int32_t y) {
+    Event e;
+    e.type = type;
+    e.button = b;
+    e.x = x;
+    e.y = y;
+    e.mods = (type == EventType::Down) ? static_cast<std::uint32_t>(arc::gesture::kModAlt) : 0u;
+    return e;
+}
+
+double elapsed_ns(std::chrono::steady_clock::time_point t0) {
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+}
+
+}  // namespace
+
+/** @brief Entry point: times tracked moves and drag replays separately. */
+int main(int argc, char **argv) {
+    std::size_t drags = 200000;
+    if (argc > 1)
+        drags = static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10));
+
+    // Pre-generate jiggle lengths and offsets so only the engine is timed
+    XorShift rng;
+    std::vector<std::uint16_t> lengths(drags);
+    std::vector<std::int8_t> jiggle(1 << 16);
+    for (auto &n : lengths)
+        n = static_cast<std::uint16_t>(rng.next() % 8 == 0 ? 64 + rng.next() % 512 : rng.next() % 24);
+    for (auto &j : jiggle)
+        j = static_cast<std::int8_t>(static_cast<int>(rng.next() % 9) - 4);
+
+    arc::gesture::Engine engine;
+    const std::int32_t vw = 3840, vh = 2160;
+    AbsMove out[arc::gesture::Engine::kMotionCapacity + 1];
+    std::uint64_t moves = 0, replayed = 0, checksum = 0;
+    double move_ns = 0, drag_ns = 0;
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < drags; ++i) {
+        engine.on_event(make(EventType::Down, Button::Left, 1000, 800));
+        auto t0 = std::chrono::steady_clock::now();
+        for (int m = 0; m < lengths[i]; ++m, ++k) {
+            auto d = engine.on_event(make(EventType::Move, Button::None, 1000 + jiggle[k & 0xFFFF],
+                                          800 + jiggle[(k + 7) & 0xFFFF]));
+            checksum += d.count;
+        }
+        move_ns += elapsed_ns(t0);
+        moves += lengths[i];
+
+        t0 = std::chrono::steady_clock::now();
+        auto d = engine.on_event(make(EventType::Move, Button::None, 1020, 800));
+        for (int p = 0; p < d.path_count; ++p) {
+            out[p].dx = static_cast<std::int32_t>((static_cast<std::int64_t>(d.path[p].x) * 65535) / (vw - 1));
+            out[p].dy = static_cast<std::int32_t>((static_cast<std::int64_t>(d.path[p].y) * 65535) / (vh - 1));
+            out[p].flags = 0xC001;
+        }
+        drag_ns += elapsed_ns(t0);
+        replayed += d.path_count;
+        checksum += static_cast<std::uint64_t>(out[d.path_count - 1].dx);
+        engine.on_event(make(EventType::Up, Button::Left, 1020, 800));
+    }
+
+    std::printf("[BENCH] motion buffer: %llu tracked moves, %.2f ns/move (timer overhead included)\n",
+                static_cast<unsigned long long>(moves), moves ? move_ns / static_cast<double>(moves) : 0.0);
+    std::printf("[BENCH] drag replay: %zu drags, %.1f points/drag, %.1f ns/drag\n", drags,
+                static_cast<double>(replayed) / static_cast<double>(drags), drag_ns / static_cast<double>(drags));
+    std::printf("[BENCH] checksum=%llu\n", static_cast<unsigned long long>(checksum));
+    return 0;
+}
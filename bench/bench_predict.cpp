@@ -0,0 +1,251 @@
+/**
+ * @file bench_predict.cpp
+ * @brief Drag prediction trade-off: latency gained vs. clicks misread as drags.
+ *
+ * Usage: bench_predict [trace] [--radius N]
+ *
+ * Replays an input stream through a reference engine (prediction off) and
+ * one engine per prediction horizon, in lockstep. For every press the
+ * reference turns into a drag, the gain is how much earlier (event time)
+ * the predicting engine started it; every press the reference resolves as
+ * a click or long press but the predictor turned into a drag counts as a
+ * misclassification. The stream is a `--record-trace` file when given
+ * (its recorded settings apply), otherwise a synthetic 1 kHz session of
+ * jittery clicks, twitchy clicks and drags from rest at varied speeds on a
+ * high-DPI radius.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "arc/trace.h"
+
+using arc::gesture::Button;
+using arc::gesture::Event;
+using arc::gesture::EventType;
+using arc::gesture::Settings;
+
+namespace {
+
+/** Small deterministic PRNG so runs are comparable. */
+struct XorShift {
+    std::uint64_t s = 0x9E3779B97F4A7C15ull;
+    std::uint32_t next() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return static_cast<std::uint32_t>(s >> 32);
+    }
+    double unit() { return (next() & 0xFFFFFF) / static_cast<double>(0x1000000); }
+};
+
+/** Input stream: settings changes interleaved with events. */
+struct Item {
+    bool is_settings;
+    Event ev;
+    Settings settings;
+};
+
+/** Synthetic 1 kHz session: clicks with tremor, twitchy clicks, and drags accelerating from rest. */
+std::vector<Item> synthesize(std::int32_t radius, std::size_t presses) {
+    std::vector<Item> out;
+    XorShift rng;
+    Settings s;
+    s.move_radius_px = radius;
+    out.push_back(Item{true, Event{}, s});
+    std::uint32_t t = 0;
+    double x = 1000, y = 700;
+    auto push = [&](EventType type, Button b, std::uint32_t mods) {
+        Event e;
+        e.type = type;
+        e.button = b;
+        e.x = static_cast<std::int32_t>(std::lround(x));
+        e.y = static_cast<std::int32_t>(std::lround(y));
+        e.time_ms = t;
+        e.mods = mods;
+        out.push_back(Item{false, e, Settings{}});
+    };
+    for (std::size_t i = 0; i < presses; ++i) {
+        t += 200 + rng.next() % 400;
+        double ox = x, oy = y;
+        push(EventType::Down, Button::Left, arc::gesture::kModAlt);
+        std::uint32_t kind = rng.next() % 10;
+        if (kind < 4) {
+            // Click with tremor: sub-radius wander
+            int hold = 40 + static_cast<int>(rng.next() % 160);
+            for (int m = 0; m < hold; ++m) {
+                ++t;
+                x = ox + (rng.unit() - 0.5) * radius * 0.6;
+                y = oy + (rng.unit() - 0.5) * radius * 0.6;
+                push(EventType::Move, Button::None, 0);
+            }
+        } else if (kind < 6) {
+            // Twitchy click: a quick flick that stops short of the radius
+            double ang = rng.unit() * 6.2832, reach = radius * (0.5 + 0.45 * rng.unit());
+            int dur = 20 + static_cast<int>(rng.next() % 40);
+            for (int m = 1; m <= dur; ++m) {
+                ++t;
+                double u = static_cast<double>(m) / dur, k = u * u * (3 - 2 * u);
+                x = ox + std::cos(ang) * reach * k;
+                y = oy + std::sin(ang) * reach * k;
+                push(EventType::Move, Button::None, 0);
+            }
+            for (int m = 0; m < 30; ++m) {
+                ++t;
+                push(EventType::Move, Button::None, 0);
+            }
+        } else {
+            // Drag from rest: minimum-jerk reach of 3-20x the radius in 150-600 ms
+            double ang = rng.unit() * 6.2832, reach = radius * (3 + 17 * rng.unit());
+            int dur = 150 + static_cast<int>(rng.next() % 450);
+            for (int m = 1; m <= dur; ++m) {
+                ++t;
+                double u = static_cast<double>(m) / dur, k = u * u * u * (10 - 15 * u + 6 * u * u);
+                x = ox + std::cos(ang) * reach * k;
+                y = oy + std::sin(ang) * reach * k;
+                push(EventType::Move, Button::None, 0);
+            }
+        }
+        t += 10;
+        push(EventType::Up, Button::Left, 0);
+        x = 1000 + rng.next() % 400;
+        y = 700 + rng.next() % 300;
+    }
+    return out;
+}
+
+/** Event records of a trace file, with its settings changes. */
+bool load_trace(const std::string &path, std::vector<Item> &out) {
+    arc::trace::Reader reader;
+    std::string err;
+    if (!reader.open(path, &err)) {
+        std::fprintf(stderr, "bench_predict: %s: %s\n", path.c_str(), err.c_str());
+        return false;
+    }
+    arc::trace::Record r;
+    while (reader.next(r)) {
+        if (r.kind == arc::trace::Kind::Settings)
+            out.push_back(Item{true, Event{}, r.settings});
+        else if (r.kind == arc::trace::Kind::Event)
+            out.push_back(Item{false, r.event, Settings{}});
+    }
+    return true;
+}
+
+/** Engine with its own long-press resolution and per-press outcome. */
+struct Lane {
+    arc::gesture::Engine engine;
+    bool pressed = false;       ///< A tracked press is unresolved.
+    bool dragged = false;       ///< The current press became a drag.
+    std::uint32_t drag_at = 0;  ///< Event time of the drag decision.
+
+    void feed(const Event &ev) {
+        std::uint32_t at;
+        if (engine.deadline(at) && static_cast<std::int32_t>(ev.time_ms - at) >= 0) {
+            engine.on_timer(at);
+            pressed = false;
+        }
+        bool was = engine.tracking();
+        auto d = engine.on_event(ev);
+        if (!was && engine.tracking()) {
+            pressed = true;
+            dragged = false;
+        } else if (was && !engine.tracking()) {
+            pressed = false;
+            if (d.path_count) {
+                dragged = true;
+                drag_at = ev.time_ms;
+            }
+        }
+    }
+};
+
+}  // namespace
+
+/** @brief Entry point: prints gain and misclassification per horizon. */
+int main(int argc, char **argv) {
+    std::string trace;
+    std::int32_t radius = 16;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--radius") && i + 1 < argc)
+            radius = static_cast<std::int32_t>(std::atoi(argv[++i]));
+        else
+            trace = argv[i];
+    }
+    std::vector<Item> stream;
+    if (trace.empty())
+        stream = synthesize(radius, 20000);
+    else if (!load_trace(trace, stream))
+        return 2;
+
+    const std::uint32_t horizons[] = {8, 16, 24, 32, 48, 64};
+    std::printf("[BENCH] drag prediction over %zu events (%s)\n", stream.size(),
+                trace.empty() ? "synthetic, 1 kHz" : trace.c_str());
+    std::printf("[BENCH] %8s %8s %10s %10s %12s %10s\n", "horizon", "drags", "early", "mean_gain", "misclassify",
+                "ns/event");
+    for (std::uint32_t h : horizons) {
+        Lane ref, pred;
+        std::uint64_t drags = 0, early = 0, presses = 0, false_drags = 0;
+        double gain_ms = 0;
+        bool counted = true;
+        for (const Item &it : stream) {
+            if (it.is_settings) {
+                Settings s = it.settings;
+                s.predict_ms = 0;
+                ref.engine.configure(s);
+                s.predict_ms = h;
+                pred.engine.configure(s);
+                continue;
+            }
+            ref.feed(it.ev);
+            pred.feed(it.ev);
+            if (ref.pressed || pred.pressed) {
+                counted = false;
+                continue;
+            }
+            if (counted)
+                continue;
+            // Both lanes resolved the press: score it once
+            counted = true;
+            ++presses;
+            if (ref.dragged) {
+                ++drags;
+                if (pred.dragged) {
+                    std::int32_t g = static_cast<std::int32_t>(ref.drag_at - pred.drag_at);
+                    gain_ms += g;
+                    early += g > 0;
+                }
+            } else if (pred.dragged) {
+                ++false_drags;
+            }
+        }
+        // Engine cost with this horizon, timed on its own pass
+        arc::gesture::Engine timed;
+        std::uint64_t sink = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (const Item &it : stream) {
+            if (it.is_settings) {
+                Settings s = it.settings;
+                s.predict_ms = h;
+                timed.configure(s);
+            } else {
+                sink += timed.on_event(it.ev).count;
+            }
+        }
+        double pred_ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+        if (sink == 0)
+            std::printf("[BENCH] (no injections)\n");
+        std::printf("[BENCH] %6u ms %8llu %9.1f%% %8.2f ms %11.2f%% %10.1f\n", h,
+                    static_cast<unsigned long long>(drags), drags ? 100.0 * early / drags : 0.0,
+                    drags ? gain_ms / drags : 0.0, presses ? 100.0 * false_drags / (presses - drags) : 0.0,
+                    pred_ns / static_cast<double>(stream.size()));
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file bench_spsc.cpp
+ * @brief Throughput and hand-off latency of arc::queue::SpscRing.
+ *
+ * Usage: bench_spsc [items]
+ *
+ * Throughput: producer pushes as fast as possible, consumer polls.
+ * Latency: producer pushes one timestamped item at a time with gaps (like
+ * the hook callback does), consumer polls and records push-to-pop time. This
+ * is the cost the hook pays to hand an injection to the injector thread,
+ * excluding the wake-up of a sleeping injector.
+ *
+ * Wait loops yield so the benchmark still completes on a single core, where
+ * latency is dominated by the scheduler.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "arc/spsc_ring.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/** Nanoseconds since an arbitrary epoch on the steady clock. */
+inline std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+/** Payload about the size of a queued injection batch. */
+struct Item {
+    std::int64_t stamp;
+    std::uint64_t pad[11];
+};
+
+arc::queue::SpscRing<Item, 64> g_ring;
+
+/** Returns the value at quantile @p q of a sorted sample. */
+std::int64_t quantile(const std::vector<std::int64_t> &sorted, double q) {
+    if (sorted.empty())
+        return 0;
+    std::size_t i = static_cast<std::size_t>(q * static_cast<double>(sorted.size() - 1));
+    return sorted[i];
+}
+
+}  // namespace
+
+/** @brief Entry point: runs the throughput and latency phases. */
+int main(int argc, char **argv) {
+    std::size_t n = 10000000;
+    if (argc > 1)
+        n = static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10));
+
+    // Throughput
+    {
+        auto t0 = Clock::now();
+        std::thread producer([n]() {
+            Item it{};
+            for (std::size_t i = 0; i < n; ++i) {
+                it.stamp = static_cast<std::int64_t>(i);
+                while (!g_ring.try_push(it))
+                    std::this_thread::yield();
+            }
+        });
+        Item it{};
+        std::size_t got = 0;
+        while (got < n) {
+            if (g_ring.try_pop(it))
+                ++got;
+            else
+                std::this_thread::yield();
+        }
+        producer.join();
+        double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+        std::printf("[BENCH] spsc throughput: %zu items, %.2f ns/item, %.1f Mitems/s\n", n,
+                    ns / static_cast<double>(n), static_cast<double>(n) * 1e3 / ns);
+    }
+
+    // Latency (paced producer, polling consumer)
+    {
+        std::size_t samples = std::min<std::size_t>(n / 10, 1000000);
+        std::vector<std::int64_t> lat;
+        lat.reserve(samples);
+        std::thread producer([samples]() {
+            Item it{};
+            for (std::size_t i = 0; i < samples; ++i) {
+                std::int64_t next = now_ns() + 2000;  // ~2 us between events
+                while (now_ns() < next)
+                    std::this_thread::yield();
+                it.stamp = now_ns();
+                while (!g_ring.try_push(it))
+                    std::this_thread::yield();
+            }
+        });
+        Item it{};
+        while (lat.size() < samples) {
+            if (g_ring.try_pop(it))
+                lat.push_back(now_ns() - it.stamp);
+            else
+                std::this_thread::yield();
+        }
+        producer.join();
+        std::sort(lat.begin(), lat.end());
+        std::printf("[BENCH] spsc hand-off latency (ns): p50=%lld p99=%lld p999=%lld max=%lld (%zu samples)\n",
+                    static_cast<long long>(quantile(lat, 0.50)), static_cast<long long>(quantile(lat, 0.99)),
+                    static_cast<long long>(quantile(lat, 0.999)), static_cast<long long>(lat.back()), lat.size());
+    }
+    return 0;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file bench_stroke.cpp
+ * @brief Stroke recognition cost: resampling, and matching against 8-64 templates.
+ *
+ * Usage: bench_stroke [strokes]
+ *
+ * Draws synthetic strokes of one to four segments (about 40-400 recorded
+ * positions each, as the engine buffers them) and times
+ * arc::stroke::normalize, then arc::stroke::Library::best against libraries
+ * of 8, 16, 32 and 64 templates. For comparison, the same scoring written
+ * as a plain array-of-structures loop with one accumulator (the form the
+ * compiler cannot vectorize without reassociating floats) runs on the same
+ * strokes; both must pick the same templates.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "arc/stroke.h"
+
+using arc::stroke::kSamples;
+using arc::stroke::Shape;
+using arc::stroke::Vector;
+
+namespace {
+
+/** Small deterministic PRNG so runs are comparable. */
+struct XorShift {
+    std::uint64_t s = 0x9E3779B97F4A7C15ull;
+    std::uint32_t next() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return static_cast<std::uint32_t>(s >> 32);
+    }
+    double unit() { return static_cast<double>(next()) / 4294967296.0; }
+};
+
+double elapsed_ns(std::chrono::steady_clock::time_point t0) {
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+}
+
+/// @brief Recorded positions of one stroke.
+struct Raw {
+    std::vector<std::int32_t> x, y;
+};
+
+/** A wobbly rendition of @p shape sampled every 1-3 px. */
+Raw draw(Shape shape, XorShift &rng) {
+    static const double kAngle[] = {3.14159265, 0.0, -1.5707963, 1.5707963};
+    Raw r;
+    double x = 800, y = 500;
+    r.x.push_back(800);
+    r.y.push_back(500);
+    for (int s = 0; s < shape.count; ++s) {
+        double a = kAngle[static_cast<int>(shape.at(s))] + (rng.unit() - 0.5) * 0.3;
+        double len = 80 + rng.unit() * 120;
+        for (double done = 0; done < len; done += 2) {
+            x += 2 * std::cos(a);
+            y += 2 * std::sin(a);
+            r.x.push_back(static_cast<std::int32_t>(x + rng.unit() * 2));
+            r.y.push_back(static_cast<std::int32_t>(y + rng.unit() * 2));
+        }
+    }
+    return r;
+}
+
+/// @brief Array-of-structures template store with a single-accumulator scoring loop.
+struct AosLibrary {
+    struct Pt {
+        float x, y;
+    };
+    std::vector<Pt> pts;  // kSamples per template
+
+    void add(const Vector &v) {
+        for (int i = 0; i < kSamples; ++i)
+            pts.push_back(Pt{v.x[i], v.y[i]});
+    }
+
+    arc::stroke::Match best(const Vector &v) const {
+        static const float kCos = std::cos(arc::stroke::kMaxRotation);
+        static const float kSin = std::sin(arc::stroke::kMaxRotation);
+        static const float kTan = std::tan(arc::stroke::kMaxRotation);
+        arc::stroke::Match m;
+        int n = static_cast<int>(pts.size() / kSamples);
+        for (int t = 0; t < n; ++t) {
+            const Pt *p = &pts[static_cast<std::size_t>(t) * kSamples];
+            float dot = 0.f, cross = 0.f;
+            for (int i = 0; i < kSamples; ++i) {
+                dot += p[i].x * v.x[i] + p[i].y * v.y[i];
+                cross += p[i].x * v.y[i] - p[i].y * v.x[i];
+            }
+            float across = std::fabs(cross);
+            float score = dot > 0.f && across <= dot * kTan ? std::sqrt(dot * dot + cross * cross)
+                                                            : dot * kCos + across * kSin;
+            if (score > m.score) {
+                m.score = score;
+                m.index = t;
+            }
+        }
+        return m;
+    }
+};
+
+/** Up to @p n distinct shapes, shortest first. */
+std::vector<Shape> shapes(int n) {
+    std::vector<Shape> out;
+    static const char kLetters[] = "LRUD";
+    for (int len = 1, combos = 4; len <= arc::stroke::kMaxSegments && static_cast<int>(out.size()) < n;
+         ++len, combos *= 4) {
+        for (int c = 0; c < combos && static_cast<int>(out.size()) < n; ++c) {
+            char text[arc::stroke::kMaxSegments + 1] = {};
+            for (int i = 0, v = c; i < len; ++i, v /= 4)
+                text[i] = kLetters[v % 4];
+            Shape s;
+            if (arc::stroke::parse_shape(text, s))
+                out.push_back(s);
+        }
+    }
+    return out;
+}
+
+}  // namespace
+
+/** @brief Entry point: ns per resample and per match, SoA vs. AoS. */
+int main(int argc, char **argv) {
+    std::size_t n = 20000;
+    if (argc > 1)
+        n = static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10));
+    if (n == 0)
+        n = 1;
+    XorShift rng;
+    std::vector<Shape> all = shapes(arc::stroke::kMaxTemplates);
+    std::vector<Raw> strokes;
+    std::size_t points = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        strokes.push_back(draw(all[rng.next() % all.size()], rng));
+        points += strokes.back().x.size();
+    }
+
+    std::vector<Vector> vectors(n);
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; ++i)
+        arc::stroke::normalize(strokes[i].x.data(), strokes[i].y.data(), static_cast<int>(strokes[i].x.size()),
+                               vectors[i]);
+    double resample_ns = elapsed_ns(t0) / static_cast<double>(n);
+    std::printf("[BENCH] %zu strokes, %.0f positions each on average\n", n,
+                static_cast<double>(points) / static_cast<double>(n));
+    std::printf("[BENCH] normalize: %.0f ns/stroke\n", resample_ns);
+    std::printf("[BENCH] %-10s %12s %12s %10s\n", "templates", "soa_ns", "aos_ns", "speedup");
+
+    int mismatches = 0;
+    double sink = 0;
+    static const int kSizes[] = {8, 16, 32, 64};
+    for (int size : kSizes) {
+        arc::stroke::Library lib;
+        AosLibrary aos;
+        for (int i = 0; i < size && i < static_cast<int>(all.size()); ++i) {
+            Vector v;
+            arc::stroke::shape_vector(all[static_cast<std::size_t>(i)], v);
+            lib.add(v);
+            aos.add(v);
+        }
+        std::vector<int> soa_pick(n), aos_pick(n);
+        t0 = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            arc::stroke::Match m = lib.best(vectors[i]);
+            soa_pick[i] = m.index;
+            sink += m.score;
+        }
+        double soa_ns = elapsed_ns(t0) / static_cast<double>(n);
+        t0 = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            arc::stroke::Match m = aos.best(vectors[i]);
+            aos_pick[i] = m.index;
+            sink += m.score;
+        }
+        double aos_ns = elapsed_ns(t0) / static_cast<double>(n);
+        for (std::size_t i = 0; i < n; ++i)
+            mismatches += soa_pick[i] != aos_pick[i];
+        std::printf("[BENCH] %-10d %12.0f %12.0f %9.2fx\n", lib.size(), soa_ns, aos_ns, aos_ns / soa_ns);
+    }
+    // Rounding differs between the two summation orders; near-ties may flip
+    if (mismatches)
+        std::printf("[BENCH] %d picks differ between SoA and AoS (near-ties)\n", mismatches);
+    if (sink == 0)
+        std::printf("[BENCH] (no scores)\n");
+    return 0;
+}
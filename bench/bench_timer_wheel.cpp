@@ -0,0 +1,152 @@
+/**
+ * @file bench_timer_wheel.cpp
+ * @brief Insert/cancel and insert/fire throughput of arc::timer::Wheel.
+ *
+ * Usage: bench_timer_wheel [ops]
+ *
+ * For several numbers of already pending timers (deadlines spread over the
+ * next ten seconds), times:
+ * - schedule + cancel: a timer scheduled 1-1000 ms ahead and cancelled
+ *   again, the hook's pattern when a press or a held-back click moves the
+ *   engine's deadline;
+ * - schedule + fire: the clock advances 1 ms per step and every step
+ *   schedules a timer up to 2 * pending + 1 ms ahead, so about @c pending
+ *   timers stay outstanding while they cascade down the levels and fire.
+ * A std::multimap keyed by deadline (the usual ordered-container timer
+ * queue) runs the same operations for comparison.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <utility>
+
+#include "arc/timer_wheel.h"
+
+namespace {
+
+/** Small deterministic PRNG so runs are comparable. */
+struct XorShift {
+    std::uint64_t s = 0x9E3779B97F4A7C15ull;
+    std::uint32_t next() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return static_cast<std::uint32_t>(s >> 32);
+    }
+};
+
+double elapsed_ns(std::chrono::steady_clock::time_point t0) {
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+}
+
+std::uint64_t g_fired = 0;
+
+void on_fire(void *, std::uint64_t) { ++g_fired; }
+
+/// @brief Ordered-container timer queue with the wheel's operations.
+struct MapTimers {
+    using Map = std::multimap<std::uint64_t, std::pair<arc::timer::Callback, void *>>;
+    Map map;
+    std::uint64_t now = 0;
+
+    Map::iterator schedule(std::uint64_t at, arc::timer::Callback cb, void *ctx) {
+        return map.emplace(at, std::make_pair(cb, ctx));
+    }
+    void cancel(Map::iterator it) { map.erase(it); }
+    void advance(std::uint64_t to) {
+        now = to;
+        while (!map.empty() && map.begin()->first <= to) {
+            auto entry = map.begin()->second;
+            map.erase(map.begin());
+            entry.first(entry.second, to);
+        }
+    }
+};
+
+/** ns per schedule+cancel pair with @p pending other timers in place. */
+template <typename Queue>
+double time_cancel(Queue &q, std::size_t ops, XorShift &rng) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < ops; ++i)
+        q.cancel(q.schedule(q.now + 1 + rng.next() % 1000, on_fire, nullptr));
+    return elapsed_ns(t0) / static_cast<double>(ops);
+}
+
+/** ns per scheduled-and-fired timer; one schedule per 1 ms step, @p span ms ahead at most. */
+template <typename Queue>
+double time_fire(Queue &q, std::size_t ops, std::uint32_t span, XorShift &rng) {
+    std::uint64_t before = g_fired;
+    std::uint64_t t = q.now;
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < ops; ++i) {
+        q.schedule(t + 1 + rng.next() % span, on_fire, nullptr);
+        q.advance(++t);
+    }
+    double ns = elapsed_ns(t0);
+    std::uint64_t fired = g_fired - before;
+    return ns / static_cast<double>(fired ? fired : 1);
+}
+
+/// @brief The wheel behind the same interface as MapTimers.
+struct WheelTimers {
+    arc::timer::Wheel wheel;
+    std::uint64_t now = 0;
+
+    explicit WheelTimers(std::size_t capacity) : wheel(capacity, 0) {}
+
+    arc::timer::TimerId schedule(std::uint64_t at, arc::timer::Callback cb, void *ctx) {
+        return wheel.schedule(at, cb, ctx);
+    }
+    void cancel(arc::timer::TimerId id) { wheel.cancel(id); }
+    void advance(std::uint64_t to) {
+        now = to;
+        wheel.advance(to);
+    }
+};
+
+/** Fills @p q with @p n timers due within the next ten seconds. */
+template <typename Queue>
+void populate(Queue &q, std::size_t n, XorShift &rng) {
+    for (std::size_t i = 0; i < n; ++i)
+        q.schedule(q.now + 1 + rng.next() % 10000, on_fire, nullptr);
+}
+
+}  // namespace
+
+/** @brief Entry point: ns/op of the wheel and the multimap per pending population. */
+int main(int argc, char **argv) {
+    std::size_t ops = 2000000;
+    if (argc > 1)
+        ops = static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10));
+    if (ops == 0)
+        ops = 1;
+    static const std::size_t kPending[] = {0, 64, 1024, 16384};
+
+    std::printf("[BENCH] %zu ops per cell\n", ops);
+    std::printf("[BENCH] %-8s %16s %16s %16s %16s\n", "pending", "wheel_cancel_ns", "map_cancel_ns", "wheel_fire_ns",
+                "map_fire_ns");
+    for (std::size_t pending : kPending) {
+        XorShift rng;
+        WheelTimers w(pending + 1);
+        MapTimers m;
+        populate(w, pending, rng);
+        populate(m, pending, rng);
+        double wc = time_cancel(w, ops, rng);
+        double mc = time_cancel(m, ops, rng);
+        // Deadlines spread over 2 * pending ms keep about pending timers outstanding
+        std::uint32_t span = static_cast<std::uint32_t>(2 * pending + 1);
+        WheelTimers wf(span + 1);
+        MapTimers mf;
+        XorShift wrng, mrng;
+        double wfire = time_fire(wf, ops, span, wrng);
+        double mfire = time_fire(mf, ops, span, mrng);
+        std::printf("[BENCH] %-8zu %16.2f %16.2f %16.2f %16.2f\n", pending, wc, mc, wfire, mfire);
+    }
+    if (g_fired == 0)
+        std::printf("[BENCH] (nothing fired)\n");
+    return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file arming.h
+ * @brief Decides when the mouse hook must be installed in armed hook mode.
+ *
+ * In armed mode the WH_MOUSE_LL hook is not installed for the whole session.
+ * A keyboard hook watches the configured modifier combo, and the mouse hook
+ * is installed only while the combo is held, for a grace period after it is
+ * released, and for as long as the gesture engine has a gesture in flight
+ * (so the release of a swallowed press is never missed). Every other
+ * application's mouse input skips our callback the rest of the time.
+ *
+ * The controller is pure state: callers feed it modifier and tracking
+ * changes with millisecond timestamps and ask whether the hook is wanted.
+ * Installing, removing and timers are the caller's job (see hook.cpp).
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace arc { namespace arming {
+
+/**
+ * @brief Armed-mode state machine.
+ *
+ * Not thread-safe; owned by the hook worker thread. Timestamps wrap like
+ * GetTickCount.
+ */
+class Controller {
+ public:
+    /**
+     * @brief Sets the combo that arms the hook and the grace period.
+     *
+     * @param required_mods arc::gesture::Modifier bits that must all be held;
+     *                      0 means no modifier, so the hook is always wanted.
+     * @param grace_ms      Time the hook stays wanted after the combo is
+     *                      released or a tracked click ends.
+     */
+    void configure(std::uint32_t required_mods, std::uint32_t grace_ms);
+
+    /**
+     * @brief Sets the held-modifier masks that arm the hook (several bindings).
+     *
+     * @param sets     Bit @c m set if holding exactly the modifier mask @c m
+     *                 completes some binding (see
+     *                 arc::gesture::BindingTable::modifier_sets); bit 0 means
+     *                 a binding needs no modifier, so the hook is always wanted.
+     * @param grace_ms As for @ref configure.
+     */
+    void configure_sets(std::uint16_t sets, std::uint32_t grace_ms);
+
+    /** Updates the held modifiers (arc::gesture::Modifier bits). */
+    void on_modifiers(std::uint32_t held, std::uint32_t now_ms);
+
+    /**
+     * @brief Updates whether the gesture engine has a gesture in flight.
+     *
+     * True while it is not arc::gesture::Engine::settled(): a tracked press,
+     * a stroke, a held-back click, or a release still to be swallowed.
+     */
+    void on_tracking(bool tracking, std::uint32_t now_ms);
+
+    /** Returns true if the mouse hook should be installed at @p now_ms. */
+    bool wanted(std::uint32_t now_ms) const;
+
+    /**
+     * @brief Time until @ref wanted turns false without further input.
+     *
+     * @return Remaining grace in milliseconds, or 0 if no grace period is
+     *         running (the hook is either held armed or not wanted).
+     */
+    std::uint32_t grace_left(std::uint32_t now_ms) const;
+
+    /** Returns true while the combo is held. */
+    bool combo_held() const { return combo_; }
+
+    /** Forgets held modifiers, tracking and any running grace period. */
+    void reset();
+
+ private:
+    bool pinned() const { return (sets_ & 1u) != 0 || combo_ || tracking_; }
+
+    std::uint16_t sets_ = 0xAAAA;  ///< Held masks that arm (default: any with ALT).
+    std::uint32_t grace_ms_ = 300; ///< Grace period after release.
+    bool combo_ = false;           ///< Combo currently held.
+    bool tracking_ = false;        ///< Engine has a gesture in flight.
+    bool lingering_ = false;       ///< Grace period running since @ref since_.
+    std::uint32_t since_ = 0;      ///< Start of the grace period.
+};
+
+}  // namespace arming
+
+}  // namespace arc
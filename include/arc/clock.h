@@ -0,0 +1,81 @@
+/**
+ * @file clock.h
+ * @brief Injectable monotonic clock.
+ *
+ * Gesture timing comes from the events themselves (MSLLHOOKSTRUCT::time);
+ * a clock is only needed for what happens between events, such as driving
+ * the timer wheel. Code that needs one takes an @ref arc::clock::Clock, a
+ * function pointer plus context, so the hook uses the platform's monotonic
+ * clock (QueryPerformanceCounter on Windows, CLOCK_MONOTONIC elsewhere)
+ * while tests and replays plug in a @ref arc::clock::VirtualClock and run
+ * at full CPU speed.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace arc { namespace clock {
+
+/// Reads a clock in microseconds; @p ctx is the clock's own state.
+using NowFn = std::uint64_t (*)(const void *ctx);
+
+/// @brief Handle to a monotonic microsecond clock.
+struct Clock {
+    NowFn now_fn = nullptr;     ///< Reader.
+    const void *ctx = nullptr;  ///< Passed to @ref now_fn.
+
+    /** Current time in microseconds. */
+    std::uint64_t now_us() const { return now_fn(ctx); }
+
+    /** Current time in milliseconds. */
+    std::uint64_t now_ms() const { return now_us() / 1000; }
+};
+
+/**
+ * @brief Reads the platform monotonic clock in microseconds.
+ *
+ * QueryPerformanceCounter on Windows, CLOCK_MONOTONIC elsewhere. The origin
+ * is unspecified (boot time on both platforms); only differences matter.
+ */
+std::uint64_t monotonic_us();
+
+/** Returns a @ref Clock reading @ref monotonic_us. */
+Clock monotonic();
+
+/**
+ * @brief Manually advanced clock for tests and trace replay.
+ *
+ * Time only moves when told to. The @ref Clock returned by @ref clock
+ * refers to this object and must not outlive it.
+ */
+class VirtualClock {
+ public:
+    explicit VirtualClock(std::uint64_t start_us = 0) : now_us_(start_us) {}
+
+    /** Returns a handle reading this clock. */
+    Clock clock() const { return Clock{&VirtualClock::read, this}; }
+
+    /** Current time in microseconds. */
+    std::uint64_t now_us() const { return now_us_; }
+
+    /** Moves the clock to @p t_us; earlier values are ignored (monotonic). */
+    void set_us(std::uint64_t t_us) {
+        if (t_us > now_us_)
+            now_us_ = t_us;
+    }
+
+    /** Moves the clock forward by @p us microseconds. */
+    void advance_us(std::uint64_t us) { now_us_ += us; }
+
+    /** Moves the clock forward by @p ms milliseconds. */
+    void advance_ms(std::uint64_t ms) { now_us_ += ms * 1000; }
+
+ private:
+    static std::uint64_t read(const void *ctx) { return static_cast<const VirtualClock *>(ctx)->now_us_; }
+
+    std::uint64_t now_us_;
+};
+
+}  // namespace clock
+
+}  // namespace arc
@@ -41,6 +41,26 @@ struct Config {
     unsigned int click_time_ms = 250;
     /// Max pointer movement radius (px) to consider a click.
     int move_radius_px = 6;
+    /// Drag prediction horizon (ms): start a drag as soon as the pointer's
+    /// velocity projects it clearly out of the radius within this time.
+    /// 0 disables prediction (drag only once the radius is crossed).
+    unsigned int drag_predict_ms = 0;
+    /// Speculative click: press the right button as soon as a qualifying
+    /// trigger press arrives and release it on a quick release; drags and
+    /// long presses cancel it with a right-button release first. Not used
+    /// while a double-click, long-press or chord recognizer is on.
+    bool speculative_click = false;
+    /// Auto-tune: record bound press durations and travel, and periodically
+    /// move @ref click_time_ms and @ref move_radius_px towards the gap
+    /// between clicks and drags/holds (see arc/tuning.h). The tuned values
+    /// apply for the session; saving the settings keeps them.
+    bool auto_tune = false;
+
+    /// Armed hook mode: install the mouse hook only while the modifier combo
+    /// is held (plus @ref arm_grace_ms), instead of for the whole session.
+    bool armed_hook = false;
+    /// Time (ms) the mouse hook stays installed after the combo is released.
+    unsigned int arm_grace_ms = 300;
 
     /// Logging level name: error|warn|info|debug.
     std::string log_level = "info";
@@ -48,6 +68,12 @@ struct Config {
     std::string log_file;
     /// Include thread id in log lines (for debugging concurrent threads).
     bool log_thread_id = false;
+    /// Longest the async logger holds lines before writing them (ms; 0: no delay).
+    unsigned int log_flush_ms = 0;
+    /// Async logger writes once this many bytes are held (0: no size limit).
+    unsigned int log_flush_bytes = 0;
+    /// Sub-second digits in log timestamps: 0, 3 (ms) or 6 (us).
+    unsigned int log_time_digits = 0;
 
     /// Source button that triggers translation.
     enum class Trigger {
@@ -58,6 +84,75 @@ struct Config {
     };
     Trigger trigger = Trigger::Left;
 
+    /// Additional binding: a source button pressed with modifier keys,
+    /// translated into another click. INI form: `bind=ALT+MIDDLE -> DOUBLE`.
+    struct Binding {
+        /// Click injected for a quick press.
+        enum class Action {
+            Right,
+            Left,
+            Middle,
+            X1,
+            X2,
+            DoubleLeft
+        };
+        Trigger source = Trigger::Left;          ///< Pressed button.
+        std::vector<unsigned int> modifier_vks;  ///< Modifier keys that must all be held.
+        Action action = Action::Right;           ///< Translation.
+    };
+    /// Binding rules, in priority order. The `modifier`/`trigger` pair is an
+    /// implicit last rule mapped to a right click. When several rules match
+    /// a press, the one with the most modifiers wins, then the earliest.
+    std::vector<Binding> bindings;
+
+    /// Double click: a second bound click within this many ms injects
+    /// @ref double_click_action; single clicks are delayed by the window.
+    /// 0 disables recognition.
+    unsigned int double_click_ms = 0;
+    /// Click injected for a bound double click.
+    Binding::Action double_click_action = Binding::Action::Middle;
+    /// Long press: a bound press held still this long (ms, must exceed
+    /// @ref click_time_ms) injects @ref long_press_action. 0 disables it.
+    unsigned int long_press_ms = 0;
+    /// Click injected for a long press.
+    Binding::Action long_press_action = Binding::Action::Middle;
+    /// Chord: pressing @ref chord_button within this many ms of a bound
+    /// press injects @ref chord_action. 0 disables chords.
+    unsigned int chord_ms = 0;
+    /// Partner button of a chord (a plain button; DoubleLeft is not valid).
+    Binding::Action chord_button = Binding::Action::Right;
+    /// Click injected for a chord.
+    Binding::Action chord_action = Binding::Action::Middle;
+    /// Dwell: with the modifier combo held, the pointer resting inside
+    /// @ref move_radius_px this many ms injects @ref dwell_action without a
+    /// button press. 0 disables dwell clicks.
+    unsigned int dwell_ms = 0;
+    /// Click injected for a dwell.
+    Binding::Action dwell_action = Binding::Action::Right;
+
+    /// @brief Stroke rule: a shape drawn with a bound press held, and its click.
+    struct Stroke {
+        std::string shape;                             ///< Segment directions, e.g. "L" or "DR".
+        Binding::Action action = Binding::Action::X1;  ///< Click injected for a matching stroke.
+    };
+    /// Stroke rules (at most 64). When any is set, a bound press that
+    /// leaves the move radius draws a stroke instead of starting a drag.
+    std::vector<Stroke> strokes;
+    /// Minimum match score of a stroke, in percent (50-100).
+    unsigned int stroke_min_score = 80;
+
+    /// @brief Device rule: pointing devices whose name matches a pattern,
+    /// and the source buttons translated for them.
+    /// INI form: `device=*Touchpad* -> LEFT`.
+    struct DeviceRule {
+        std::string pattern;           ///< Case-insensitive glob over the device name or kind.
+        std::vector<Trigger> buttons;  ///< Source buttons translated; empty passes everything through.
+    };
+    /// Device rules (at most 16), first match wins. When any is set, only
+    /// devices matching a rule are translated, and only for its buttons;
+    /// every other device's input passes through untouched.
+    std::vector<DeviceRule> devices;
+
     /// Live reload toggle for config file changes.
     bool watch_config = false;
 
@@ -0,0 +1,160 @@
+/**
+ * @file device.h
+ * @brief Per-device input routing: which bound buttons each pointing device may use.
+ *
+ * A machine can have a mouse, a touchpad and a pen at once, and the
+ * translation is often wanted on one of them only. The platform input
+ * source (Raw Input on Windows, see hook.cpp; evdev on Linux, see
+ * arc/evdev.h) tags every event with a small device id, registering each
+ * device the first time it produces input. @ref arc::device::Table maps the
+ * id to the set of bound source buttons that device may use, evaluated
+ * once from the configured name patterns when the device appears or the
+ * rules change, so routing an event is one bounds check and one load.
+ *
+ * A press of a button its device may not use bypasses the gesture engine
+ * entirely, as does any press from a device no rule matches, including
+ * events that cannot be attributed to a device. Without rules, routing is
+ * off and every event reaches the engine as before.
+ *
+ * Portable (no platform headers) so routing can be tested on any host with
+ * fake device descriptors.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "arc/gesture.h"
+
+namespace arc { namespace device {
+
+constexpr int kMaxRules = 16;     ///< Device rules kept; later ones are ignored.
+constexpr int kMaxPattern = 128;  ///< Pattern capacity, including the terminating NUL.
+
+/// Device id tagged on events; ids index the routing table densely.
+using Id = std::uint32_t;
+constexpr Id kUnknown = 0;  ///< Events that cannot be attributed to a device.
+
+/// @brief What kind of pointing device produced the input.
+enum class Kind : std::uint8_t { Unknown, Mouse, Touchpad, Pen, Touch, Keyboard };
+
+/** Lower-case name of @p k ("mouse", "touchpad", ...), as rule patterns can match it. */
+const char *kind_name(Kind k);
+
+/// @brief A pointing device as reported by the platform.
+struct Descriptor {
+    std::uint64_t key = 0;      ///< Platform handle (HANDLE value, evdev event number, ...).
+    std::string name;           ///< Platform name (device interface path, evdev name).
+    Kind kind = Kind::Unknown;  ///< Device kind, where the platform reports it.
+    std::uint16_t vendor = 0;   ///< USB/Bluetooth vendor id, if known.
+    std::uint16_t product = 0;  ///< Product id, if known.
+};
+
+/**
+ * @brief One routing rule: devices matching @ref pattern may use @ref buttons.
+ *
+ * Fixed-size so a rule set can live in the hook snapshot.
+ */
+struct Rule {
+    char pattern[kMaxPattern] = {};  ///< Glob over the device name or kind name (see @ref match).
+    std::uint8_t buttons = 0;        ///< Bit (1 << arc::gesture::Button) per bound button the device may use.
+};
+
+/** Bit of @p b in Rule::buttons. */
+constexpr std::uint8_t button_bit(arc::gesture::Button b) {
+    return static_cast<std::uint8_t>(1u << static_cast<unsigned>(b));
+}
+
+/// Rule::buttons value allowing every source button.
+constexpr std::uint8_t kAllButtons = button_bit(arc::gesture::Button::Left) |
+                                     button_bit(arc::gesture::Button::Middle) |
+                                     button_bit(arc::gesture::Button::X1) | button_bit(arc::gesture::Button::X2);
+
+/** Copies @p pattern into @p rule (truncated to kMaxPattern - 1 characters). */
+void set_pattern(Rule &rule, const char *pattern);
+
+/**
+ * @brief Case-insensitive glob match of @p text against @p pattern.
+ *
+ * @c * matches any run of characters (including none) and @c ? any single
+ * character; everything else matches itself, ignoring ASCII case.
+ */
+bool match(const char *pattern, const char *text);
+
+/// @brief An engine event and the device that produced it.
+struct Tagged {
+    arc::gesture::Event event;  ///< The event.
+    Id device = kUnknown;       ///< Producing device.
+};
+
+/**
+ * @brief Flat routing table: device id to the buttons it may use.
+ *
+ * Devices are registered once (@ref add, which allocates) and keep their
+ * id; @ref configure re-evaluates every known device against a new rule set
+ * without allocating. Lookups are O(1). Not thread-safe: owned by the
+ * thread that feeds the engine.
+ */
+class Table {
+ public:
+    Table();
+
+    /**
+     * @brief Replaces the rules and re-evaluates every known device.
+     *
+     * The first rule whose pattern matches a device's name or kind name
+     * decides; devices no rule matches may use no button. An empty rule set
+     * turns routing off.
+     */
+    void configure(const Rule *rules, int count);
+
+    /** True when rules are configured, so events are routed. */
+    bool routing() const { return count_ > 0; }
+
+    /**
+     * @brief Registers a device, or returns its id if @p d.key is known.
+     *
+     * Ids start at 1 and are never reused. Allocates; call from the thread
+     * that owns the table, outside of the per-event path.
+     */
+    Id add(const Descriptor &d);
+
+    /** Id of the device with platform handle @p key, or kUnknown. Linear; for registration paths. */
+    Id find(std::uint64_t key) const;
+
+    /** The registered device @p id, or nullptr. */
+    const Descriptor *descriptor(Id id) const { return id && id < devices_.size() ? &devices_[id] : nullptr; }
+
+    /** Number of registered devices. */
+    std::size_t size() const { return devices_.size() - 1; }
+
+    /** Rule::buttons of device @p id (0 for unknown ids). */
+    std::uint8_t buttons(Id id) const { return id < masks_.size() ? masks_[id] : 0; }
+
+    /**
+     * @brief True if @p ev must bypass the engine and pass through untouched.
+     *
+     * Only presses are routed: a press of a button @p id may not use
+     * bypasses the engine while the engine is idle (nothing tracked or held
+     * back), and its release then finds the engine not tracking it. Moves
+     * and releases always reach the engine, which has its own idle fast
+     * path. A press arriving while a gesture is in progress takes part in
+     * it as before, so the engine's ordering guarantees hold.
+     */
+    bool bypass(Id id, const arc::gesture::Event &ev, bool engine_idle) const {
+        return ev.type == arc::gesture::EventType::Down && engine_idle && !(buttons(id) & button_bit(ev.button));
+    }
+
+ private:
+    std::uint8_t evaluate(const Descriptor &d) const;
+
+    Rule rules_[kMaxRules];               ///< Active rules, first match wins.
+    int count_ = 0;                       ///< Number of valid rules.
+    std::vector<Descriptor> devices_;     ///< Registered devices by id; [0] is kUnknown.
+    std::vector<std::uint8_t> masks_;     ///< Rule::buttons by id.
+};
+
+}  // namespace device
+
+}  // namespace arc
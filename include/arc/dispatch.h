@@ -0,0 +1,111 @@
+/**
+ * @file dispatch.h
+ * @brief Translation of raw low-level mouse messages, specialized per trigger.
+ *
+ * The mouse hook sees every pointer event on the desktop, and nearly all of
+ * them are WM_MOUSEMOVE. The generic @ref arc::dispatch::translate decodes
+ * every button message on every event; @ref arc::dispatch::translate_for is
+ * instantiated once per trigger button (Left, Middle, X1, X2) with the
+ * button's messages folded into constants, tests for a move first, and
+ * reports the other buttons' messages as EventType::Other. The engine never
+ * acts on an unbound button, so both give the same decisions when only that
+ * button is bound. @ref arc::dispatch::select picks the instance for a
+ * binding table; the hook snapshot carries it, so a config change swaps the
+ * instance atomically with the rest of the settings.
+ *
+ * Message values are the Win32 WM_* codes, spelled out so no platform header
+ * is needed.
+ */
+#pragma once
+
+#include "arc/gesture.h"
+
+namespace arc { namespace dispatch {
+
+/// @brief Raw WH_MOUSE_LL message codes (WM_* values).
+enum Message : unsigned int {
+    kMouseMove = 0x0200,    ///< WM_MOUSEMOVE
+    kLButtonDown = 0x0201,  ///< WM_LBUTTONDOWN
+    kLButtonUp = 0x0202,    ///< WM_LBUTTONUP
+    kRButtonDown = 0x0204,  ///< WM_RBUTTONDOWN
+    kRButtonUp = 0x0205,    ///< WM_RBUTTONUP
+    kMButtonDown = 0x0207,  ///< WM_MBUTTONDOWN
+    kMButtonUp = 0x0208,    ///< WM_MBUTTONUP
+    kMouseWheel = 0x020A,   ///< WM_MOUSEWHEEL
+    kXButtonDown = 0x020B,  ///< WM_XBUTTONDOWN
+    kXButtonUp = 0x020C     ///< WM_XBUTTONUP
+};
+
+constexpr unsigned int kXButton1 = 1;  ///< HIWORD(mouseData) of the first extended button (XBUTTON1).
+
+/// @brief Event type and button decoded from one message.
+struct Kind {
+    arc::gesture::EventType type = arc::gesture::EventType::Other;  ///< Event kind.
+    arc::gesture::Button button = arc::gesture::Button::None;       ///< Button for Down/Up.
+};
+
+/// Translation instance: message code and HIWORD(mouseData) to event kind.
+using TranslateFn = Kind (*)(unsigned int msg, unsigned int xbutton);
+
+/**
+ * @brief Generic translation: decodes every button message.
+ *
+ * @param msg     Message code (@ref Message).
+ * @param xbutton HIWORD(mouseData); only read for the X button messages.
+ */
+Kind translate(unsigned int msg, unsigned int xbutton);
+
+/**
+ * @brief Translation specialized for one trigger button.
+ *
+ * Moves and the messages of @p Source decode as in @ref translate;
+ * everything else is EventType::Other.
+ */
+template <arc::gesture::Button Source>
+Kind translate_for(unsigned int msg, unsigned int xbutton) {
+    using arc::gesture::Button;
+    using arc::gesture::EventType;
+    static_assert(Source == Button::Left || Source == Button::Middle || Source == Button::X1 ||
+                      Source == Button::X2,
+                  "translate_for is instantiated for the trigger buttons only");
+    constexpr unsigned int down = Source == Button::Left     ? kLButtonDown
+                                  : Source == Button::Middle ? kMButtonDown
+                                                             : kXButtonDown;
+    constexpr bool extended = Source == Button::X1 || Source == Button::X2;
+    constexpr unsigned int which = Source == Button::X1 ? kXButton1 : kXButton1 + 1;
+    Kind k;
+    if (msg == kMouseMove) {
+        k.type = EventType::Move;
+        return k;
+    }
+    if ((msg != down && msg != down + 1) || (extended && xbutton != which))
+        return k;
+    k.type = msg == down ? EventType::Down : EventType::Up;
+    k.button = Source;
+    return k;
+}
+
+/**
+ * @brief Picks the translation instance for engine settings.
+ *
+ * @return The @ref translate_for instance if exactly one of Left, Middle,
+ *         X1 and X2 is bound (and Right is not) in the effective bindings,
+ *         else @ref translate. Chords and double clicks watch the other
+ *         buttons too, so with either on the result is @ref translate.
+ */
+TranslateFn select(const arc::gesture::Settings &settings);
+
+/**
+ * @brief Translation to use for the next event while switching to @p wanted.
+ *
+ * A release the engine still owns (a tracked or stroking press, or one whose
+ * release is swallowed) must decode under the old and the new bindings, so
+ * until @p engine is settled the answer is @ref translate.
+ */
+inline TranslateFn translation_for(TranslateFn wanted, const arc::gesture::Engine &engine) {
+    return engine.settled() ? wanted : &translate;
+}
+
+}  // namespace dispatch
+
+}  // namespace arc
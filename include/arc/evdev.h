@@ -0,0 +1,173 @@
+/**
+ * @file evdev.h
+ * @brief Linux evdev input source: device discovery and per-device event decoding.
+ *
+ * The Linux counterpart of the Raw Input tagging in hook.cpp. Devices are
+ * discovered from the text of /proc/bus/input/devices (@ref
+ * arc::evdev::parse_devices), classified from their capability bitmaps and
+ * registered in an arc::device::Table. Each device's input_event stream is
+ * decoded by its own @ref arc::evdev::Decoder into engine events tagged with
+ * the device id; all decoders of a @ref arc::evdev::Seat share one pointer
+ * position and one modifier state, as the devices share one cursor.
+ *
+ * Parsing and decoding are portable (the event codes are spelled out, as in
+ * linux/input-event-codes.h), so they run in tests on any host with fake
+ * descriptors and streams. Only @ref arc::evdev::Source, which reads the
+ * /dev/input/event* nodes, needs Linux.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "arc/device.h"
+#include "arc/modifiers.h"
+
+namespace arc { namespace evdev {
+
+/// @brief Event types (EV_*).
+enum Type : std::uint16_t {
+    kEvSyn = 0x00,  ///< EV_SYN
+    kEvKey = 0x01,  ///< EV_KEY
+    kEvRel = 0x02,  ///< EV_REL
+    kEvAbs = 0x03   ///< EV_ABS
+};
+
+/// @brief Event codes used here (SYN_*, REL_*, ABS_*, KEY_*, BTN_*).
+enum Code : std::uint16_t {
+    kSynReport = 0x00,       ///< SYN_REPORT
+    kRelX = 0x00,            ///< REL_X (also ABS_X)
+    kRelY = 0x01,            ///< REL_Y (also ABS_Y)
+    kKeyLeftCtrl = 29,       ///< KEY_LEFTCTRL
+    kKeyLeftShift = 42,      ///< KEY_LEFTSHIFT
+    kKeyRightShift = 54,     ///< KEY_RIGHTSHIFT
+    kKeyLeftAlt = 56,        ///< KEY_LEFTALT
+    kKeyRightCtrl = 97,      ///< KEY_RIGHTCTRL
+    kKeyRightAlt = 100,      ///< KEY_RIGHTALT
+    kKeyLeftMeta = 125,      ///< KEY_LEFTMETA
+    kKeyRightMeta = 126,     ///< KEY_RIGHTMETA
+    kBtnLeft = 0x110,        ///< BTN_LEFT
+    kBtnRight = 0x111,       ///< BTN_RIGHT
+    kBtnMiddle = 0x112,      ///< BTN_MIDDLE
+    kBtnSide = 0x113,        ///< BTN_SIDE (first extended button)
+    kBtnExtra = 0x114,       ///< BTN_EXTRA (second extended button)
+    kBtnToolPen = 0x140,     ///< BTN_TOOL_PEN
+    kBtnToolFinger = 0x145,  ///< BTN_TOOL_FINGER
+    kBtnTouch = 0x14a        ///< BTN_TOUCH
+};
+
+/// @brief One decoded input_event.
+struct Input {
+    std::uint32_t time_ms = 0;  ///< Event time in milliseconds (wraps).
+    std::uint16_t type = 0;     ///< @ref Type.
+    std::uint16_t code = 0;     ///< @ref Code.
+    std::int32_t value = 0;     ///< Delta, position or key state (0 up, 1 down, 2 repeat).
+};
+
+/**
+ * @brief Pointing devices and keyboards listed in /proc/bus/input/devices.
+ *
+ * Each returned descriptor has the event node number as key (from the
+ * `eventN` handler), the quoted name, vendor and product, and a kind from
+ * the capability bitmaps: a pen tool makes a Pen, a finger tool with
+ * absolute axes a Touchpad, touch with absolute axes a Touch screen,
+ * relative axes with a left button a Mouse, and modifier keys a Keyboard.
+ * Other devices (power buttons, lid switches, ...) are left out.
+ *
+ * @param text File contents; bitmap words are taken as 64 bits wide.
+ */
+std::vector<arc::device::Descriptor> parse_devices(const std::string &text);
+
+/// @brief State shared by every device of a seat: the cursor and the held modifiers.
+struct Seat {
+    std::int32_t x = 0;                   ///< Pointer x.
+    std::int32_t y = 0;                   ///< Pointer y.
+    arc::modifiers::Tracker modifiers;    ///< Fed by every keyboard of the seat.
+};
+
+/**
+ * @brief Turns one device's input_event stream into tagged engine events.
+ *
+ * Buttons produce Down/Up events at once; relative motion (and the change
+ * of absolute positions while in contact, for touchpads, pens and touch
+ * screens) accumulates until SYN_REPORT and then moves the seat's pointer,
+ * producing one Move. On pens and touch screens, contact (BTN_TOUCH) is the
+ * left button. Modifier keys update the seat's tracker and produce no event.
+ */
+class Decoder {
+ public:
+    Decoder(arc::device::Id id, arc::device::Kind kind, Seat *seat) : id_(id), kind_(kind), seat_(seat) {}
+
+    /**
+     * @brief Decodes one input_event.
+     *
+     * @return true if @p out received an event for the engine.
+     */
+    bool feed(const Input &in, arc::device::Tagged &out);
+
+    arc::device::Id id() const { return id_; }  ///< Device id tagged on events.
+
+ private:
+    void emit(arc::gesture::EventType type, arc::gesture::Button button, std::uint32_t time_ms,
+              arc::device::Tagged &out) const;
+
+    arc::device::Id id_;
+    arc::device::Kind kind_;
+    Seat *seat_;
+    std::int32_t dx_ = 0, dy_ = 0;          ///< Motion since the last SYN_REPORT.
+    std::int32_t abs_x_ = 0, abs_y_ = 0;    ///< Last absolute position.
+    bool have_x_ = false, have_y_ = false;  ///< abs_x_ / abs_y_ valid (contact continues).
+};
+
+/**
+ * @brief Reads input_event records from evdev nodes and decodes them.
+ *
+ * Linux only (the portable build compiles it to stubs that read nothing).
+ * Not thread-safe; owned by the thread that feeds the engine.
+ */
+class Source {
+ public:
+    Source() = default;
+    Source(const Source &) = delete;
+    Source &operator=(const Source &) = delete;
+    ~Source();
+
+    /**
+     * @brief Registers every device listed in /proc/bus/input/devices and opens its node.
+     *
+     * @return Number of devices opened (nodes need read access, usually the
+     *         `input` group).
+     */
+    int scan(arc::device::Table &table);
+
+    /**
+     * @brief Reads an already open evdev node (or any stream of input_event records).
+     *
+     * Takes ownership of @p fd.
+     */
+    void attach(int fd, arc::device::Id id, arc::device::Kind kind);
+
+    /**
+     * @brief Waits up to @p timeout_ms for input and decodes what is available.
+     *
+     * @return Number of events stored in @p out (at most @p max), or -1 on
+     *         a poll error. Records beyond @p max stay queued in the nodes.
+     */
+    int poll(int timeout_ms, arc::device::Tagged *out, int max);
+
+    Seat &seat() { return seat_; }  ///< Shared pointer position and modifiers.
+
+ private:
+    struct Node {
+        int fd;
+        Decoder decoder;
+    };
+
+    Seat seat_;
+    std::vector<Node> nodes_;
+};
+
+}  // namespace evdev
+
+}  // namespace arc
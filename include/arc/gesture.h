@@ -0,0 +1,499 @@
+/**
+ * @file gesture.h
+ * @brief Platform-neutral click/drag gesture engine.
+ *
+ * The engine holds the click-vs-drag discrimination that used to live inside
+ * the low-level mouse hook. It consumes plain input events (button, position,
+ * timestamp, modifier mask) and returns a decision: pass the event through,
+ * swallow it, and optionally inject a short list of synthetic button events.
+ * It has no dependency on windows.h so it can be unit-tested, replayed and
+ * benchmarked on any platform; the Windows hook only translates
+ * MSLLHOOKSTRUCT to @ref arc::gesture::Event and the decision back to
+ * SendInput.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "arc/stroke.h"
+
+namespace arc { namespace tuning { class Usage; } }
+
+namespace arc { namespace gesture {
+
+/// @brief Mouse buttons known to the engine.
+enum class Button : std::uint8_t {
+    None = 0,  ///< No button (move/other events).
+    Left,      ///< Primary button.
+    Right,     ///< Secondary button.
+    Middle,    ///< Middle/wheel button.
+    X1,        ///< First extended button (typically "back").
+    X2         ///< Second extended button (typically "forward").
+};
+
+/// @brief Kind of input event.
+enum class EventType : std::uint8_t {
+    Move,  ///< Pointer moved.
+    Down,  ///< Button pressed.
+    Up,    ///< Button released.
+    Other  ///< Anything else (wheel, unknown); always passed through.
+};
+
+/// @brief Modifier bits used in @ref Event::mods and @ref Settings::required_mods.
+enum Modifier : std::uint32_t {
+    kModAlt = 1u << 0,    ///< Either ALT key.
+    kModCtrl = 1u << 1,   ///< Either CTRL key.
+    kModShift = 1u << 2,  ///< Either SHIFT key.
+    kModWin = 1u << 3     ///< Either Windows key.
+};
+
+/**
+ * @brief Maps a Win32 virtual-key code to its modifier bit.
+ *
+ * Accepts the generic and left/right specific codes (e.g. VK_MENU, VK_LMENU,
+ * VK_RMENU all map to @ref kModAlt). Virtual-key values are plain integers so
+ * no platform header is needed.
+ *
+ * @param vk Virtual-key code.
+ * @return Modifier bit, or 0 if @p vk is not a modifier key.
+ */
+std::uint32_t modifier_from_vk(unsigned int vk);
+
+/// @brief A pointer position in screen pixels.
+struct Point {
+    std::int32_t x = 0;  ///< Screen x.
+    std::int32_t y = 0;  ///< Screen y.
+};
+
+/// @brief A single input event as seen by the engine.
+struct Event {
+    EventType type = EventType::Other;  ///< Event kind.
+    Button button = Button::None;       ///< Button for Down/Up events.
+    std::int32_t x = 0;                 ///< Pointer x in screen pixels.
+    std::int32_t y = 0;                 ///< Pointer y in screen pixels.
+    std::uint32_t time_ms = 0;          ///< Millisecond timestamp (wraps like GetTickCount).
+    std::uint32_t mods = 0;             ///< Held modifiers (@ref Modifier bits).
+};
+
+/// @brief What a bound press turns into when it is a quick click.
+struct Action {
+    Button button = Button::None;  ///< Button to click (None: the press is not bound).
+    bool double_click = false;     ///< Click it twice.
+};
+
+/// @brief One binding rule: a source button with required modifiers, mapped to an action.
+struct Binding {
+    Button source = Button::Left;                ///< Pressed button.
+    std::uint32_t mods = kModAlt;                ///< Modifiers that must all be held (0: none).
+    Action action{Button::Right, false};         ///< Quick-click translation.
+};
+
+/**
+ * @brief Binding rules compiled to a flat (button, held modifiers) table.
+ *
+ * One byte per button and combination of the four modifier bits, so the
+ * action for a press is a single indexed load however many rules there are.
+ * Among the rules matching a press (same source, all of their modifiers
+ * held), the one requiring the most modifiers wins, then the earliest.
+ */
+class BindingTable {
+ public:
+    static constexpr int kButtons = 6;   ///< Button values, None included.
+    static constexpr int kMasks = 16;    ///< Combinations of the four modifier bits.
+    static constexpr int kCells = kButtons * kMasks;
+
+    /** Action bound to pressing @p b with @p mods held. */
+    Action at(Button b, std::uint32_t mods) const {
+        std::uint8_t c = cells_[static_cast<unsigned>(b) * kMasks + (mods & (kMasks - 1))];
+        return Action{static_cast<Button>(c & kButtonBits), (c & kDoubleBit) != 0};
+    }
+
+    /** Returns true if no press is bound. */
+    bool empty() const;
+
+    /**
+     * @brief Held-modifier masks that complete some binding.
+     *
+     * Bit @c m is set if a press of some button with exactly the modifier
+     * mask @c m held is bound (used by armed mode).
+     */
+    std::uint16_t modifier_sets() const;
+
+    /** Raw cell (button bits, plus 0x8 for a double click); for serialization. */
+    std::uint8_t cell(int i) const { return cells_[i]; }
+
+    /** Sets a raw cell; values outside the encoding are ignored. */
+    void set_cell(int i, std::uint8_t v) {
+        if ((v & kButtonBits) < kButtons && v < 16)
+            cells_[i] = v;
+    }
+
+ private:
+    static constexpr std::uint8_t kButtonBits = 0x7;
+    static constexpr std::uint8_t kDoubleBit = 0x8;
+
+    std::uint8_t cells_[kCells] = {};
+};
+
+/**
+ * @brief Compiles binding rules into a lookup table.
+ *
+ * @param rules Rules, in priority order for equally specific matches.
+ * @param count Number of rules.
+ */
+BindingTable compile_bindings(const Binding *rules, std::size_t count);
+
+/// @brief A stroke template shape and the action a matching stroke injects.
+struct StrokeRule {
+    arc::stroke::Shape shape;  ///< Template shape (see arc::stroke::parse_shape).
+    Action action;             ///< Click injected for a matching stroke.
+};
+
+/// @brief Engine tuning; mirrors the hook-related fields of arc::config::Config.
+struct Settings {
+    Button trigger = Button::Left;      ///< Source button of the legacy single binding.
+    std::uint32_t required_mods = kModAlt;  ///< Modifiers of the legacy binding (0: none).
+    std::uint32_t click_time_ms = 250;  ///< Max press duration to consider a click.
+    std::int32_t move_radius_px = 6;    ///< Max pointer travel to consider a click.
+    std::uint32_t predict_ms = 0;       ///< Drag prediction horizon (0: wait for the radius to be crossed).
+    bool speculative = false;           ///< Press the action button at trigger down instead of at release.
+    BindingTable bindings;              ///< Compiled bindings; empty: trigger + required_mods -> right click.
+    std::uint32_t double_click_ms = 0;  ///< Window for a second bound click (0: no double-click recognition).
+    Action double_action{Button::Middle, false};      ///< Injected for a bound double click.
+    std::uint32_t long_press_ms = 0;    ///< Hold time of a still bound press (off unless above click_time_ms).
+    Action long_press_action{Button::Middle, false};  ///< Injected for a long press.
+    std::uint32_t chord_ms = 0;         ///< Window for the chord partner's press (0: no chords).
+    Button chord_button = Button::Right;              ///< Partner button completing a chord.
+    Action chord_action{Button::Middle, false};       ///< Injected for a chord.
+    StrokeRule strokes[arc::stroke::kMaxTemplates];   ///< Stroke rules; the first stroke_count are used.
+    std::uint8_t stroke_count = 0;      ///< Stroke rules in use (0: bound drags are native drags).
+    std::uint8_t stroke_min_score = 80; ///< Minimum similarity of a recognized stroke, in percent.
+    std::uint32_t dwell_ms = 0;         ///< Stillness with required_mods held that injects dwell_action (0: off).
+    Action dwell_action{Button::Right, false};        ///< Injected when the pointer dwells.
+};
+
+/** Bindings the engine applies for @p s: its table, or the legacy single binding. */
+BindingTable effective_bindings(const Settings &s);
+
+/// @brief What the caller should do with the original event.
+enum class Verdict : std::uint8_t {
+    Pass,    ///< Forward the event to the next hook/application.
+    Swallow  ///< Consume the event.
+};
+
+/// @brief Synthetic button event the caller should inject.
+struct Injection {
+    Button button = Button::None;  ///< Button to synthesize.
+    bool down = false;             ///< True for press, false for release.
+};
+
+/**
+ * @brief Result of feeding one event to the engine.
+ *
+ * When @ref path_count is non-zero (a click turning into a drag), the caller
+ * moves the pointer to @c path[0] (the press origin), performs the
+ * injections there, then moves through the rest of the path, all as one
+ * batch.
+ */
+struct Decision {
+    static constexpr int kMaxInjections = 8;  ///< Capacity of @ref inject (a pending double click, then another).
+
+    Verdict verdict = Verdict::Pass;      ///< Disposition of the original event.
+    std::uint8_t count = 0;               ///< Number of valid entries in @ref inject.
+    std::uint8_t path_count = 0;          ///< Number of points in @ref path (0: no pointer replay).
+    Injection inject[kMaxInjections]{};   ///< Injections, in order.
+    const Point *path = nullptr;          ///< Pointer path owned by the engine; valid until its next call.
+
+    /** Appends an injection; silently drops it if the list is full. */
+    void push(Button b, bool down) {
+        if (count < kMaxInjections)
+            inject[count++] = Injection{b, down};
+    }
+};
+
+/**
+ * @brief Click-vs-drag discriminator for configurable button bindings.
+ *
+ * Not thread-safe: an engine is owned by the thread delivering events (the
+ * hook worker on Windows). The engine never allocates: the motion buffer is
+ * a fixed array of @ref kMotionCapacity points. When a slow jiggle fills it,
+ * every other point is dropped and later moves are sampled at twice the
+ * stride, so the buffer always spans the whole press at even spacing.
+ *
+ * Behavior:
+ * - Press bound in the binding table (see @ref effective_bindings; by
+ *   default the trigger with all required modifiers held): start tracking
+ *   that button, swallow.
+ * - Move beyond the radius while tracking: swallow the move, inject the
+ *   source-button down at the press origin and replay the pointer path
+ *   buffered since the press (see @ref Decision), so the drag starts where
+ *   the button went down; stop tracking.
+ * - With @c predict_ms set, a move whose recent velocity projects the
+ *   pointer well beyond the radius within @c predict_ms (see
+ *   @ref predicts_drag) is treated like a move beyond the radius, so fast
+ *   drags start before the pointer has covered a large radius.
+ * - Tracking outlives @c click_time_ms (@ref on_timer): inject the
+ *   source-button down so a long press behaves natively; stop tracking.
+ * - Release of the tracked button: if within the time and radius
+ *   thresholds, inject the bound action (a right click by default),
+ *   otherwise replay the source click; swallow the up.
+ *
+ * Recognizers (each off by default):
+ * - Double click (@c double_click_ms): a quick click is held back for the
+ *   window. A second bound press of the same button in it (the pointer
+ *   never left the radius) is tracked with @c double_action, and its quick
+ *   release injects that action; any other outcome first injects the held
+ *   click. The window closing (@ref on_timer), the pointer leaving the
+ *   radius, or another press also deliver the held click first.
+ * - Long press (@c long_press_ms, above @c click_time_ms): a bound press
+ *   held that long inside the radius injects @c long_press_action and its
+ *   release is swallowed. Released earlier but after the click time, it
+ *   replays the source click; the source button is not pressed natively at
+ *   the click time.
+ * - Chord (@c chord_ms): @c chord_button pressed within the window after a
+ *   tracked bound press injects @c chord_action; both releases are
+ *   swallowed.
+ * - Strokes (@c stroke_count rules): a bound press leaving the radius
+ *   becomes a stroke instead of a drag. Its moves pass (the pointer
+ *   follows the hand) and are recorded; at the release the path is matched
+ *   against the rules' templates (see arc/stroke.h), a match of at least
+ *   @c stroke_min_score percent injects that rule's action, and the
+ *   release is swallowed either way.
+ * With a recognizer on, presses are never speculated.
+ *
+ * Dwell (@c dwell_ms, with non-zero @c required_mods): while those
+ * modifiers are held and no press is in progress, a pointer that stays
+ * within @c move_radius_px of an anchor for @c dwell_ms injects
+ * @c dwell_action without any button being pressed. The anchor is set when
+ * the modifiers go down (an Other event carrying the new modifier state
+ * starts it without a move) and moves to the pointer whenever it leaves the
+ * radius, with the same inscribed-square prefilter as a tracked press, so
+ * each move costs O(1). A press re-anchors at its position without firing,
+ * and each anchor fires at most once. The deadline is re-armed lazily: a
+ * re-anchor never moves an armed deadline; @ref on_timer finding the anchor
+ * too young re-arms it at the anchor's own due time, so continuous motion
+ * costs one timer change per @c dwell_ms, not one per move.
+ *
+ * With a usage sink attached (@ref observe), every bound press is reported
+ * at its release with its duration and the farthest it travelled from the
+ * press point; travel keeps being measured after a drag starts, until it
+ * reaches arc::tuning::kTravelCapPx. Chord presses are not reported.
+ *
+ * Speculative mode (@c speculative, fixed per press at the trigger down)
+ * injects the action button's down together with the swallowed press, so
+ * applications that react to the press see it a click duration earlier;
+ * double-click actions are never speculated. A quick release then only
+ * injects the action button's up. Every other outcome (drag, long press,
+ * late release, @ref reset) first injects that up to cancel the speculation
+ * and then continues as above, so no button is ever left pressed.
+ */
+class Engine {
+ public:
+    static constexpr int kMotionCapacity = 32;  ///< Buffered positions per press, origin included.
+    static constexpr int kVelocitySamples = 8;  ///< Recent timed positions kept for drag prediction.
+    static constexpr std::uint32_t kVelocityWindowMs = 8;  ///< Preferred age of the velocity reference sample.
+    static constexpr int kStrokeCapacity = 128;  ///< Buffered positions per stroke.
+
+    explicit Engine(const Settings &settings = Settings{}) { configure(settings); }
+
+    /** Replaces the engine settings; an in-flight tracked click (and dwell anchor) is kept. */
+    void configure(const Settings &settings) {
+        settings_ = settings;
+        table_ = effective_bindings(settings);
+        inner_ = inscribed_half_width(settings.move_radius_px);
+        load_strokes();
+        if (!settings.dwell_ms)
+            dwelling_ = false;
+    }
+
+    /** Returns the current settings. */
+    const Settings &settings() const { return settings_; }
+
+    /**
+     * @brief Feeds one event and returns what to do with it.
+     *
+     * @param ev Input event.
+     * @return Decision for the event.
+     */
+    Decision on_event(const Event &ev);
+
+    /**
+     * @brief Resolves a tracked press that outlived the click time.
+     *
+     * Called by the owner's timer at @ref deadline. Once more than
+     * @c click_time_ms has passed since the down, injects the source-button
+     * down and stops tracking (with long presses on: once @c long_press_ms
+     * has passed, injects the long-press action). A held-back click whose
+     * double-click window has closed is injected, and so is the dwell
+     * action once the pointer has rested @c dwell_ms (see the class
+     * comment). Earlier calls (or calls with nothing pending) return an
+     * empty decision.
+     *
+     * @param now_ms Current time in the event clock.
+     */
+    Decision on_timer(std::uint32_t now_ms);
+
+    /**
+     * @brief Time at which @ref on_timer resolves the tracked press, held-back click or dwell.
+     *
+     * @param[out] at_ms Deadline in the event clock (first ms past the click
+     *                   time, the long-press time, or the double-click window;
+     *                   the armed dwell time if that comes first).
+     * @return true while tracking, holding a click back or dwelling; false otherwise.
+     */
+    bool deadline(std::uint32_t &at_ms) const {
+        bool any = false;
+        if (tracking_) {
+            at_ms = down_time_ + (long_press_on() ? settings_.long_press_ms : settings_.click_time_ms + 1);
+            any = true;
+        } else if (pending_) {
+            at_ms = pending_time_ + settings_.double_click_ms + 1;
+            any = true;
+        }
+        if (dwell_armed() && (!any || static_cast<std::int32_t>(dwell_due_ - at_ms) < 0)) {
+            at_ms = dwell_due_;
+            any = true;
+        }
+        return any;
+    }
+
+    /** Returns true while a potential click is being tracked. */
+    bool tracking() const { return tracking_; }
+
+    /** Returns true if a move can change nothing: no press tracked, no click held back, no travel measured. */
+    bool idle() const { return !tracking_ && !pending_ && !stroking_ && !measuring_; }
+
+    /** Returns true if idle and no resolved press still has its release to swallow. */
+    bool settled() const { return idle() && !swallow_ups_; }
+
+    /** Returns true while a bound press is recording a stroke. */
+    bool stroking() const { return stroking_; }
+
+    /** Returns true while the dwell modifiers are held, so moves must reach the engine even when idle. */
+    bool dwelling() const { return dwelling_; }
+
+    /**
+     * @brief Drag predictor: does the motion up to @p ev clearly leave the radius?
+     *
+     * Estimates the velocity between @p ev and a recent sample about
+     * @ref kVelocityWindowMs older (at least half that; shorter spans are
+     * too coarse at 1 px / 1 ms resolution). The prediction holds when the
+     * pointer is already past half the radius, moving away from the origin
+     * without slowing down (second half of the window at least as fast as
+     * the first), and the position projected @c predict_ms ahead lies
+     * beyond 1.5x the radius. Always false with @c predict_ms at 0.
+     */
+    bool predicts_drag(const Event &ev) const;
+
+    /**
+     * @brief Reports bound presses to @p usage (nullptr: stop reporting).
+     *
+     * The sink must outlive the engine or the next call. Recording is two
+     * relaxed atomic increments per press, at its release.
+     */
+    void observe(arc::tuning::Usage *usage) {
+        usage_ = usage;
+        observing_ = false;
+        measuring_ = false;
+    }
+
+    /**
+     * @brief Drops any tracked click (e.g. after the hook was reinstalled).
+     *
+     * @return The right-button release cancelling a speculative press, if
+     *         one was outstanding, and a held-back click; the caller must
+     *         inject them.
+     */
+    Decision reset();
+
+ private:
+    Settings settings_;
+    BindingTable table_;           ///< Effective bindings of settings_.
+    bool tracking_ = false;        ///< Tracking a potential click between down/up.
+    Button press_button_ = Button::None;  ///< Source button of the tracked press.
+    Action action_;                ///< Action bound to the tracked press.
+    std::int32_t start_x_ = 0;     ///< Pointer x at button down.
+    std::int32_t start_y_ = 0;     ///< Pointer y at button down.
+    std::uint32_t down_time_ = 0;  ///< Timestamp at button down.
+    bool speculating_ = false;     ///< A speculative down of action_.button is outstanding.
+    bool second_ = false;          ///< The tracked press is the second one of a double click.
+    bool pending_ = false;         ///< A quick click is held back for the double-click window.
+    Button pending_button_ = Button::None;  ///< Source button of the held-back click.
+    Action pending_action_;        ///< Action of the held-back click.
+    std::uint32_t pending_time_ = 0;  ///< Release time of the held-back click.
+    Point pending_at_;             ///< Release position of the held-back click.
+    Point flush_path_[2];          ///< Path of a held-back click delivered by a move.
+    std::uint8_t swallow_ups_ = 0; ///< Bit per button whose next release is swallowed (resolved press).
+    bool stroking_ = false;        ///< The tracked press left the radius and records a stroke.
+
+    std::int32_t inner_ = 0;       ///< Half-width of the square inscribed in the radius (no distance check inside).
+
+    /** Largest h with 2h^2 <= r^2: every offset with |dx|, |dy| <= h lies within @p r. */
+    static std::int32_t inscribed_half_width(std::int32_t r);
+
+    /// @brief Timed position for velocity estimation.
+    struct Sample {
+        std::int32_t x, y;
+        std::uint32_t t;
+    };
+
+    Decision begin_drag(const Event &ev);
+    Decision begin_chord(const Event &ev);
+    Decision begin_stroke(const Event &ev);
+    Decision end_stroke(const Event &ev);
+    void cancel_speculation(Decision &d);
+    void flush_pending(Decision &d);
+    bool long_press_on() const { return settings_.long_press_ms > settings_.click_time_ms; }
+    bool recognizing() const {
+        return settings_.double_click_ms || settings_.chord_ms || long_press_on() || settings_.stroke_count;
+    }
+    void load_strokes();
+    void record_motion(std::int32_t x, std::int32_t y);
+    void record_sample(const Event &ev);
+    void record_stroke(std::int32_t x, std::int32_t y);
+    void measure(const Event &ev);
+    void end_observation(const Event &ev);
+    bool dwell_wanted(std::uint32_t mods) const {
+        return settings_.dwell_ms && settings_.required_mods &&
+               (mods & settings_.required_mods) == settings_.required_mods;
+    }
+    bool dwell_armed() const { return dwelling_ && !dwell_fired_ && !tracking_ && !stroking_; }
+    void update_dwell(const Event &ev);
+    void fire_dwell(Decision &d, std::uint32_t now_ms);
+
+    Point motion_[kMotionCapacity + 1];  ///< Origin, sampled moves, and room for the drag exit point.
+    std::uint8_t motion_count_ = 0;      ///< Valid entries in motion_.
+    std::uint16_t motion_stride_ = 1;    ///< Moves per stored sample (doubles on each compaction).
+    std::uint16_t motion_skip_ = 0;      ///< Moves seen since the last stored sample.
+
+    Sample recent_[kVelocitySamples];    ///< Ring of the latest timed positions (prediction only).
+    std::uint8_t recent_count_ = 0;      ///< Valid entries in recent_.
+    std::uint8_t recent_head_ = 0;       ///< Slot of the next sample.
+
+    std::int32_t stroke_x_[kStrokeCapacity];  ///< Stroke positions (x), sampled like motion_.
+    std::int32_t stroke_y_[kStrokeCapacity];  ///< Stroke positions (y).
+    std::uint16_t stroke_len_ = 0;            ///< Valid stroke positions.
+    std::uint16_t stroke_stride_ = 1;         ///< Moves per stored stroke position.
+    std::uint16_t stroke_skip_ = 0;           ///< Moves seen since the last stored position.
+    arc::stroke::Library templates_;          ///< Templates of the stroke rules.
+    Action stroke_actions_[arc::stroke::kMaxTemplates];  ///< Action per template.
+
+    arc::tuning::Usage *usage_ = nullptr;  ///< Sink of press reports (see observe()).
+    bool observing_ = false;               ///< A bound press awaits its release to be reported.
+    bool measuring_ = false;               ///< Its travel is still below the cap (moves matter).
+    Button observe_button_ = Button::None; ///< Button of the observed press.
+    Point observe_at_;                     ///< Press point of the observed press.
+    std::uint32_t observe_time_ = 0;       ///< Press time of the observed press.
+    std::int64_t travel_sq_ = 0;           ///< Largest squared distance from observe_at_ so far.
+
+    bool dwelling_ = false;                ///< Dwell modifiers held; dwell_at_ is valid.
+    bool dwell_fired_ = false;             ///< The current anchor fired (or saw a press); nothing armed.
+    Point dwell_at_;                       ///< Anchor the pointer must stay near.
+    std::uint32_t dwell_since_ = 0;        ///< Time the anchor was set.
+    std::uint32_t dwell_due_ = 0;          ///< Armed dwell deadline (may precede dwell_since_ + dwell_ms).
+};
+
+}  // namespace gesture
+
+}  // namespace arc
@@ -0,0 +1,77 @@
+/**
+ * @file histogram.h
+ * @brief Allocation-free, lock-free log-bucketed latency histogram.
+ *
+ * HDR-style bucketing: values below 16 get exact buckets; above that each
+ * power of two is split into 8 linear sub-buckets, bounding the relative
+ * error of reported quantiles to 12.5% over the full 64-bit range. Recording
+ * is a handful of relaxed atomic increments so it can run inside the mouse
+ * hook on every event. The object is standard-layout and position
+ * independent, so it can live in shared memory and be read by another
+ * process (see arc/metrics.h).
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace arc { namespace metrics {
+
+/// @brief Point-in-time summary of a histogram.
+struct LatencySummary {
+    std::uint64_t count = 0;  ///< Number of recorded samples.
+    std::uint64_t mean = 0;   ///< Mean value (integer division).
+    std::uint64_t p50 = 0;    ///< Median (bucket upper bound, capped at max).
+    std::uint64_t p99 = 0;    ///< 99th percentile.
+    std::uint64_t p999 = 0;   ///< 99.9th percentile.
+    std::uint64_t max = 0;    ///< Largest value recorded (exact).
+};
+
+/**
+ * @brief Concurrent log-bucketed histogram of non-negative integer values.
+ *
+ * Any number of threads may call @ref record concurrently with readers
+ * calling @ref summarize / @ref quantile; readers see a consistent-enough
+ * view for monitoring (counts may be mid-update by a few samples).
+ */
+class LatencyHistogram {
+ public:
+    static constexpr unsigned kSubBits = 3;                        ///< log2(sub-buckets per power of two).
+    static constexpr unsigned kSubCount = 1u << kSubBits;          ///< Sub-buckets per power of two.
+    static constexpr std::size_t kBuckets = (64 - kSubBits) * kSubCount + kSubCount;  ///< Total buckets.
+
+    /** Returns the bucket index for @p v. */
+    static std::size_t bucket_of(std::uint64_t v);
+    /** Returns the largest value that maps to bucket @p idx. */
+    static std::uint64_t bucket_upper(std::size_t idx);
+
+    /** Records one sample; lock-free and allocation-free. */
+    void record(std::uint64_t v) {
+        buckets_[bucket_of(v)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(v, std::memory_order_relaxed);
+        std::uint64_t cur = max_.load(std::memory_order_relaxed);
+        while (v > cur && !max_.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+        }
+    }
+
+    /** Returns the value at quantile @p q in [0, 1]; 0 when empty. */
+    std::uint64_t quantile(double q) const;
+
+    /** Returns count, mean, p50/p99/p999 and max in one pass. */
+    LatencySummary summarize() const;
+
+    /** Clears all samples. Not atomic with respect to concurrent writers. */
+    void reset();
+
+ private:
+    std::atomic<std::uint64_t> buckets_[kBuckets] = {};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+}  // namespace metrics
+
+}  // namespace arc
@@ -11,13 +11,19 @@
 
 #include <windows.h>
 
+#include <string>
+
 namespace arc { namespace config { struct Config; } }
+namespace arc { namespace tuning { class Usage; } }
 
 namespace arc { namespace hook {
 
 /**
  * @brief Installs the process-wide low-level mouse hook.
  *
+ * Also installs a low-level keyboard hook and foreground/desktop-switch
+ * watchers that keep the cached modifier state current.
+ *
  * Typically called from the hook worker thread; not intended for UI threads as
  * it requires a message loop. Safe to call if already installed (no-op).
  *
@@ -26,7 +32,7 @@ namespace arc { namespace hook {
 bool install();
 
 /**
- * @brief Removes the low-level mouse hook if installed.
+ * @brief Removes the low-level mouse and keyboard hooks if installed.
  *
  * Safe to call multiple times; subsequent calls after removal are no-ops.
  */
@@ -42,20 +48,58 @@ void remove();
  */
 LRESULT CALLBACK LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam);
 
+/**
+ * @brief Low-level keyboard hook procedure.
+ *
+ * Observes modifier key transitions to maintain the cached modifier mask
+ * consulted by @ref LowLevelMouseProc. Never consumes keyboard input.
+ *
+ * @param nCode Hook code from WH_KEYBOARD_LL contract.
+ * @param wParam Keyboard message identifier (e.g., WM_KEYDOWN).
+ * @param lParam Pointer to KBDLLHOOKSTRUCT for the event.
+ * @return Result of CallNextHookEx.
+ */
+LRESULT CALLBACK LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam);
+
 /**
  * @brief Applies runtime configuration for the hook.
  *
- * Thread-safe: internal state uses atomics and private storage.
+ * Thread-safe and callable from any thread: the hook-related fields are
+ * copied into an immutable HookSnapshot (see hook_snapshot.h) that the hook
+ * callback picks up, whole, on its next event.
  *
  * @param cfg New configuration values to apply.
  */
 void apply_hook_config(const arc::config::Config &cfg);
 
+/**
+ * @brief Usage histograms fed by the hook while auto_tune is on.
+ *
+ * The hook thread records each bound press at its release; any thread may
+ * read them (and age or reset them) concurrently, see arc/tuning.h.
+ */
+arc::tuning::Usage &usage();
+
+/**
+ * @brief Records the hook's input and decisions to a binary trace file.
+ *
+ * Every event that reaches the gesture engine is appended with its decision,
+ * along with settings changes and long-press timer resolutions (see
+ * trace.h; replay with the arc-replay tool). Recording never blocks the hook
+ * callback. Call before @ref start; @ref stop finishes the file.
+ *
+ * @param path Trace file to create (truncated if it exists).
+ * @return false if the file cannot be created.
+ */
+bool record_trace(const std::string &path);
+
 /**
  * @brief Starts the hook worker thread and installs the hook.
  *
  * The worker pumps a private message loop until @ref stop posts a
- * quit message. The call blocks until installation succeeds/fails, then returns.
+ * quit message. A companion injector thread performs the SendInput calls
+ * queued by the hook callback, keeping them off the hook's timeout budget.
+ * The call blocks until installation succeeds/fails, then returns.
  *
  * @return true if the hook was installed and the worker is running.
  */
@@ -63,6 +107,9 @@ bool start();
 
 /**
  * @brief Requests the hook worker to quit and waits for it to join.
+ *
+ * The injector thread is stopped afterwards, once it has sent any pending
+ * injections.
  */
 void stop();
 
@@ -0,0 +1,66 @@
+/**
+ * @file hook_snapshot.h
+ * @brief Immutable hook configuration read by the mouse hook once per event.
+ *
+ * @ref arc::hook::apply_hook_config builds a HookSnapshot from the runtime
+ * configuration and publishes it through an arc::rcu::Cell. The hook
+ * callback reads one consistent snapshot per event, so a config change from
+ * the tray or the config watcher can never be observed half-applied.
+ * Portable (no windows.h) so it can be exercised in tests on any host.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include "arc/device.h"
+#include "arc/dispatch.h"
+#include "arc/gesture.h"
+
+namespace arc { namespace config { struct Config; } }
+
+namespace arc { namespace hook {
+
+/**
+ * @brief Everything the hook callback needs from the configuration.
+ *
+ * Fixed-size and allocation-free; aligned to a cache line so a snapshot
+ * never shares a line with writer-side data.
+ */
+struct alignas(64) HookSnapshot {
+    static constexpr int kMaxPollKeys = 8;  ///< Capacity of @ref poll_vks.
+
+    std::uint64_t generation = 0;        ///< Increases with every publish; 0 for the built-in defaults.
+    arc::gesture::Settings gesture;      ///< Engine settings (trigger, modifiers, thresholds).
+    arc::dispatch::TranslateFn translate = &arc::dispatch::translate;  ///< Message translation for @ref gesture.
+    bool enabled = true;                 ///< Master enable flag.
+    bool ignore_injected = true;         ///< Skip externally injected events.
+    bool armed = false;                  ///< Armed hook mode (mouse hook only while the combo is held).
+    bool auto_tune = false;              ///< Report bound presses to the usage histograms (arc::hook::usage()).
+    std::uint32_t arm_grace_ms = 300;    ///< Armed mode: hook lifetime after the combo is released.
+    std::uint8_t poll_count = 1;         ///< Number of valid entries in @ref poll_vks.
+    unsigned int poll_vks[kMaxPollKeys] = {0x12};  ///< Modifier keys to poll when no keyboard hook is available.
+    std::uint8_t device_count = 0;       ///< Number of valid entries in @ref devices (0: routing off).
+    arc::device::Rule devices[arc::device::kMaxRules];  ///< Per-device routing rules, first match wins.
+};
+
+/**
+ * @brief Builds a snapshot from the runtime configuration.
+ *
+ * The required modifier mask comes from the modifier combo if configured,
+ * otherwise from the legacy single modifier. Binding rules are compiled
+ * into the engine's lookup table, with the legacy trigger rule last; with no
+ * rules the table stays empty and the engine applies the legacy rule
+ * itself. The message translation is the instance specialized for the
+ * bound source button when there is only one. Device rules become fixed-size
+ * routing rules with a button mask. Keys beyond HookSnapshot::kMaxPollKeys (combo and rule modifiers)
+ * still take part in matching but are not polled.
+ *
+ * @param cfg        Configuration to translate.
+ * @param generation Generation number stored in the snapshot.
+ * @return The populated snapshot.
+ */
+HookSnapshot make_snapshot(const arc::config::Config &cfg, std::uint64_t generation);
+
+}  // namespace hook
+
+}  // namespace arc
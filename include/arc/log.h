@@ -6,11 +6,21 @@
  * optionally, to a file. When async mode is enabled, a background thread
  * handles IO to reduce contention with UI/hook threads. Public APIs are
  * thread-safe unless otherwise noted.
+ *
+ * Prefer the ARC_LOG_ERROR / WARN / INFO / DEBUG macros: they check the
+ * level before evaluating their argument, so a filtered message costs one
+ * atomic load and never builds its string. Levels above ARC_LOG_MIN_LEVEL
+ * are compiled out entirely.
  */
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 
+#include "arc/log_batch.h"
+#include "arc/log_format.h"
+
 namespace arc { namespace log {
 
 /// @brief Severity levels (in increasing verbosity order).
@@ -21,6 +31,26 @@ enum class LogLevel {
     Debug = 3   ///< Verbose debugging information.
 };
 
+/**
+ * @brief Most verbose level compiled in (0 error .. 3 debug).
+ *
+ * Build with e.g. -DARC_LOG_MIN_LEVEL=2 (CMake: -DARC_LOG_MIN_LEVEL=2) to
+ * strip ARC_LOG_DEBUG and ARC_LOG_SCOPE from release builds.
+ */
+#ifndef ARC_LOG_MIN_LEVEL
+#define ARC_LOG_MIN_LEVEL 3
+#endif
+
+namespace detail {
+/// Runtime level (see set_level), read inline by @ref enabled.
+inline std::atomic<int> level{static_cast<int>(LogLevel::Info)};
+}  // namespace detail
+
+/** True if messages at @p lvl pass the runtime level. */
+inline bool enabled(LogLevel lvl) {
+    return static_cast<int>(lvl) <= detail::level.load(std::memory_order_relaxed);
+}
+
 /**
  * @brief Sets the minimum severity to emit.
  *
@@ -61,18 +91,37 @@ void start_async();
 void stop_async();
 
 /**
- * @brief Returns a UTF-8 message string for a Windows error code.
+ * @brief Sets the sub-second precision of line timestamps.
+ *
+ * @param precision Seconds (default), milliseconds or microseconds.
+ */
+void set_timestamp_precision(Precision precision);
+
+/**
+ * @brief Sets when the async worker writes queued lines out.
+ *
+ * The worker writes everything it has drained with one write per sink; the
+ * policy lets it hold text for up to @c interval_ms or until @c bytes have
+ * accumulated, trading log latency for fewer writes. Error lines are always
+ * flushed at once. The default flushes on every wakeup. Thread-safe.
+ *
+ * @param policy Flush limits (see arc::log::FlushPolicy).
+ */
+void set_flush_policy(const FlushPolicy &policy);
+
+/**
+ * @brief Returns a UTF-8 message string for a system error code.
  *
- * Uses FormatMessageW and converts the result to UTF-8. Suitable for
- * GetLastError() values.
+ * On Windows uses FormatMessageW and converts the result to UTF-8, for
+ * GetLastError() values; elsewhere describes an errno value.
  *
- * @param err Windows error code (e.g., GetLastError()).
+ * @param err Windows error code (e.g., GetLastError()), or errno elsewhere.
  * @return Human-readable message text.
  */
 std::string last_error_message(uint32_t err);
 
 /**
- * @brief Enables or disables inclusion of Windows thread ids in log lines.
+ * @brief Enables or disables inclusion of OS thread ids in log lines.
  *
  * @param enabled True to append `[T:<thread-id>]` to each message.
  */
@@ -83,21 +132,43 @@ void set_include_thread_id(bool enabled);
  *
  * Constructing the scope emits "<name> begin" at the requested severity and
  * destroying it emits "<name> end". Useful for tracing critical sections.
+ * Nothing is built or written when the level is filtered out at entry.
  */
 class LogScope {
  public:
+    /** @param name Scope name; must outlive the scope (normally a literal). */
     LogScope(const char *name, LogLevel lvl = LogLevel::Debug);
     ~LogScope();
 
  private:
-    std::string name_;
+    const char *name_;
     LogLevel level_;
     bool active_ = false;
 };
 
 #define ARC_LOG_CONCAT_INNER(a, b) a##b
 #define ARC_LOG_CONCAT(a, b) ARC_LOG_CONCAT_INNER(a, b)
+#if ARC_LOG_MIN_LEVEL >= 3
 #define ARC_LOG_SCOPE(name) ::arc::log::LogScope ARC_LOG_CONCAT(_arc_scope_, __LINE__)(name)
+#else
+#define ARC_LOG_SCOPE(name) static_cast<void>(0)
+#endif
+
+/**
+ * @brief Logs the message expression only if @p lvl is enabled.
+ *
+ * The message (anything convertible to std::string) is evaluated after the
+ * level check, and not at all for levels above ARC_LOG_MIN_LEVEL.
+ */
+#define ARC_LOG_AT(lvl, ...)                                                        \
+    do {                                                                            \
+        if (static_cast<int>(lvl) <= ARC_LOG_MIN_LEVEL && ::arc::log::enabled(lvl)) \
+            ::arc::log::write(lvl, __VA_ARGS__);                                    \
+    } while (0)
+#define ARC_LOG_ERROR(...) ARC_LOG_AT(::arc::log::LogLevel::Error, __VA_ARGS__)
+#define ARC_LOG_WARN(...) ARC_LOG_AT(::arc::log::LogLevel::Warn, __VA_ARGS__)
+#define ARC_LOG_INFO(...) ARC_LOG_AT(::arc::log::LogLevel::Info, __VA_ARGS__)
+#define ARC_LOG_DEBUG(...) ARC_LOG_AT(::arc::log::LogLevel::Debug, __VA_ARGS__)
 
 /**
  * @brief Emits a log line at the given severity.
@@ -109,6 +180,9 @@ class LogScope {
  */
 void write(LogLevel lvl, const std::string &msg);
 
+// Convenience wrappers: the message is built before the level check; prefer
+// the ARC_LOG_* macros where it is not a plain literal.
+
 /// @brief Convenience wrapper that logs at LogLevel::Error.
 inline void error(const std::string &msg) { write(LogLevel::Error, msg); }
 /// @brief Convenience wrapper that logs at LogLevel::Warn.
@@ -0,0 +1,80 @@
+/**
+ * @file log_batch.h
+ * @brief What the async log worker writes per flush, and when it flushes.
+ *
+ * The worker drains every queued line into one contiguous buffer and hands
+ * it to each sink with a single write, instead of a write and a flush per
+ * line. A FlushPolicy decides how long text may sit in the buffer: flushing
+ * on every wakeup, after a delay, or once enough bytes have piled up. An
+ * error line forces the next flush regardless.
+ *
+ * Portable (no platform headers) and clock-free: callers pass the current
+ * time in milliseconds, so the policy can be tested on a virtual clock.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace arc { namespace log {
+
+/// @brief When buffered log text is written out. Both limits 0: on every worker wakeup.
+struct FlushPolicy {
+    std::uint32_t interval_ms = 0;  ///< Longest a line waits for its flush (0: no time limit).
+    std::size_t bytes = 0;          ///< Flush once this much text is buffered (0: no size limit).
+};
+
+constexpr std::uint32_t kMaxHoldMs = 1000;  ///< Time limit used when a policy sets only bytes.
+
+/**
+ * @brief The worker's pending output and its flush decision.
+ *
+ * Single-threaded: owned by the log worker (or whoever drains the queue).
+ */
+class Batch {
+ public:
+    /** Replaces the flush policy; applies to text already buffered. */
+    void set_policy(const FlushPolicy &p) { policy_ = p; }
+    const FlushPolicy &policy() const { return policy_; }
+
+    /** Buffer the caller appends drained lines to. */
+    std::string &text() { return text_; }
+    bool empty() const { return text_.empty(); }
+
+    /**
+     * @brief Records that text was appended at @p now_ms.
+     *
+     * The first append after a flush starts the hold time.
+     */
+    void appended(std::int64_t now_ms);
+
+    /** Forces the next @ref due check to flush (an error line was queued). */
+    void force() { forced_ = true; }
+
+    /** True if buffered text should be written now. */
+    bool due(std::int64_t now_ms) const;
+
+    /**
+     * @brief Milliseconds until the buffered text falls due.
+     *
+     * @return 0 if due now, -1 if nothing is buffered.
+     */
+    std::int64_t wait_ms(std::int64_t now_ms) const;
+
+    /** Empties the buffer after a flush (keeps its capacity). */
+    void clear();
+
+ private:
+    std::uint32_t hold_ms() const;
+
+    FlushPolicy policy_;
+    std::string text_;
+    std::int64_t since_ms_ = 0;  ///< Time of the oldest unflushed text (valid while holding_).
+    bool holding_ = false;
+    bool forced_ = false;
+};
+
+}  // namespace log
+
+}  // namespace arc
@@ -0,0 +1,75 @@
+/**
+ * @file log_format.h
+ * @brief Allocation-free formatting of log lines.
+ *
+ * A log line is "[YYYY-MM-DD HH:MM:SS] [LEVEL] [T:<thread>] message\n".
+ * Converting the time to local calendar fields is the expensive part, and it
+ * only changes once a second: TimestampCache keeps the formatted seconds and
+ * redoes the conversion only when the second changes, appending
+ * milliseconds or microseconds arithmetically. format_line then assembles a
+ * line into a caller buffer (normally on the stack) without streams.
+ *
+ * Portable: localtime_s on Windows, localtime_r elsewhere.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace arc { namespace log {
+
+/// @brief Sub-second digits in log timestamps (the value is the digit count).
+enum class Precision {
+    Seconds = 0,  ///< YYYY-MM-DD HH:MM:SS
+    Millis = 3,   ///< YYYY-MM-DD HH:MM:SS.mmm
+    Micros = 6    ///< YYYY-MM-DD HH:MM:SS.uuuuuu
+};
+
+constexpr std::size_t kTimestampBytes = 26;  ///< Longest timestamp (microsecond precision).
+
+/** Current wall-clock time in microseconds since the Unix epoch. */
+std::int64_t wall_us();
+
+/**
+ * @brief Local-time timestamp formatter that converts once per second.
+ *
+ * Not thread-safe; keep one per thread (log.cpp uses a thread_local).
+ */
+class TimestampCache {
+ public:
+    /**
+     * @brief Writes the local time of @p unix_us to @p out.
+     *
+     * @param unix_us Microseconds since the Unix epoch (see @ref wall_us).
+     * @param precision Sub-second digits to append.
+     * @param out Receives the text (not NUL-terminated); at least kTimestampBytes.
+     * @return Characters written.
+     */
+    std::size_t format(std::int64_t unix_us, Precision precision, char *out);
+
+    /** Calendar conversions done so far (one per distinct second formatted). */
+    std::uint64_t conversions() const { return conversions_; }
+
+ private:
+    std::int64_t second_ = 0;  ///< Second held in text_ (valid once conversions_ > 0).
+    char text_[19] = {};       ///< "YYYY-MM-DD HH:MM:SS" for second_.
+    std::uint64_t conversions_ = 0;
+};
+
+/**
+ * @brief Assembles "[stamp] [level][ [T:tid]] msg\n" into @p out.
+ *
+ * Writes at most @p cap bytes; like snprintf, the return value is the full
+ * line length, so a result above @p cap means the buffer was too small
+ * (retry with a larger one). No NUL terminator is written.
+ *
+ * @param with_tid Include the " [T:<tid>]" field.
+ * @return Length of the complete line.
+ */
+std::size_t format_line(char *out, std::size_t cap, std::string_view stamp, std::string_view level, bool with_tid,
+                        std::uint32_t tid, std::string_view msg);
+
+}  // namespace log
+
+}  // namespace arc
@@ -0,0 +1,133 @@
+/**
+ * @file log_queue.h
+ * @brief Line queue between logging threads and the async log worker.
+ *
+ * Producers (hook, tray, watcher threads) copy each formatted line into a
+ * fixed slot of an arc::queue::MpscRing, so queueing a line never takes a
+ * lock or allocates. Lines longer than a slot, or arriving while the ring is
+ * full, spill into a bounded side buffer under a mutex; beyond its capacity
+ * they are dropped and counted. The worker sleeps on a condition variable
+ * only while the queue is empty, and producers touch its mutex only to wake
+ * it from there. Once stopped, the queue refuses new lines, so a caller that
+ * raced the shutdown writes its line itself instead of leaving it queued
+ * after the consumer's last drain.
+ *
+ * Portable (no platform headers) so it can be tested and benchmarked on any
+ * host; log.cpp owns the instance behind arc::log::write.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "arc/mpsc_ring.h"
+
+namespace arc { namespace log {
+
+constexpr std::size_t kLineBytes = 252;          ///< Longest line a ring slot holds (bytes, newline included).
+constexpr std::size_t kQueueSlots = 1024;        ///< Ring slots.
+constexpr std::size_t kSpillBytes = 1u << 20;    ///< Side buffer capacity.
+
+/// @brief Outcome of @ref Queue::push.
+enum class Pushed {
+    Queued,   ///< In the ring or the side buffer.
+    Dropped,  ///< Ring and side buffer full; counted in @ref Queue::dropped.
+    Closed    ///< The queue is stopped; the caller must write the line itself.
+};
+
+/// @brief One queued line: a ring slot.
+struct Line {
+    std::uint32_t size = 0;    ///< Valid bytes in text.
+    char text[kLineBytes];     ///< Line text (not NUL-terminated).
+};
+
+/**
+ * @brief Multi-producer, single-consumer line queue with overflow spill.
+ *
+ * @ref push may be called from any thread and copies the line straight into
+ * its slot. @ref pop, @ref take_spill and @ref wait belong to the single
+ * consumer. Lines from one thread come out in order, except that a spilled
+ * line is delivered after the ring lines the consumer drains with it.
+ */
+class Queue {
+ public:
+    Queue() = default;
+    Queue(const Queue &) = delete;
+    Queue &operator=(const Queue &) = delete;
+
+    /**
+     * @brief Producer: queues one line and wakes a sleeping consumer.
+     *
+     * @param urgent Ask the consumer to flush promptly (see @ref take_urgent).
+     * @return Whether the line was queued, dropped, or refused after @ref stop.
+     */
+    Pushed push(const char *text, std::size_t size, bool urgent = false);
+
+    /** Consumer: appends the oldest ring line to @p out, if any. */
+    bool pop(std::string &out) {
+        return ring_.try_pop_with([&out](const Line &l) { out.append(l.text, l.size); });
+    }
+
+    /**
+     * @brief Consumer: appends the spilled text to @p out and empties the side buffer.
+     *
+     * @return true if anything was spilled.
+     */
+    bool take_spill(std::string &out);
+
+    /**
+     * @brief Consumer: true (once) if an urgent line was queued since the last call.
+     *
+     * Call before draining: the urgent line is then among the lines drained.
+     */
+    bool take_urgent() { return urgent_.exchange(false, std::memory_order_acquire); }
+
+    /** Consumer: blocks until a line is queued or @ref stop is called. */
+    void wait();
+
+    /** Consumer: like @ref wait, but returns after @p ms at the latest. */
+    void wait_for(std::uint32_t ms);
+
+    /**
+     * @brief Asks the consumer to finish: @ref wait returns and @ref stopping holds.
+     *
+     * Returns once no @ref push is in flight; later pushes return
+     * Pushed::Closed. Lines queued before then are drained by the consumer
+     * or by a final drain after it exits.
+     */
+    void stop();
+
+    /** Clears a previous @ref stop so a new consumer can run. */
+    void restart() { stop_.store(false, std::memory_order_release); }
+
+    /** True once @ref stop was called. */
+    bool stopping() const { return stop_.load(std::memory_order_acquire); }
+
+    std::uint64_t spilled() const { return spilled_.load(std::memory_order_relaxed); }  ///< Lines that spilled.
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }  ///< Lines dropped.
+
+ private:
+    bool pending() const;
+
+    arc::queue::MpscRing<Line, kQueueSlots> ring_;
+    std::mutex spill_mutex_;
+    std::string spill_;                          ///< Overflow text (guarded by spill_mutex_).
+    std::atomic<std::size_t> spill_bytes_{0};    ///< spill_.size(), readable without the lock.
+    std::atomic<std::uint64_t> spilled_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> idle_{false};              ///< Consumer is (about to be) asleep in wait().
+    std::atomic<bool> urgent_{false};
+    std::atomic<bool> stop_{false};
+    std::atomic<std::uint32_t> pushing_{0};      ///< Producers inside push (see @ref stop).
+};
+
+}  // namespace log
+
+}  // namespace arc
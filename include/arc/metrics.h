@@ -0,0 +1,103 @@
+/**
+ * @file metrics.h
+ * @brief Always-on hook metrics and their cross-process publication.
+ *
+ * The running instance keeps a @ref arc::metrics::HookMetrics block in a
+ * named, session-local shared memory section so that a separate
+ * `altrightclick --status` process can report live latency percentiles and
+ * event counts without attaching a profiler. The block only contains
+ * fixed-size atomics and is updated without locks or allocation.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "arc/histogram.h"
+
+namespace arc { namespace metrics {
+
+/// @brief Mouse event categories counted by the hook.
+enum HookEventType : unsigned {
+    kEventMove = 0,   ///< WM_MOUSEMOVE.
+    kEventDown,       ///< Any button down.
+    kEventUp,         ///< Any button up.
+    kEventWheel,      ///< Vertical or horizontal wheel.
+    kEventOther,      ///< Anything else.
+    kEventTypeCount   ///< Number of categories.
+};
+
+/** Returns a lowercase name for a @ref HookEventType (e.g., "move"). */
+inline const char *event_type_name(unsigned type) {
+    static const char *const kNames[kEventTypeCount] = {"move", "down", "up", "wheel", "other"};
+    return type < kEventTypeCount ? kNames[type] : "unknown";
+}
+
+/**
+ * @brief Shared hook metrics block.
+ *
+ * Written by the hook thread, read by anyone. Layout is versioned so a
+ * status reader from a different build can detect a mismatch.
+ */
+struct HookMetrics {
+    static constexpr std::uint32_t kMagic = 0x41524D31;  ///< "ARM1".
+    static constexpr std::uint32_t kVersion = 2;        ///< Bumped on layout change.
+
+    std::uint32_t magic = kMagic;      ///< Identifies an initialized block.
+    std::uint32_t version = kVersion;  ///< Layout version.
+    std::atomic<std::uint32_t> pid{0};  ///< Process id of the publishing instance.
+
+    /// Time spent inside LowLevelMouseProc per event, in nanoseconds.
+    LatencyHistogram hook_latency_ns;
+    /// Events seen by the hook, by @ref HookEventType.
+    std::atomic<std::uint64_t> events[kEventTypeCount] = {};
+    /// Events the hook consumed (returned 1).
+    std::atomic<std::uint64_t> swallowed{0};
+    /// Events skipped because they were injected (ours or, if configured, others'; idle moves are not checked).
+    std::atomic<std::uint64_t> skipped_injected{0};
+
+    /// 1 while the WH_MOUSE_LL hook is installed, 0 while it is removed (e.g. disabled).
+    std::atomic<std::uint32_t> hook_installed{0};
+    /// Successful mouse hook installations (initial one included).
+    std::atomic<std::uint64_t> installs{0};
+    /// Mouse hook removals.
+    std::atomic<std::uint64_t> uninstalls{0};
+    /// Failed installation attempts.
+    std::atomic<std::uint64_t> install_failures{0};
+    /// Time from an install/uninstall request to its completion on the hook thread, in nanoseconds.
+    LatencyHistogram transition_ns;
+
+    /** Counts one event of the given type. */
+    void count_event(unsigned type) {
+        if (type < kEventTypeCount)
+            events[type].fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "metrics require lock-free 64-bit atomics");
+
+/**
+ * @brief Creates (or opens) the session-wide metrics block for writing.
+ *
+ * Windows-only. Falls back to a process-local block if the shared section
+ * cannot be created, so the caller always gets a valid pointer.
+ *
+ * @return Metrics block owned by this process for its lifetime.
+ */
+HookMetrics *publish();
+
+/**
+ * @brief Opens the metrics block published by a running instance.
+ *
+ * Windows-only. The returned pointer stays valid until @ref close_published.
+ *
+ * @return Read-only view, or nullptr if no instance publishes metrics.
+ */
+const HookMetrics *open_published();
+
+/** Releases a view returned by @ref open_published. */
+void close_published(const HookMetrics *m);
+
+}  // namespace metrics
+
+}  // namespace arc
@@ -0,0 +1,77 @@
+/**
+ * @file modifiers.h
+ * @brief Cached modifier-key state for the mouse hook hot path.
+ *
+ * Instead of polling GetAsyncKeyState for every configured modifier on each
+ * trigger press, the hook keeps an atomic bitmask of held modifiers that is
+ * maintained from key events (a WH_KEYBOARD_LL hook on Windows, or synthetic
+ * key events in tests and replays). The mouse hook then checks modifiers
+ * with one load and a mask compare.
+ *
+ * Left and right keys are tracked separately so releasing one side of a key
+ * held on both sides does not drop the modifier. Because key-up events can
+ * be missed (secure desktop, session switch, focus moving to a process we
+ * cannot observe), the tracker can be resynchronized from the real key
+ * state on such transitions.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace arc { namespace modifiers {
+
+/**
+ * @brief Lock-free modifier state tracker.
+ *
+ * Single writer (the thread delivering key events and resyncs), any number
+ * of readers. Readers call @ref held, which returns arc::gesture::Modifier
+ * bits.
+ */
+class Tracker {
+ public:
+    /// Callback reporting whether a virtual key is currently down.
+    using KeyStateFn = bool (*)(unsigned int vk);
+
+    /** Returns held modifiers as arc::gesture::Modifier bits (one acquire load). */
+    std::uint32_t held() const { return held_.load(std::memory_order_acquire); }
+
+    /** Returns the side-specific key bits (for diagnostics and tests). */
+    std::uint32_t keys() const { return keys_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Applies a key transition.
+     *
+     * Accepts side-specific codes (VK_LMENU, VK_RSHIFT, ...) as delivered by
+     * WH_KEYBOARD_LL, and generic codes (VK_MENU, ...) which are treated as
+     * the left key. Repeated downs (auto-repeat) are idempotent.
+     *
+     * @param vk   Virtual-key code.
+     * @param down True for press, false for release.
+     * @return true if @p vk is a modifier key (state may have changed).
+     */
+    bool on_key(unsigned int vk, bool down);
+
+    /**
+     * @brief Replaces the cached state with the real key state.
+     *
+     * Used to recover from missed key-ups on focus, desktop or session
+     * changes. Polls each side-specific modifier key once.
+     *
+     * @param is_down Returns whether the given virtual key is held.
+     */
+    void resync(KeyStateFn is_down);
+
+    /** Clears all held modifiers. */
+    void reset() { publish(0); }
+
+ private:
+    void publish(std::uint32_t keys);
+
+    std::atomic<std::uint32_t> keys_{0};  ///< One bit per side-specific modifier key.
+    std::atomic<std::uint32_t> held_{0};  ///< Folded arc::gesture::Modifier bits.
+};
+
+}  // namespace modifiers
+
+}  // namespace arc
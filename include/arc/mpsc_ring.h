@@ -0,0 +1,142 @@
+/**
+ * @file mpsc_ring.h
+ * @brief Bounded lock-free multi-producer/single-consumer ring buffer.
+ *
+ * Lets any number of threads hand fixed-size items to one consumer thread
+ * without locks, allocation or syscalls (the async logger's line queue).
+ * Portable: relies only on std::atomic.
+ *
+ * Each slot carries a sequence number (the bounded queue of D. Vyukov):
+ * a producer claims the next free slot with one compare-and-swap on the
+ * write index, copies the item in and publishes it by advancing the slot's
+ * sequence; the consumer takes published slots in order and hands them
+ * back for the next lap.
+ *
+ * Guarantees:
+ * - Any number of threads may call @ref try_push / @ref try_push_with
+ *   concurrently; exactly one thread may call the consumer API
+ *   (@ref try_pop, @ref try_pop_with, @ref empty) at a time.
+ * - Items from one producer are delivered in the order it pushed them, each
+ *   exactly once; items from different producers are ordered by slot claim.
+ * - Everything a producer wrote before a successful push (including the
+ *   item itself) is visible to the consumer after the matching pop.
+ * - A push never blocks or spins on the consumer: it fails when the ring is
+ *   full. A producer preempted between claiming and publishing its slot
+ *   holds back the items behind it until it resumes (the consumer sees the
+ *   ring as empty at that slot meanwhile).
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "arc/spsc_ring.h"
+
+namespace arc { namespace queue {
+
+/**
+ * @brief Fixed-capacity MPSC ring of trivially copyable items.
+ *
+ * @tparam T        Item type; copied in and out by value.
+ * @tparam Capacity Number of slots; must be a power of two.
+ */
+template <typename T, std::size_t Capacity>
+class MpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "MpscRing items must be trivially copyable");
+
+ public:
+    MpscRing() {
+        for (std::size_t i = 0; i < Capacity; ++i)
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    MpscRing(const MpscRing &) = delete;
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    /** Returns the number of slots. */
+    static constexpr std::size_t capacity() { return Capacity; }
+
+    /**
+     * @brief Producer (any thread): appends an item if there is room.
+     *
+     * @param item Item to copy into the ring.
+     * @return false if the ring is full (item not enqueued).
+     */
+    bool try_push(const T &item) {
+        return try_push_with([&item](T &slot) { slot = item; });
+    }
+
+    /**
+     * @brief Producer (any thread): fills the next free slot in place.
+     *
+     * @param fill Called as fill(T &) on the claimed slot before it is
+     *             published; must not touch the ring.
+     * @return false if the ring is full (@p fill not called).
+     */
+    template <typename F> bool try_push_with(F &&fill) {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        Cell *cell;
+        for (;;) {
+            cell = &cells_[pos & (Capacity - 1)];
+            std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            auto lag = static_cast<std::ptrdiff_t>(seq - pos);
+            if (lag == 0) {
+                // Free for this lap: claim it (on failure pos is reloaded)
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (lag < 0) {
+                return false;  // still holds last lap's item: full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);  // another producer claimed it
+            }
+        }
+        fill(cell->item);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer: removes the oldest published item if any.
+     *
+     * @param out Receives the item on success.
+     * @return false if the ring is empty (or its oldest slot is not published yet).
+     */
+    bool try_pop(T &out) {
+        return try_pop_with([&out](const T &item) { out = item; });
+    }
+
+    /**
+     * @brief Consumer: hands the oldest published item to @p use in place, then frees its slot.
+     *
+     * @return false if the ring is empty (@p use not called).
+     */
+    template <typename F> bool try_pop_with(F &&use) {
+        Cell &cell = cells_[head_ & (Capacity - 1)];
+        if (cell.seq.load(std::memory_order_acquire) != head_ + 1)
+            return false;
+        use(static_cast<const T &>(cell.item));
+        cell.seq.store(head_ + Capacity, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+    /** Consumer: returns true if no published item is currently available. */
+    bool empty() const { return cells_[head_ & (Capacity - 1)].seq.load(std::memory_order_acquire) != head_ + 1; }
+
+ private:
+    /// @brief Slot: sequence number (pos: free for lap pos, pos + 1: holds its item) and the item.
+    struct Cell {
+        std::atomic<std::size_t> seq;
+        T item;
+    };
+
+    // Producers share the write index; the consumer owns the read index.
+    alignas(kCacheLine) std::atomic<std::size_t> tail_{0};
+    alignas(kCacheLine) std::size_t head_ = 0;
+    alignas(kCacheLine) Cell cells_[Capacity];
+};
+
+}  // namespace queue
+
+}  // namespace arc
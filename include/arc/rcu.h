@@ -0,0 +1,144 @@
+/**
+ * @file rcu.h
+ * @brief Read-copy-update cell for immutable configuration snapshots.
+ *
+ * Lets a latency-critical reader (the low-level mouse hook) see a consistent
+ * immutable object per event without locks, while writers on other threads
+ * (tray, config watcher) replace it at any time. Writers build a new object,
+ * swap the published pointer and retire the old one; retired objects are
+ * freed only once the reader can no longer hold them.
+ *
+ * Guarantees:
+ * - One reader thread at a time (@ref read); any number of writers
+ *   (@ref publish), serialized by an internal mutex.
+ * - The read side is wait-free and allocation-free: one store announcing the
+ *   reader's epoch, one load of the pointer, one store on exit.
+ * - A snapshot obtained through @ref read stays valid until its guard is
+ *   destroyed, even if writers publish in the meantime.
+ * - Writers allocate; reclamation happens on later @ref publish or
+ *   @ref reclaim calls and in the destructor.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace arc { namespace rcu {
+
+/**
+ * @brief Single-reader RCU cell holding a `const T`.
+ *
+ * The reader announces the global epoch it entered in before loading the
+ * pointer. A writer swaps the pointer first and then advances the epoch, so
+ * an object retired at epoch @c e can only be referenced by a reader that
+ * announced an epoch <= @c e and has not left yet.
+ *
+ * @tparam T Snapshot type; published objects are never modified.
+ */
+template <typename T>
+class Cell {
+ public:
+    /** RAII read-side critical section; dereferences to the snapshot. */
+    class Guard {
+     public:
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+        Guard(Guard &&other) noexcept : cell_(other.cell_), ptr_(other.ptr_) { other.cell_ = nullptr; }
+        ~Guard() {
+            if (cell_)
+                cell_->active_.store(0, std::memory_order_release);
+        }
+
+        const T *get() const { return ptr_; }
+        const T *operator->() const { return ptr_; }
+        const T &operator*() const { return *ptr_; }
+
+     private:
+        friend class Cell;
+        Guard(const Cell *cell, const T *ptr) : cell_(cell), ptr_(ptr) {}
+
+        const Cell *cell_;
+        const T *ptr_;
+    };
+
+    /** Publishes @p initial as the first snapshot. */
+    explicit Cell(T initial = T{}) : current_(new T(std::move(initial))) {}
+    Cell(const Cell &) = delete;
+    Cell &operator=(const Cell &) = delete;
+
+    ~Cell() {
+        delete current_.load(std::memory_order_relaxed);
+        for (auto &r : retired_)
+            delete r.ptr;
+    }
+
+    /**
+     * @brief Reader: enters a critical section and returns the snapshot.
+     *
+     * Only one thread may hold a guard at a time, and guards must not nest.
+     */
+    Guard read() const {
+        // seq_cst store/load pair: either this reader sees a writer's new
+        // pointer, or that writer sees the announced epoch (see publish()).
+        active_.store(epoch_.load(std::memory_order_acquire), std::memory_order_seq_cst);
+        return Guard(this, current_.load(std::memory_order_seq_cst));
+    }
+
+    /**
+     * @brief Writer: replaces the snapshot and retires the previous one.
+     *
+     * Also frees previously retired snapshots the reader can no longer see.
+     */
+    void publish(T next) {
+        const T *fresh = new T(std::move(next));
+        std::lock_guard<std::mutex> lk(write_mu_);
+        const T *old = current_.exchange(fresh, std::memory_order_seq_cst);
+        std::uint64_t tag = epoch_.fetch_add(1, std::memory_order_seq_cst);
+        retired_.push_back(Retired{old, tag});
+        reclaim_locked();
+    }
+
+    /** Writer: frees retired snapshots the reader can no longer see. */
+    void reclaim() {
+        std::lock_guard<std::mutex> lk(write_mu_);
+        reclaim_locked();
+    }
+
+    /** Returns the number of retired snapshots awaiting reclamation. */
+    std::size_t retired() const {
+        std::lock_guard<std::mutex> lk(write_mu_);
+        return retired_.size();
+    }
+
+ private:
+    struct Retired {
+        const T *ptr;       ///< Snapshot replaced by a writer.
+        std::uint64_t tag;  ///< Epoch current when it was replaced.
+    };
+
+    void reclaim_locked() {
+        std::uint64_t active = active_.load(std::memory_order_seq_cst);
+        std::size_t kept = 0;
+        for (auto &r : retired_) {
+            if (active == 0 || active > r.tag)
+                delete r.ptr;
+            else
+                retired_[kept++] = r;
+        }
+        retired_.resize(kept);
+    }
+
+    std::atomic<const T *> current_;                ///< Published snapshot.
+    std::atomic<std::uint64_t> epoch_{1};           ///< Advanced by every publish.
+    mutable std::atomic<std::uint64_t> active_{0};  ///< Reader's announced epoch; 0 when outside.
+    mutable std::mutex write_mu_;                   ///< Serializes writers.
+    std::vector<Retired> retired_;                  ///< Replaced snapshots (guarded by write_mu_).
+};
+
+}  // namespace rcu
+
+}  // namespace arc
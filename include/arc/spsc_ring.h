@@ -0,0 +1,99 @@
+/**
+ * @file spsc_ring.h
+ * @brief Bounded lock-free single-producer/single-consumer ring buffer.
+ *
+ * Used to hand work from latency-critical callbacks (the low-level mouse
+ * hook) to a worker thread without locks, allocation or syscalls. Portable:
+ * relies only on std::atomic.
+ *
+ * Guarantees:
+ * - Exactly one thread may call the producer API (@ref try_push) and exactly
+ *   one thread the consumer API (@ref try_pop, @ref empty) at a time.
+ * - Items are delivered in FIFO order, each exactly once.
+ * - Everything the producer wrote before a successful push (including the
+ *   item itself) is visible to the consumer after the matching pop
+ *   (release/acquire on the indices).
+ * - A push never blocks: it fails when the ring is full.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace arc { namespace queue {
+
+/// Assumed cache-line size used to keep producer and consumer state apart.
+constexpr std::size_t kCacheLine = 64;
+
+/**
+ * @brief Fixed-capacity SPSC ring of trivially copyable items.
+ *
+ * @tparam T        Item type; copied in and out by value.
+ * @tparam Capacity Number of slots; must be a power of two.
+ */
+template <typename T, std::size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing items must be trivially copyable");
+
+ public:
+    SpscRing() = default;
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    /** Returns the number of slots. */
+    static constexpr std::size_t capacity() { return Capacity; }
+
+    /**
+     * @brief Producer: appends an item if there is room.
+     *
+     * @param item Item to copy into the ring.
+     * @return false if the ring is full (item not enqueued).
+     */
+    bool try_push(const T &item) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == Capacity) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == Capacity)
+                return false;
+        }
+        slots_[tail & (Capacity - 1)] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer: removes the oldest item if any.
+     *
+     * @param out Receives the item on success.
+     * @return false if the ring is empty.
+     */
+    bool try_pop(T &out) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_)
+                return false;
+        }
+        out = slots_[head & (Capacity - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Consumer: returns true if no item is currently available. */
+    bool empty() const { return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire); }
+
+ private:
+    // Producer-owned line: write index plus a cached copy of the read index.
+    alignas(kCacheLine) std::atomic<std::size_t> tail_{0};
+    std::size_t head_cache_ = 0;
+    // Consumer-owned line: read index plus a cached copy of the write index.
+    alignas(kCacheLine) std::atomic<std::size_t> head_{0};
+    std::size_t tail_cache_ = 0;
+    alignas(kCacheLine) T slots_[Capacity];
+};
+
+}  // namespace queue
+
+}  // namespace arc
@@ -0,0 +1,128 @@
+/**
+ * @file stroke.h
+ * @brief Stroke (mouse gesture) recognizer: resampling and template matching.
+ *
+ * A Protractor-style recognizer (Li, 2010; resampling as in Wobbrock et al.'s
+ * $1): a stroke is resampled to @ref arc::stroke::kSamples points evenly
+ * spaced along its length, translated so its centroid is the origin and
+ * scaled to a unit vector. Two such vectors are compared by their cosine
+ * similarity after the best rotation, which has a closed form; the rotation
+ * is limited to @ref arc::stroke::kMaxRotation so a stroke to the left never
+ * matches one upwards.
+ *
+ * Templates are generated from shapes: one to @ref arc::stroke::kMaxSegments
+ * straight segments in the four screen directions (e.g. "L" for a stroke to
+ * the left, "DR" for down then right). Vectors and the template library are
+ * stored as structure-of-arrays floats with fixed capacity, so matching is a
+ * few straight multiply-add loops the compiler vectorizes, and nothing
+ * allocates after construction.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace arc { namespace stroke {
+
+constexpr int kSamples = 32;       ///< Points per resampled stroke.
+constexpr int kMaxSegments = 4;    ///< Segments per template shape.
+constexpr int kMaxTemplates = 64;  ///< Capacity of a @ref Library.
+constexpr float kMaxRotation = 0.3927f;  ///< Largest rotation applied when matching (pi/8, 22.5 degrees).
+constexpr int kBlock = 8;                ///< Templates a @ref Library scores side by side.
+static_assert(kMaxTemplates % kBlock == 0, "templates must fill whole blocks");
+
+/// @brief Screen direction of one template segment (y grows downwards).
+enum class Direction : std::uint8_t { Left, Right, Up, Down };
+
+/// @brief Template shape: up to @ref kMaxSegments directions, packed 2 bits each.
+struct Shape {
+    std::uint8_t count = 0;  ///< Number of segments (0: no shape).
+    std::uint8_t dirs = 0;   ///< Direction of segment @c i in bits 2i..2i+1.
+
+    /** Direction of segment @p i. */
+    Direction at(int i) const { return static_cast<Direction>((dirs >> (2 * i)) & 3); }
+};
+
+/**
+ * @brief Parses a shape such as "L", "dr" or "RDL".
+ *
+ * Letters L, R, U, D (case-insensitive), one per segment; a letter may not
+ * repeat the one before it (that would be a single segment).
+ *
+ * @return true and sets @p out if @p text is a valid shape.
+ */
+bool parse_shape(const char *text, Shape &out);
+
+/**
+ * @brief Writes @p shape as letters ("DR").
+ *
+ * @param out Buffer of at least kMaxSegments + 1 chars; empty for no shape.
+ */
+void format_shape(Shape shape, char *out);
+
+/// @brief Resampled, centred, unit-length stroke (structure of arrays).
+struct alignas(32) Vector {
+    float x[kSamples];  ///< Sample x coordinates.
+    float y[kSamples];  ///< Sample y coordinates.
+};
+
+/**
+ * @brief Resamples a recorded stroke into a @ref Vector.
+ *
+ * @param xs, ys Recorded positions (screen pixels), in order.
+ * @param n      Number of positions.
+ * @return false if the stroke has no length (fewer than two distinct points).
+ */
+bool normalize(const std::int32_t *xs, const std::int32_t *ys, int n, Vector &out);
+
+/** Builds the template vector of @p shape (false for an empty shape). */
+bool shape_vector(Shape shape, Vector &out);
+
+/**
+ * @brief Similarity of two vectors after the best rotation within
+ *        @ref kMaxRotation.
+ *
+ * @return Cosine similarity in [-1, 1]; 1 for identical strokes.
+ */
+float similarity(const Vector &a, const Vector &b);
+
+/// @brief Best template for a stroke.
+struct Match {
+    int index = -1;      ///< Template index, or -1 if the library is empty.
+    float score = -1.f;  ///< @ref similarity to that template.
+};
+
+/**
+ * @brief Fixed-capacity template library.
+ *
+ * Templates are stored in blocks of @c kBlock, interleaved by sample:
+ * sample @c i of template @c t is at
+ * <tt>(t / kBlock) * kSamples * kBlock + i * kBlock + t % kBlock</tt>, so
+ * @ref best scores a whole block with one vector multiply-add per sample.
+ */
+class Library {
+ public:
+    /** Removes every template. */
+    void clear() { count_ = 0; }
+
+    /**
+     * @brief Appends a template.
+     *
+     * @return Its index, or -1 if the library is full.
+     */
+    int add(const Vector &v);
+
+    /** Number of templates. */
+    int size() const { return count_; }
+
+    /** Best-scoring template for @p v. */
+    Match best(const Vector &v) const;
+
+ private:
+    alignas(32) float x_[kMaxTemplates * kSamples] = {};
+    alignas(32) float y_[kMaxTemplates * kSamples] = {};
+    int count_ = 0;
+};
+
+}  // namespace stroke
+
+}  // namespace arc
@@ -0,0 +1,137 @@
+/**
+ * @file timer_wheel.h
+ * @brief Hierarchical timer wheel driven by an external millisecond clock.
+ *
+ * Holds the deadlines of the gesture logic (long-press resolution and later
+ * recognizers) for the hook worker thread. The wheel never reads a clock:
+ * the owner calls @ref arc::timer::Wheel::advance with the current time,
+ * typically from one OS timer armed at @ref arc::timer::Wheel::next_deadline.
+ * Tests and replays drive it from a virtual clock.
+ *
+ * Layout: 6 levels of 64 slots. Level @c n slots span 64^n ms, so the wheel
+ * places timers up to about a year ahead (farther ones are re-parked as time
+ * passes); a timer's level is chosen from the highest bit in which its
+ * deadline differs from the current time, and it cascades to lower levels as
+ * the clock approaches it. Schedule and cancel are O(1);
+ * advancing costs O(levels) per expiring slot, regardless of idle gaps.
+ * Timer nodes come from a pool sized at construction, so the wheel never
+ * allocates afterwards.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace arc { namespace timer {
+
+/// Opaque timer handle; 0 is never a valid id.
+using TimerId = std::uint64_t;
+
+/// Timer callback: receives the context given to @ref Wheel::schedule and the current time.
+using Callback = void (*)(void *ctx, std::uint64_t now_ms);
+
+/// Returned by @ref Wheel::next_deadline when nothing is scheduled.
+constexpr std::uint64_t kNever = ~std::uint64_t{0};
+
+/**
+ * @brief Hierarchical hashed timer wheel.
+ *
+ * Not thread-safe; owned by one thread. Callbacks run inside @ref advance
+ * and may schedule or cancel timers (including ones due in the same call).
+ */
+class Wheel {
+ public:
+    static constexpr unsigned kLevels = 6;      ///< Number of wheel levels.
+    static constexpr unsigned kSlotBits = 6;    ///< log2 of slots per level.
+    static constexpr unsigned kSlots = 1u << kSlotBits;  ///< Slots per level.
+
+    /**
+     * @param capacity Maximum number of simultaneously scheduled timers.
+     * @param now_ms   Initial clock value.
+     */
+    explicit Wheel(std::size_t capacity = 64, std::uint64_t now_ms = 0);
+
+    /**
+     * @brief Schedules @p cb to run once the clock reaches @p deadline_ms.
+     *
+     * Deadlines in the past fire on the next @ref advance.
+     *
+     * @return Timer id, or 0 if the pool is exhausted.
+     */
+    TimerId schedule(std::uint64_t deadline_ms, Callback cb, void *ctx);
+
+    /**
+     * @brief Cancels a pending timer.
+     *
+     * @return true if the timer was pending (it will not fire); false if it
+     *         already fired, was cancelled, or @p id is invalid.
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief Moves the clock to @p now_ms and fires every timer due by then.
+     *
+     * Timers fire in deadline order. A clock that goes backwards is ignored.
+     *
+     * @return Number of callbacks invoked.
+     */
+    std::size_t advance(std::uint64_t now_ms);
+
+    /**
+     * @brief Earliest time @ref advance needs to be called.
+     *
+     * Exact for timers in the lowest level; for farther timers it is the
+     * start of their slot, where they cascade closer (calling @ref advance
+     * then fires nothing but keeps the wheel exact).
+     *
+     * @return Time in ms, or @ref kNever if no timer is pending.
+     */
+    std::uint64_t next_deadline() const;
+
+    /** Current clock value (last @ref advance, or the initial value). */
+    std::uint64_t now() const { return now_; }
+
+    /** Number of pending timers. */
+    std::size_t size() const { return size_; }
+
+ private:
+    static constexpr std::uint32_t kNil = ~std::uint32_t{0};
+    static constexpr std::uint8_t kFree = 0xFF;     ///< Node is on the free list.
+    static constexpr std::uint8_t kFiring = 0xFE;   ///< Node is on the due list.
+
+    struct Node {
+        std::uint64_t deadline = 0;
+        Callback cb = nullptr;
+        void *ctx = nullptr;
+        std::uint32_t prev = kNil;
+        std::uint32_t next = kNil;
+        std::uint32_t generation = 1;
+        std::uint8_t level = kFree;
+        std::uint8_t slot = 0;
+    };
+
+    struct Expiration {
+        unsigned level;
+        unsigned slot;
+        std::uint64_t deadline;
+    };
+
+    std::uint32_t &head_of(const Node &n);
+    void link(std::uint32_t idx);
+    void unlink(std::uint32_t idx);
+    void release(std::uint32_t idx);
+    bool next_expiration(Expiration &out) const;
+
+    std::vector<Node> nodes_;
+    std::uint32_t free_ = kNil;                  ///< Free list (singly linked through next).
+    std::uint32_t heads_[kLevels][kSlots];       ///< Per-slot list heads.
+    std::uint64_t occupied_[kLevels] = {};       ///< Bit per non-empty slot.
+    std::uint32_t due_ = kNil;                   ///< Timers detached for firing in advance().
+    std::uint64_t now_ = 0;
+    std::size_t size_ = 0;
+};
+
+}  // namespace timer
+
+}  // namespace arc
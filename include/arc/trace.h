@@ -0,0 +1,309 @@
+/**
+ * @file trace.h
+ * @brief Compact binary input traces: encoder, background recorder, reader.
+ *
+ * A trace captures every event the hook fed to the gesture engine together
+ * with the engine's decision, plus the engine settings and long-press timer
+ * resolutions, so a user's session can be replayed deterministically on
+ * any host (see the arc-replay tool) and the decisions diffed against the
+ * current engine.
+ *
+ * File layout (all integers little-endian):
+ * - Header (16 bytes): magic "ARCTRACE", u16 version, u16 header size,
+ *   u32 reserved.
+ * - Blocks: u32 payload size, u32 records dropped right before the block,
+ *   payload. Delta state restarts in every block, so a block decodes on
+ *   its own and dropped records never corrupt the ones that follow.
+ * - Records: one tag byte (kind, button, swallow bit, modifiers-changed
+ *   bit), varint time delta, then per kind: zigzag varint position deltas
+ *   and optional modifiers for events; the engine settings for settings
+ *   records (the binding table as a row-presence byte plus 8 bytes of
+ *   packed 4-bit cells per bound button, then the recognizer windows and
+ *   actions, then the stroke rules at two bytes each). Events and timers end with the decision (injection count and
+ *   one byte per injection). A mouse move with no decision takes about
+ *   5 bytes.
+ *
+ * The @ref arc::trace::Writer never blocks the producer: records are
+ * encoded into pre-allocated blocks that a background thread writes out;
+ * if every block is in flight, records are dropped and counted.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arc/gesture.h"
+#include "arc/spsc_ring.h"
+
+namespace arc { namespace trace {
+
+constexpr std::uint16_t kVersion = 7;             ///< Format version (2: settings carry predict_ms, 3: flags, 4: bindings, 5: recognizers, 6: strokes, 7: dwell).
+constexpr std::size_t kHeaderBytes = 16;          ///< File header size.
+constexpr std::size_t kBlockHeaderBytes = 8;      ///< Per-block header size.
+constexpr std::size_t kMaxRecordBytes = 256;      ///< Upper bound of one encoded record (settings with bindings and strokes).
+
+/// @brief What a record describes.
+enum class Kind : std::uint8_t {
+    Event,     ///< An input event and the engine's decision.
+    Timer,     ///< An engine deadline resolved by the timer (at event.time_ms) and its decision.
+    Settings   ///< The engine settings in effect from here on.
+};
+
+/// @brief One trace record.
+struct Record {
+    Kind kind = Kind::Event;                 ///< Record kind.
+    arc::gesture::Event event;               ///< Event (Kind::Event); only time_ms for other kinds.
+    arc::gesture::Decision decision;         ///< Decision (Kind::Event, Kind::Timer).
+    arc::gesture::Settings settings;         ///< Settings (Kind::Settings).
+};
+
+/**
+ * @brief Delta encoder for records.
+ *
+ * Keeps the previous timestamp, position and modifiers; @ref reset starts a
+ * new block.
+ */
+class Encoder {
+ public:
+    /**
+     * @brief Encodes @p r into @p out.
+     *
+     * @param out Buffer with at least @ref kMaxRecordBytes free bytes.
+     * @return Number of bytes written.
+     */
+    std::size_t encode(const Record &r, std::uint8_t *out);
+
+    /** Forgets the delta state (start of a block). */
+    void reset() { *this = Encoder{}; }
+
+ private:
+    std::uint32_t time_ = 0;
+    std::int32_t x_ = 0;
+    std::int32_t y_ = 0;
+    std::uint32_t mods_ = 0;
+};
+
+/** @brief Decoder matching @ref Encoder. */
+class Decoder {
+ public:
+    /** @param version Format version of the trace being decoded. */
+    explicit Decoder(std::uint16_t version = kVersion) : version_(version) {}
+
+    /**
+     * @brief Decodes the record at @p p.
+     *
+     * @param p   In: record start; out: past the record on success.
+     * @param end End of the block payload.
+     * @param out Receives the record.
+     * @return false if the payload is truncated or malformed.
+     */
+    bool decode(const std::uint8_t *&p, const std::uint8_t *end, Record &out);
+
+    /** Forgets the delta state (start of a block). */
+    void reset() { *this = Decoder{version_}; }
+
+ private:
+    std::uint16_t version_;
+    std::uint32_t time_ = 0;
+    std::int32_t x_ = 0;
+    std::int32_t y_ = 0;
+    std::uint32_t mods_ = 0;
+};
+
+/**
+ * @brief Append-only trace file recorder with a background flush thread.
+ *
+ * One producer thread calls @ref append; it only encodes into the current
+ * block and, when the block is full, hands it to the flush thread through a
+ * lock-free ring. Blocks return through a second ring, so after @ref open
+ * nothing allocates and the producer never waits on disk I/O.
+ */
+class Writer {
+ public:
+    static constexpr std::size_t kMaxBlocks = 64;  ///< Upper bound for the block count.
+
+    /**
+     * @param block_bytes Payload bytes per block (at least 256).
+     * @param blocks      Number of pre-allocated blocks (2..@ref kMaxBlocks).
+     */
+    explicit Writer(std::size_t block_bytes = 64 * 1024, std::size_t blocks = 16);
+    ~Writer();
+
+    Writer(const Writer &) = delete;
+    Writer &operator=(const Writer &) = delete;
+
+    /**
+     * @brief Creates (truncates) @p path, writes the header and starts the flush thread.
+     *
+     * @return false if the file cannot be created or a trace is already open.
+     */
+    bool open(const std::string &path);
+
+    /** Returns true between a successful @ref open and @ref close. */
+    bool is_open() const { return file_ != nullptr; }
+
+    /** Producer: appends a record; drops it if every block is in flight. */
+    void append(const Record &r);
+
+    /** Flushes the partial block, stops the flush thread and closes the file. */
+    void close();
+
+    /** Records accepted so far. */
+    std::uint64_t records() const { return records_.load(std::memory_order_relaxed); }
+
+    /** Records dropped because the flush thread fell behind. */
+    std::uint64_t dropped() const { return dropped_total_.load(std::memory_order_relaxed); }
+
+    /** Bytes written to the file so far (header and blocks). */
+    std::uint64_t bytes_written() const { return bytes_written_.load(std::memory_order_relaxed); }
+
+ private:
+    struct Block {
+        std::uint32_t index;    ///< Block number in storage_.
+        std::uint32_t size;     ///< Payload bytes used.
+        std::uint32_t dropped;  ///< Records dropped before this block.
+    };
+
+    bool acquire_block();
+    void submit_block();
+    void flush_loop();
+
+    std::size_t block_bytes_;
+    std::size_t block_count_;
+    std::vector<std::uint8_t> storage_;                 ///< block_count_ * block_bytes_ bytes.
+    arc::queue::SpscRing<Block, kMaxBlocks> full_;      ///< Producer -> flush thread.
+    arc::queue::SpscRing<std::uint32_t, kMaxBlocks> free_;  ///< Flush thread -> producer.
+
+    // Producer state
+    Encoder encoder_;
+    bool have_block_ = false;
+    Block current_{0, 0, 0};
+    std::uint32_t pending_dropped_ = 0;
+
+    std::FILE *file_ = nullptr;
+    std::thread flusher_;
+    std::mutex wake_mu_;
+    std::condition_variable wake_;
+    std::atomic<bool> stop_{false};
+    std::atomic<std::uint64_t> records_{0};
+    std::atomic<std::uint64_t> dropped_total_{0};
+    std::atomic<std::uint64_t> bytes_written_{0};
+};
+
+/**
+ * @brief Sequential trace file reader.
+ *
+ * Loads the whole file; traces are a few MB per hour of input.
+ */
+class Reader {
+ public:
+    /**
+     * @brief Loads and validates @p path.
+     *
+     * @param error Receives a description on failure (optional).
+     * @return false if the file is missing, not a trace, or of a newer version.
+     */
+    bool open(const std::string &path, std::string *error = nullptr);
+
+    /**
+     * @brief Reads the next record.
+     *
+     * @return false at the end of the trace or on a corrupt block (see @ref corrupt).
+     */
+    bool next(Record &out);
+
+    /** Records the writer dropped, summed over the blocks read so far. */
+    std::uint64_t dropped() const { return dropped_; }
+
+    /** Returns true if reading stopped at a malformed or truncated block. */
+    bool corrupt() const { return corrupt_; }
+
+ private:
+    bool enter_block();
+
+    std::vector<std::uint8_t> data_;
+    std::size_t pos_ = 0;                ///< Next block header.
+    const std::uint8_t *cur_ = nullptr;  ///< Next record in the current block.
+    const std::uint8_t *end_ = nullptr;  ///< End of the current block payload.
+    Decoder decoder_;
+    std::uint64_t dropped_ = 0;
+    bool corrupt_ = false;
+};
+
+/** Returns true if two decisions are identical (verdict and injections). */
+bool same_decision(const arc::gesture::Decision &a, const arc::gesture::Decision &b);
+
+/// @brief A decision that differs between the recording and the replay.
+struct Diff {
+    std::uint64_t index = 0;            ///< Index of the record being replayed.
+    Kind kind = Kind::Event;            ///< Event decision or timer resolution.
+    arc::gesture::Event event;          ///< The event (Kind::Event) or the timer time (time_ms).
+    arc::gesture::Decision recorded;    ///< Decision in the trace (empty: no timer fired there).
+    arc::gesture::Decision replayed;    ///< Decision of the replayed engine (empty: no timer fired).
+};
+
+/**
+ * @brief Feeds a trace through a fresh gesture engine and reports diffs.
+ *
+ * Settings records reconfigure the engine (after the optional filter, which
+ * lets a replay try other thresholds). The replayed engine resolves its own
+ * long-press deadlines from the record timestamps, so a timer that fires in
+ * one run but not the other shows up as a timer diff.
+ */
+class Replayer {
+ public:
+    /// Adjusts recorded settings before they are applied.
+    using SettingsFn = void (*)(arc::gesture::Settings &s, void *ctx);
+    /// Receives each diff.
+    using DiffFn = void (*)(const Diff &d, void *ctx);
+
+    /**
+     * @param on_diff  Diff sink (optional).
+     * @param ctx      Passed to @p on_diff.
+     * @param filter   Settings filter (optional).
+     * @param fctx     Passed to @p filter.
+     */
+    explicit Replayer(DiffFn on_diff = nullptr, void *ctx = nullptr, SettingsFn filter = nullptr,
+                      void *fctx = nullptr)
+        : on_diff_(on_diff), ctx_(ctx), filter_(filter), fctx_(fctx) {}
+
+    /** Replays one record. */
+    void feed(const Record &r);
+
+    /** Reports the replayed engine's bound presses to @p usage (see arc::gesture::Engine::observe). */
+    void observe(arc::tuning::Usage *usage) { engine_.observe(usage); }
+
+    /** Settings the replayed engine currently runs with (after the filter). */
+    const arc::gesture::Settings &settings() const { return engine_.settings(); }
+
+    std::uint64_t records() const { return records_; }  ///< Records fed.
+    std::uint64_t events() const { return events_; }    ///< Event records fed.
+    std::uint64_t timers() const { return timers_; }    ///< Timer resolutions, recorded or replayed.
+    std::uint64_t diffs() const { return diffs_; }      ///< Diffs reported.
+
+ private:
+    void report(Kind kind, const arc::gesture::Event &ev, const arc::gesture::Decision &recorded,
+                const arc::gesture::Decision &replayed);
+    void fire_due(std::uint32_t now_ms);
+
+    arc::gesture::Engine engine_;
+    DiffFn on_diff_;
+    void *ctx_;
+    SettingsFn filter_;
+    void *fctx_;
+    std::uint64_t records_ = 0;
+    std::uint64_t events_ = 0;
+    std::uint64_t timers_ = 0;
+    std::uint64_t diffs_ = 0;
+};
+
+}  // namespace trace
+
+}  // namespace arc
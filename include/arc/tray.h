@@ -12,6 +12,7 @@
 #include <string>
 #include <atomic>
 #include <filesystem>
+#include <mutex>
 
 namespace arc { namespace config { struct Config; } }
 namespace arc { namespace tray {
@@ -20,6 +21,8 @@ namespace arc { namespace tray {
  * @brief Live context passed to the tray worker.
  *
  * Holds references to lifetime-managed state owned by the main controller.
+ * The tray thread, the config watcher and the auto-tuner all read and write
+ * @ref cfg, so every access holds @ref cfg_mutex.
  */
 struct TrayContext {
     /** Active runtime configuration to reflect and mutate from the tray. */
@@ -28,6 +31,8 @@ struct TrayContext {
     const std::filesystem::path &config_path;
     /** Stop signal; set to true when user clicks Exit in the tray. */
     std::atomic<bool> &exit_requested;
+    /** Guards @ref cfg across the tray, watcher and controller threads. */
+    std::mutex &cfg_mutex;
 };
 
 /**
@@ -0,0 +1,168 @@
+/**
+ * @file tuning.h
+ * @brief Usage histograms of bound presses and click-threshold auto-tuning.
+ *
+ * The gesture engine can report every bound press it resolves to a
+ * @ref arc::tuning::Usage: how long the button was held and how far the
+ * pointer travelled from the press point. Quick still presses (clicks) and
+ * presses that travel (drags) or are held (native long presses) form
+ * separate clusters in these histograms; @ref arc::tuning::suggest finds
+ * the gap between them and proposes a @c click_time_ms and
+ * @c move_radius_px that fall inside it.
+ *
+ * Recording is two relaxed atomic increments into fixed linear buckets, so
+ * it runs in the hook callback without locks or allocation while another
+ * thread reads the histograms. Nothing here depends on the platform: the
+ * same code tunes from a live hook or from a recorded trace replayed with
+ * arc::trace::Replayer.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace arc { namespace tuning {
+
+constexpr std::uint32_t kDurationStepMs = 10;  ///< Width of a press-duration bucket.
+constexpr int kDurationBuckets = 128;          ///< Duration buckets; the last also counts longer presses.
+constexpr int kTravelBuckets = 64;             ///< Travel buckets, one pixel each.
+constexpr std::uint32_t kTravelCapPx = kTravelBuckets - 1;  ///< Travel counted in the last bucket (and beyond).
+
+constexpr std::uint32_t kMinClickTimeMs = 100;   ///< Lowest click time suggested.
+constexpr std::uint32_t kMaxClickTimeMs = 1000;  ///< Highest click time suggested.
+constexpr std::int32_t kMinRadiusPx = 2;         ///< Lowest move radius suggested.
+constexpr std::int32_t kMaxRadiusPx = 32;        ///< Highest move radius suggested.
+constexpr std::uint64_t kMinSamples = 40;        ///< Presses a histogram needs before it is used.
+
+/**
+ * @brief Fixed linear histogram with relaxed atomic counters.
+ *
+ * One writer and any number of readers; readers may see a sample counted
+ * in one bucket before the next one, which is harmless for tuning.
+ */
+template <int N>
+class Counts {
+ public:
+    static constexpr int kBuckets = N;  ///< Number of buckets.
+
+    /** Counts one sample in bucket @p b (clamped to the last bucket). */
+    void add(std::uint32_t b) { buckets_[b < N ? b : N - 1].fetch_add(1, std::memory_order_relaxed); }
+
+    /** Samples in bucket @p b. */
+    std::uint32_t at(int b) const { return buckets_[b].load(std::memory_order_relaxed); }
+
+    /** Samples in all buckets. */
+    std::uint64_t total() const {
+        std::uint64_t n = 0;
+        for (const auto &c : buckets_)
+            n += c.load(std::memory_order_relaxed);
+        return n;
+    }
+
+    /** Halves every bucket, so older samples weigh less than new ones. */
+    void halve() {
+        for (auto &c : buckets_)
+            c.fetch_sub(c.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+    }
+
+    /** Clears every bucket. */
+    void reset() {
+        for (auto &c : buckets_)
+            c.store(0, std::memory_order_relaxed);
+    }
+
+ private:
+    std::atomic<std::uint32_t> buckets_[N] = {};
+};
+
+/// @brief Press durations and travel of bound presses.
+class Usage {
+ public:
+    /**
+     * @brief Records one bound press, at its release.
+     *
+     * Lock-free and allocation-free; called from the hook thread.
+     *
+     * @param duration_ms Time from the press to the release.
+     * @param travel_px   Largest distance from the press point, in whole
+     *                    pixels (values from @ref kTravelCapPx up share the
+     *                    last bucket).
+     * @param still       The press stayed within the move radius in effect;
+     *                    only still presses count towards the durations, as
+     *                    the click time only decides between their outcomes.
+     */
+    void record(std::uint32_t duration_ms, std::uint32_t travel_px, bool still) {
+        travel.add(travel_px);
+        if (still)
+            durations.add(duration_ms / kDurationStepMs);
+    }
+
+    /**
+     * @brief Halves both histograms once either holds more than @p keep samples.
+     *
+     * Called periodically by the tuner so the suggestion follows recent use.
+     */
+    void age(std::uint64_t keep) {
+        if (travel.total() > keep || durations.total() > keep) {
+            travel.halve();
+            durations.halve();
+        }
+    }
+
+    /** Clears both histograms. */
+    void reset() {
+        travel.reset();
+        durations.reset();
+    }
+
+    Counts<kDurationBuckets> durations;  ///< Still presses by duration, kDurationStepMs per bucket.
+    Counts<kTravelBuckets> travel;       ///< All presses by travel, one pixel per bucket.
+};
+
+/// @brief Click thresholds being tuned.
+struct Thresholds {
+    std::uint32_t click_time_ms = 250;  ///< See arc::gesture::Settings::click_time_ms.
+    std::int32_t move_radius_px = 6;    ///< See arc::gesture::Settings::move_radius_px.
+};
+
+/// @brief Gap between the two populations of a histogram.
+struct Split {
+    bool found = false;  ///< The histogram is clearly bimodal with a gap.
+    int low = 0;         ///< Highest bucket of the lower population (its 99th percentile).
+    int high = 0;        ///< Lowest bucket of the upper population (its 1st percentile).
+};
+
+/**
+ * @brief Splits a histogram into two populations.
+ *
+ * Otsu's threshold (the cut maximizing the between-class variance) divides
+ * the buckets; the split holds when there are at least @ref kMinSamples
+ * samples, each side has at least 5% of them, the cut explains at least 80%
+ * of the variance (a single bell curve reaches about 64%), and the 99th
+ * percentile of the lower side lies at least two buckets below the 1st
+ * percentile of the upper side.
+ *
+ * @param counts  Bucket counts.
+ * @param buckets Number of buckets.
+ */
+Split split(const std::uint32_t *counts, int buckets);
+
+/**
+ * @brief Thresholds separating the clicks in @p usage from drags and holds.
+ *
+ * For each histogram that splits (see @ref split), the target threshold
+ * lies in the gap: 1.5 times the clicks' travel (at most the middle of the
+ * gap) for the radius, the middle of the gap for the click time, clamped
+ * to the kMin / kMax bounds above. The result moves half way from
+ * @p current towards it (the whole way once it is one step away), so a
+ * burst of unusual presses cannot swing the thresholds at once. A
+ * histogram that does not split leaves its threshold as it is.
+ */
+Thresholds suggest(const Usage &usage, const Thresholds &current);
+
+/** Whole pixels of a squared distance (floor of the root), capped at @ref kTravelCapPx. */
+std::uint32_t travel_px(std::int64_t dist_sq);
+
+}  // namespace tuning
+
+}  // namespace arc
@@ -0,0 +1,217 @@
+/**
+ * @file arc_replay.cpp
+ * @brief Replays a recorded input trace through the gesture engine.
+ *
+ * Reads a trace written by `altrightclick --record-trace <file>`, feeds every
+ * event through a fresh arc::gesture::Engine as fast as the host allows, and
+ * prints each decision that differs from the recorded one. Thresholds can be
+ * overridden to see how a user's session would classify under other
+ * settings. With --tune, the bound presses of the session also feed the
+ * auto-tune histograms (arc/tuning.h) and the thresholds auto_tune would
+ * settle on are printed. Portable: builds and runs on any host with the core
+ * library.
+ *
+ * Usage:
+ *   arc-replay <trace> [--click-time-ms N] [--move-radius-px N] [--predict-ms N] [--speculative 0|1]
+ *              [--max-diffs N] [--quiet] [--tune]
+ *
+ * Exit status: 0 if the replay matches the recording, 1 if decisions
+ * differ, 2 on usage or file errors.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "arc/trace.h"
+#include "arc/tuning.h"
+
+namespace {
+
+/** Command-line threshold overrides; negative means "as recorded". */
+struct Overrides {
+    long click_time_ms = -1;
+    long move_radius_px = -1;
+    long predict_ms = -1;
+    long speculative = -1;
+};
+
+/** Output options for the diff sink. */
+struct Output {
+    unsigned long max_diffs = 20;
+    unsigned long printed = 0;
+    bool quiet = false;
+};
+
+const char *type_name(arc::gesture::EventType t) {
+    switch (t) {
+    case arc::gesture::EventType::Move:
+        return "move";
+    case arc::gesture::EventType::Down:
+        return "down";
+    case arc::gesture::EventType::Up:
+        return "up";
+    case arc::gesture::EventType::Other:
+        return "other";
+    }
+    return "?";
+}
+
+const char *button_name(arc::gesture::Button b) {
+    static const char *names[] = {"-", "L", "R", "M", "X1", "X2"};
+    auto i = static_cast<unsigned>(b);
+    return i < sizeof(names) / sizeof(names[0]) ? names[i] : "?";
+}
+
+/** Formats a decision as e.g. "swallow [R+ R-]". */
+std::string describe(const arc::gesture::Decision &d) {
+    std::string s = d.verdict == arc::gesture::Verdict::Swallow ? "swallow [" : "pass [";
+    for (int i = 0; i < d.count; ++i) {
+        if (i)
+            s += ' ';
+        s += button_name(d.inject[i].button);
+        s += d.inject[i].down ? '+' : '-';
+    }
+    return s + "]";
+}
+
+void apply_overrides(arc::gesture::Settings &s, void *ctx) {
+    const auto *o = static_cast<const Overrides *>(ctx);
+    if (o->click_time_ms >= 0)
+        s.click_time_ms = static_cast<std::uint32_t>(o->click_time_ms);
+    if (o->move_radius_px >= 0)
+        s.move_radius_px = static_cast<std::int32_t>(o->move_radius_px);
+    if (o->predict_ms >= 0)
+        s.predict_ms = static_cast<std::uint32_t>(o->predict_ms);
+    if (o->speculative >= 0)
+        s.speculative = o->speculative != 0;
+}
+
+void print_diff(const arc::trace::Diff &d, void *ctx) {
+    auto *out = static_cast<Output *>(ctx);
+    if (out->quiet || out->printed >= out->max_diffs)
+        return;
+    ++out->printed;
+    if (d.kind == arc::trace::Kind::Timer) {
+        std::printf("#%llu t=%u timer: recorded %s, replayed %s\n", static_cast<unsigned long long>(d.index),
+                    d.event.time_ms, d.recorded.count ? describe(d.recorded).c_str() : "none",
+                    d.replayed.count ? describe(d.replayed).c_str() : "none");
+        return;
+    }
+    std::printf("#%llu t=%u %s %s (%d,%d) mods=0x%x: recorded %s, replayed %s\n",
+                static_cast<unsigned long long>(d.index), d.event.time_ms, type_name(d.event.type),
+                button_name(d.event.button), d.event.x, d.event.y, d.event.mods, describe(d.recorded).c_str(),
+                describe(d.replayed).c_str());
+}
+
+void usage() {
+    std::fprintf(stderr,
+                 "Usage: arc-replay <trace> [options]\n"
+                 "\nOptions:\n"
+                 "  --click-time-ms <n>   Replay with this click time instead of the recorded one\n"
+                 "  --move-radius-px <n>  Replay with this move radius instead of the recorded one\n"
+                 "  --predict-ms <n>      Replay with this drag prediction horizon (0: off)\n"
+                 "  --speculative <0|1>   Replay with the speculative click off or on\n"
+                 "  --max-diffs <n>       Print at most n diffs (default: 20)\n"
+                 "  --quiet               Print the summary only\n"
+                 "  --tune                Print the click thresholds auto_tune learns from the trace\n");
+}
+
+bool parse_number(const char *s, long &out) {
+    char *end = nullptr;
+    long v = std::strtol(s, &end, 10);
+    if (!end || *end || v < 0)
+        return false;
+    out = v;
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string path;
+    Overrides ov;
+    Output out;
+    bool tune = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        long v = 0;
+        if (a == "--click-time-ms" && i + 1 < argc && parse_number(argv[i + 1], v)) {
+            ov.click_time_ms = v;
+            ++i;
+        } else if (a == "--move-radius-px" && i + 1 < argc && parse_number(argv[i + 1], v)) {
+            ov.move_radius_px = v;
+            ++i;
+        } else if (a == "--predict-ms" && i + 1 < argc && parse_number(argv[i + 1], v)) {
+            ov.predict_ms = v;
+            ++i;
+        } else if (a == "--speculative" && i + 1 < argc && parse_number(argv[i + 1], v) && v <= 1) {
+            ov.speculative = v;
+            ++i;
+        } else if (a == "--max-diffs" && i + 1 < argc && parse_number(argv[i + 1], v)) {
+            out.max_diffs = static_cast<unsigned long>(v);
+            ++i;
+        } else if (a == "--quiet") {
+            out.quiet = true;
+        } else if (a == "--tune") {
+            tune = true;
+        } else if (a == "--help" || a == "-h") {
+            usage();
+            return 0;
+        } else if (path.empty() && a.compare(0, 2, "--") != 0) {
+            path = a;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (path.empty()) {
+        usage();
+        return 2;
+    }
+
+    arc::trace::Reader reader;
+    std::string error;
+    if (!reader.open(path, &error)) {
+        std::fprintf(stderr, "arc-replay: %s: %s\n", path.c_str(), error.c_str());
+        return 2;
+    }
+    arc::trace::Replayer replayer(print_diff, &out, apply_overrides, &ov);
+    arc::tuning::Usage usage;
+    if (tune)
+        replayer.observe(&usage);
+    arc::trace::Record r;
+    auto t0 = std::chrono::steady_clock::now();
+    while (reader.next(r))
+        replayer.feed(r);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    if (reader.corrupt())
+        std::fprintf(stderr, "arc-replay: trace truncated or corrupt after %llu records\n",
+                     static_cast<unsigned long long>(replayer.records()));
+    if (replayer.diffs() > out.printed && !out.quiet)
+        std::printf("... %llu more diffs\n", static_cast<unsigned long long>(replayer.diffs() - out.printed));
+    std::printf("records=%llu events=%llu timers=%llu dropped=%llu diffs=%llu time=%.3fs rate=%.0f events/s\n",
+                static_cast<unsigned long long>(replayer.records()), static_cast<unsigned long long>(replayer.events()),
+                static_cast<unsigned long long>(replayer.timers()), static_cast<unsigned long long>(reader.dropped()),
+                static_cast<unsigned long long>(replayer.diffs()), secs,
+                secs > 0 ? static_cast<double>(replayer.events()) / secs : 0.0);
+    if (tune) {
+        // Run the tuner until it settles, as the live one would over several rounds
+        arc::tuning::Thresholds cur{replayer.settings().click_time_ms, replayer.settings().move_radius_px};
+        arc::tuning::Thresholds next = cur;
+        for (int round = 0; round < 32; ++round) {
+            arc::tuning::Thresholds step = arc::tuning::suggest(usage, next);
+            if (step.click_time_ms == next.click_time_ms && step.move_radius_px == next.move_radius_px)
+                break;
+            next = step;
+        }
+        std::printf("tune: presses=%llu still=%llu click_time_ms %u -> %u, move_radius_px %d -> %d\n",
+                    static_cast<unsigned long long>(usage.travel.total()),
+                    static_cast<unsigned long long>(usage.durations.total()), cur.click_time_ms, next.click_time_ms,
+                    cur.move_radius_px, next.move_radius_px);
+    }
+    return replayer.diffs() ? 1 : 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file arming.cpp
+ * @brief Armed-mode state machine for the on-demand mouse hook.
+ */
+
+#include "arc/arming.h"
+
+namespace arc::arming {
+
+/** Applies new settings; held/tracking state is kept. */
+void Controller::configure(std::uint32_t required_mods, std::uint32_t grace_ms) {
+    // Every held mask containing the required bits arms
+    std::uint16_t sets = 0;
+    for (std::uint32_t m = 0; m < 16; ++m)
+        if ((m & required_mods) == required_mods)
+            sets = static_cast<std::uint16_t>(sets | (1u << m));
+    configure_sets(required_mods > 15 ? std::uint16_t{0} : sets, grace_ms);
+}
+
+/** Applies new settings; held/tracking state is kept. */
+void Controller::configure_sets(std::uint16_t sets, std::uint32_t grace_ms) {
+    sets_ = sets;
+    grace_ms_ = grace_ms;
+}
+
+/** Starts the grace period when the combo goes from held to released. */
+void Controller::on_modifiers(std::uint32_t held, std::uint32_t now_ms) {
+    bool combo = (sets_ & 1u) == 0 && ((sets_ >> (held & 15u)) & 1u) != 0;
+    if (combo_ && !combo) {
+        lingering_ = true;
+        since_ = now_ms;
+    }
+    combo_ = combo;
+}
+
+/** Starts the grace period when a gesture in flight ends. */
+void Controller::on_tracking(bool tracking, std::uint32_t now_ms) {
+    if (tracking_ && !tracking) {
+        lingering_ = true;
+        since_ = now_ms;
+    }
+    tracking_ = tracking;
+}
+
+/** Held combo or gesture in flight pins the hook; otherwise only the grace period. */
+bool Controller::wanted(std::uint32_t now_ms) const {
+    if (pinned())
+        return true;
+    return lingering_ && now_ms - since_ < grace_ms_;
+}
+
+/** Remaining grace, with wrap-safe unsigned arithmetic. */
+std::uint32_t Controller::grace_left(std::uint32_t now_ms) const {
+    if (pinned() || !lingering_)
+        return 0;
+    std::uint32_t elapsed = now_ms - since_;
+    return elapsed < grace_ms_ ? grace_ms_ - elapsed : 0;
+}
+
+/** Clears all state but the configuration. */
+void Controller::reset() {
+    combo_ = false;
+    tracking_ = false;
+    lingering_ = false;
+    since_ = 0;
+}
+
+}  // namespace arc::arming
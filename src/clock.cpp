@@ -0,0 +1,53 @@
+/**
+ * @file clock.cpp
+ * @brief Platform monotonic clock.
+ */
+
+#include "arc/clock.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace arc::clock {
+
+namespace {
+
+std::uint64_t read_monotonic(const void *) { return monotonic_us(); }
+
+#ifdef _WIN32
+/** QueryPerformanceFrequency, fixed at boot. */
+std::uint64_t qpc_frequency() {
+    static const std::uint64_t freq = [] {
+        LARGE_INTEGER f;
+        return QueryPerformanceFrequency(&f) && f.QuadPart > 0 ? static_cast<std::uint64_t>(f.QuadPart)
+                                                                : std::uint64_t{1000000};
+    }();
+    return freq;
+}
+#endif
+
+}  // namespace
+
+/** Reads QPC or CLOCK_MONOTONIC and scales to microseconds. */
+std::uint64_t monotonic_us() {
+#ifdef _WIN32
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    std::uint64_t ticks = static_cast<std::uint64_t>(t.QuadPart);
+    std::uint64_t freq = qpc_frequency();
+    // Split to avoid overflowing ticks * 1e6 after long uptimes
+    return (ticks / freq) * 1000000 + (ticks % freq) * 1000000 / freq;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::uint64_t>(ts.tv_sec) * 1000000 + static_cast<std::uint64_t>(ts.tv_nsec) / 1000;
+#endif
+}
+
+/** Handle to the platform clock; it has no state. */
+Clock monotonic() { return Clock{read_monotonic, nullptr}; }
+
+}  // namespace arc::clock
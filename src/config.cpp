@@ -15,6 +15,8 @@
  */
 
 #include "arc/config.h"
+#include "arc/device.h"
+#include "arc/stroke.h"
 
 #include <windows.h>
 #include <shlobj.h>
@@ -144,6 +146,200 @@ static Config::Trigger trigger_from_str(const std::string &name) {
     return Config::Trigger::Left;
 }
 
+/**
+ * @brief Parse a button name strictly (no default), for binding rules.
+ *
+ * @param name Lowercased button name (left|middle|x1|x2 and their aliases).
+ * @param out  Receives the button on success.
+ * @return true if the name is a known source button.
+ */
+static bool button_from_str(const std::string &name, Config::Trigger *out) {
+    if (name == "left" || name == "l" || name == "lbutton")
+        *out = Config::Trigger::Left;
+    else if (name == "middle" || name == "m" || name == "mbutton")
+        *out = Config::Trigger::Middle;
+    else if (name == "x1" || name == "xbutton1")
+        *out = Config::Trigger::X1;
+    else if (name == "x2" || name == "xbutton2")
+        *out = Config::Trigger::X2;
+    else
+        return false;
+    return true;
+}
+
+/**
+ * @brief Parse an action name strictly.
+ *
+ * @param name Lowercased action (right|left|middle|x1|x2|double).
+ * @param out  Receives the action on success.
+ * @return true if the name is a known action.
+ */
+static bool action_from_str(const std::string &name, Config::Binding::Action *out) {
+    if (name == "right")
+        *out = Config::Binding::Action::Right;
+    else if (name == "left")
+        *out = Config::Binding::Action::Left;
+    else if (name == "middle")
+        *out = Config::Binding::Action::Middle;
+    else if (name == "x1")
+        *out = Config::Binding::Action::X1;
+    else if (name == "x2")
+        *out = Config::Binding::Action::X2;
+    else if (name == "double" || name == "double_left" || name == "doubleclick")
+        *out = Config::Binding::Action::DoubleLeft;
+    else
+        return false;
+    return true;
+}
+
+/** Formats an action the way action_from_str() reads it. */
+static const char *action_to_str(Config::Binding::Action a) {
+    static const char *actions[] = {"RIGHT", "LEFT", "MIDDLE", "X1", "X2", "DOUBLE"};
+    return actions[static_cast<int>(a)];
+}
+
+/**
+ * @brief Parse a binding rule of the form "MOD+MOD+BUTTON -> ACTION".
+ *
+ * The last '+'-separated token before the arrow is the source button, the
+ * others are modifier names as accepted by vk_from_str(). Actions are
+ * RIGHT, LEFT, MIDDLE, X1, X2 and DOUBLE (a double left click).
+ *
+ * @param val Rule text from the config file.
+ * @param out Receives the rule on success.
+ * @return true if the rule is well formed; unknown names reject the rule.
+ */
+static bool parse_binding(const std::string &val, Config::Binding *out) {
+    auto arrow = val.find("->");
+    if (arrow == std::string::npos)
+        return false;
+    std::string lhs = to_lower(trim(val.substr(0, arrow)));
+    std::string act = to_lower(trim(val.substr(arrow + 2)));
+    Config::Binding b;
+    if (!action_from_str(act, &b.action))
+        return false;
+    std::vector<std::string> tokens;
+    std::string tmp;
+    for (size_t i = 0; i <= lhs.size(); ++i) {
+        char c = (i < lhs.size()) ? lhs[i] : '+';
+        if (c == '+') {
+            tokens.push_back(trim(tmp));
+            tmp.clear();
+        } else {
+            tmp.push_back(c);
+        }
+    }
+    if (!button_from_str(tokens.back(), &b.source))
+        return false;
+    for (size_t i = 0; i + 1 < tokens.size(); ++i) {
+        unsigned int vk = vk_from_str(tokens[i]);
+        if (!vk || vk == VK_ESCAPE || vk == VK_F12)
+            return false;
+        b.modifier_vks.push_back(vk);
+    }
+    *out = b;
+    return true;
+}
+
+/**
+ * @brief Parse a stroke rule of the form "SHAPE -> ACTION" (e.g. "DR -> MIDDLE").
+ *
+ * @param val Rule text from the config file.
+ * @param out Receives the rule, with the shape in upper case, on success.
+ * @return true if the shape and the action are valid.
+ */
+static bool parse_stroke(const std::string &val, Config::Stroke *out) {
+    auto arrow = val.find("->");
+    if (arrow == std::string::npos)
+        return false;
+    arc::stroke::Shape shape;
+    Config::Stroke st;
+    if (!arc::stroke::parse_shape(trim(val.substr(0, arrow)).c_str(), shape) ||
+        !action_from_str(to_lower(trim(val.substr(arrow + 2))), &st.action))
+        return false;
+    char text[arc::stroke::kMaxSegments + 1];
+    arc::stroke::format_shape(shape, text);
+    st.shape = text;
+    *out = st;
+    return true;
+}
+
+/**
+ * @brief Parse a device rule of the form "PATTERN -> BUTTONS" (e.g. "*Touchpad* -> LEFT").
+ *
+ * BUTTONS is ALL, NONE, or source buttons joined by '+' or ','. The
+ * pattern is kept as written (matching ignores case); the last arrow
+ * separates it, so the pattern itself may not contain one.
+ *
+ * @param val Rule text from the config file.
+ * @param out Receives the rule on success.
+ * @return true if the pattern fits and every button name is known.
+ */
+static bool parse_device(const std::string &val, Config::DeviceRule *out) {
+    auto arrow = val.rfind("->");
+    if (arrow == std::string::npos)
+        return false;
+    Config::DeviceRule r;
+    r.pattern = trim(val.substr(0, arrow));
+    if (r.pattern.empty() || r.pattern.size() >= static_cast<size_t>(arc::device::kMaxPattern))
+        return false;
+    std::string rhs = to_lower(trim(val.substr(arrow + 2)));
+    if (rhs == "all") {
+        r.buttons = {Config::Trigger::Left, Config::Trigger::Middle, Config::Trigger::X1, Config::Trigger::X2};
+    } else if (rhs != "none") {
+        std::string tmp;
+        for (size_t i = 0; i <= rhs.size(); ++i) {
+            char c = (i < rhs.size()) ? rhs[i] : '+';
+            if (c == '+' || c == ',') {
+                Config::Trigger t;
+                if (!button_from_str(trim(tmp), &t))
+                    return false;
+                if (std::find(r.buttons.begin(), r.buttons.end(), t) == r.buttons.end())
+                    r.buttons.push_back(t);
+                tmp.clear();
+            } else {
+                tmp.push_back(c);
+            }
+        }
+    }
+    *out = r;
+    return true;
+}
+
+/** Formats a device rule the way parse_device() reads it. */
+static std::string device_to_str(const Config::DeviceRule &r) {
+    static const char *buttons[] = {"LEFT", "MIDDLE", "X1", "X2"};
+    std::string s = r.pattern + " -> ";
+    if (r.buttons.empty())
+        return s + "NONE";
+    for (size_t i = 0; i < r.buttons.size(); ++i) {
+        if (i)
+            s += '+';
+        s += buttons[static_cast<int>(r.buttons[i])];
+    }
+    return s;
+}
+
+/** Formats a binding rule the way parse_binding() reads it. */
+static std::string binding_to_str(const Config::Binding &b) {
+    static const char *buttons[] = {"LEFT", "MIDDLE", "X1", "X2"};
+    std::string s;
+    for (unsigned int vk : b.modifier_vks) {
+        if (vk == VK_MENU)
+            s += "ALT+";
+        else if (vk == VK_CONTROL)
+            s += "CTRL+";
+        else if (vk == VK_SHIFT)
+            s += "SHIFT+";
+        else if (vk == VK_LWIN)
+            s += "WIN+";
+    }
+    s += buttons[static_cast<int>(b.source)];
+    s += " -> ";
+    s += action_to_str(b.action);
+    return s;
+}
+
 /**
  * @brief Load configuration from a file path.
  *
@@ -191,6 +387,12 @@ Config load(const std::filesystem::path &path) {
             }
         } else if (key == "trigger") {
             cfg.trigger = trigger_from_str(val);
+        } else if (key == "bind") {
+            Config::Binding b;
+            if (parse_binding(val, &b))
+                cfg.bindings.push_back(b);
+            else
+                ARC_LOG_WARN("Config: ignoring malformed binding '" + val + "'");
         } else if (key == "exit_key") {
             unsigned int vk = vk_from_str(val);
             if (vk)
@@ -211,12 +413,116 @@ Config load(const std::filesystem::path &path) {
                     cfg.move_radius_px = v;
             } catch (...) {
             }
+        } else if (key == "drag_predict_ms") {
+            try {
+                unsigned int v = static_cast<unsigned int>(std::stoul(vall));
+                if (v <= 200)
+                    cfg.drag_predict_ms = v;
+            } catch (...) {
+            }
+        } else if (key == "speculative_click") {
+            cfg.speculative_click = (vall == "1" || vall == "true" || vall == "yes");
+        } else if (key == "auto_tune") {
+            cfg.auto_tune = (vall == "1" || vall == "true" || vall == "yes");
+        } else if (key == "double_click_ms") {
+            try {
+                unsigned int v = static_cast<unsigned int>(std::stoul(vall));
+                if (v <= 1000)
+                    cfg.double_click_ms = v;
+            } catch (...) {
+            }
+        } else if (key == "double_click_action") {
+            action_from_str(vall, &cfg.double_click_action);
+        } else if (key == "long_press_ms") {
+            try {
+                unsigned int v = static_cast<unsigned int>(std::stoul(vall));
+                if (v <= 10000)
+                    cfg.long_press_ms = v;
+            } catch (...) {
+            }
+        } else if (key == "long_press_action") {
+            action_from_str(vall, &cfg.long_press_action);
+        } else if (key == "chord_ms") {
+            try {
+                unsigned int v = static_cast<unsigned int>(std::stoul(vall));
+                if (v <= 500)
+                    cfg.chord_ms = v;
+            } catch (...) {
+            }
+        } else if (key == "chord_button") {
+            Config::Binding::Action b;
+            if (action_from_str(vall, &b) && b != Config::Binding::Action::DoubleLeft)
+                cfg.chord_button = b;
+        } else if (key == "chord_action") {
+            action_from_str(vall, &cfg.chord_action);
+        } else if (key == "dwell_ms") {
+            try {
+                unsigned int v = static_cast<unsigned int>(std::stoul(vall));
+                if (v == 0 || (v >= 100 && v <= 10000))
+                    cfg.dwell_ms = v;
+            } catch (...) {
+            }
+        } else if (key == "dwell_action") {
+            action_from_str(vall, &cfg.dwell_action);
+        } else if (key == "stroke") {
+            Config::Stroke st;
+            if (cfg.strokes.size() >= static_cast<size_t>(arc::stroke::kMaxTemplates))
+                ARC_LOG_WARN("Config: ignoring stroke '" + val + "': too many strokes");
+            else if (parse_stroke(val, &st))
+                cfg.strokes.push_back(st);
+            else
+                ARC_LOG_WARN("Config: ignoring malformed stroke '" + val + "'");
+        } else if (key == "device") {
+            Config::DeviceRule r;
+            if (cfg.devices.size() >= static_cast<size_t>(arc::device::kMaxRules))
+                ARC_LOG_WARN("Config: ignoring device rule '" + val + "': too many device rules");
+            else if (parse_device(val, &r))
+                cfg.devices.push_back(r);
+            else
+                ARC_LOG_WARN("Config: ignoring malformed device rule '" + val + "'");
+        } else if (key == "stroke_min_score") {
+            try {
+                unsigned int v = static_cast<unsigned int>(std::stoul(vall));
+                if (v >= 50 && v <= 100)
+                    cfg.stroke_min_score = v;
+            } catch (...) {
+            }
+        } else if (key == "armed_hook") {
+            cfg.armed_hook = (vall == "1" || vall == "true" || vall == "yes");
+        } else if (key == "arm_grace_ms") {
+            try {
+                unsigned int v = static_cast<unsigned int>(std::stoul(vall));
+                if (v <= 5000)
+                    cfg.arm_grace_ms = v;
+            } catch (...) {
+            }
         } else if (key == "log_level") {
             cfg.log_level = vall;
         } else if (key == "log_file") {
             cfg.log_file = val;  // keep original as path
         } else if (key == "log_thread_id") {
             cfg.log_thread_id = (vall == "1" || vall == "true" || vall == "yes");
+        } else if (key == "log_flush_ms") {
+            try {
+                unsigned int v = static_cast<unsigned int>(std::stoul(vall));
+                if (v <= 10000)
+                    cfg.log_flush_ms = v;
+            } catch (...) {
+            }
+        } else if (key == "log_time_digits") {
+            try {
+                unsigned int v = static_cast<unsigned int>(std::stoul(vall));
+                if (v == 0 || v == 3 || v == 6)
+                    cfg.log_time_digits = v;
+            } catch (...) {
+            }
+        } else if (key == "log_flush_bytes") {
+            try {
+                unsigned int v = static_cast<unsigned int>(std::stoul(vall));
+                if (v <= (1u << 20))
+                    cfg.log_flush_bytes = v;
+            } catch (...) {
+            }
         } else if (key == "watch_config") {
             cfg.watch_config = (vall == "1" || vall == "true" || vall == "yes");
         } else if (key == "persistence" || key == "persistence_enabled") {
@@ -294,7 +600,7 @@ std::filesystem::path default_path() {
         CoTaskMemFree(appdataW);
         return std::filesystem::path(wpath);
     } else {
-        arc::log::warn("SHGetKnownFolderPath failed; using local config path");
+        ARC_LOG_WARN("SHGetKnownFolderPath failed; using local config path");
     }
     return local;  // fallback
 }
@@ -374,6 +680,16 @@ bool save(const std::filesystem::path &path, const Config &cfg) {
     out << "click_time_ms=" << cfg.click_time_ms << "\n\n";
     out << "# Max pointer movement radius in pixels to still translate as click (0-100)\n";
     out << "move_radius_px=" << cfg.move_radius_px << "\n\n";
+    out << "# Start drags early when the pointer is clearly leaving the radius: prediction horizon in ms (0 = off, 0-200)\n";
+    out << "drag_predict_ms=" << cfg.drag_predict_ms << "\n\n";
+    out << "# Press the right button immediately and release it on a quick release (true/false)\n";
+    out << "speculative_click=" << (cfg.speculative_click ? "true" : "false") << "\n\n";
+    out << "# Learn click_time_ms and move_radius_px from how bound presses are used (true/false)\n";
+    out << "auto_tune=" << (cfg.auto_tune ? "true" : "false") << "\n\n";
+    out << "# Install the mouse hook only while the modifier is held (true/false)\n";
+    out << "armed_hook=" << (cfg.armed_hook ? "true" : "false") << "\n";
+    out << "# Milliseconds the armed hook stays installed after the modifier is released (0-5000)\n";
+    out << "arm_grace_ms=" << cfg.arm_grace_ms << "\n\n";
     out << "# Source button to translate (LEFT|MIDDLE|X1|X2)\n";
     const char *trig = "LEFT";
     if (cfg.trigger == Config::Trigger::Middle)
@@ -383,6 +699,35 @@ bool save(const std::filesystem::path &path, const Config &cfg) {
     else if (cfg.trigger == Config::Trigger::X2)
         trig = "X2";
     out << "trigger=" << trig << "\n\n";
+    out << "# Extra bindings, one per line: MODIFIERS+BUTTON -> RIGHT|LEFT|MIDDLE|X1|X2|DOUBLE\n";
+    out << "# e.g. bind=ALT+MIDDLE -> DOUBLE; the most specific matching rule wins\n";
+    for (const auto &b : cfg.bindings)
+        out << "bind=" << binding_to_str(b) << "\n";
+    out << "\n";
+    out << "# Bound double click within this many ms (0 = off, 0-1000) and its action\n";
+    out << "double_click_ms=" << cfg.double_click_ms << "\n";
+    out << "double_click_action=" << action_to_str(cfg.double_click_action) << "\n";
+    out << "# Bound press held still this many ms (0 = off, above click_time_ms, up to 10000) and its action\n";
+    out << "long_press_ms=" << cfg.long_press_ms << "\n";
+    out << "long_press_action=" << action_to_str(cfg.long_press_action) << "\n";
+    out << "# Chord: chord_button pressed within this many ms of a bound press (0 = off, 0-500) and its action\n";
+    out << "chord_ms=" << cfg.chord_ms << "\n";
+    out << "chord_button=" << action_to_str(cfg.chord_button) << "\n";
+    out << "chord_action=" << action_to_str(cfg.chord_action) << "\n";
+    out << "# Dwell: modifier combo held, pointer resting this many ms (0 = off, 100-10000) and its action\n";
+    out << "dwell_ms=" << cfg.dwell_ms << "\n";
+    out << "dwell_action=" << action_to_str(cfg.dwell_action) << "\n\n";
+    out << "# Strokes drawn with a bound press held, one per line: SHAPE -> RIGHT|LEFT|MIDDLE|X1|X2|DOUBLE\n";
+    out << "# Shapes are 1-4 directions (L, R, U, D), e.g. stroke=L -> X1 (back), stroke=DR -> MIDDLE\n";
+    for (const auto &st : cfg.strokes)
+        out << "stroke=" << st.shape << " -> " << action_to_str(st.action) << "\n";
+    out << "# Minimum match score of a stroke in percent (50-100)\n";
+    out << "stroke_min_score=" << cfg.stroke_min_score << "\n\n";
+    out << "# Per-device routing, one rule per line: NAME_PATTERN -> BUTTONS (LEFT+MIDDLE+X1+X2, ALL or NONE)\n";
+    out << "# e.g. device=*Touchpad* -> LEFT; with rules, devices matching none pass through untouched\n";
+    for (const auto &r : cfg.devices)
+        out << "device=" << device_to_str(r) << "\n";
+    out << "\n";
     out << "# Logging level: error|warn|info|debug\n";
     out << "log_level=" << cfg.log_level << "\n";
     if (!cfg.log_file.empty()) {
@@ -391,6 +736,11 @@ bool save(const std::filesystem::path &path, const Config &cfg) {
     }
     out << "# Include thread id in each log line (true/false)\n";
     out << "log_thread_id=" << (cfg.log_thread_id ? "true" : "false") << "\n";
+    out << "# Hold log lines up to this many ms, or until this many bytes, before writing (0: write at once)\n";
+    out << "log_flush_ms=" << cfg.log_flush_ms << "\n";
+    out << "log_flush_bytes=" << cfg.log_flush_bytes << "\n";
+    out << "# Sub-second digits in log timestamps: 0, 3 (milliseconds) or 6 (microseconds)\n";
+    out << "log_time_digits=" << cfg.log_time_digits << "\n";
     out << "\n# Live reload the config file on changes (true/false)\n";
     out << "watch_config=" << (cfg.watch_config ? "true" : "false") << "\n";
     out << "\n# Restart the app if it crashes (true/false). Applies only to interactive mode.\n";
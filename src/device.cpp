@@ -0,0 +1,99 @@
+/**
+ * @file device.cpp
+ * @brief Device name matching and the routing table.
+ */
+
+#include "arc/device.h"
+
+namespace arc::device {
+
+namespace {
+
+char fold(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+}  // namespace
+
+const char *kind_name(Kind k) {
+    switch (k) {
+    case Kind::Mouse:
+        return "mouse";
+    case Kind::Touchpad:
+        return "touchpad";
+    case Kind::Pen:
+        return "pen";
+    case Kind::Touch:
+        return "touch";
+    case Kind::Keyboard:
+        return "keyboard";
+    case Kind::Unknown:
+        break;
+    }
+    return "unknown";
+}
+
+void set_pattern(Rule &rule, const char *pattern) {
+    int i = 0;
+    for (; pattern[i] && i < kMaxPattern - 1; ++i)
+        rule.pattern[i] = pattern[i];
+    rule.pattern[i] = '\0';
+}
+
+/**
+ * Iterative glob with single-star backtracking: on a mismatch, the last @c *
+ * absorbs one more character of the text. Linear in practice, quadratic at
+ * worst, which is fine for registration-time use.
+ */
+bool match(const char *pattern, const char *text) {
+    const char *star = nullptr, *resume = nullptr;
+    while (*text) {
+        if (*pattern == '*') {
+            star = pattern++;
+            resume = text;
+        } else if (*pattern && (*pattern == '?' || fold(*pattern) == fold(*text))) {
+            ++pattern;
+            ++text;
+        } else if (star) {
+            pattern = star + 1;
+            text = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (*pattern == '*')
+        ++pattern;
+    return *pattern == '\0';
+}
+
+Table::Table() : devices_(1), masks_(1, 0) {}
+
+void Table::configure(const Rule *rules, int count) {
+    count_ = 0;
+    for (int i = 0; i < count && count_ < kMaxRules; ++i)
+        rules_[count_++] = rules[i];
+    for (std::size_t id = 1; id < devices_.size(); ++id)
+        masks_[id] = evaluate(devices_[id]);
+}
+
+Id Table::add(const Descriptor &d) {
+    if (Id id = find(d.key))
+        return id;
+    devices_.push_back(d);
+    masks_.push_back(evaluate(d));
+    return static_cast<Id>(devices_.size() - 1);
+}
+
+Id Table::find(std::uint64_t key) const {
+    for (std::size_t id = 1; id < devices_.size(); ++id)
+        if (devices_[id].key == key)
+            return static_cast<Id>(id);
+    return kUnknown;
+}
+
+std::uint8_t Table::evaluate(const Descriptor &d) const {
+    for (int i = 0; i < count_; ++i)
+        if (match(rules_[i].pattern, d.name.c_str()) || match(rules_[i].pattern, kind_name(d.kind)))
+            return rules_[i].buttons;
+    return 0;
+}
+
+}  // namespace arc::device
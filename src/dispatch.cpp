@@ -0,0 +1,76 @@
+/**
+ * @file dispatch.cpp
+ * @brief Generic message translation and per-table instance selection.
+ */
+
+#include "arc/dispatch.h"
+
+namespace arc::dispatch {
+
+/** Decodes every button message; wheel and unknown messages are Other. */
+Kind translate(unsigned int msg, unsigned int xbutton) {
+    using arc::gesture::Button;
+    using arc::gesture::EventType;
+    Kind k;
+    switch (msg) {
+    case kMouseMove:
+        k.type = EventType::Move;
+        break;
+    case kLButtonDown:
+    case kLButtonUp:
+        k.type = msg == kLButtonDown ? EventType::Down : EventType::Up;
+        k.button = Button::Left;
+        break;
+    case kRButtonDown:
+    case kRButtonUp:
+        k.type = msg == kRButtonDown ? EventType::Down : EventType::Up;
+        k.button = Button::Right;
+        break;
+    case kMButtonDown:
+    case kMButtonUp:
+        k.type = msg == kMButtonDown ? EventType::Down : EventType::Up;
+        k.button = Button::Middle;
+        break;
+    case kXButtonDown:
+    case kXButtonUp:
+        k.type = msg == kXButtonDown ? EventType::Down : EventType::Up;
+        k.button = xbutton == kXButton1 ? Button::X1 : Button::X2;
+        break;
+    default:
+        break;
+    }
+    return k;
+}
+
+/** Bound source rows of the effective table decide the instance. */
+TranslateFn select(const arc::gesture::Settings &settings) {
+    using arc::gesture::BindingTable;
+    using arc::gesture::Button;
+    if (settings.chord_ms || settings.double_click_ms)
+        return &translate;
+    const BindingTable table = arc::gesture::effective_bindings(settings);
+    static const TranslateFn kInstances[BindingTable::kButtons] = {
+        nullptr,
+        &translate_for<Button::Left>,
+        nullptr,  // Right is not a trigger
+        &translate_for<Button::Middle>,
+        &translate_for<Button::X1>,
+        &translate_for<Button::X2>,
+    };
+    int bound = -1;
+    for (int b = 1; b < BindingTable::kButtons; ++b) {
+        for (int m = 0; m < BindingTable::kMasks; ++m) {
+            if (table.cell(b * BindingTable::kMasks + m)) {
+                if (bound >= 0)
+                    return &translate;
+                bound = b;
+                break;
+            }
+        }
+    }
+    if (bound < 0 || !kInstances[bound])
+        return &translate;
+    return kInstances[bound];
+}
+
+}  // namespace arc::dispatch
@@ -0,0 +1,334 @@
+/**
+ * @file evdev.cpp
+ * @brief /proc/bus/input/devices parsing, input_event decoding and the evdev node reader.
+ */
+
+#include "arc/evdev.h"
+
+#include <fstream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/input.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace arc::evdev {
+
+namespace {
+
+using arc::device::Descriptor;
+using arc::device::Kind;
+
+/** Capability bitmap from a "B: NAME=" line: hex words, most significant first. */
+struct Bits {
+    std::vector<std::uint64_t> words;  ///< words[0] holds bits 0-63.
+
+    bool test(unsigned bit) const {
+        std::size_t w = bit / 64;
+        return w < words.size() && ((words[w] >> (bit % 64)) & 1u) != 0;
+    }
+};
+
+Bits parse_bits(const std::string &hex) {
+    Bits b;
+    std::istringstream in(hex);
+    std::string word;
+    while (in >> word)
+        b.words.insert(b.words.begin(), std::stoull(word, nullptr, 16));
+    return b;
+}
+
+/** Value of @p key in a line of space-separated KEY=value pairs, or "". */
+std::string field(const std::string &line, const std::string &key) {
+    auto pos = line.find(key + "=");
+    if (pos == std::string::npos)
+        return {};
+    pos += key.size() + 1;
+    return line.substr(pos, line.find(' ', pos) - pos);
+}
+
+/** Device in the block being parsed. */
+struct Block {
+    Descriptor d;
+    bool has_node = false;
+    bool malformed = false;
+    Bits key, rel, abs;
+};
+
+void finish(Block &b, std::vector<Descriptor> &out) {
+    if (b.has_node && !b.malformed) {
+        bool abs_xy = b.abs.test(kRelX) && b.abs.test(kRelY);
+        if (b.key.test(kBtnToolPen))
+            b.d.kind = Kind::Pen;
+        else if (b.key.test(kBtnToolFinger) && abs_xy)
+            b.d.kind = Kind::Touchpad;
+        else if (b.key.test(kBtnTouch) && abs_xy)
+            b.d.kind = Kind::Touch;
+        else if (b.rel.test(kRelX) && b.rel.test(kRelY) && b.key.test(kBtnLeft))
+            b.d.kind = Kind::Mouse;
+        else if (b.key.test(kKeyLeftAlt) || b.key.test(kKeyLeftCtrl))
+            b.d.kind = Kind::Keyboard;
+        if (b.d.kind != Kind::Unknown)
+            out.push_back(b.d);
+    }
+    b = Block{};
+}
+
+/** Virtual key of an evdev modifier key code (left/right specific), or 0. */
+unsigned int modifier_vk(std::uint16_t code) {
+    switch (code) {
+    case kKeyLeftAlt:
+        return 0xA4;  // VK_LMENU
+    case kKeyRightAlt:
+        return 0xA5;  // VK_RMENU
+    case kKeyLeftCtrl:
+        return 0xA2;  // VK_LCONTROL
+    case kKeyRightCtrl:
+        return 0xA3;  // VK_RCONTROL
+    case kKeyLeftShift:
+        return 0xA0;  // VK_LSHIFT
+    case kKeyRightShift:
+        return 0xA1;  // VK_RSHIFT
+    case kKeyLeftMeta:
+        return 0x5B;  // VK_LWIN
+    case kKeyRightMeta:
+        return 0x5C;  // VK_RWIN
+    default:
+        return 0;
+    }
+}
+
+}  // namespace
+
+/**
+ * Blocks are separated by blank lines; I: carries the ids, N: the name,
+ * H: the handlers (eventN gives the key) and B: the capability bitmaps.
+ */
+std::vector<Descriptor> parse_devices(const std::string &text) {
+    std::vector<Descriptor> out;
+    std::istringstream in(text);
+    std::string line;
+    Block b;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.size() < 3 || line[1] != ':') {
+            finish(b, out);
+            continue;
+        }
+        std::string body = line.substr(3);
+        try {
+            switch (line[0]) {
+            case 'I': {
+                std::string v = field(body, "Vendor"), p = field(body, "Product");
+                b.d.vendor = static_cast<std::uint16_t>(v.empty() ? 0 : std::stoul(v, nullptr, 16));
+                b.d.product = static_cast<std::uint16_t>(p.empty() ? 0 : std::stoul(p, nullptr, 16));
+                break;
+            }
+            case 'N': {
+                auto q = body.find('"');
+                auto e = body.rfind('"');
+                if (q != std::string::npos && e > q)
+                    b.d.name = body.substr(q + 1, e - q - 1);
+                break;
+            }
+            case 'H': {
+                auto pos = body.find("event");
+                auto digit = [&](std::size_t i) { return i < body.size() && body[i] >= '0' && body[i] <= '9'; };
+                while (pos != std::string::npos && !digit(pos + 5))
+                    pos = body.find("event", pos + 5);
+                if (pos != std::string::npos) {
+                    b.d.key = std::stoull(body.substr(pos + 5));
+                    b.has_node = true;
+                }
+                break;
+            }
+            case 'B':
+                if (body.compare(0, 4, "KEY=") == 0)
+                    b.key = parse_bits(body.substr(4));
+                else if (body.compare(0, 4, "REL=") == 0)
+                    b.rel = parse_bits(body.substr(4));
+                else if (body.compare(0, 4, "ABS=") == 0)
+                    b.abs = parse_bits(body.substr(4));
+                break;
+            default:
+                break;
+            }
+        } catch (...) {
+            b.malformed = true;  // skip the device
+        }
+    }
+    finish(b, out);
+    return out;
+}
+
+void Decoder::emit(arc::gesture::EventType type, arc::gesture::Button button, std::uint32_t time_ms,
+                   arc::device::Tagged &out) const {
+    out.event.type = type;
+    out.event.button = button;
+    out.event.x = seat_->x;
+    out.event.y = seat_->y;
+    out.event.time_ms = time_ms;
+    out.event.mods = seat_->modifiers.held();
+    out.device = id_;
+}
+
+bool Decoder::feed(const Input &in, arc::device::Tagged &out) {
+    using arc::gesture::Button;
+    using arc::gesture::EventType;
+    switch (in.type) {
+    case kEvKey: {
+        if (in.value == 2)
+            return false;  // autorepeat
+        bool down = in.value != 0;
+        if (unsigned int vk = modifier_vk(in.code)) {
+            seat_->modifiers.on_key(vk, down);
+            return false;
+        }
+        Button b = Button::None;
+        switch (in.code) {
+        case kBtnLeft:
+            b = Button::Left;
+            break;
+        case kBtnRight:
+            b = Button::Right;
+            break;
+        case kBtnMiddle:
+            b = Button::Middle;
+            break;
+        case kBtnSide:
+            b = Button::X1;
+            break;
+        case kBtnExtra:
+            b = Button::X2;
+            break;
+        case kBtnTouch:
+            // A new contact starts from wherever it lands, without a jump
+            have_x_ = have_y_ = false;
+            if (kind_ == Kind::Pen || kind_ == Kind::Touch)
+                b = Button::Left;
+            break;
+        default:
+            break;
+        }
+        if (b == Button::None)
+            return false;
+        emit(down ? EventType::Down : EventType::Up, b, in.time_ms, out);
+        return true;
+    }
+    case kEvRel:
+        if (in.code == kRelX)
+            dx_ += in.value;
+        else if (in.code == kRelY)
+            dy_ += in.value;
+        return false;
+    case kEvAbs:
+        if (in.code == kRelX) {
+            if (have_x_)
+                dx_ += in.value - abs_x_;
+            abs_x_ = in.value;
+            have_x_ = true;
+        } else if (in.code == kRelY) {
+            if (have_y_)
+                dy_ += in.value - abs_y_;
+            abs_y_ = in.value;
+            have_y_ = true;
+        }
+        return false;
+    case kEvSyn:
+        if (in.code != kSynReport || (dx_ == 0 && dy_ == 0))
+            return false;
+        seat_->x += dx_;
+        seat_->y += dy_;
+        dx_ = dy_ = 0;
+        emit(EventType::Move, Button::None, in.time_ms, out);
+        return true;
+    default:
+        return false;
+    }
+}
+
+#if defined(__linux__)
+
+namespace {
+constexpr std::size_t kMaxNodes = 64;  ///< Nodes polled at once.
+}  // namespace
+
+Source::~Source() {
+    for (const Node &n : nodes_)
+        ::close(n.fd);
+}
+
+int Source::scan(arc::device::Table &table) {
+    std::ifstream f("/proc/bus/input/devices");
+    std::stringstream text;
+    text << f.rdbuf();
+    int opened = 0;
+    for (const Descriptor &d : parse_devices(text.str())) {
+        std::string path = "/dev/input/event" + std::to_string(d.key);
+        int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0)
+            continue;
+        attach(fd, table.add(d), d.kind);
+        ++opened;
+    }
+    return opened;
+}
+
+void Source::attach(int fd, arc::device::Id id, arc::device::Kind kind) {
+    if (nodes_.size() == kMaxNodes) {
+        ::close(fd);
+        return;
+    }
+    nodes_.push_back(Node{fd, Decoder(id, kind, &seat_)});
+}
+
+/**
+ * One read per ready node, sized to the room left in @p out: every record
+ * yields at most one event, so nothing read is ever dropped, and a
+ * blocking descriptor is never read twice for one readiness report.
+ */
+int Source::poll(int timeout_ms, arc::device::Tagged *out, int max) {
+    pollfd fds[kMaxNodes];
+    for (std::size_t i = 0; i < nodes_.size(); ++i)
+        fds[i] = pollfd{nodes_[i].fd, POLLIN, 0};
+    int ready = ::poll(fds, static_cast<nfds_t>(nodes_.size()), timeout_ms);
+    if (ready < 0)
+        return -1;
+    int n = 0;
+    input_event buf[64];
+    for (std::size_t i = 0; i < nodes_.size() && n < max; ++i) {
+        if (!(fds[i].revents & POLLIN))
+            continue;
+        std::size_t room = static_cast<std::size_t>(max - n);
+        std::size_t want = room < 64 ? room : 64;
+        ssize_t got = ::read(nodes_[i].fd, buf, want * sizeof(input_event));
+        for (ssize_t k = 0; got > 0 && k < got / static_cast<ssize_t>(sizeof(input_event)); ++k) {
+            Input in;
+            in.time_ms = static_cast<std::uint32_t>(buf[k].time.tv_sec * 1000 + buf[k].time.tv_usec / 1000);
+            in.type = buf[k].type;
+            in.code = buf[k].code;
+            in.value = buf[k].value;
+            if (nodes_[i].decoder.feed(in, out[n]))
+                ++n;
+        }
+    }
+    return n;
+}
+
+#else
+
+Source::~Source() {}
+
+int Source::scan(arc::device::Table &) { return 0; }
+
+void Source::attach(int, arc::device::Id, arc::device::Kind) {}
+
+int Source::poll(int, arc::device::Tagged *, int) { return 0; }
+
+#endif
+
+}  // namespace arc::evdev
@@ -0,0 +1,621 @@
+/**
+ * @file gesture.cpp
+ * @brief Platform-neutral click/drag gesture engine implementation.
+ *
+ * Contains the decision logic formerly embedded in LowLevelMouseProc. Nothing
+ * here touches the OS: timestamps, positions and modifier state arrive in the
+ * event, and the result is a plain Decision the caller acts upon.
+ */
+
+#include "arc/gesture.h"
+
+#include "arc/tuning.h"
+
+namespace arc::gesture {
+
+namespace {
+
+/** Returns squared distance between two points (avoids sqrt). */
+inline std::int64_t distance_sq(std::int32_t ax, std::int32_t ay, std::int32_t bx, std::int32_t by) {
+    std::int64_t dx = static_cast<std::int64_t>(ax) - bx;
+    std::int64_t dy = static_cast<std::int64_t>(ay) - by;
+    return dx * dx + dy * dy;
+}
+
+/** Bit of @p b in a per-button mask. */
+inline std::uint8_t button_bit(Button b) { return static_cast<std::uint8_t>(1u << static_cast<unsigned>(b)); }
+
+/** Appends a click of the action's button, twice for a double click. */
+void push_click(Decision &d, Action a) {
+    d.push(a.button, true);
+    d.push(a.button, false);
+    if (a.double_click) {
+        d.push(a.button, true);
+        d.push(a.button, false);
+    }
+}
+
+}  // namespace
+
+/** Maps generic and left/right virtual-key codes to modifier bits. */
+std::uint32_t modifier_from_vk(unsigned int vk) {
+    switch (vk) {
+    case 0x12:  // VK_MENU
+    case 0xA4:  // VK_LMENU
+    case 0xA5:  // VK_RMENU
+        return kModAlt;
+    case 0x11:  // VK_CONTROL
+    case 0xA2:  // VK_LCONTROL
+    case 0xA3:  // VK_RCONTROL
+        return kModCtrl;
+    case 0x10:  // VK_SHIFT
+    case 0xA0:  // VK_LSHIFT
+    case 0xA1:  // VK_RSHIFT
+        return kModShift;
+    case 0x5B:  // VK_LWIN
+    case 0x5C:  // VK_RWIN
+        return kModWin;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * Feeds one event through the click/drag discriminator.
+ *
+ * Mirrors the original hook workflow: a bound press (trigger-down with
+ * modifiers by default) starts tracking and is swallowed; leaving the radius turns the gesture into a
+ * native drag by injecting the source-button down at the origin and replaying
+ * the buffered path up to the current position; releasing the tracked button
+ * injects the bound action when inside the thresholds and is always
+ * swallowed.
+ * A press released outside the thresholds without having been resolved (the
+ * long-press timer did not run in time) replays the source click instead of
+ * losing it. With prediction enabled, a move heading clearly out of the
+ * radius starts the drag early.
+ */
+Decision Engine::on_event(const Event &ev) {
+    // Fast path: moves while nothing is tracked or held back are most of all
+    // input; a dwell only needs its anchor check
+    if (ev.type == EventType::Move && idle()) {
+        if (dwelling_ || dwell_wanted(ev.mods))
+            update_dwell(ev);
+        return Decision{};
+    }
+    if (dwelling_ || settings_.dwell_ms)
+        update_dwell(ev);
+    Decision d;
+    switch (ev.type) {
+    case EventType::Move: {
+        if (measuring_)
+            measure(ev);
+        if (stroking_) {
+            record_stroke(ev.x, ev.y);
+            break;
+        }
+        if (!tracking_) {
+            // Leaving the radius ends the double-click window: deliver the
+            // held-back click where it happened, then replay this move
+            std::int64_t r = settings_.move_radius_px;
+            if (pending_ && distance_sq(ev.x, ev.y, pending_at_.x, pending_at_.y) > r * r) {
+                flush_pending(d);
+                flush_path_[0] = pending_at_;
+                flush_path_[1] = Point{ev.x, ev.y};
+                d.path = flush_path_;
+                d.path_count = 2;
+                d.verdict = Verdict::Swallow;
+            }
+            break;
+        }
+        // Inside the inscribed square the pointer is within the radius;
+        // only moves outside it need the distance check
+        std::int64_t dx = static_cast<std::int64_t>(ev.x) - start_x_;
+        std::int64_t dy = static_cast<std::int64_t>(ev.y) - start_y_;
+        if (dx < -inner_ || dx > inner_ || dy < -inner_ || dy > inner_) {
+            std::int64_t r = settings_.move_radius_px;
+            if (dx * dx + dy * dy > r * r)
+                return templates_.size() ? begin_stroke(ev) : begin_drag(ev);
+        }
+        if (settings_.predict_ms) {
+            if (predicts_drag(ev))
+                return templates_.size() ? begin_stroke(ev) : begin_drag(ev);
+            record_sample(ev);
+        }
+        record_motion(ev.x, ev.y);
+        break;
+    }
+    case EventType::Down: {
+        swallow_ups_ = static_cast<std::uint8_t>(swallow_ups_ & ~button_bit(ev.button));  // its release was lost
+        if (stroking_) {
+            if (ev.button != press_button_)
+                break;  // other buttons pass during a stroke
+            stroking_ = false;  // the stroke lost its release
+        }
+        if (tracking_ && settings_.chord_ms && ev.button == settings_.chord_button && ev.button != press_button_ &&
+            ev.time_ms - down_time_ <= settings_.chord_ms)
+            return begin_chord(ev);
+        Action a = table_.at(ev.button, ev.mods);
+        bool second = false;
+        if (pending_) {
+            std::int64_t r = settings_.move_radius_px;
+            second = a.button != Button::None && !tracking_ && ev.button == pending_button_ &&
+                     ev.time_ms - pending_time_ <= settings_.double_click_ms &&
+                     distance_sq(ev.x, ev.y, pending_at_.x, pending_at_.y) <= r * r;
+            if (!second) {
+                flush_pending(d);
+                if (a.button == Button::None) {
+                    // Replay this press after the click it follows
+                    d.push(ev.button, true);
+                    d.verdict = Verdict::Swallow;
+                    break;
+                }
+            }
+        }
+        if (a.button != Button::None) {
+            cancel_speculation(d);  // a press that lost its release
+            tracking_ = true;
+            second_ = second;
+            press_button_ = ev.button;
+            action_ = second ? settings_.double_action : a;
+            start_x_ = ev.x;
+            start_y_ = ev.y;
+            down_time_ = ev.time_ms;
+            motion_[0] = Point{ev.x, ev.y};
+            motion_count_ = 1;
+            motion_stride_ = 1;
+            motion_skip_ = 0;
+            recent_count_ = 0;
+            recent_head_ = 0;
+            record_sample(ev);
+            if (usage_) {
+                observing_ = true;
+                measuring_ = true;
+                observe_button_ = ev.button;
+                observe_at_ = Point{ev.x, ev.y};
+                observe_time_ = ev.time_ms;
+                travel_sq_ = 0;
+            }
+            d.verdict = Verdict::Swallow;
+            if (settings_.speculative && !a.double_click && !recognizing()) {
+                d.push(a.button, true);
+                speculating_ = true;
+            }
+        }
+        break;
+    }
+    case EventType::Up:
+        if (observing_ && ev.button == observe_button_)
+            end_observation(ev);
+        if (swallow_ups_ & button_bit(ev.button)) {
+            // Release of a press resolved by a long press or chord
+            swallow_ups_ = static_cast<std::uint8_t>(swallow_ups_ & ~button_bit(ev.button));
+            d.verdict = Verdict::Swallow;
+            break;
+        }
+        if (stroking_ && ev.button == press_button_)
+            return end_stroke(ev);
+        if (tracking_ && ev.button == press_button_) {
+            std::uint32_t dt = ev.time_ms - down_time_;
+            std::int64_t r = settings_.move_radius_px;
+            if (dt <= settings_.click_time_ms && distance_sq(ev.x, ev.y, start_x_, start_y_) <= r * r) {
+                if (second_) {
+                    pending_ = false;  // the double click replaces the held-back one
+                    push_click(d, action_);
+                } else if (settings_.double_click_ms) {
+                    // Hold the click back until the window shows whether a second one follows
+                    pending_ = true;
+                    pending_button_ = press_button_;
+                    pending_action_ = action_;
+                    pending_time_ = ev.time_ms;
+                    pending_at_ = Point{ev.x, ev.y};
+                } else if (speculating_) {
+                    // Quick click within radius: release the speculated action
+                    d.push(action_.button, false);
+                    speculating_ = false;
+                } else {
+                    // Quick click within radius: translate to the bound action
+                    push_click(d, action_);
+                }
+            } else {
+                flush_pending(d);
+                cancel_speculation(d);
+                d.push(press_button_, true);
+                d.push(press_button_, false);
+            }
+            // Swallow the up corresponding to our swallowed down
+            tracking_ = false;
+            second_ = false;
+            d.verdict = Verdict::Swallow;
+        }
+        break;
+    case EventType::Other:
+        break;
+    }
+    return d;
+}
+
+/**
+ * Dwell bookkeeping for one event: the modifiers going down set the anchor
+ * and arm the deadline, going up stops dwelling; a press re-anchors without
+ * arming; a move leaving the radius re-anchors and arms only if nothing is
+ * armed yet (an armed deadline stays where it is, see on_timer).
+ */
+void Engine::update_dwell(const Event &ev) {
+    if (!dwell_wanted(ev.mods)) {
+        dwelling_ = false;
+        return;
+    }
+    if (!dwelling_ || ev.type == EventType::Down) {
+        dwelling_ = true;
+        dwell_fired_ = ev.type == EventType::Down;
+        dwell_at_ = Point{ev.x, ev.y};
+        dwell_since_ = ev.time_ms;
+        dwell_due_ = ev.time_ms + settings_.dwell_ms;
+        return;
+    }
+    if (ev.type != EventType::Move)
+        return;
+    std::int64_t dx = static_cast<std::int64_t>(ev.x) - dwell_at_.x;
+    std::int64_t dy = static_cast<std::int64_t>(ev.y) - dwell_at_.y;
+    if (dx >= -inner_ && dx <= inner_ && dy >= -inner_ && dy <= inner_)
+        return;
+    std::int64_t r = settings_.move_radius_px;
+    if (dx * dx + dy * dy <= r * r)
+        return;
+    dwell_at_ = Point{ev.x, ev.y};
+    dwell_since_ = ev.time_ms;
+    if (dwell_fired_) {
+        dwell_fired_ = false;
+        dwell_due_ = ev.time_ms + settings_.dwell_ms;
+    }
+}
+
+/** Injects the dwell action if the anchor is old enough, else re-arms at its due time. */
+void Engine::fire_dwell(Decision &d, std::uint32_t now_ms) {
+    if (!dwell_armed())
+        return;
+    if (now_ms - dwell_since_ < settings_.dwell_ms) {
+        dwell_due_ = dwell_since_ + settings_.dwell_ms;
+        return;
+    }
+    flush_pending(d);
+    push_click(d, settings_.dwell_action);
+    dwell_fired_ = true;
+}
+
+/** Integer square root of r^2 / 2, rounded down. */
+std::int32_t Engine::inscribed_half_width(std::int32_t r) {
+    if (r <= 0)
+        return -1;  // no square: always run the distance check
+    std::int64_t r2 = static_cast<std::int64_t>(r) * r;
+    std::int64_t h = (r * 7071LL) / 10000;  // r / sqrt(2), then fix up the rounding
+    while (2 * (h + 1) * (h + 1) <= r2)
+        ++h;
+    while (h > 0 && 2 * h * h > r2)
+        --h;
+    return static_cast<std::int32_t>(h);
+}
+
+/** True if any press is bound. */
+bool BindingTable::empty() const {
+    for (std::uint8_t c : cells_)
+        if (c)
+            return false;
+    return true;
+}
+
+/** Collects, per held-modifier mask, whether any button is bound with it. */
+std::uint16_t BindingTable::modifier_sets() const {
+    std::uint16_t sets = 0;
+    for (int b = 0; b < kButtons; ++b)
+        for (int m = 0; m < kMasks; ++m)
+            if (cells_[b * kMasks + m])
+                sets = static_cast<std::uint16_t>(sets | (1u << m));
+    return sets;
+}
+
+/**
+ * Fills every (button, held mask) cell from the best matching rule: each
+ * rule claims the masks that contain its own, unless an earlier rule with at
+ * least as many modifiers already did.
+ */
+BindingTable compile_bindings(const Binding *rules, std::size_t count) {
+    BindingTable t;
+    std::int8_t rank[BindingTable::kCells];
+    for (auto &r : rank)
+        r = -1;
+    for (std::size_t i = 0; i < count; ++i) {
+        const Binding &b = rules[i];
+        auto src = static_cast<unsigned>(b.source);
+        auto act = static_cast<unsigned>(b.action.button);
+        if (src == 0 || src >= BindingTable::kButtons || act == 0 || act >= BindingTable::kButtons)
+            continue;
+        std::uint32_t need = b.mods & (BindingTable::kMasks - 1);
+        auto specificity = static_cast<std::int8_t>(((need >> 0) & 1) + ((need >> 1) & 1) + ((need >> 2) & 1) +
+                                                    ((need >> 3) & 1));
+        auto value = static_cast<std::uint8_t>(act | (b.action.double_click ? 0x8 : 0));
+        for (std::uint32_t m = 0; m < static_cast<std::uint32_t>(BindingTable::kMasks); ++m) {
+            if ((m & need) != need)
+                continue;
+            int cell = static_cast<int>(src) * BindingTable::kMasks + static_cast<int>(m);
+            if (specificity > rank[cell]) {
+                rank[cell] = specificity;
+                t.set_cell(cell, value);
+            }
+        }
+    }
+    return t;
+}
+
+/** The table itself, or the legacy trigger + required modifiers -> right click. */
+BindingTable effective_bindings(const Settings &s) {
+    if (!s.bindings.empty())
+        return s.bindings;
+    Binding legacy;
+    legacy.source = s.trigger;
+    legacy.mods = s.required_mods;
+    legacy.action = Action{Button::Right, false};
+    return compile_bindings(&legacy, 1);
+}
+
+/** Drag: press at the origin, then retrace the path to the current position. */
+Decision Engine::begin_drag(const Event &ev) {
+    Decision d;
+    motion_[motion_count_++] = Point{ev.x, ev.y};
+    flush_pending(d);
+    cancel_speculation(d);
+    d.push(press_button_, true);
+    d.path = motion_;
+    d.path_count = motion_count_;
+    d.verdict = Verdict::Swallow;
+    tracking_ = false;
+    second_ = false;
+    return d;
+}
+
+/** Chord: the partner went down while the press was tracked. */
+Decision Engine::begin_chord(const Event &ev) {
+    Decision d;
+    flush_pending(d);
+    cancel_speculation(d);
+    push_click(d, settings_.chord_action);
+    swallow_ups_ = static_cast<std::uint8_t>(swallow_ups_ | button_bit(press_button_) | button_bit(ev.button));
+    d.verdict = Verdict::Swallow;
+    tracking_ = false;
+    second_ = false;
+    observing_ = false;  // a chord says nothing about click thresholds
+    measuring_ = false;
+    return d;
+}
+
+/**
+ * Stroke: the press left the radius with stroke rules configured. The path
+ * so far seeds the stroke buffer and the move passes, so the pointer keeps
+ * following the hand. A held-back click is delivered at its own position
+ * first, then the pointer is replayed to this move.
+ */
+Decision Engine::begin_stroke(const Event &ev) {
+    Decision d;
+    if (pending_) {
+        flush_pending(d);
+        flush_path_[0] = pending_at_;
+        flush_path_[1] = Point{ev.x, ev.y};
+        d.path = flush_path_;
+        d.path_count = 2;
+        d.verdict = Verdict::Swallow;
+    }
+    cancel_speculation(d);
+    stroke_len_ = 0;
+    stroke_stride_ = 1;
+    stroke_skip_ = 0;
+    for (int i = 0; i < motion_count_; ++i)
+        record_stroke(motion_[i].x, motion_[i].y);
+    record_stroke(ev.x, ev.y);
+    tracking_ = false;
+    second_ = false;
+    stroking_ = true;
+    return d;
+}
+
+/** Matches the finished stroke and injects the best rule's action if it scores high enough. */
+Decision Engine::end_stroke(const Event &ev) {
+    Decision d;
+    stroke_skip_ = static_cast<std::uint16_t>(stroke_stride_ - 1);  // always keep the end point
+    record_stroke(ev.x, ev.y);
+    arc::stroke::Vector v;
+    if (arc::stroke::normalize(stroke_x_, stroke_y_, stroke_len_, v)) {
+        arc::stroke::Match m = templates_.best(v);
+        if (m.index >= 0 && m.score * 100.f >= static_cast<float>(settings_.stroke_min_score))
+            push_click(d, stroke_actions_[m.index]);
+    }
+    stroking_ = false;
+    d.verdict = Verdict::Swallow;
+    return d;
+}
+
+/** Builds the template library of the configured stroke rules. */
+void Engine::load_strokes() {
+    templates_.clear();
+    int n = settings_.stroke_count < arc::stroke::kMaxTemplates ? settings_.stroke_count : arc::stroke::kMaxTemplates;
+    for (int i = 0; i < n; ++i) {
+        const StrokeRule &rule = settings_.strokes[i];
+        arc::stroke::Vector v;
+        if (rule.action.button == Button::None || !arc::stroke::shape_vector(rule.shape, v))
+            continue;
+        int idx = templates_.add(v);
+        if (idx >= 0)
+            stroke_actions_[idx] = rule.action;
+    }
+}
+
+/** Releases a speculative action-button down ahead of the fallback injections. */
+void Engine::cancel_speculation(Decision &d) {
+    if (speculating_) {
+        d.push(action_.button, false);
+        speculating_ = false;
+    }
+}
+
+/** Delivers the click held back for the double-click window, if any. */
+void Engine::flush_pending(Decision &d) {
+    if (pending_) {
+        push_click(d, pending_action_);
+        pending_ = false;
+    }
+}
+
+/** Forgets the tracked press; hands back the release of a speculative press and a held-back click. */
+Decision Engine::reset() {
+    Decision d;
+    cancel_speculation(d);
+    flush_pending(d);
+    tracking_ = false;
+    second_ = false;
+    stroking_ = false;
+    observing_ = false;
+    measuring_ = false;
+    dwelling_ = false;
+    swallow_ups_ = 0;
+    motion_count_ = 0;
+    return d;
+}
+
+/** Projects the recent velocity @c predict_ms ahead; see the header for the rule. */
+bool Engine::predicts_drag(const Event &ev) const {
+    if (!settings_.predict_ms || recent_count_ == 0)
+        return false;
+    const std::int64_t r = settings_.move_radius_px;
+    std::int64_t ox = static_cast<std::int64_t>(ev.x) - start_x_;
+    std::int64_t oy = static_cast<std::int64_t>(ev.y) - start_y_;
+    if (4 * (ox * ox + oy * oy) < r * r)
+        return false;  // still near the origin: jitter territory
+    // Newest sample at least kVelocityWindowMs old, else the oldest one kept;
+    // remember the newest one at least half that old as the midpoint
+    const Sample *ref = nullptr;
+    const Sample *mid = nullptr;
+    for (int i = 1; i <= recent_count_; ++i) {
+        ref = &recent_[(recent_head_ + kVelocitySamples - i) % kVelocitySamples];
+        if (!mid && ev.time_ms - ref->t >= kVelocityWindowMs / 2)
+            mid = ref;
+        if (ev.time_ms - ref->t >= kVelocityWindowMs)
+            break;
+    }
+    std::uint32_t dt = ev.time_ms - ref->t;
+    if (!mid || mid == ref || dt > 4 * kVelocityWindowMs)
+        return false;
+    std::int64_t vx = static_cast<std::int64_t>(ev.x) - ref->x;
+    std::int64_t vy = static_cast<std::int64_t>(ev.y) - ref->y;
+    if (vx * ox + vy * oy <= 0)
+        return false;  // not moving away from the origin
+    // Outward speed must not be dropping: a flick that is braking stops short
+    std::int64_t dt_new = ev.time_ms - mid->t, dt_old = mid->t - ref->t;
+    std::int64_t out_new =
+        (static_cast<std::int64_t>(ev.x) - mid->x) * ox + (static_cast<std::int64_t>(ev.y) - mid->y) * oy;
+    std::int64_t out_old =
+        (static_cast<std::int64_t>(mid->x) - ref->x) * ox + (static_cast<std::int64_t>(mid->y) - ref->y) * oy;
+    if (out_new * dt_old < out_old * dt_new)
+        return false;
+    // Projected offset, scaled by dt to stay in integers: (o*dt + v*h)
+    std::int64_t h = settings_.predict_ms < 1000 ? settings_.predict_ms : 1000;
+    std::int64_t px = ox * dt + vx * h;
+    std::int64_t py = oy * dt + vy * h;
+    std::int64_t lim = 3 * r * static_cast<std::int64_t>(dt);  // 1.5r, doubled
+    return 4 * (px * px + py * py) > lim * lim;
+}
+
+/** Remembers a timed position for the velocity estimate (fixed ring, oldest overwritten). */
+void Engine::record_sample(const Event &ev) {
+    recent_[recent_head_] = Sample{ev.x, ev.y, ev.time_ms};
+    recent_head_ = static_cast<std::uint8_t>((recent_head_ + 1) % kVelocitySamples);
+    if (recent_count_ < kVelocitySamples)
+        ++recent_count_;
+}
+
+/**
+ * Buffers a move inside the radius. A full buffer keeps the origin and every
+ * other sample, and the sampling stride doubles, so memory stays fixed while
+ * the samples still cover the whole press evenly.
+ */
+void Engine::record_motion(std::int32_t x, std::int32_t y) {
+    if (++motion_skip_ < motion_stride_)
+        return;
+    motion_skip_ = 0;
+    if (motion_count_ == kMotionCapacity) {
+        std::uint8_t n = 1;
+        for (int i = 2; i < kMotionCapacity; i += 2)
+            motion_[n++] = motion_[i];
+        motion_count_ = n;
+        motion_stride_ = static_cast<std::uint16_t>(motion_stride_ * 2);
+    }
+    motion_[motion_count_++] = Point{x, y};
+}
+
+/** Buffers a stroke position; a full buffer is halved like the motion buffer. */
+void Engine::record_stroke(std::int32_t x, std::int32_t y) {
+    if (++stroke_skip_ < stroke_stride_)
+        return;
+    stroke_skip_ = 0;
+    if (stroke_len_ == kStrokeCapacity) {
+        std::uint16_t n = 1;
+        for (int i = 2; i < kStrokeCapacity; i += 2, ++n) {
+            stroke_x_[n] = stroke_x_[i];
+            stroke_y_[n] = stroke_y_[i];
+        }
+        stroke_len_ = n;
+        stroke_stride_ = static_cast<std::uint16_t>(stroke_stride_ * 2);
+    }
+    stroke_x_[stroke_len_] = x;
+    stroke_y_[stroke_len_] = y;
+    ++stroke_len_;
+}
+
+/** Updates the observed press's travel; stops once it reaches the cap. */
+void Engine::measure(const Event &ev) {
+    std::int64_t d2 = distance_sq(ev.x, ev.y, observe_at_.x, observe_at_.y);
+    if (d2 > travel_sq_)
+        travel_sq_ = d2;
+    const std::int64_t cap = arc::tuning::kTravelCapPx;
+    if (travel_sq_ >= cap * cap)
+        measuring_ = false;
+}
+
+/** Reports the observed press: duration, travel, and whether it stayed within the radius. */
+void Engine::end_observation(const Event &ev) {
+    measure(ev);
+    std::int64_t r = settings_.move_radius_px;
+    usage_->record(ev.time_ms - observe_time_, arc::tuning::travel_px(travel_sq_), travel_sq_ <= r * r);
+    observing_ = false;
+    measuring_ = false;
+}
+
+/**
+ * Turns a press held past the click time into a native source-button press
+ * (or, with long presses on, a still press held long enough into the
+ * long-press action), and delivers a held-back click once its double-click
+ * window has closed, and injects the dwell action of a resting pointer.
+ */
+Decision Engine::on_timer(std::uint32_t now_ms) {
+    Decision d;
+    if (tracking_) {
+        std::uint32_t held = now_ms - down_time_;
+        if (long_press_on() ? held < settings_.long_press_ms : held <= settings_.click_time_ms)
+            return d;
+        flush_pending(d);
+        cancel_speculation(d);
+        if (long_press_on()) {
+            push_click(d, settings_.long_press_action);
+            swallow_ups_ = static_cast<std::uint8_t>(swallow_ups_ | button_bit(press_button_));
+        } else {
+            d.push(press_button_, true);
+        }
+        tracking_ = false;
+        second_ = false;
+    } else if (pending_ && now_ms - pending_time_ > settings_.double_click_ms) {
+        flush_pending(d);
+    }
+    if (dwelling_ && static_cast<std::int32_t>(now_ms - dwell_due_) >= 0)
+        fire_dwell(d, now_ms);
+    return d;
+}
+
+}  // namespace arc::gesture
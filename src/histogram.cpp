@@ -0,0 +1,98 @@
+/**
+ * @file histogram.cpp
+ * @brief Bucket math and quantile extraction for LatencyHistogram.
+ */
+
+#include "arc/histogram.h"
+
+namespace arc::metrics {
+
+namespace {
+
+/** Index of the highest set bit; @p v must be non-zero. */
+inline unsigned msb_index(std::uint64_t v) {
+    unsigned n = 0;
+    while (v >>= 1)
+        ++n;
+    return n;
+}
+
+}  // namespace
+
+/**
+ * Values below 2*kSubCount map to themselves. Above that the top kSubBits+1
+ * bits select one of kSubCount linear sub-buckets within the value's power of
+ * two.
+ */
+std::size_t LatencyHistogram::bucket_of(std::uint64_t v) {
+    if (v < 2 * kSubCount)
+        return static_cast<std::size_t>(v);
+    unsigned shift = msb_index(v) - kSubBits;
+    std::uint64_t mantissa = v >> shift;  // in [kSubCount, 2*kSubCount)
+    return static_cast<std::size_t>(shift) * kSubCount + static_cast<std::size_t>(mantissa);
+}
+
+/** Inverse of bucket_of: highest value sharing bucket @p idx. */
+std::uint64_t LatencyHistogram::bucket_upper(std::size_t idx) {
+    if (idx < 2 * kSubCount)
+        return idx;
+    std::size_t shift = idx / kSubCount - 1;
+    std::uint64_t mantissa = idx % kSubCount + kSubCount;
+    std::uint64_t upper = ((mantissa + 1) << shift) - 1;
+    // The last bucket's bound overflows 64 bits
+    return upper < (mantissa << shift) ? ~std::uint64_t{0} : upper;
+}
+
+/**
+ * Walks buckets until the cumulative count reaches ceil(q * total). The
+ * result is the bucket's upper bound, capped at the recorded maximum.
+ */
+std::uint64_t LatencyHistogram::quantile(double q) const {
+    std::uint64_t total = 0;
+    for (const auto &b : buckets_)
+        total += b.load(std::memory_order_relaxed);
+    if (total == 0)
+        return 0;
+    if (q < 0.0)
+        q = 0.0;
+    if (q > 1.0)
+        q = 1.0;
+    std::uint64_t target = static_cast<std::uint64_t>(q * static_cast<double>(total));
+    if (static_cast<double>(target) < q * static_cast<double>(total))
+        ++target;
+    if (target == 0)
+        target = 1;
+    std::uint64_t seen = 0;
+    std::uint64_t mx = max_.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            std::uint64_t up = bucket_upper(i);
+            return up < mx ? up : mx;
+        }
+    }
+    return mx;
+}
+
+/** Summarizes the histogram for status output. */
+LatencySummary LatencyHistogram::summarize() const {
+    LatencySummary s;
+    s.count = count_.load(std::memory_order_relaxed);
+    s.max = max_.load(std::memory_order_relaxed);
+    s.mean = s.count ? sum_.load(std::memory_order_relaxed) / s.count : 0;
+    s.p50 = quantile(0.50);
+    s.p99 = quantile(0.99);
+    s.p999 = quantile(0.999);
+    return s;
+}
+
+/** Zeroes all counters. */
+void LatencyHistogram::reset() {
+    for (auto &b : buckets_)
+        b.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace arc::metrics
@@ -4,10 +4,11 @@
  *
  * Translates a configurable source click (e.g., Alt+Left) into a right-click.
  * The hook runs on a dedicated thread with a private message loop to avoid
- * blocking the main controller/UI thread. A simple click-vs-drag discriminator
- * prevents interfering with drags: short click within a movement radius is
- * translated; long press or movement beyond radius simulates the original
- * source button instead (e.g., left-drag stays a left-drag).
+ * blocking the main controller/UI thread. The click-vs-drag discrimination
+ * itself lives in the portable arc::gesture::Engine; this file only adapts
+ * MSLLHOOKSTRUCT events to it and turns its decisions into SendInput calls.
+ * With device rules configured, Raw Input names the device behind each
+ * event so presses from other devices can bypass the engine (arc/device.h).
  */
 
 #include "arc/hook.h"
@@ -15,45 +16,802 @@
 #include <windows.h>
 
 #include <atomic>
+#include <cstdint>
+#include <cstdlib>
 #include <thread>
 #include <vector>
 #include <future>
+#include <string>
 #include <utility>
 
+#include "arc/arming.h"
+#include "arc/clock.h"
 #include "arc/config.h"
+#include "arc/device.h"
+#include "arc/dispatch.h"
+#include "arc/gesture.h"
+#include "arc/hook_snapshot.h"
 #include "arc/log.h"
+#include "arc/metrics.h"
+#include "arc/modifiers.h"
+#include "arc/rcu.h"
+#include "arc/spsc_ring.h"
+#include "arc/timer_wheel.h"
+#include "arc/trace.h"
+#include "arc/tuning.h"
 
 namespace {
 
 /** Private hook state kept in-process. */
 struct HookState {
     std::atomic<HHOOK> mouse_hook{nullptr};      ///< Current WH_MOUSE_LL hook handle.
-    std::atomic<unsigned int> modifier_vk{VK_MENU};  ///< Legacy single modifier (default ALT).
+    std::atomic<HHOOK> keyboard_hook{nullptr};   ///< WH_KEYBOARD_LL hook feeding the modifier tracker.
+    HWINEVENTHOOK focus_hook = nullptr;          ///< EVENT_SYSTEM_FOREGROUND watcher (modifier resync).
+    HWINEVENTHOOK desktop_hook = nullptr;        ///< EVENT_SYSTEM_DESKTOPSWITCH watcher (modifier resync).
+    bool watching = false;                       ///< Keyboard hook and WinEvent watchers set up.
 } g_state;
 
-std::atomic<bool> g_enabled{true};               ///< Master enable flag.
-bool g_ignore_injected = true;                   ///< Skip externally injected events.
 const ULONG_PTR kArcInjectedTag = 0xA17C1C00;    ///< Tag for events we inject via SendInput.
 
 std::atomic<bool> g_hookRunning{false};          ///< Worker thread running flag.
-DWORD g_hookThreadId = 0;                        ///< Hook worker thread id for PostThreadMessage.
+std::atomic<DWORD> g_hookThreadId{0};            ///< Hook worker thread id for PostThreadMessage.
 std::thread g_hookThread;                        ///< Hook worker thread handle.
 
-std::vector<unsigned int> g_modifier_combo;      ///< Optional combo of modifier VKs.
-arc::config::Config::Trigger g_trigger = arc::config::Config::Trigger::Left;  ///< Source button to translate.
+// Control channel: other threads never touch the hooks directly; they post
+// kMsgSyncHooks and the worker installs or removes the hooks to match the
+// current config snapshot (and, in armed mode, the modifier state).
+constexpr UINT kMsgSyncHooks = WM_APP + 1;       ///< Thread message: reconcile hooks with the config.
+std::atomic<std::int64_t> g_syncRequestQpc{0};   ///< QPC time of the oldest pending sync request (0: none).
 
-// Click/drag discrimination
-bool g_tracking = false;                         ///< Tracking a potential click between down/up.
-POINT g_startPt{0, 0};                           ///< Mouse position at button down.
-DWORD g_downTick = 0;                            ///< Tick count at button down.
-unsigned int g_clickTimeMs = 250;                ///< Max duration (ms) to consider a click.
-int g_moveRadius = 6;                            ///< Max movement radius (px) to consider a click.
+// Configuration: written by apply_hook_config on any thread, read by the hook
+// callback as one immutable snapshot per event.
+arc::rcu::Cell<arc::hook::HookSnapshot> g_config;  ///< Published hook configuration.
+std::atomic<std::uint64_t> g_configGeneration{0};  ///< Last generation handed out by apply_hook_config.
 
-/** Returns squared distance between two points (avoids sqrt). */
-static inline int distance_sq(POINT a, POINT b) {
-    int dx = a.x - b.x;
-    int dy = a.y - b.y;
-    return dx * dx + dy * dy;
+arc::modifiers::Tracker g_modifiers;             ///< Held modifiers, fed by the keyboard hook.
+arc::gesture::Engine g_engine;                   ///< Click/drag discriminator (driven on the hook thread).
+std::uint64_t g_engineGeneration = 0;            ///< Snapshot generation g_engine is configured for (hook thread).
+arc::dispatch::TranslateFn g_translate = &arc::dispatch::translate;  ///< Installed message translation (hook thread).
+
+// Armed hook mode (hook thread only): the mouse hook is installed on demand.
+arc::arming::Controller g_arming;                ///< Decides when the mouse hook is wanted.
+bool g_armed = false;                            ///< Armed mode in effect (needs the keyboard hook).
+UINT_PTR g_graceTimer = 0;                       ///< Thread timer ending the grace period.
+
+// Gesture deadlines (hook thread only): the engine times gestures with the
+// events' own timestamps (MSLLHOOKSTRUCT::time, GetTickCount domain); the
+// wheel runs on g_clock, and one thread timer tracks its earliest deadline.
+arc::clock::Clock g_clock = arc::clock::monotonic();  ///< Clock driving g_timers.
+arc::timer::Wheel g_timers{16};                  ///< Pending gesture deadlines (g_clock ms).
+UINT_PTR g_wheelTimer = 0;                       ///< Thread timer armed at g_timers.next_deadline().
+arc::timer::TimerId g_deadline = 0;              ///< Wheel timer at the engine's deadline (0: none).
+std::uint32_t g_deadlineAt = 0;                  ///< Engine deadline g_deadline is set for (event time).
+
+arc::trace::Writer g_trace;                      ///< --record-trace recorder (hook thread appends).
+arc::tuning::Usage g_usage;                      ///< Bound press histograms (hook thread records, auto_tune).
+bool g_observing = false;                        ///< g_engine reports to g_usage (hook thread).
+
+// Per-device routing (hook thread only). The LL hook does not say which
+// device an event came from, and Raw Input reports it only after the hook
+// ran, so an event is tagged with the device that last produced raw mouse
+// input (the one moving the pointer up to the press). Pen and touch input
+// carry a signature in dwExtraInfo and are tagged directly.
+arc::device::Table g_devices;                    ///< Known devices and the buttons each may use.
+arc::device::Id g_lastDevice = arc::device::kUnknown;  ///< Device of the latest raw mouse input.
+std::uint64_t g_lastDeviceKey = 0;               ///< Raw Input handle of g_lastDevice.
+arc::device::Id g_penDevice = arc::device::kUnknown;    ///< Pseudo-device for pen input.
+arc::device::Id g_touchDevice = arc::device::kUnknown;  ///< Pseudo-device for touch input.
+HWND g_rawWindow = nullptr;                      ///< Message-only window receiving WM_INPUT.
+constexpr ULONG_PTR kPenSignatureMask = 0xFFFFFF00;  ///< dwExtraInfo bits holding the signature.
+constexpr ULONG_PTR kPenSignature = 0xFF515700;  ///< MI_WP_SIGNATURE: pen or touch promoted to mouse.
+constexpr ULONG_PTR kTouchBit = 0x80;            ///< Set in dwExtraInfo for touch (clear for pen).
+
+/** One SendInput call worth of synthetic events, queued by the hook callback. */
+struct InjectBatch {
+    /// Button injections plus a drag's replayed path (origin, buffered moves, exit point).
+    static constexpr int kMaxInputs = arc::gesture::Decision::kMaxInjections + arc::gesture::Engine::kMotionCapacity + 1;
+
+    UINT count = 0;              ///< Number of valid entries in inputs.
+    INPUT inputs[kMaxInputs];    ///< Tagged mouse inputs, in order.
+};
+
+// Injection hand-off: the hook callback (producer) never calls SendInput itself
+// unless the ring is full; the injector thread (consumer) drains it.
+arc::queue::SpscRing<InjectBatch, 64> g_injectRing;  ///< Hook thread -> injector thread.
+HANDLE g_injectWake = nullptr;                   ///< Auto-reset event waking an idle injector.
+std::atomic<bool> g_injectorRunning{false};      ///< Injector thread accepting work.
+std::atomic<bool> g_injectorIdle{false};         ///< Injector is (about to be) blocked on g_injectWake.
+std::atomic<bool> g_injectorStop{false};         ///< Requests the injector to drain and exit.
+std::atomic<unsigned long> g_injectInline{0};    ///< Batches sent inline because the ring was full.
+std::thread g_injectorThread;                    ///< Injector thread handle.
+
+arc::metrics::HookMetrics *g_metrics = nullptr;  ///< Published metrics block (set by start()).
+std::uint64_t g_qpcFreq = 1;                     ///< QueryPerformanceFrequency, ticks per second.
+
+/** Returns true if @p vk is physically held, per GetAsyncKeyState. */
+bool key_is_down(unsigned int vk) { return (GetAsyncKeyState(static_cast<int>(vk)) & 0x8000) != 0; }
+
+/**
+ * Returns the modifier mask of configured modifier keys currently held.
+ * Only the keys listed in the snapshot (the combo, or the legacy single
+ * modifier) are polled. Used only when the keyboard hook that feeds
+ * g_modifiers could not be installed.
+ */
+std::uint32_t poll_modifiers(const arc::hook::HookSnapshot &snap) {
+    std::uint32_t mods = 0;
+    for (int i = 0; i < snap.poll_count; ++i) {
+        if (key_is_down(snap.poll_vks[i]))
+            mods |= arc::gesture::modifier_from_vk(snap.poll_vks[i]);
+    }
+    return mods;
+}
+
+/**
+ * Translates a WH_MOUSE_LL message into an engine event, decoding the
+ * message with the installed translation instance (g_translate).
+ */
+arc::gesture::Event to_event(WPARAM wParam, const MSLLHOOKSTRUCT &m, const arc::hook::HookSnapshot &snap) {
+    using arc::gesture::EventType;
+    arc::gesture::Event ev;
+    ev.x = m.pt.x;
+    ev.y = m.pt.y;
+    // The event's own timestamp: our scheduling delay is not part of the press
+    ev.time_ms = m.time ? m.time : GetTickCount();
+    arc::dispatch::Kind k = g_translate(static_cast<unsigned int>(wParam), HIWORD(m.mouseData));
+    ev.type = k.type;
+    ev.button = k.button;
+    // One load from the tracker; poll only if the keyboard hook is missing
+    if (g_state.keyboard_hook.load(std::memory_order_relaxed))
+        ev.mods = g_modifiers.held();
+    else if (ev.type == EventType::Down)
+        ev.mods = poll_modifiers(snap);
+    return ev;
+}
+
+/** Builds a tagged SendInput record for an engine injection. */
+INPUT to_input(const arc::gesture::Injection &inj) {
+    using arc::gesture::Button;
+    INPUT in{};
+    in.type = INPUT_MOUSE;
+    switch (inj.button) {
+    case Button::Left:
+        in.mi.dwFlags = inj.down ? MOUSEEVENTF_LEFTDOWN : MOUSEEVENTF_LEFTUP;
+        break;
+    case Button::Right:
+        in.mi.dwFlags = inj.down ? MOUSEEVENTF_RIGHTDOWN : MOUSEEVENTF_RIGHTUP;
+        break;
+    case Button::Middle:
+        in.mi.dwFlags = inj.down ? MOUSEEVENTF_MIDDLEDOWN : MOUSEEVENTF_MIDDLEUP;
+        break;
+    case Button::X1:
+    case Button::X2:
+        in.mi.dwFlags = inj.down ? MOUSEEVENTF_XDOWN : MOUSEEVENTF_XUP;
+        in.mi.mouseData = (inj.button == Button::X1) ? XBUTTON1 : XBUTTON2;
+        break;
+    case Button::None:
+        break;
+    }
+    in.mi.dwExtraInfo = kArcInjectedTag;
+    return in;
+}
+
+/** Virtual-desktop rectangle used to normalize absolute moves. */
+struct Desktop {
+    LONG x, y, w, h;
+};
+
+Desktop virtual_desktop() {
+    return Desktop{GetSystemMetrics(SM_XVIRTUALSCREEN), GetSystemMetrics(SM_YVIRTUALSCREEN),
+                   GetSystemMetrics(SM_CXVIRTUALSCREEN), GetSystemMetrics(SM_CYVIRTUALSCREEN)};
+}
+
+/** Builds a tagged absolute pointer move to a screen position. */
+INPUT to_move(const arc::gesture::Point &p, const Desktop &vd) {
+    INPUT in{};
+    in.type = INPUT_MOUSE;
+    in.mi.dx = static_cast<LONG>((static_cast<LONGLONG>(p.x - vd.x) * 65535) / (vd.w > 1 ? vd.w - 1 : 1));
+    in.mi.dy = static_cast<LONG>((static_cast<LONGLONG>(p.y - vd.y) * 65535) / (vd.h > 1 ? vd.h - 1 : 1));
+    in.mi.dwFlags = MOUSEEVENTF_MOVE | MOUSEEVENTF_ABSOLUTE | MOUSEEVENTF_VIRTUALDESK;
+    in.mi.dwExtraInfo = kArcInjectedTag;
+    return in;
+}
+
+/**
+ * Hands the decision's injections to the injector thread.
+ *
+ * Called from the hook callback. Lock-free and allocation-free; the injector
+ * is only signaled when it announced it is going to sleep. If the injector is
+ * not running or the ring is full, falls back to an inline SendInput so that
+ * no synthetic press/release is ever dropped. A drag's path goes into the same
+ * batch: back to the press origin, the button down, then the buffered moves.
+ */
+void queue_injection(const arc::gesture::Decision &d) {
+    InjectBatch b;
+    Desktop vd{};
+    if (d.path_count) {
+        vd = virtual_desktop();
+        b.inputs[b.count++] = to_move(d.path[0], vd);
+    }
+    for (int i = 0; i < d.count; ++i)
+        b.inputs[b.count++] = to_input(d.inject[i]);
+    for (int i = 1; i < d.path_count; ++i)
+        b.inputs[b.count++] = to_move(d.path[i], vd);
+    if (!g_injectorRunning.load(std::memory_order_acquire) || !g_injectRing.try_push(b)) {
+        g_injectInline.fetch_add(1, std::memory_order_relaxed);
+        SendInput(b.count, b.inputs, sizeof(INPUT));
+        return;
+    }
+    // Pairs with the fence in injector_loop: either the injector sees the new
+    // item before sleeping, or we see it idle and wake it.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (g_injectorIdle.exchange(false))
+        SetEvent(g_injectWake);
+}
+
+/**
+ * Injector thread body: drains queued batches in FIFO order and issues one
+ * SendInput per batch, so a press/release pair is never interleaved with
+ * other synthetic input. Drains whatever is left before exiting.
+ */
+void injector_loop() {
+    InjectBatch b;
+    for (;;) {
+        while (g_injectRing.try_pop(b))
+            SendInput(b.count, b.inputs, sizeof(INPUT));
+        if (g_injectorStop.load())
+            break;
+        g_injectorIdle.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!g_injectRing.empty() || g_injectorStop.load()) {
+            g_injectorIdle.store(false);
+            continue;
+        }
+        WaitForSingleObject(g_injectWake, INFINITE);
+        g_injectorIdle.store(false);
+    }
+    while (g_injectRing.try_pop(b))
+        SendInput(b.count, b.inputs, sizeof(INPUT));
+}
+
+/** Starts the injector thread (idempotent). */
+bool start_injector() {
+    if (g_injectorRunning.load())
+        return true;
+    if (!g_injectWake)
+        g_injectWake = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!g_injectWake) {
+        ARC_LOG_WARN("Hook: failed to create injector event; injecting inline");
+        return false;
+    }
+    g_injectorStop.store(false);
+    g_injectorThread = std::thread(injector_loop);
+    g_injectorRunning.store(true, std::memory_order_release);
+    return true;
+}
+
+/**
+ * Stops the injector thread after it drained pending batches. Must be called
+ * after the hook was removed so no producer is active.
+ */
+void stop_injector() {
+    if (!g_injectorRunning.exchange(false))
+        return;
+    g_injectorStop.store(true);
+    SetEvent(g_injectWake);
+    if (g_injectorThread.joinable())
+        g_injectorThread.join();
+    unsigned long inl = g_injectInline.exchange(0);
+    if (inl)
+        ARC_LOG_DEBUG("Hook: " + std::to_string(inl) + " injection batch(es) sent inline");
+}
+
+/** Maps a mouse message to its metrics category. */
+unsigned classify(WPARAM wParam) {
+    switch (wParam) {
+    case WM_MOUSEMOVE:
+        return arc::metrics::kEventMove;
+    case WM_LBUTTONDOWN:
+    case WM_RBUTTONDOWN:
+    case WM_MBUTTONDOWN:
+    case WM_XBUTTONDOWN:
+        return arc::metrics::kEventDown;
+    case WM_LBUTTONUP:
+    case WM_RBUTTONUP:
+    case WM_MBUTTONUP:
+    case WM_XBUTTONUP:
+        return arc::metrics::kEventUp;
+    case WM_MOUSEWHEEL:
+    case WM_MOUSEHWHEEL:
+        return arc::metrics::kEventWheel;
+    default:
+        return arc::metrics::kEventOther;
+    }
+}
+
+/** Returns the current QPC tick count. */
+std::int64_t qpc_now() {
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    return t.QuadPart;
+}
+
+/**
+ * Asks the hook worker to reconcile its hooks with the current config.
+ * Requests are coalesced: the worker always acts on the latest snapshot, and
+ * the transition timing starts at the oldest pending request.
+ */
+void request_sync() {
+    DWORD tid = g_hookThreadId.load();
+    if (!tid)
+        return;  // not running; start() installs according to the config
+    std::int64_t none = 0;
+    g_syncRequestQpc.compare_exchange_strong(none, qpc_now());
+    PostThreadMessage(tid, kMsgSyncHooks, 0, 0);
+}
+
+/**
+ * Feeds the modifier state to the armed-mode controller after a change.
+ * Requests a sync when the combo goes down (arm) or up (start grace).
+ */
+void note_modifiers(std::uint32_t now_ms) {
+    if (!g_armed)
+        return;
+    bool before = g_arming.combo_held();
+    g_arming.on_modifiers(g_modifiers.held(), now_ms);
+    if (g_arming.combo_held() != before)
+        request_sync();
+}
+
+/** Points the thread timer at the wheel's next deadline, or kills it. */
+void rearm_wheel_timer() {
+    std::uint64_t next = g_timers.next_deadline();
+    if (next == arc::timer::kNever) {
+        if (g_wheelTimer) {
+            KillTimer(nullptr, g_wheelTimer);
+            g_wheelTimer = 0;
+        }
+        return;
+    }
+    std::uint64_t now = g_clock.now_ms();
+    UINT delay = next > now ? static_cast<UINT>(next - now < 0x7FFFFFFF ? next - now : 0x7FFFFFFF) : 0;
+    // Reusing the id replaces the pending thread timer instead of adding one
+    g_wheelTimer = SetTimer(nullptr, g_wheelTimer, delay, nullptr);
+}
+
+/** Fires every due gesture deadline (WM_TIMER of g_wheelTimer). */
+void run_timers() {
+    g_timers.advance(g_clock.now_ms());
+    rearm_wheel_timer();
+}
+
+void note_tracking(bool was_busy, std::uint32_t now_ms);
+void sync_deadline();
+
+/**
+ * Wheel callback at the engine's deadline: the click time or long-press
+ * time of a tracked press, or the end of a double-click window. Resolves
+ * the press (or delivers the held-back click) right away instead of waiting
+ * for the next input. The wheel is the authority on the deadline, so the
+ * engine is resolved at its own deadline rather than at a coarse tick
+ * reading.
+ */
+void on_deadline(void *, std::uint64_t) {
+    g_deadline = 0;
+    bool was_busy = !g_engine.settled();
+    std::uint32_t at;
+    if (!g_engine.deadline(at))
+        return;
+    arc::gesture::Decision d = g_engine.on_timer(at);
+    if (d.count)
+        queue_injection(d);
+    if (g_trace.is_open()) {
+        arc::trace::Record r;
+        r.kind = arc::trace::Kind::Timer;
+        r.event.time_ms = at;
+        r.decision = d;
+        g_trace.append(r);
+    }
+    sync_deadline();
+    note_tracking(was_busy, GetTickCount());
+}
+
+/**
+ * Keeps exactly one wheel timer at the engine's next deadline: reschedules
+ * it when the deadline moves (a press starts, a click is held back) and
+ * cancels it when there is none.
+ */
+void sync_deadline() {
+    std::uint32_t at = 0;
+    bool want = g_engine.deadline(at);
+    if (want == (g_deadline != 0) && (!want || at == g_deadlineAt))
+        return;
+    if (g_deadline) {
+        g_timers.cancel(g_deadline);
+        g_deadline = 0;
+    }
+    if (want) {
+        // The deadline is in event time; what is left of it starts now
+        std::int32_t delay = static_cast<std::int32_t>(at - GetTickCount());
+        g_deadline = g_timers.schedule(g_clock.now_ms() + (delay > 0 ? delay : 0), on_deadline, nullptr);
+        g_deadlineAt = at;
+    }
+    rearm_wheel_timer();
+}
+
+/**
+ * Follows the engine in and out of gestures: in armed mode, pins the hook
+ * until it settles. A stroke, a held-back click and a release still to be
+ * swallowed (long press, chord) all count, not just a tracked press;
+ * removing the hook would reset the engine and let that release reach the
+ * application unpaired.
+ */
+void note_tracking(bool was_busy, std::uint32_t now_ms) {
+    bool busy = !g_engine.settled();
+    if (busy == was_busy)
+        return;
+    if (g_armed) {
+        g_arming.on_tracking(busy, now_ms);
+        request_sync();
+    }
+}
+
+/** Device that produced @p m: pen or touch by signature, else the latest raw input device. */
+arc::device::Id device_of(const MSLLHOOKSTRUCT &m) {
+    if ((m.dwExtraInfo & kPenSignatureMask) == kPenSignature)
+        return (m.dwExtraInfo & kTouchBit) ? g_touchDevice : g_penDevice;
+    return g_lastDevice;
+}
+
+/** Converts a UTF-16 string to UTF-8. */
+std::string to_utf8(const wchar_t *w) {
+    int n = WideCharToMultiByte(CP_UTF8, 0, w, -1, nullptr, 0, nullptr, nullptr);
+    std::string s(n > 0 ? n - 1 : 0, '\0');
+    if (n > 1)
+        WideCharToMultiByte(CP_UTF8, 0, w, -1, s.data(), n, nullptr, nullptr);
+    return s;
+}
+
+/** Adds @p d to the routing table and logs its id and name, for writing rules. */
+arc::device::Id register_device(const arc::device::Descriptor &d) {
+    arc::device::Id id = g_devices.add(d);
+    ARC_LOG_INFO("Device " + std::to_string(id) + " (" + arc::device::kind_name(d.kind) + "): " + d.name +
+                 (g_devices.buttons(id) ? "" : " [passed through]"));
+    return id;
+}
+
+/**
+ * Registers the Raw Input device @p h: its interface path is the name
+ * rules match (it contains the VID_xxxx&PID_xxxx of USB and Bluetooth
+ * devices), and those ids are parsed out of it.
+ */
+arc::device::Id register_raw_device(HANDLE h) {
+    arc::device::Descriptor d;
+    d.key = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(h));
+    d.kind = arc::device::Kind::Mouse;
+    UINT len = 0;
+    GetRawInputDeviceInfoW(h, RIDI_DEVICENAME, nullptr, &len);
+    std::wstring name(len + 1, L'\0');
+    if (len && GetRawInputDeviceInfoW(h, RIDI_DEVICENAME, name.data(), &len) != static_cast<UINT>(-1))
+        d.name = to_utf8(name.c_str());
+    std::string upper = d.name;
+    for (char &c : upper)
+        c = (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    auto vid = upper.find("VID_"), pid = upper.find("PID_");
+    if (vid != std::string::npos)
+        d.vendor = static_cast<std::uint16_t>(std::strtoul(upper.c_str() + vid + 4, nullptr, 16));
+    if (pid != std::string::npos)
+        d.product = static_cast<std::uint16_t>(std::strtoul(upper.c_str() + pid + 4, nullptr, 16));
+    return register_device(d);
+}
+
+/**
+ * WM_INPUT: remembers which device produced the latest mouse input,
+ * registering it the first time it is seen. Runs on the hook thread
+ * between hook callbacks; one header read per input.
+ */
+void on_raw_input(HRAWINPUT input) {
+    RAWINPUTHEADER hdr;
+    UINT size = sizeof(hdr);
+    if (GetRawInputData(input, RID_HEADER, &hdr, &size, sizeof(RAWINPUTHEADER)) == static_cast<UINT>(-1) ||
+        hdr.dwType != RIM_TYPEMOUSE)
+        return;
+    std::uint64_t key = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(hdr.hDevice));
+    if (key == g_lastDeviceKey && g_lastDevice)
+        return;
+    g_lastDeviceKey = key;
+    if (!hdr.hDevice) {
+        g_lastDevice = arc::device::kUnknown;  // synthesized input with no device behind it
+        return;
+    }
+    arc::device::Id id = g_devices.find(key);
+    g_lastDevice = id ? id : register_raw_device(hdr.hDevice);
+}
+
+/**
+ * Starts or stops receiving Raw Input for the mouse devices (sink mode, so
+ * input is seen whatever window has focus). Hook thread only.
+ */
+void sync_raw_input(bool want) {
+    if (want == (g_rawWindow != nullptr))
+        return;
+    if (!want) {
+        RAWINPUTDEVICE rid{0x01, 0x02, RIDEV_REMOVE, nullptr};  // generic desktop, mouse
+        RegisterRawInputDevices(&rid, 1, sizeof(rid));
+        DestroyWindow(g_rawWindow);
+        g_rawWindow = nullptr;
+        g_lastDevice = arc::device::kUnknown;
+        g_lastDeviceKey = 0;
+        return;
+    }
+    g_rawWindow = CreateWindowExW(0, L"STATIC", L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, GetModuleHandleW(nullptr),
+                                  nullptr);
+    RAWINPUTDEVICE rid{0x01, 0x02, RIDEV_INPUTSINK, g_rawWindow};
+    if (!g_rawWindow || !RegisterRawInputDevices(&rid, 1, sizeof(rid))) {
+        ARC_LOG_WARN("Hook: Raw Input unavailable; device rules treat every device as unknown");
+        if (g_rawWindow)
+            DestroyWindow(g_rawWindow);
+        g_rawWindow = nullptr;
+        return;
+    }
+    if (!g_penDevice) {
+        arc::device::Descriptor pen, touch;
+        pen.key = ~0ull;
+        pen.name = "Pen";
+        pen.kind = arc::device::Kind::Pen;
+        touch.key = ~0ull - 1;
+        touch.name = "Touch";
+        touch.kind = arc::device::Kind::Touch;
+        g_penDevice = register_device(pen);
+        g_touchDevice = register_device(touch);
+    }
+}
+
+/**
+ * Runs one HC_ACTION event through the filters and the gesture engine.
+ *
+ * @return true if the original event must be swallowed.
+ */
+bool handle_event(WPARAM wParam, const MSLLHOOKSTRUCT *pMouse) {
+    if (!pMouse || pMouse->dwExtraInfo == kArcInjectedTag) {
+        // Ignore events we injected ourselves
+        if (g_metrics)
+            g_metrics->skipped_injected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // Fast path: a move while nothing is tracked, held back or dwelling
+    // passes whatever the config says, so skip the snapshot read (a full
+    // fence) and the engine; only a trace recording needs to see it
+    if (wParam == WM_MOUSEMOVE && g_engine.idle() && !g_engine.dwelling() && !g_trace.is_open())
+        return false;
+    auto snap = g_config.read();
+    if (!snap->enabled)
+        return false;
+    // Ignore or treat cautiously any injected events from other processes or lower IL
+    if (snap->ignore_injected && (pMouse->flags & (LLMHF_INJECTED | LLMHF_LOWER_IL_INJECTED))) {
+        if (g_metrics)
+            g_metrics->skipped_injected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Swap translation instances between gestures only: releases the engine
+    // still owns must decode, so translate everything until it settles
+    if (g_translate != snap->translate)
+        g_translate = arc::dispatch::translation_for(snap->translate, g_engine);
+
+    // Settings change only between events, never while one is being decided
+    arc::gesture::Event ev = to_event(wParam, *pMouse, *snap);
+    if (snap->generation != g_engineGeneration) {
+        g_engine.configure(snap->gesture);
+        g_engineGeneration = snap->generation;
+        if (snap->auto_tune != g_observing) {
+            g_engine.observe(snap->auto_tune ? &g_usage : nullptr);
+            g_observing = snap->auto_tune;
+        }
+        g_devices.configure(snap->devices, snap->device_count);
+        if (g_trace.is_open()) {
+            arc::trace::Record r;
+            r.kind = arc::trace::Kind::Settings;
+            r.event.time_ms = ev.time_ms;
+            r.settings = snap->gesture;
+            g_trace.append(r);
+        }
+    }
+    // A press its device may not use never reaches the engine (or the trace)
+    if (g_devices.routing() && g_devices.bypass(device_of(*pMouse), ev, g_engine.idle()))
+        return false;
+    bool was_busy = !g_engine.settled();
+    arc::gesture::Decision d = g_engine.on_event(ev);
+    if (d.count)
+        queue_injection(d);
+    if (g_trace.is_open()) {
+        arc::trace::Record r;
+        r.event = ev;
+        r.decision = d;
+        g_trace.append(r);
+    }
+    sync_deadline();
+    note_tracking(was_busy, ev.time_ms);
+    return d.verdict == arc::gesture::Verdict::Swallow;
+}
+
+/**
+ * Feeds a modifier change to the engine when dwell clicks are configured:
+ * pressing the modifiers must start the dwell anchor even if the pointer
+ * never moves, and releasing them must stop it. The change arrives as an
+ * Other event at the cursor position, which the engine passes through.
+ */
+void note_dwell(std::uint32_t now_ms) {
+    if (!g_engine.settings().dwell_ms || !g_state.mouse_hook.load())
+        return;
+    POINT pt;
+    if (!GetCursorPos(&pt))
+        return;
+    arc::gesture::Event ev;
+    ev.type = arc::gesture::EventType::Other;
+    ev.x = pt.x;
+    ev.y = pt.y;
+    ev.time_ms = now_ms;
+    ev.mods = g_modifiers.held();
+    arc::gesture::Decision d = g_engine.on_event(ev);
+    if (d.count)
+        queue_injection(d);
+    if (g_trace.is_open()) {
+        arc::trace::Record r;
+        r.event = ev;
+        r.decision = d;
+        g_trace.append(r);
+    }
+    sync_deadline();
+}
+
+/**
+ * WinEvent callback for foreground and desktop switches.
+ *
+ * Key-ups can be missed while another desktop (UAC prompt, lock screen,
+ * Ctrl+Alt+Del) has input, so the cached modifier state is rebuilt from the
+ * real key state on every such transition. Runs on the hook worker thread.
+ */
+void CALLBACK ResyncModifiersProc(HWINEVENTHOOK, DWORD, HWND, LONG, LONG, DWORD, DWORD) {
+    g_modifiers.resync(key_is_down);
+    note_modifiers(GetTickCount());
+}
+
+/** Installs the keyboard hook and WinEvent watchers feeding g_modifiers. */
+void install_watchers() {
+    HINSTANCE hInst = GetModuleHandleW(nullptr);
+    g_modifiers.resync(key_is_down);
+    HHOOK kh = SetWindowsHookEx(WH_KEYBOARD_LL, arc::hook::LowLevelKeyboardProc, hInst, 0);
+    if (!kh)
+        ARC_LOG_WARN("Hook: keyboard hook unavailable; polling modifier keys instead");
+    g_state.keyboard_hook.store(kh);
+    g_state.focus_hook = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, nullptr,
+                                         ResyncModifiersProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+    g_state.desktop_hook = SetWinEventHook(EVENT_SYSTEM_DESKTOPSWITCH, EVENT_SYSTEM_DESKTOPSWITCH, nullptr,
+                                           ResyncModifiersProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+    g_state.watching = true;
+}
+
+/** Removes the keyboard hook and WinEvent watchers. */
+void remove_watchers() {
+    HHOOK kh = g_state.keyboard_hook.exchange(nullptr);
+    if (kh) {
+        UnhookWindowsHookEx(kh);
+    }
+    if (g_state.focus_hook) {
+        UnhookWinEvent(g_state.focus_hook);
+        g_state.focus_hook = nullptr;
+    }
+    if (g_state.desktop_hook) {
+        UnhookWinEvent(g_state.desktop_hook);
+        g_state.desktop_hook = nullptr;
+    }
+    g_state.watching = false;
+    g_modifiers.reset();
+}
+
+/** Installs the WH_MOUSE_LL hook and counts the transition. */
+bool install_mouse_hook() {
+    if (g_state.mouse_hook.load())
+        return true;
+    HHOOK h = SetWindowsHookEx(WH_MOUSE_LL, arc::hook::LowLevelMouseProc, GetModuleHandleW(nullptr), 0);
+    g_state.mouse_hook.store(h);
+    if (g_metrics) {
+        if (h) {
+            g_metrics->installs.fetch_add(1, std::memory_order_relaxed);
+            g_metrics->hook_installed.store(1, std::memory_order_relaxed);
+        } else {
+            g_metrics->install_failures.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return h != nullptr;
+}
+
+/** Removes the WH_MOUSE_LL hook and counts the transition. */
+void remove_mouse_hook() {
+    HHOOK h = g_state.mouse_hook.exchange(nullptr);
+    if (h) {
+        UnhookWindowsHookEx(h);
+        if (g_metrics) {
+            g_metrics->uninstalls.fetch_add(1, std::memory_order_relaxed);
+            g_metrics->hook_installed.store(0, std::memory_order_relaxed);
+        }
+    }
+    // Whatever was tracked can no longer complete; a speculative right
+    // press must still be released
+    arc::gesture::Decision d = g_engine.reset();
+    if (d.count)
+        queue_injection(d);
+    sync_deadline();
+}
+
+/**
+ * Installs or removes the hooks so they match the current snapshot. Runs on
+ * the hook worker thread only, for kMsgSyncHooks and the grace timer.
+ *
+ * - Disabled: no hook at all, so a disabled instance adds nothing to the
+ *   input path of other applications.
+ * - Enabled: keyboard hook and watchers, plus the mouse hook; in armed mode
+ *   the mouse hook only while g_arming wants it, with a thread timer ending
+ *   the grace period. Armed mode needs the keyboard hook; without it the
+ *   mouse hook stays installed.
+ */
+void sync_hooks() {
+    bool enabled, armed, routing;
+    std::uint32_t grace;
+    std::uint16_t arm_sets;
+    {
+        auto snap = g_config.read();
+        enabled = snap->enabled;
+        armed = snap->armed;
+        arm_sets = arc::gesture::effective_bindings(snap->gesture).modifier_sets();
+        grace = snap->arm_grace_ms;
+        routing = snap->device_count > 0;
+    }
+    std::int64_t requested = g_syncRequestQpc.exchange(0);
+    bool had_mouse = g_state.mouse_hook.load() != nullptr;
+    if (g_graceTimer) {
+        KillTimer(nullptr, g_graceTimer);
+        g_graceTimer = 0;
+    }
+
+    if (!enabled) {
+        if (g_state.watching || had_mouse) {
+            arc::hook::remove();
+            ARC_LOG_INFO("Hook: disabled, hooks removed");
+        }
+    } else {
+        bool was_watching = g_state.watching;
+        if (!was_watching)
+            install_watchers();
+        DWORD now = GetTickCount();
+        g_arming.configure_sets(arm_sets, grace);
+        g_armed = armed && g_state.keyboard_hook.load() != nullptr;
+        g_arming.on_modifiers(g_modifiers.held(), now);
+        g_arming.on_tracking(!g_engine.settled(), now);
+        bool want = !g_armed || g_arming.wanted(now);
+        if (want && !had_mouse) {
+            // Modifier changes before the install skipped note_dwell; without
+            // this the engine never learns the combo is held and the move
+            // fast path drops every move, so an armed dwell could not start
+            if (install_mouse_hook())
+                note_dwell(now);
+            else
+                ARC_LOG_ERROR("Hook: failed to install mouse hook");
+        } else if (!want && had_mouse) {
+            remove_mouse_hook();
+        }
+        std::uint32_t left = (g_armed && g_state.mouse_hook.load()) ? g_arming.grace_left(now) : 0;
+        if (left)
+            g_graceTimer = SetTimer(nullptr, 0, left, nullptr);
+        if (!was_watching)
+            ARC_LOG_INFO(g_armed ? "Hook: enabled, mouse hook armed by modifier" : "Hook: enabled, hooks installed");
+        sync_raw_input(routing);
+    }
+
+    if (g_metrics && requested && had_mouse != (g_state.mouse_hook.load() != nullptr)) {
+        std::uint64_t ticks = static_cast<std::uint64_t>(qpc_now() - requested);
+        g_metrics->transition_ns.record(ticks * 1000000000ull / g_qpcFreq);
+    }
 }
 }  // namespace
 
@@ -64,193 +822,144 @@ namespace arc::hook {
  *
  * Workflow:
  * - If disabled or event is our own injection, pass-through.
- * - If required modifier(s) not held, pass-through.
- * - On trigger-button down: begin tracking; swallow original down.
- * - On move: if moved beyond radius while tracking, synthesize original source-button down and stop tracking
- *   (so drags continue to behave as expected); allow further events to pass-through.
- * - On trigger-button up while tracking: if within time/radius thresholds, inject a right click and swallow the up.
+ * - Otherwise translate the event for the gesture engine (see gesture.h for
+ *   the click/drag rules), queue whatever it asks to inject for the injector
+ *   thread and either swallow the original event or delegate it to the next
+ *   hook. SendInput is never called here unless the injection ring is full.
+ * - Every HC_ACTION event is timed with a QPC pair and recorded, together
+ *   with its type, in the shared hook metrics (see metrics.h).
  *
  * Returns 1 to consume events we translate; otherwise delegates to next hook.
  */
 LRESULT CALLBACK LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam) {
     if (nCode == HC_ACTION) {
-        if (!g_enabled.load()) {
-            return CallNextHookEx(g_state.mouse_hook.load(), nCode, wParam, lParam);
-        }
-        PMSLLHOOKSTRUCT pMouse = reinterpret_cast<PMSLLHOOKSTRUCT>(lParam);
-        if (pMouse && pMouse->dwExtraInfo == kArcInjectedTag) {
-            // Ignore events we injected ourselves
-            return CallNextHookEx(g_state.mouse_hook.load(), nCode, wParam, lParam);
+        LARGE_INTEGER t0;
+        QueryPerformanceCounter(&t0);
+        bool swallow = handle_event(wParam, reinterpret_cast<PMSLLHOOKSTRUCT>(lParam));
+        if (g_metrics) {
+            LARGE_INTEGER t1;
+            QueryPerformanceCounter(&t1);
+            std::uint64_t ticks = static_cast<std::uint64_t>(t1.QuadPart - t0.QuadPart);
+            g_metrics->hook_latency_ns.record(ticks * 1000000000ull / g_qpcFreq);
+            g_metrics->count_event(classify(wParam));
+            if (swallow)
+                g_metrics->swallowed.fetch_add(1, std::memory_order_relaxed);
         }
+        if (swallow)
+            return 1;
+    }
 
-        // Ignore or treat cautiously any injected events from other processes or lower IL
-        if (g_ignore_injected && pMouse && (pMouse->flags & (LLMHF_INJECTED | LLMHF_LOWER_IL_INJECTED))) {
-            return CallNextHookEx(g_state.mouse_hook.load(), nCode, wParam, lParam);
-        }
+    return CallNextHookEx(g_state.mouse_hook.load(), nCode, wParam, lParam);
+}
 
-        // Returns true when all configured modifiers are held down. If no combo
-        // is configured, falls back to the legacy single modifier.
-        auto all_mods_down = []() -> bool {
-            if (!g_modifier_combo.empty()) {
-                for (auto vk : g_modifier_combo) {
-                    if (!(GetAsyncKeyState(static_cast<int>(vk)) & 0x8000))
-                        return false;
-                }
-                return true;
-            }
-            unsigned int mvk = g_state.modifier_vk.load();
-            return mvk ? (GetAsyncKeyState(static_cast<int>(mvk)) & 0x8000) != 0 : true;
-        };
-
-        // Returns true if wParam represents the configured trigger button down.
-        auto is_down = [&](WPARAM wp, const MSLLHOOKSTRUCT *m) -> bool {
-            (void)m;
-            switch (g_trigger) {
-            case arc::config::Config::Trigger::Left:
-                return wp == WM_LBUTTONDOWN;
-            case arc::config::Config::Trigger::Middle:
-                return wp == WM_MBUTTONDOWN;
-            case arc::config::Config::Trigger::X1:
-            case arc::config::Config::Trigger::X2:
-                if (wp == WM_XBUTTONDOWN) {
-                    WORD xb = HIWORD(m->mouseData);
-                    return (g_trigger == arc::config::Config::Trigger::X1 && xb == XBUTTON1) ||
-                           (g_trigger == arc::config::Config::Trigger::X2 && xb == XBUTTON2);
-                }
-                return false;
-            }
-            return false;
-        };
-        // Returns true if wParam represents the configured trigger button up.
-        auto is_up = [&](WPARAM wp, const MSLLHOOKSTRUCT *m) -> bool {
-            (void)m;
-            switch (g_trigger) {
-            case arc::config::Config::Trigger::Left:
-                return wp == WM_LBUTTONUP;
-            case arc::config::Config::Trigger::Middle:
-                return wp == WM_MBUTTONUP;
-            case arc::config::Config::Trigger::X1:
-            case arc::config::Config::Trigger::X2:
-                if (wp == WM_XBUTTONUP) {
-                    WORD xb = HIWORD(m->mouseData);
-                    return (g_trigger == arc::config::Config::Trigger::X1 && xb == XBUTTON1) ||
-                           (g_trigger == arc::config::Config::Trigger::X2 && xb == XBUTTON2);
-                }
-                return false;
-            }
-            return false;
-        };
-
-        if (is_down(wParam, pMouse)) {
-            if (all_mods_down()) {
-                // Begin tracking: suppress original left-down for potential translation
-                g_tracking = true;
-                g_startPt = pMouse->pt;
-                g_downTick = GetTickCount();
-                return 1;  // swallow original down
-            }
-        } else if (wParam == WM_MOUSEMOVE) {
-            if (g_tracking) {
-                // If moved beyond radius, treat as drag: synthesize left-down and stop tracking
-                if (distance_sq(pMouse->pt, g_startPt) > g_moveRadius * g_moveRadius) {
-                    INPUT in{};
-                    in.type = INPUT_MOUSE;
-                    // Inject source button down depending on trigger
-                    if (g_trigger == arc::config::Config::Trigger::Left) {
-                        in.mi.dwFlags = MOUSEEVENTF_LEFTDOWN;
-                    } else if (g_trigger == arc::config::Config::Trigger::Middle) {
-                        in.mi.dwFlags = MOUSEEVENTF_MIDDLEDOWN;
-                    } else {
-                        in.mi.dwFlags = MOUSEEVENTF_XDOWN;
-                        in.mi.mouseData = (g_trigger == arc::config::Config::Trigger::X1) ? XBUTTON1 : XBUTTON2;
-                    }
-                    in.mi.dwExtraInfo = kArcInjectedTag;
-                    SendInput(1, &in, sizeof(INPUT));
-                    g_tracking = false;
-                }
-            }
-        } else if (is_up(wParam, pMouse)) {
-            if (g_tracking) {
-                DWORD dt = GetTickCount() - g_downTick;
-                int d2 = distance_sq(pMouse->pt, g_startPt);
-                if (dt <= g_clickTimeMs && d2 <= g_moveRadius * g_moveRadius) {
-                    // Quick click within radius: translate to right-click
-                    INPUT input[2] = {};
-                    input[0].type = INPUT_MOUSE;
-                    input[0].mi.dwFlags = MOUSEEVENTF_RIGHTDOWN;
-                    input[0].mi.dwExtraInfo = kArcInjectedTag;
-                    input[1].type = INPUT_MOUSE;
-                    input[1].mi.dwFlags = MOUSEEVENTF_RIGHTUP;
-                    input[1].mi.dwExtraInfo = kArcInjectedTag;
-                    SendInput(2, input, sizeof(INPUT));
-                }
-                // Swallow the left-up corresponding to our swallowed left-down
-                g_tracking = false;
-                return 1;
+/**
+ * Low-level keyboard hook procedure.
+ *
+ * Only observes modifier transitions to keep g_modifiers current, to
+ * start or stop a dwell and, in armed mode, to arm or start disarming the
+ * mouse hook; never consumes
+ * keyboard input. Injected keys are tracked too since they change the key
+ * state applications see.
+ */
+LRESULT CALLBACK LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
+    if (nCode == HC_ACTION) {
+        const KBDLLHOOKSTRUCT *k = reinterpret_cast<const KBDLLHOOKSTRUCT *>(lParam);
+        if (k) {
+            bool down = (wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN);
+            bool up = (wParam == WM_KEYUP || wParam == WM_SYSKEYUP);
+            if ((down || up) && g_modifiers.on_key(static_cast<unsigned int>(k->vkCode), down)) {
+                note_modifiers(k->time);
+                note_dwell(k->time);
             }
         }
     }
-
-    return CallNextHookEx(g_state.mouse_hook.load(), nCode, wParam, lParam);
+    return CallNextHookEx(g_state.keyboard_hook.load(), nCode, wParam, lParam);
 }
 
 /**
- * Installs the WH_MOUSE_LL hook for the current process.
+ * Installs the WH_MOUSE_LL hook for the current process, plus the keyboard
+ * hook and WinEvent watchers that maintain the cached modifier state.
  * Should be called on the hook worker thread.
  */
 bool install() {
-    HINSTANCE hInst = GetModuleHandleW(nullptr);
-    HHOOK h = SetWindowsHookEx(WH_MOUSE_LL, LowLevelMouseProc, hInst, 0);
-    g_state.mouse_hook.store(h);
-    return h != nullptr;
+    if (!g_state.watching)
+        install_watchers();
+    return install_mouse_hook();
 }
 
 /**
- * Uninstalls the WH_MOUSE_LL hook if previously installed.
+ * Uninstalls the hooks if previously installed.
  */
 void remove() {
-    HHOOK h = g_state.mouse_hook.exchange(nullptr);
-    if (h) {
-        UnhookWindowsHookEx(h);
-    }
+    remove_mouse_hook();
+    remove_watchers();
+    sync_raw_input(false);
+    g_arming.reset();
 }
 
 /**
  * Applies runtime configuration to the hook state.
+ *
+ * Builds a fresh immutable snapshot and publishes it with a pointer swap;
+ * the hook picks it up on its next event. The replaced snapshot is freed
+ * once the hook can no longer be reading it.
  */
 void apply_hook_config(const arc::config::Config &cfg) {
-    g_state.modifier_vk.store(cfg.modifier_vk);
-    g_modifier_combo = cfg.modifier_combo_vks;
-    g_enabled.store(cfg.enabled);
-    g_ignore_injected = cfg.ignore_injected;
-    g_clickTimeMs = cfg.click_time_ms;
-    g_moveRadius = cfg.move_radius_px;
-    g_trigger = cfg.trigger;
+    std::uint64_t gen = g_configGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
+    g_config.publish(make_snapshot(cfg, gen));
+    // Enable/disable and armed mode also install/remove hooks on the worker
+    request_sync();
 }
 
 /**
  * Starts the hook worker thread and installs the hook.
- * The worker pumps a private message loop until @ref stop.
+ * The worker pumps a private message loop until @ref stop and services
+ * kMsgSyncHooks requests from it. If the configuration is disabled at start,
+ * no hook is installed until it is enabled.
  *
- * @return true if the hook was installed successfully.
+ * @return true if the hook was installed successfully (or is not wanted).
  */
 bool start() {
     if (g_hookRunning.load())
         return true;
     g_hookRunning.store(true);
+    if (!g_metrics) {
+        LARGE_INTEGER f;
+        if (QueryPerformanceFrequency(&f) && f.QuadPart > 0)
+            g_qpcFreq = static_cast<std::uint64_t>(f.QuadPart);
+        g_metrics = arc::metrics::publish();
+    }
+    start_injector();
     std::promise<bool> ready;
     auto fut = ready.get_future();
     g_hookThread = std::thread([p = std::move(ready)]() mutable {
-        g_hookThreadId = GetCurrentThreadId();
-        bool ok = install();
+        // Create the message queue before publishing the thread id, so
+        // sync requests posted from now on are not lost
+        MSG msg;
+        PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+        g_hookThreadId.store(GetCurrentThreadId());
+        g_timers.advance(g_clock.now_ms());  // start the wheel at the current time
+        sync_hooks();
+        bool ok = !g_state.watching || g_armed || g_state.mouse_hook.load();
         p.set_value(ok);
         if (!ok) {
-            arc::log::error("Hook worker: failed to install mouse hook");
+            ARC_LOG_ERROR("Hook worker: failed to install mouse hook");
+            remove();
+            g_hookThreadId.store(0);
             g_hookRunning.store(false);
             return;
         }
-        MSG msg;
         while (GetMessage(&msg, nullptr, 0, 0)) {
+            if (msg.hwnd == nullptr && msg.message == WM_TIMER && g_wheelTimer && msg.wParam == g_wheelTimer) {
+                run_timers();
+                continue;
+            }
+            if (msg.hwnd == nullptr && (msg.message == kMsgSyncHooks || msg.message == WM_TIMER)) {
+                sync_hooks();
+                continue;
+            }
+            if (msg.message == WM_INPUT)
+                on_raw_input(reinterpret_cast<HRAWINPUT>(msg.lParam));
             TranslateMessage(&msg);
             DispatchMessage(&msg);
         }
@@ -261,22 +970,44 @@ bool start() {
     if (!ok) {
         if (g_hookThread.joinable())
             g_hookThread.join();
+        stop_injector();
     }
     return ok;
 }
 
+arc::tuning::Usage &usage() { return g_usage; }
+
+/** Opens the trace recorder; the hook thread starts appending once running. */
+bool record_trace(const std::string &path) {
+    if (!g_trace.open(path)) {
+        ARC_LOG_ERROR("Trace: cannot create " + path);
+        return false;
+    }
+    ARC_LOG_INFO("Trace: recording to " + path);
+    return true;
+}
+
 /**
  * Requests the hook worker to quit and waits for it to join.
  */
 void stop() {
     if (g_hookRunning.load()) {
-        if (g_hookThreadId)
-            PostThreadMessage(g_hookThreadId, WM_QUIT, 0, 0);
+        DWORD tid = g_hookThreadId.load();
+        if (tid)
+            PostThreadMessage(tid, WM_QUIT, 0, 0);
         if (g_hookThread.joinable())
             g_hookThread.join();
-        g_hookThreadId = 0;
+        g_hookThreadId.store(0);
         g_hookRunning.store(false);
     }
+    // The hook is gone, so nothing produces injections any more
+    stop_injector();
+    if (g_trace.is_open()) {
+        g_trace.close();
+        ARC_LOG_INFO("Trace: " + std::to_string(g_trace.records()) + " records, " +
+                     std::to_string(g_trace.dropped()) + " dropped, " + std::to_string(g_trace.bytes_written()) +
+                     " bytes");
+    }
 }
 
 }  // namespace arc::hook
@@ -0,0 +1,148 @@
+/**
+ * @file hook_snapshot.cpp
+ * @brief Translation of arc::config::Config into an immutable HookSnapshot.
+ */
+
+#include "arc/hook_snapshot.h"
+
+#include <vector>
+
+#include "arc/config.h"
+
+namespace arc::hook {
+
+namespace {
+
+/** Maps the configured trigger to the engine's button identifier. */
+arc::gesture::Button to_button(arc::config::Config::Trigger t) {
+    switch (t) {
+    case arc::config::Config::Trigger::Left:
+        return arc::gesture::Button::Left;
+    case arc::config::Config::Trigger::Middle:
+        return arc::gesture::Button::Middle;
+    case arc::config::Config::Trigger::X1:
+        return arc::gesture::Button::X1;
+    case arc::config::Config::Trigger::X2:
+        return arc::gesture::Button::X2;
+    }
+    return arc::gesture::Button::Left;
+}
+
+/** Maps a binding action to the engine's action. */
+arc::gesture::Action to_action(arc::config::Config::Binding::Action a) {
+    using A = arc::config::Config::Binding::Action;
+    using arc::gesture::Button;
+    switch (a) {
+    case A::Right:
+        return {Button::Right, false};
+    case A::Left:
+        return {Button::Left, false};
+    case A::Middle:
+        return {Button::Middle, false};
+    case A::X1:
+        return {Button::X1, false};
+    case A::X2:
+        return {Button::X2, false};
+    case A::DoubleLeft:
+        return {Button::Left, true};
+    }
+    return {Button::Right, false};
+}
+
+/** Adds @p vk to the polled keys unless present or full. */
+void add_poll_key(HookSnapshot &s, unsigned int vk) {
+    for (int i = 0; i < s.poll_count; ++i)
+        if (s.poll_vks[i] == vk)
+            return;
+    if (s.poll_count < HookSnapshot::kMaxPollKeys)
+        s.poll_vks[s.poll_count++] = vk;
+}
+
+}  // namespace
+
+/**
+ * Copies the hook-related fields, precomputes the modifier mask and compiles
+ * the binding rules (followed by the legacy trigger rule) into the lookup
+ * table, converts the stroke and device rules, then picks the message
+ * translation for that table.
+ */
+HookSnapshot make_snapshot(const arc::config::Config &cfg, std::uint64_t generation) {
+    HookSnapshot s;
+    s.generation = generation;
+    s.enabled = cfg.enabled;
+    s.ignore_injected = cfg.ignore_injected;
+    s.armed = cfg.armed_hook;
+    s.auto_tune = cfg.auto_tune;
+    s.arm_grace_ms = cfg.arm_grace_ms;
+    s.gesture.trigger = to_button(cfg.trigger);
+    s.gesture.click_time_ms = cfg.click_time_ms;
+    s.gesture.move_radius_px = cfg.move_radius_px;
+    s.gesture.predict_ms = cfg.drag_predict_ms;
+    s.gesture.speculative = cfg.speculative_click;
+    s.gesture.double_click_ms = cfg.double_click_ms;
+    s.gesture.double_action = to_action(cfg.double_click_action);
+    s.gesture.long_press_ms = cfg.long_press_ms;
+    s.gesture.long_press_action = to_action(cfg.long_press_action);
+    s.gesture.chord_ms = cfg.chord_ms;
+    s.gesture.chord_button = to_action(cfg.chord_button).button;
+    s.gesture.chord_action = to_action(cfg.chord_action);
+    s.gesture.dwell_ms = cfg.dwell_ms;
+    s.gesture.dwell_action = to_action(cfg.dwell_action);
+    s.gesture.stroke_count = 0;
+    for (const auto &st : cfg.strokes) {
+        if (s.gesture.stroke_count == arc::stroke::kMaxTemplates)
+            break;
+        arc::gesture::StrokeRule &rule = s.gesture.strokes[s.gesture.stroke_count];
+        if (arc::stroke::parse_shape(st.shape.c_str(), rule.shape)) {
+            rule.action = to_action(st.action);
+            ++s.gesture.stroke_count;
+        }
+    }
+    s.device_count = 0;
+    for (const auto &dr : cfg.devices) {
+        if (s.device_count == arc::device::kMaxRules)
+            break;
+        arc::device::Rule &rule = s.devices[s.device_count++];
+        arc::device::set_pattern(rule, dr.pattern.c_str());
+        for (auto t : dr.buttons)
+            rule.buttons |= arc::device::button_bit(to_button(t));
+    }
+    s.gesture.stroke_min_score = static_cast<std::uint8_t>(cfg.stroke_min_score <= 100 ? cfg.stroke_min_score : 100);
+    s.gesture.required_mods = 0;
+    s.poll_count = 0;
+    if (!cfg.modifier_combo_vks.empty()) {
+        for (auto vk : cfg.modifier_combo_vks) {
+            s.gesture.required_mods |= arc::gesture::modifier_from_vk(vk);
+            if (s.poll_count < HookSnapshot::kMaxPollKeys)
+                s.poll_vks[s.poll_count++] = vk;
+        }
+    } else {
+        s.gesture.required_mods = arc::gesture::modifier_from_vk(cfg.modifier_vk);
+        if (cfg.modifier_vk)
+            s.poll_vks[s.poll_count++] = cfg.modifier_vk;
+    }
+    if (!cfg.bindings.empty()) {
+        std::vector<arc::gesture::Binding> rules;
+        rules.reserve(cfg.bindings.size() + 1);
+        for (const auto &b : cfg.bindings) {
+            arc::gesture::Binding r;
+            r.source = to_button(b.source);
+            r.mods = 0;
+            for (auto vk : b.modifier_vks) {
+                r.mods |= arc::gesture::modifier_from_vk(vk);
+                add_poll_key(s, vk);
+            }
+            r.action = to_action(b.action);
+            rules.push_back(r);
+        }
+        arc::gesture::Binding legacy;
+        legacy.source = s.gesture.trigger;
+        legacy.mods = s.gesture.required_mods;
+        rules.push_back(legacy);
+        s.gesture.bindings = arc::gesture::compile_bindings(rules.data(), rules.size());
+    }
+    s.translate = arc::dispatch::select(s.gesture);
+    return s;
+}
+
+}  // namespace arc::hook
@@ -4,42 +4,69 @@
  *
  * Threading model:
  * - All configuration functions are thread-safe.
- * - When async mode is enabled via start_async(), write() enqueues lines
- *   and signals a background thread that flushes to console/file.
+ * - When async mode is enabled via start_async(), write() copies lines into
+ *   a lock-free queue (see arc/log_queue.h) drained by a background thread
+ *   that writes them to console/file; producers only take a lock when the
+ *   queue overflows or the worker must be woken.
+ * - The worker gathers each drain into one buffer and writes it with one
+ *   write and flush per sink, when the flush policy says so (see
+ *   arc/log_batch.h); an error line flushes at once.
+ * - Lines are assembled without streams, on the stack when they fit a queue
+ *   slot, behind a per-thread timestamp cache (see arc/log_format.h).
  * - When async mode is disabled, log_msg writes synchronously on the caller's
  *   thread (still thread-safe for file output via a mutex).
+ * - The level is an atomic read inline by arc::log::enabled, so the ARC_LOG_*
+ *   macros can skip building filtered messages.
+ *
+ * Portable: Windows APIs only for thread ids and error messages.
  */
 
 #include "arc/log.h"
 
+#ifdef _WIN32
 #include <windows.h>
+#elif defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include <chrono>
-#include <ctime>
-#include <deque>
+#include <cstring>
 #include <fstream>
-#include <iomanip>
+#include <functional>
 #include <mutex>
-#include <sstream>
 #include <string>
 #include <utility>
 #include <cstdio>
 #include <atomic>
+#include <thread>
+
+#include "arc/log_batch.h"
+#include "arc/log_format.h"
+#include "arc/log_queue.h"
 
 namespace {
 std::mutex g_logMutex;
-arc::log::LogLevel g_level = arc::log::LogLevel::Info;
 std::ofstream g_logFile;
 bool g_logToFile = false;
-bool g_async = false;
+std::atomic<bool> g_async{false};
 std::thread g_thread;
-std::condition_variable g_cv;
-bool g_stop = false;
-std::deque<std::string> g_queue;
+arc::log::Queue g_queue;
 std::atomic<bool> g_includeThreadId{false};
 
+/** OS id of the calling thread, as debuggers and process tools show it. */
+std::uint32_t current_thread_id() {
+#ifdef _WIN32
+    return static_cast<std::uint32_t>(GetCurrentThreadId());
+#elif defined(__linux__)
+    return static_cast<std::uint32_t>(::syscall(SYS_gettid));
+#else
+    return static_cast<std::uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif
+}
+
 /** Returns canonical uppercase name for a log level. */
-std::string level_name(arc::log::LogLevel lvl) {
+const char *level_name(arc::log::LogLevel lvl) {
     switch (lvl) {
     case arc::log::LogLevel::Error:
         return "ERROR";
@@ -53,22 +80,66 @@ std::string level_name(arc::log::LogLevel lvl) {
     return "INFO";
 }
 
-/** Returns current local time formatted as YYYY-MM-DD HH:MM:SS. */
-std::string timestamp() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t t = std::chrono::system_clock::to_time_t(now);
-    std::tm tm{};
-    localtime_s(&tm, &t);
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+/** Writes queued text to the console and, if enabled, the log file: one write and flush each. */
+void emit(const char *text, std::size_t size) {
+    fwrite(text, 1, size, stdout);
+    fflush(stdout);
+    std::lock_guard<std::mutex> lk(g_logMutex);
+    if (g_logToFile) {
+        g_logFile.write(text, static_cast<std::streamsize>(size));
+        g_logFile.flush();
+    }
+}
+
+/** Milliseconds on the steady clock (flush timing). */
+std::int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * Appends everything queued to @p batch, then a note if lines were dropped
+ * since @p reported. Only one thread may drain at a time.
+ *
+ * @return true if anything was appended.
+ */
+bool drain(arc::log::Batch &batch, std::uint64_t &reported) {
+    std::string &buf = batch.text();
+    std::size_t before = buf.size();
+    while (g_queue.pop(buf)) {
+    }
+    g_queue.take_spill(buf);
+    std::uint64_t dropped = g_queue.dropped();
+    if (dropped != reported) {
+        buf += "[log] " + std::to_string(dropped - reported) + " lines dropped (queue full)\n";
+        reported = dropped;
+    }
+    if (buf.size() == before)
+        return false;
+    batch.appended(now_ms());
+    return true;
+}
+
+/** Writes the batched text with one write per sink and empties the batch. */
+void flush(arc::log::Batch &batch) {
+    if (!batch.empty())
+        emit(batch.text().data(), batch.text().size());
+    batch.clear();
 }
+
+std::uint64_t g_droppedReported = 0;  ///< Dropped lines already noted (draining thread).
+std::atomic<std::uint32_t> g_flushMs{0};
+std::atomic<std::size_t> g_flushBytes{0};
+
+std::atomic<arc::log::Precision> g_precision{arc::log::Precision::Seconds};
+thread_local arc::log::TimestampCache t_stamp;  ///< Per-thread: formats once per second.
 }  // namespace
 
 namespace arc::log {
 
 /** Sets the minimum severity level for log output. */
-void set_level(LogLevel lvl) { g_level = lvl; }
+void set_level(LogLevel lvl) { detail::level.store(static_cast<int>(lvl), std::memory_order_relaxed); }
 
 /** Parses a level name (error|warn|info|debug) and sets severity. */
 void set_level_by_name(const std::string &name) {
@@ -76,13 +147,13 @@ void set_level_by_name(const std::string &name) {
     for (auto &c : n)
         c = static_cast<char>(::tolower(static_cast<unsigned char>(c)));
     if (n == "error")
-        g_level = LogLevel::Error;
+        set_level(LogLevel::Error);
     else if (n == "warn" || n == "warning")
-        g_level = LogLevel::Warn;
+        set_level(LogLevel::Warn);
     else if (n == "info")
-        g_level = LogLevel::Info;
+        set_level(LogLevel::Info);
     else if (n == "debug")
-        g_level = LogLevel::Debug;
+        set_level(LogLevel::Debug);
 }
 
 /**
@@ -101,8 +172,9 @@ void set_file(const std::string &path) {
     }
 }
 
-/** Returns a UTF-8 message string for a Windows error code. */
+/** Returns a UTF-8 message string for a Windows error code (errno elsewhere). */
 std::string last_error_message(uint32_t err) {
+#ifdef _WIN32
     wchar_t *buf = nullptr;
     DWORD flags = FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS;
     DWORD len = FormatMessageW(flags, nullptr, static_cast<DWORD>(err), 0, reinterpret_cast<LPWSTR>(&buf), 0, nullptr);
@@ -114,65 +186,86 @@ std::string last_error_message(uint32_t err) {
     if (bytes > 0)
         WideCharToMultiByte(CP_UTF8, 0, wmsg.c_str(), -1, out.data(), bytes, nullptr, nullptr);
     return out;
+#else
+    return std::strerror(static_cast<int>(err));
+#endif
 }
 
 /** Starts the background logging thread (idempotent). */
 void start_async() {
     std::lock_guard<std::mutex> lk(g_logMutex);
-    if (g_async)
+    if (g_async.load(std::memory_order_relaxed))
         return;
-    g_stop = false;
-    g_async = true;
+    g_queue.restart();
     g_thread = std::thread([]() {
-        std::unique_lock<std::mutex> lk(g_logMutex);
-        while (!g_stop || !g_queue.empty()) {
-            if (g_queue.empty()) {
-                g_cv.wait(lk, [] { return g_stop || !g_queue.empty(); });
-                if (g_stop && g_queue.empty())
-                    break;
-            }
-            auto s = std::move(g_queue.front());
-            g_queue.pop_front();
-            // unlock during IO
-            lk.unlock();
-            // write to console
-            fwrite(s.data(), 1, s.size(), stdout);
-            fflush(stdout);
-            if (g_logToFile) {
-                g_logFile << s;
-                g_logFile.flush();
-            }
-            lk.lock();
+        arc::log::Batch batch;
+        for (;;) {
+            batch.set_policy({g_flushMs.load(std::memory_order_relaxed), g_flushBytes.load(std::memory_order_relaxed)});
+            // Checked before draining, so lines queued before stop() (or
+            // before an urgent line was flagged) are in this pass
+            bool stopping = g_queue.stopping();
+            if (g_queue.take_urgent())
+                batch.force();
+            bool any = drain(batch, g_droppedReported);
+            std::int64_t now = now_ms();
+            if (stopping || batch.due(now))
+                flush(batch);
+            if (any)
+                continue;
+            if (stopping)
+                break;
+            std::int64_t wait = batch.wait_ms(now);
+            if (wait < 0)
+                g_queue.wait();
+            else
+                g_queue.wait_for(static_cast<std::uint32_t>(wait));
         }
     });
+    g_async.store(true, std::memory_order_release);
 }
 
-/** Signals the background logging thread to stop and joins it. */
+/**
+ * Signals the background logging thread to stop and joins it. New lines are
+ * written synchronously from here on: the stopped queue refuses writers that
+ * saw async mode just before it ended, and waits out those already pushing,
+ * whose lines the drain after the join writes.
+ */
 void stop_async() {
     std::unique_lock<std::mutex> lk(g_logMutex);
-    if (!g_async)
+    if (!g_async.load(std::memory_order_relaxed))
         return;
-    g_stop = true;
-    g_cv.notify_all();
+    g_async.store(false, std::memory_order_release);
+    g_queue.stop();
     lk.unlock();
     if (g_thread.joinable())
         g_thread.join();
-    lk.lock();
-    g_async = false;
+    arc::log::Batch batch;
+    drain(batch, g_droppedReported);
+    flush(batch);
+}
+
+/** Sets the sub-second digits of line timestamps. */
+void set_timestamp_precision(Precision precision) { g_precision.store(precision, std::memory_order_relaxed); }
+
+/** Sets how long the async worker may hold lines before writing them. */
+void set_flush_policy(const FlushPolicy &policy) {
+    g_flushMs.store(policy.interval_ms, std::memory_order_relaxed);
+    g_flushBytes.store(policy.bytes, std::memory_order_relaxed);
 }
 
 /** Toggle inclusion of thread ids in each log line. */
 void set_include_thread_id(bool enabled) { g_includeThreadId.store(enabled, std::memory_order_release); }
 
-LogScope::LogScope(const char *name, LogLevel lvl) : name_(name ? name : ""), level_(lvl), active_(true) {
-    if (!name_.empty()) {
-        write(level_, name_ + " begin");
+LogScope::LogScope(const char *name, LogLevel lvl)
+    : name_(name), level_(lvl), active_(name && *name && enabled(lvl)) {
+    if (active_) {
+        write(level_, std::string(name_) + " begin");
     }
 }
 
 LogScope::~LogScope() {
-    if (active_ && !name_.empty()) {
-        write(level_, name_ + " end");
+    if (active_ && enabled(level_)) {
+        write(level_, std::string(name_) + " end");
     }
 }
 
@@ -182,28 +275,33 @@ LogScope::~LogScope() {
  * enabled, enqueues the line; otherwise writes synchronously.
  */
 void write(LogLevel lvl, const std::string &msg) {
-    if (static_cast<int>(lvl) > static_cast<int>(g_level))
+    if (!enabled(lvl))
         return;
-    std::ostringstream line;
-    line << '[' << timestamp() << "] [" << level_name(lvl) << ']';
-    if (g_includeThreadId.load(std::memory_order_acquire)) {
-        line << " [T:" << GetCurrentThreadId() << ']';
+    char stamp[kTimestampBytes];
+    std::size_t stamp_len = t_stamp.format(wall_us(), g_precision.load(std::memory_order_relaxed), stamp);
+    bool with_tid = g_includeThreadId.load(std::memory_order_acquire);
+    std::uint32_t tid = with_tid ? current_thread_id() : 0;
+    // Lines that fit a queue slot are assembled on the stack; longer ones on the heap
+    char buf[kLineBytes];
+    std::string big;
+    const char *line = buf;
+    std::size_t n = format_line(buf, sizeof buf, {stamp, stamp_len}, level_name(lvl), with_tid, tid, msg);
+    if (n > sizeof buf) {
+        big.resize(n);
+        format_line(big.data(), n, {stamp, stamp_len}, level_name(lvl), with_tid, tid, msg);
+        line = big.data();
     }
-    line << ' ' << msg << '\n';
-    auto s = line.str();
-    if (g_async) {
+    // A line refused because stop_async raced this write is written here
+    if (g_async.load(std::memory_order_acquire) &&
+        g_queue.push(line, n, lvl == LogLevel::Error) != Pushed::Closed)
+        return;
+    FILE *stream = (lvl == LogLevel::Error || lvl == LogLevel::Warn) ? stderr : stdout;
+    fwrite(line, 1, n, stream);
+    fflush(stream);
+    if (g_logToFile) {
         std::lock_guard<std::mutex> lk(g_logMutex);
-        g_queue.emplace_back(std::move(s));
-        g_cv.notify_one();
-    } else {
-        FILE *stream = (lvl == LogLevel::Error || lvl == LogLevel::Warn) ? stderr : stdout;
-        fwrite(s.data(), 1, s.size(), stream);
-        fflush(stream);
-        if (g_logToFile) {
-            std::lock_guard<std::mutex> lk(g_logMutex);
-            g_logFile << s;
-            g_logFile.flush();
-        }
+        g_logFile.write(line, static_cast<std::streamsize>(n));
+        g_logFile.flush();
     }
 }
 
@@ -0,0 +1,47 @@
+/**
+ * @file log_batch.cpp
+ * @brief Flush decisions for the async log worker's output buffer.
+ */
+
+#include "arc/log_batch.h"
+
+namespace arc::log {
+
+void Batch::appended(std::int64_t now_ms) {
+    if (!text_.empty() && !holding_) {
+        holding_ = true;
+        since_ms_ = now_ms;
+    }
+}
+
+std::uint32_t Batch::hold_ms() const {
+    if (policy_.interval_ms)
+        return policy_.interval_ms;
+    return policy_.bytes ? kMaxHoldMs : 0;
+}
+
+bool Batch::due(std::int64_t now_ms) const {
+    if (text_.empty())
+        return false;
+    if (forced_ || hold_ms() == 0)
+        return true;
+    if (policy_.bytes && text_.size() >= policy_.bytes)
+        return true;
+    return now_ms - since_ms_ >= hold_ms();
+}
+
+std::int64_t Batch::wait_ms(std::int64_t now_ms) const {
+    if (text_.empty())
+        return -1;
+    if (due(now_ms))
+        return 0;
+    return since_ms_ + hold_ms() - now_ms;
+}
+
+void Batch::clear() {
+    text_.clear();
+    holding_ = false;
+    forced_ = false;
+}
+
+}  // namespace arc::log
@@ -0,0 +1,105 @@
+/**
+ * @file log_format.cpp
+ * @brief Cached local-time timestamps and stream-free log line assembly.
+ */
+
+#include "arc/log_format.h"
+
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+namespace arc::log {
+
+namespace {
+
+/** Writes @p digits decimal digits of @p value (zero-padded) at @p out. */
+void put_digits(char *out, std::uint32_t value, int digits) {
+    for (int i = digits - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+/** Bounded appender: counts every byte, stores those that fit. */
+struct Appender {
+    char *out;
+    std::size_t cap;
+    std::size_t len = 0;
+
+    void put(std::string_view s) {
+        if (len < cap)
+            std::memcpy(out + len, s.data(), s.size() < cap - len ? s.size() : cap - len);
+        len += s.size();
+    }
+};
+
+}  // namespace
+
+std::int64_t wall_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+std::size_t TimestampCache::format(std::int64_t unix_us, Precision precision, char *out) {
+    // Floor division so times before the epoch still split into second + fraction
+    std::int64_t second = unix_us / 1000000;
+    std::int64_t frac = unix_us % 1000000;
+    if (frac < 0) {
+        frac += 1000000;
+        --second;
+    }
+    if (conversions_ == 0 || second != second_) {
+        std::time_t t = static_cast<std::time_t>(second);
+        std::tm tm{};
+#ifdef _WIN32
+        localtime_s(&tm, &t);
+#else
+        localtime_r(&t, &tm);
+#endif
+        char tmp[32];
+        if (std::strftime(tmp, sizeof tmp, "%Y-%m-%d %H:%M:%S", &tm) == sizeof text_)
+            std::memcpy(text_, tmp, sizeof text_);
+        else
+            std::memset(text_, '?', sizeof text_);  // year outside 0000-9999
+        second_ = second;
+        ++conversions_;
+    }
+    std::memcpy(out, text_, sizeof text_);
+    std::size_t n = sizeof text_;
+    int digits = static_cast<int>(precision);
+    if (digits > 0) {
+        out[n++] = '.';
+        put_digits(out + n, static_cast<std::uint32_t>(digits == 3 ? frac / 1000 : frac), digits);
+        n += static_cast<std::size_t>(digits);
+    }
+    return n;
+}
+
+std::size_t format_line(char *out, std::size_t cap, std::string_view stamp, std::string_view level, bool with_tid,
+                        std::uint32_t tid, std::string_view msg) {
+    Appender a{out, cap};
+    a.put("[");
+    a.put(stamp);
+    a.put("] [");
+    a.put(level);
+    a.put("]");
+    if (with_tid) {
+        char digits[10];
+        int n = 0;
+        do {
+            digits[sizeof digits - 1 - n++] = static_cast<char>('0' + tid % 10);
+            tid /= 10;
+        } while (tid);
+        a.put(" [T:");
+        a.put(std::string_view(digits + sizeof digits - n, static_cast<std::size_t>(n)));
+        a.put("]");
+    }
+    a.put(" ");
+    a.put(msg);
+    a.put("\n");
+    return a.len;
+}
+
+}  // namespace arc::log
@@ -0,0 +1,106 @@
+/**
+ * @file log_queue.cpp
+ * @brief Async log line queue: ring fast path, spill slow path, consumer wake-up.
+ */
+
+#include "arc/log_queue.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace arc::log {
+
+/**
+ * The wake-up handshake: the producer publishes its line, then checks
+ * whether the consumer is asleep; the consumer announces it is going to
+ * sleep, then checks for lines. Full fences between the store and the load
+ * on both sides mean at least one of them sees the other, so a line is
+ * never left queued with the consumer asleep.
+ *
+ * The shutdown handshake works the same way: the producer announces itself
+ * in pushing_, then checks stop_; stop() sets stop_, then waits for
+ * pushing_ to drain. Either the producer sees the stop and refuses the line,
+ * or stop() waits until the line is queued.
+ */
+Pushed Queue::push(const char *text, std::size_t size, bool urgent) {
+    pushing_.fetch_add(1, std::memory_order_seq_cst);
+    if (stop_.load(std::memory_order_seq_cst)) {
+        pushing_.fetch_sub(1, std::memory_order_release);
+        return Pushed::Closed;
+    }
+    bool queued = true;
+    auto fill = [text, size](Line &l) {
+        l.size = static_cast<std::uint32_t>(size);
+        std::memcpy(l.text, text, size);
+    };
+    if (size > kLineBytes || !ring_.try_push_with(fill)) {
+        std::lock_guard<std::mutex> lk(spill_mutex_);
+        if (spill_.size() + size <= kSpillBytes) {
+            if (spill_.capacity() < kSpillBytes)
+                spill_.reserve(kSpillBytes);  // once: later spills do not allocate
+            spill_.append(text, size);
+            spill_bytes_.store(spill_.size(), std::memory_order_release);
+            spilled_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            queued = false;
+        }
+    }
+    if (queued && urgent)
+        urgent_.store(true, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (queued && idle_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lk(wake_mutex_);
+        wake_.notify_one();
+    }
+    pushing_.fetch_sub(1, std::memory_order_release);
+    return queued ? Pushed::Queued : Pushed::Dropped;
+}
+
+bool Queue::take_spill(std::string &out) {
+    if (spill_bytes_.load(std::memory_order_acquire) == 0)
+        return false;
+    std::lock_guard<std::mutex> lk(spill_mutex_);
+    out.append(spill_);
+    spill_.clear();
+    spill_bytes_.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+bool Queue::pending() const {
+    return !ring_.empty() || spill_bytes_.load(std::memory_order_acquire) != 0 ||
+           stop_.load(std::memory_order_acquire);
+}
+
+void Queue::wait() {
+    idle_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+        std::unique_lock<std::mutex> lk(wake_mutex_);
+        wake_.wait(lk, [this] { return pending(); });
+    }
+    idle_.store(false, std::memory_order_relaxed);
+}
+
+void Queue::wait_for(std::uint32_t ms) {
+    idle_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+        std::unique_lock<std::mutex> lk(wake_mutex_);
+        wake_.wait_for(lk, std::chrono::milliseconds(ms), [this] { return pending(); });
+    }
+    idle_.store(false, std::memory_order_relaxed);
+}
+
+void Queue::stop() {
+    stop_.store(true, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lk(wake_mutex_);
+        wake_.notify_one();
+    }
+    while (pushing_.load(std::memory_order_acquire) != 0)
+        std::this_thread::yield();
+}
+
+}  // namespace arc::log
@@ -9,6 +9,7 @@
 #include <thread>
 #include <atomic>
 #include <filesystem>
+#include <mutex>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
@@ -23,6 +24,8 @@
 #include "arc/singleton.h"
 #include "arc/task.h"
 #include "arc/log.h"
+#include "arc/metrics.h"
+#include "arc/tuning.h"
 #include "altrightclick/version.h"
 
 /** Converts a UTF-8 string to UTF-16 (Windows wide). */
@@ -166,6 +169,31 @@ static bool is_elevated() {
     return isMember == TRUE;
 }
 
+/**
+ * Moves the click thresholds in @p cfg towards the suggestion from the hook's
+ * usage histograms and pushes them to the hook. Keeps the click time below a
+ * configured long-press time, then ages the histograms so the next round
+ * follows recent use. Holds @p cfg_mutex throughout, since the tray and the
+ * config watcher change @p cfg from their own threads.
+ */
+static void auto_tune(arc::config::Config &cfg, std::mutex &cfg_mutex) {
+    std::lock_guard<std::mutex> lock(cfg_mutex);
+    arc::tuning::Usage &usage = arc::hook::usage();
+    arc::tuning::Thresholds cur{cfg.click_time_ms, cfg.move_radius_px};
+    arc::tuning::Thresholds next = arc::tuning::suggest(usage, cur);
+    if (cfg.long_press_ms && next.click_time_ms >= cfg.long_press_ms)
+        next.click_time_ms = cur.click_time_ms;
+    usage.age(2000);  // roughly a day of presses at full weight
+    if (next.click_time_ms == cur.click_time_ms && next.move_radius_px == cur.move_radius_px)
+        return;
+    ARC_LOG_INFO("Auto-tune: click_time_ms " + std::to_string(cur.click_time_ms) + " -> " +
+                 std::to_string(next.click_time_ms) + ", move_radius_px " + std::to_string(cur.move_radius_px) +
+                 " -> " + std::to_string(next.move_radius_px));
+    cfg.click_time_ms = next.click_time_ms;
+    cfg.move_radius_px = next.move_radius_px;
+    arc::hook::apply_hook_config(cfg);
+}
+
 /** Prints CLI usage help to stdout. */
 static void print_help() {
     std::cout << "Usage: altrightclick [options]\n"
@@ -189,6 +217,7 @@ static void print_help() {
                  "  --task-status          Check if Scheduled Task exists\n"
                  "  --status               Print human-readable runtime/config status\n"
                  "  --status-json          Print status as JSON (mutually implies --status)\n"
+                 "  --record-trace <file>  Record hook input and decisions to a binary trace (see arc-replay)\n"
                  "  --help                 Show this help\n";
 }
 
@@ -207,6 +236,7 @@ int main(int argc, char **argv) {
     bool do_status_json = false;
     std::string cli_log_level;
     std::string cli_log_file;
+    std::string cli_trace_file;
     bool do_generate_config = false;
     int cli_persistence = -1;  // -1: no override, 0: disable, 1: enable
     for (int i = 1; i < argc; ++i) {
@@ -219,6 +249,8 @@ int main(int argc, char **argv) {
             cli_log_level = argv[++i];
         } else if (a == "--log-file" && i + 1 < argc) {
             cli_log_file = argv[++i];
+        } else if (a == "--record-trace" && i + 1 < argc) {
+            cli_trace_file = argv[++i];
         } else if (a == "--install") {
             do_install = true;
         } else if (a == "--uninstall") {
@@ -288,7 +320,7 @@ int main(int argc, char **argv) {
         }
         std::wstring exe = get_module_path();
         if (!file_exists_w(exe)) {
-            arc::log::error("Service: executable path does not exist");
+            ARC_LOG_ERROR("Service: executable path does not exist");
             return 1;
         }
         std::wstring cmd = L"\"" + exe + L"\" --service";
@@ -296,7 +328,7 @@ int main(int argc, char **argv) {
             if (is_safe_arg_utf8(config_path)) {
                 cmd += L" --config \"" + to_w(config_path) + L"\"";
             } else {
-                arc::log::warn("Service: unsafe characters in config path; skipping --config");
+                ARC_LOG_WARN("Service: unsafe characters in config path; skipping --config");
             }
         }
         bool ok = true;
@@ -356,6 +388,13 @@ int main(int argc, char **argv) {
         bool task_present = arc::task::exists(taskName);
         auto history = arc::persistence::restart_history();
         std::string history_last = history.empty() ? "" : to_iso8601(history.back());
+        // Live hook metrics from the running instance (if any)
+        const arc::metrics::HookMetrics *hm = arc::metrics::open_published();
+        arc::metrics::LatencySummary lat, trans;
+        if (hm) {
+            lat = hm->hook_latency_ns.summarize();
+            trans = hm->transition_ns.summarize();
+        }
         auto bool_word = [](bool v) { return v ? "true" : "false"; };
         if (do_status_json) {
             std::ostringstream oss;
@@ -373,6 +412,7 @@ int main(int argc, char **argv) {
             }
             oss << "],";
             oss << "\"trigger\":\"" << trigger_name(status_cfg.trigger) << "\",";
+            oss << "\"armed_hook\":" << (status_cfg.armed_hook ? "true" : "false") << ",";
             oss << "\"watch_config\":" << (status_cfg.watch_config ? "true" : "false") << ",";
             oss << "\"log_thread_id\":" << (status_cfg.log_thread_id ? "true" : "false") << ",";
             oss << "\"persistence_enabled\":" << (status_cfg.persistence_enabled ? "true" : "false") << ",";
@@ -386,6 +426,38 @@ int main(int argc, char **argv) {
                 oss << "null";
             else
                 oss << "\"" << escape_json(history_last) << "\"";
+            oss << ",\"hook_metrics\":";
+            if (!hm) {
+                oss << "null";
+            } else {
+                oss << "{";
+                oss << "\"pid\":" << hm->pid.load() << ",";
+                oss << "\"latency_ns\":{";
+                oss << "\"count\":" << lat.count << ",";
+                oss << "\"mean\":" << lat.mean << ",";
+                oss << "\"p50\":" << lat.p50 << ",";
+                oss << "\"p99\":" << lat.p99 << ",";
+                oss << "\"p999\":" << lat.p999 << ",";
+                oss << "\"max\":" << lat.max << "},";
+                oss << "\"events\":{";
+                for (unsigned t = 0; t < arc::metrics::kEventTypeCount; ++t) {
+                    if (t)
+                        oss << ",";
+                    oss << "\"" << arc::metrics::event_type_name(t) << "\":" << hm->events[t].load();
+                }
+                oss << "},";
+                oss << "\"swallowed\":" << hm->swallowed.load() << ",";
+                oss << "\"skipped_injected\":" << hm->skipped_injected.load() << ",";
+                oss << "\"hook_installed\":" << bool_word(hm->hook_installed.load() != 0) << ",";
+                oss << "\"installs\":" << hm->installs.load() << ",";
+                oss << "\"uninstalls\":" << hm->uninstalls.load() << ",";
+                oss << "\"install_failures\":" << hm->install_failures.load() << ",";
+                oss << "\"transition_ns\":{";
+                oss << "\"count\":" << trans.count << ",";
+                oss << "\"p50\":" << trans.p50 << ",";
+                oss << "\"max\":" << trans.max << "}";
+                oss << "}";
+            }
             oss << "}";
             std::cout << oss.str() << std::endl;
         } else {
@@ -395,6 +467,7 @@ int main(int argc, char **argv) {
             std::cout << "modifier_vk=0x" << std::hex << status_cfg.modifier_vk << std::dec << "\n";
             std::cout << "modifier_combo_count=" << status_cfg.modifier_combo_vks.size() << "\n";
             std::cout << "trigger=" << trigger_name(status_cfg.trigger) << "\n";
+            std::cout << "armed_hook=" << bool_word(status_cfg.armed_hook) << "\n";
             std::cout << "watch_config=" << bool_word(status_cfg.watch_config) << "\n";
             std::cout << "log_thread_id=" << bool_word(status_cfg.log_thread_id) << "\n";
             std::cout << "persistence_enabled=" << bool_word(status_cfg.persistence_enabled) << "\n";
@@ -404,7 +477,29 @@ int main(int argc, char **argv) {
             std::cout << "monitor_running=" << bool_word(monitor_running) << "\n";
             std::cout << "restart_history_count=" << history.size() << "\n";
             std::cout << "restart_history_last=" << (history.empty() ? "none" : history_last) << "\n";
+            if (!hm) {
+                std::cout << "hook_metrics=unavailable\n";
+            } else {
+                std::cout << "hook_latency_ns=count:" << lat.count << " mean:" << lat.mean << " p50:" << lat.p50
+                          << " p99:" << lat.p99 << " p999:" << lat.p999 << " max:" << lat.max << "\n";
+                std::cout << "hook_events=";
+                for (unsigned t = 0; t < arc::metrics::kEventTypeCount; ++t) {
+                    if (t)
+                        std::cout << " ";
+                    std::cout << arc::metrics::event_type_name(t) << ":" << hm->events[t].load();
+                }
+                std::cout << "\n";
+                std::cout << "hook_swallowed=" << hm->swallowed.load() << "\n";
+                std::cout << "hook_skipped_injected=" << hm->skipped_injected.load() << "\n";
+                std::cout << "hook_installed=" << bool_word(hm->hook_installed.load() != 0) << "\n";
+                std::cout << "hook_transitions=installs:" << hm->installs.load()
+                          << " uninstalls:" << hm->uninstalls.load()
+                          << " failures:" << hm->install_failures.load() << "\n";
+                std::cout << "hook_transition_ns=count:" << trans.count << " p50:" << trans.p50
+                          << " max:" << trans.max << "\n";
+            }
         }
+        arc::metrics::close_published(hm);
         return 0;
     }
 
@@ -415,7 +510,7 @@ int main(int argc, char **argv) {
     // Normal interactive app: enforce single instance, load config, init hook, tray, message loop
     arc::singleton::SingletonGuard instance(arc::singleton::default_name());
     if (!instance.acquired()) {
-        arc::log::warn("altrightclick is already running.");
+        ARC_LOG_WARN("altrightclick is already running.");
         return 0;
     }
     // Auto-create default config on first run if missing
@@ -438,21 +533,26 @@ int main(int argc, char **argv) {
         cfg.persistence_enabled = (cli_persistence == 1);
     arc::log::set_level_by_name(cfg.log_level);
     arc::log::set_include_thread_id(cfg.log_thread_id);
+    arc::log::set_flush_policy({cfg.log_flush_ms, cfg.log_flush_bytes});
+    arc::log::set_timestamp_precision(static_cast<arc::log::Precision>(cfg.log_time_digits));
     if (!cfg.log_file.empty())
         arc::log::set_file(cfg.log_file);
-    arc::log::info(std::string("altrightclick ") + ARC_VERSION);
-    arc::log::info(std::string("Using config: ") + config_path);
+    ARC_LOG_INFO(std::string("altrightclick ") + ARC_VERSION);
+    ARC_LOG_INFO("Using config: " + config_path);
     arc::hook::apply_hook_config(cfg);
     arc::log::start_async();
 
     if (!cfg.enabled) {
-        arc::log::info("altrightclick: disabled in config.");
+        ARC_LOG_INFO("altrightclick: disabled in config.");
         return 0;
     }
 
+    if (!cli_trace_file.empty() && !arc::hook::record_trace(cli_trace_file))
+        return 1;
+
     // Start hook + tray workers
     if (!arc::hook::start()) {
-        arc::log::error("Failed to start hook worker");
+        ARC_LOG_ERROR("Failed to start hook worker");
         return 1;
     }
     // Optionally start persistence monitor (detached process) to revive the app if it crashes
@@ -462,7 +562,8 @@ int main(int argc, char **argv) {
     }
     std::atomic<bool> exitRequested{false};
     std::filesystem::path config_path_fs = std::filesystem::path(config_path);
-    arc::tray::TrayContext trayCtx{cfg, config_path_fs, exitRequested};
+    std::mutex cfgMutex;  // guards cfg once the tray and watcher threads run
+    arc::tray::TrayContext trayCtx{cfg, config_path_fs, exitRequested, cfgMutex};
     if (cfg.show_tray) {
         arc::tray::start(L"AltRightClick running (Alt+Left => Right)", &trayCtx);
     }
@@ -471,8 +572,11 @@ int main(int argc, char **argv) {
     std::atomic<bool> watchStop{false};
     std::thread watchThread;
     auto start_watch = [&]() {
-        if (!cfg.watch_config)
-            return;
+        {
+            std::lock_guard<std::mutex> lock(cfgMutex);
+            if (!cfg.watch_config)
+                return;
+        }
         watchThread = std::thread([&]() {
             auto get_mtime = [](const std::wstring &p) -> ULONGLONG {
                 WIN32_FILE_ATTRIBUTE_DATA fad{};
@@ -498,12 +602,17 @@ int main(int argc, char **argv) {
                         newCfg.log_file = cli_log_file;
                     arc::log::set_level_by_name(newCfg.log_level);
                     arc::log::set_include_thread_id(newCfg.log_thread_id);
+                    arc::log::set_flush_policy({newCfg.log_flush_ms, newCfg.log_flush_bytes});
+                    arc::log::set_timestamp_precision(static_cast<arc::log::Precision>(newCfg.log_time_digits));
                     if (!newCfg.log_file.empty())
                         arc::log::set_file(newCfg.log_file);
-                    arc::hook::apply_hook_config(newCfg);
-                    trayCtx.cfg = newCfg;
+                    {
+                        std::lock_guard<std::mutex> lock(cfgMutex);
+                        arc::hook::apply_hook_config(newCfg);
+                        trayCtx.cfg = newCfg;
+                    }
                     arc::tray::notify(L"altrightclick", L"Configuration reloaded");
-                    arc::log::info("Configuration reloaded");
+                    ARC_LOG_INFO("Configuration reloaded");
                 }
             }
         });
@@ -511,14 +620,26 @@ int main(int argc, char **argv) {
     start_watch();
 
     // Controller: poll for exit key or tray Exit
-    arc::log::info("Alt + Left Click => Right Click. Press exit key to quit.");
+    ARC_LOG_INFO("Alt + Left Click => Right Click. Press exit key to quit.");
+    ULONGLONG lastTune = GetTickCount64();
     while (true) {
         if (exitRequested.load())
             break;
         if (g_console_shutdown.load())
             break;
-        if (cfg.exit_vk && (GetAsyncKeyState(static_cast<int>(cfg.exit_vk)) & 0x8000))
+        unsigned int exitVk;
+        bool tune;
+        {
+            std::lock_guard<std::mutex> lock(cfgMutex);
+            exitVk = cfg.exit_vk;
+            tune = cfg.auto_tune;
+        }
+        if (exitVk && (GetAsyncKeyState(static_cast<int>(exitVk)) & 0x8000))
             break;
+        if (tune && GetTickCount64() - lastTune >= 60000) {
+            lastTune = GetTickCount64();
+            auto_tune(cfg, cfgMutex);
+        }
         Sleep(50);
     }
 
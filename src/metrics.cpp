@@ -0,0 +1,87 @@
+/**
+ * @file metrics.cpp
+ * @brief Publication of hook metrics through a named shared memory section.
+ *
+ * The interactive instance creates a small session-local file mapping and
+ * constructs a HookMetrics block in it; `--status` opens the same mapping
+ * read-only. The section disappears with the last handle, so a stale block
+ * is never reported after the instance exits.
+ */
+
+#include "arc/metrics.h"
+
+#include <windows.h>
+
+#include <new>
+
+#include "arc/log.h"
+
+namespace {
+
+/// Session-local section name; matches the interactive singleton's scope.
+const wchar_t *kMetricsName = L"Local\\AltRightClick.Metrics";
+
+HANDLE g_mapping = nullptr;              ///< Section handle kept open by the publisher.
+arc::metrics::HookMetrics *g_view = nullptr;  ///< Publisher's mapped block.
+arc::metrics::HookMetrics g_local;       ///< Fallback when the section cannot be created.
+
+}  // namespace
+
+namespace arc::metrics {
+
+/**
+ * Creates the section on first use and constructs the block in place.
+ * Subsequent calls return the same pointer.
+ */
+HookMetrics *publish() {
+    if (g_view)
+        return g_view;
+    g_mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+                                   static_cast<DWORD>(sizeof(HookMetrics)), kMetricsName);
+    if (!g_mapping) {
+        ARC_LOG_WARN("metrics: CreateFileMapping failed: " + arc::log::last_error_message(GetLastError()));
+        g_view = &g_local;
+        return g_view;
+    }
+    void *mem = MapViewOfFile(g_mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(HookMetrics));
+    if (!mem) {
+        ARC_LOG_WARN("metrics: MapViewOfFile failed: " + arc::log::last_error_message(GetLastError()));
+        CloseHandle(g_mapping);
+        g_mapping = nullptr;
+        g_view = &g_local;
+        return g_view;
+    }
+    // Sections start zero-filled; construct the block so magic/version are set
+    g_view = new (mem) HookMetrics();
+    g_view->pid.store(GetCurrentProcessId(), std::memory_order_release);
+    return g_view;
+}
+
+/**
+ * Opens the running instance's section read-only. Returns nullptr if there
+ * is none or its layout does not match this build.
+ */
+const HookMetrics *open_published() {
+    HANDLE h = OpenFileMappingW(FILE_MAP_READ, FALSE, kMetricsName);
+    if (!h)
+        return nullptr;
+    void *mem = MapViewOfFile(h, FILE_MAP_READ, 0, 0, sizeof(HookMetrics));
+    // The view keeps the section alive; the handle is no longer needed
+    CloseHandle(h);
+    if (!mem)
+        return nullptr;
+    const HookMetrics *m = static_cast<const HookMetrics *>(mem);
+    if (m->magic != HookMetrics::kMagic || m->version != HookMetrics::kVersion) {
+        UnmapViewOfFile(mem);
+        return nullptr;
+    }
+    return m;
+}
+
+/** Unmaps a view obtained from open_published. */
+void close_published(const HookMetrics *m) {
+    if (m)
+        UnmapViewOfFile(m);
+}
+
+}  // namespace arc::metrics
@@ -0,0 +1,86 @@
+/**
+ * @file modifiers.cpp
+ * @brief Side-specific modifier bookkeeping for the cached modifier mask.
+ */
+
+#include "arc/modifiers.h"
+
+#include "arc/gesture.h"
+
+namespace arc::modifiers {
+
+namespace {
+
+/// Side-specific modifier keys, in key-bit order.
+constexpr unsigned int kSideKeys[] = {
+    0xA4, 0xA5,  // VK_LMENU, VK_RMENU
+    0xA2, 0xA3,  // VK_LCONTROL, VK_RCONTROL
+    0xA0, 0xA1,  // VK_LSHIFT, VK_RSHIFT
+    0x5B, 0x5C,  // VK_LWIN, VK_RWIN
+};
+constexpr int kSideKeyCount = static_cast<int>(sizeof(kSideKeys) / sizeof(kSideKeys[0]));
+
+/** Returns the key bit for @p vk, or -1 if it is not a modifier. */
+int key_bit(unsigned int vk) {
+    switch (vk) {
+    case 0x12:  // VK_MENU
+        return 0;
+    case 0x11:  // VK_CONTROL
+        return 2;
+    case 0x10:  // VK_SHIFT
+        return 4;
+    default:
+        break;
+    }
+    for (int i = 0; i < kSideKeyCount; ++i) {
+        if (kSideKeys[i] == vk)
+            return i;
+    }
+    return -1;
+}
+
+/** Folds left/right key bits into arc::gesture::Modifier bits. */
+std::uint32_t fold(std::uint32_t keys) {
+    std::uint32_t mods = 0;
+    if (keys & 0x03u)
+        mods |= arc::gesture::kModAlt;
+    if (keys & 0x0Cu)
+        mods |= arc::gesture::kModCtrl;
+    if (keys & 0x30u)
+        mods |= arc::gesture::kModShift;
+    if (keys & 0xC0u)
+        mods |= arc::gesture::kModWin;
+    return mods;
+}
+
+}  // namespace
+
+/** Stores the key bits and the folded mask readers consume. */
+void Tracker::publish(std::uint32_t keys) {
+    keys_.store(keys, std::memory_order_relaxed);
+    held_.store(fold(keys), std::memory_order_release);
+}
+
+/** Sets or clears the bit for @p vk and republishes on change. */
+bool Tracker::on_key(unsigned int vk, bool down) {
+    int bit = key_bit(vk);
+    if (bit < 0)
+        return false;
+    std::uint32_t cur = keys_.load(std::memory_order_relaxed);
+    std::uint32_t next = down ? (cur | (1u << bit)) : (cur & ~(1u << bit));
+    if (next != cur)
+        publish(next);
+    return true;
+}
+
+/** Rebuilds the key bits from the real key state. */
+void Tracker::resync(KeyStateFn is_down) {
+    std::uint32_t keys = 0;
+    for (int i = 0; i < kSideKeyCount; ++i) {
+        if (is_down(kSideKeys[i]))
+            keys |= 1u << i;
+    }
+    publish(keys);
+}
+
+}  // namespace arc::modifiers
@@ -63,13 +63,13 @@ bool spawn_monitor(const std::wstring &exe_path, const std::string &config_path)
     BOOL ok = CreateProcessW(/*lpApplicationName*/ nullptr, mutable_cmd.data(), nullptr, nullptr, FALSE,
                              CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi);
     if (!ok) {
-        arc::log::warn("persistence: failed to spawn monitor: " + arc::log::last_error_message(GetLastError()));
+        ARC_LOG_WARN("persistence: failed to spawn monitor: " + arc::log::last_error_message(GetLastError()));
         return false;
     }
     g_monitorPid.store(pi.dwProcessId);
     CloseHandle(pi.hThread);
     CloseHandle(pi.hProcess);
-    arc::log::info("persistence: monitor started");
+    ARC_LOG_INFO("persistence: monitor started");
     return true;
 }
 
@@ -155,7 +155,7 @@ static DWORD spawn_child(const std::wstring &exe_path, const std::wstring &confi
     BOOL ok = CreateProcessW(nullptr, mutable_cmd.data(), nullptr, nullptr, FALSE, CREATE_NO_WINDOW, nullptr, nullptr,
                              &si, &pi);
     if (!ok) {
-        arc::log::warn("persistence: failed to relaunch app: " + arc::log::last_error_message(GetLastError()));
+        ARC_LOG_WARN("persistence: failed to relaunch app: " + arc::log::last_error_message(GetLastError()));
         return (DWORD)-1;
     }
     *out_pi = pi;
@@ -265,7 +265,7 @@ int run_monitor(unsigned long parent_pid, const std::wstring &exe_path, const st
             save_restart_history(history_path, restarts);
         }
         if (static_cast<int>(restarts.size()) >= kMaxRestarts) {
-            arc::log::warn("persistence: too many restarts; sleeping for a minute");
+            ARC_LOG_WARN("persistence: too many restarts; sleeping for a minute");
             std::this_thread::sleep_for(kWindow);
             continue;
         }
@@ -302,10 +302,10 @@ int run_monitor(unsigned long parent_pid, const std::wstring &exe_path, const st
         }
         if (exit_code == 0 || intentional) {
             // Normal shutdown; stop monitoring
-            arc::log::info("persistence: child exited normally; stopping monitor");
+            ARC_LOG_INFO("persistence: child exited normally; stopping monitor");
             break;
         }
-        arc::log::warn("persistence: child exited abnormally; restarting...");
+        ARC_LOG_WARN("persistence: child exited abnormally; restarting...");
         restarts.push_back(std::chrono::system_clock::now());
         save_restart_history(history_path, restarts);
         std::this_thread::sleep_for(backoff);
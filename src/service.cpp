@@ -104,7 +104,7 @@ void WINAPI SvcMain(DWORD, LPTSTR *) {
 
     g_SvcStatusHandle = RegisterServiceCtrlHandlerW(L"AltRightClickService", SvcCtrlHandler);
     if (!g_SvcStatusHandle) {
-        arc::log::error("RegisterServiceCtrlHandlerW failed: " + arc::log::last_error_message(GetLastError()));
+        ARC_LOG_ERROR("RegisterServiceCtrlHandlerW failed: " + arc::log::last_error_message(GetLastError()));
         return;
     }
 
@@ -114,7 +114,7 @@ void WINAPI SvcMain(DWORD, LPTSTR *) {
     {
         arc::singleton::SingletonGuard guard(arc::singleton::service_name());
         if (!guard.acquired()) {
-            arc::log::warn("Service instance already running (singleton acquired by another process)");
+            ARC_LOG_WARN("Service instance already running (singleton acquired by another process)");
             ReportSvcStatus(SERVICE_STOPPED, NO_ERROR, 0);
             return;
         }
@@ -122,7 +122,7 @@ void WINAPI SvcMain(DWORD, LPTSTR *) {
 
     // Start hook worker on its own thread (installs its own hook + private message loop)
     if (!arc::hook::start()) {
-        arc::log::error("Service: failed to start hook worker");
+        ARC_LOG_ERROR("Service: failed to start hook worker");
         ReportSvcStatus(SERVICE_STOPPED, ERROR_SERVICE_SPECIFIC_ERROR, 2);
         return;
     }
@@ -178,16 +178,16 @@ namespace arc::service {
 bool install(const std::wstring &name, const std::wstring &display_name, const std::wstring &bin_path_with_args) {
     // Basic validation: ensure it starts with a quoted path and has no CR/LF
     if (bin_path_with_args.find(L"\n") != std::wstring::npos || bin_path_with_args.find(L"\r") != std::wstring::npos) {
-        arc::log::error("service_install: binpath contains newline characters");
+        ARC_LOG_ERROR("service_install: binpath contains newline characters");
         return false;
     }
     if (bin_path_with_args.empty() || bin_path_with_args[0] != L'\"') {
-        arc::log::error("service_install: binpath must start with a quoted executable path");
+        ARC_LOG_ERROR("service_install: binpath must start with a quoted executable path");
         return false;
     }
     SC_HANDLE scm = OpenSCManagerW(nullptr, nullptr, SC_MANAGER_CREATE_SERVICE);
     if (!scm) {
-        arc::log::error("OpenSCManagerW failed: " + arc::log::last_error_message(GetLastError()));
+        ARC_LOG_ERROR("OpenSCManagerW failed: " + arc::log::last_error_message(GetLastError()));
         return false;
     }
 
@@ -196,7 +196,7 @@ bool install(const std::wstring &name, const std::wstring &display_name, const s
                                    bin_path_with_args.c_str(), nullptr, nullptr, nullptr, nullptr, nullptr);
 
     if (!svc) {
-        arc::log::error("CreateServiceW failed: " + arc::log::last_error_message(GetLastError()));
+        ARC_LOG_ERROR("CreateServiceW failed: " + arc::log::last_error_message(GetLastError()));
         CloseServiceHandle(scm);
         return false;
     }
@@ -218,12 +218,12 @@ bool install(const std::wstring &name, const std::wstring &display_name, const s
 bool uninstall(const std::wstring &name) {
     SC_HANDLE scm = OpenSCManagerW(nullptr, nullptr, SC_MANAGER_CONNECT);
     if (!scm) {
-        arc::log::error("OpenSCManagerW failed: " + arc::log::last_error_message(GetLastError()));
+        ARC_LOG_ERROR("OpenSCManagerW failed: " + arc::log::last_error_message(GetLastError()));
         return false;
     }
     SC_HANDLE svc = OpenServiceW(scm, name.c_str(), DELETE);
     if (!svc) {
-        arc::log::error("OpenServiceW(DELETE) failed: " + arc::log::last_error_message(GetLastError()));
+        ARC_LOG_ERROR("OpenServiceW(DELETE) failed: " + arc::log::last_error_message(GetLastError()));
         CloseServiceHandle(scm);
         return false;
     }
@@ -244,12 +244,12 @@ bool uninstall(const std::wstring &name) {
 bool start(const std::wstring &name) {
     SC_HANDLE scm = OpenSCManagerW(nullptr, nullptr, SC_MANAGER_CONNECT);
     if (!scm) {
-        arc::log::error("OpenSCManagerW failed: " + arc::log::last_error_message(GetLastError()));
+        ARC_LOG_ERROR("OpenSCManagerW failed: " + arc::log::last_error_message(GetLastError()));
         return false;
     }
     SC_HANDLE svc = OpenServiceW(scm, name.c_str(), SERVICE_START);
     if (!svc) {
-        arc::log::error("OpenServiceW(START) failed: " + arc::log::last_error_message(GetLastError()));
+        ARC_LOG_ERROR("OpenServiceW(START) failed: " + arc::log::last_error_message(GetLastError()));
         CloseServiceHandle(scm);
         return false;
     }
@@ -272,12 +272,12 @@ bool start(const std::wstring &name) {
 bool stop(const std::wstring &name) {
     SC_HANDLE scm = OpenSCManagerW(nullptr, nullptr, SC_MANAGER_CONNECT);
     if (!scm) {
-        arc::log::error("OpenSCManagerW failed: " + arc::log::last_error_message(GetLastError()));
+        ARC_LOG_ERROR("OpenSCManagerW failed: " + arc::log::last_error_message(GetLastError()));
         return false;
     }
     SC_HANDLE svc = OpenServiceW(scm, name.c_str(), SERVICE_STOP);
     if (!svc) {
-        arc::log::error("OpenServiceW(STOP) failed: " + arc::log::last_error_message(GetLastError()));
+        ARC_LOG_ERROR("OpenServiceW(STOP) failed: " + arc::log::last_error_message(GetLastError()));
         CloseServiceHandle(scm);
         return false;
     }
@@ -332,7 +332,7 @@ int run(const std::wstring &name) {
     SERVICE_TABLE_ENTRYW dispatchTable[] = {{const_cast<LPWSTR>(name.c_str()), (LPSERVICE_MAIN_FUNCTIONW)SvcMain},
                                             {nullptr, nullptr}};
     if (!StartServiceCtrlDispatcherW(dispatchTable)) {
-        arc::log::error("StartServiceCtrlDispatcherW failed: " + arc::log::last_error_message(GetLastError()));
+        ARC_LOG_ERROR("StartServiceCtrlDispatcherW failed: " + arc::log::last_error_message(GetLastError()));
         return 1;
     }
     return 0;
@@ -0,0 +1,265 @@
+/**
+ * @file stroke.cpp
+ * @brief Stroke resampling, template shapes and Protractor-style matching.
+ */
+
+#include "arc/stroke.h"
+
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#endif
+
+namespace arc::stroke {
+
+namespace {
+
+constexpr int kLanes = 8;  ///< Independent partial sums in @ref dot_cross.
+static_assert(kSamples % kLanes == 0, "samples must fill whole lanes");
+
+const float kCos = std::cos(kMaxRotation);
+const float kSin = std::sin(kMaxRotation);
+const float kTan = std::tan(kMaxRotation);
+
+/** Euclidean length of (dx, dy); std::hypot's overflow care is not needed for pixel deltas. */
+inline float length_of(float dx, float dy) { return std::sqrt(dx * dx + dy * dy); }
+
+/**
+ * Dot and cross products of two sample arrays. The partial sums live in
+ * separate lanes so the loop vectorizes without reassociating floats.
+ */
+inline void dot_cross(const float *ax, const float *ay, const float *bx, const float *by, float &dot, float &cross) {
+    float d[kLanes] = {}, c[kLanes] = {};
+    for (int i = 0; i < kSamples; i += kLanes) {
+        for (int l = 0; l < kLanes; ++l) {
+            d[l] += ax[i + l] * bx[i + l] + ay[i + l] * by[i + l];
+            c[l] += ax[i + l] * by[i + l] - ay[i + l] * bx[i + l];
+        }
+    }
+    dot = 0.f;
+    cross = 0.f;
+    for (int l = 0; l < kLanes; ++l) {
+        dot += d[l];
+        cross += c[l];
+    }
+}
+
+/**
+ * Dot and cross products of @p v with four interleaved templates (stride
+ * kBlock): one 4-wide multiply-add per sample and sum. Written with SSE
+ * where available because GCC's -O3 loop vectorizer turns the plain form
+ * into a shuffle-heavy reduction over samples, slower than scalar code.
+ */
+inline void dot_cross4(const float *bx, const float *by, const Vector &v, float *dot, float *cross) {
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    __m128 d = _mm_setzero_ps(), c = _mm_setzero_ps();
+    for (int i = 0; i < kSamples; ++i, bx += kBlock, by += kBlock) {
+        const __m128 vx = _mm_set1_ps(v.x[i]), vy = _mm_set1_ps(v.y[i]);
+        const __m128 tx = _mm_loadu_ps(bx), ty = _mm_loadu_ps(by);
+        d = _mm_add_ps(d, _mm_add_ps(_mm_mul_ps(tx, vx), _mm_mul_ps(ty, vy)));
+        c = _mm_add_ps(c, _mm_sub_ps(_mm_mul_ps(tx, vy), _mm_mul_ps(ty, vx)));
+    }
+    _mm_storeu_ps(dot, d);
+    _mm_storeu_ps(cross, c);
+#else
+    for (int l = 0; l < 4; ++l) {
+        dot[l] = 0.f;
+        cross[l] = 0.f;
+    }
+    for (int i = 0; i < kSamples; ++i, bx += kBlock, by += kBlock) {
+        for (int l = 0; l < 4; ++l) {
+            dot[l] += bx[l] * v.x[i] + by[l] * v.y[i];
+            cross[l] += bx[l] * v.y[i] - by[l] * v.x[i];
+        }
+    }
+#endif
+}
+
+/**
+ * Best value of dot * cos(t) + cross * sin(t) for |t| <= kMaxRotation:
+ * the unconstrained optimum hypot(dot, cross) when its angle is in range,
+ * else the value at the limit.
+ */
+inline float rotated_score(float dot, float cross) {
+    float across = std::fabs(cross);
+    float free = std::sqrt(dot * dot + cross * cross);
+    float limit = dot * kCos + across * kSin;
+    return dot > 0.f && across <= dot * kTan ? free : limit;
+}
+
+}  // namespace
+
+/** One letter per segment, no letter twice in a row. */
+bool parse_shape(const char *text, Shape &out) {
+    Shape s;
+    int prev = -1;
+    for (const char *p = text; *p; ++p) {
+        int d;
+        switch (*p) {
+        case 'L':
+        case 'l':
+            d = static_cast<int>(Direction::Left);
+            break;
+        case 'R':
+        case 'r':
+            d = static_cast<int>(Direction::Right);
+            break;
+        case 'U':
+        case 'u':
+            d = static_cast<int>(Direction::Up);
+            break;
+        case 'D':
+        case 'd':
+            d = static_cast<int>(Direction::Down);
+            break;
+        default:
+            return false;
+        }
+        if (d == prev || s.count == kMaxSegments)
+            return false;
+        s.dirs = static_cast<std::uint8_t>(s.dirs | (d << (2 * s.count)));
+        ++s.count;
+        prev = d;
+    }
+    if (s.count == 0)
+        return false;
+    out = s;
+    return true;
+}
+
+void format_shape(Shape shape, char *out) {
+    static const char kLetters[] = {'L', 'R', 'U', 'D'};
+    int n = shape.count <= kMaxSegments ? shape.count : kMaxSegments;
+    for (int i = 0; i < n; ++i)
+        out[i] = kLetters[static_cast<int>(shape.at(i))];
+    out[n] = '\0';
+}
+
+/**
+ * Walks the polyline emitting a sample every length / (kSamples - 1) pixels
+ * (interpolating inside segments), then centres and scales the samples.
+ */
+bool normalize(const std::int32_t *xs, const std::int32_t *ys, int n, Vector &out) {
+    if (n < 2)
+        return false;
+    float length = 0.f;
+    for (int i = 1; i < n; ++i)
+        length += length_of(static_cast<float>(xs[i] - xs[i - 1]), static_cast<float>(ys[i] - ys[i - 1]));
+    if (length <= 0.f)
+        return false;
+    const float step = length / static_cast<float>(kSamples - 1);
+    float px = static_cast<float>(xs[0]), py = static_cast<float>(ys[0]);
+    out.x[0] = px;
+    out.y[0] = py;
+    int count = 1;
+    float walked = 0.f;  // distance since the last sample
+    for (int i = 1; i < n && count < kSamples; ++i) {
+        float cx = static_cast<float>(xs[i]), cy = static_cast<float>(ys[i]);
+        float d = length_of(cx - px, cy - py);
+        while (d > 0.f && walked + d >= step && count < kSamples) {
+            float t = (step - walked) / d;
+            px += t * (cx - px);
+            py += t * (cy - py);
+            out.x[count] = px;
+            out.y[count] = py;
+            ++count;
+            walked = 0.f;
+            d = length_of(cx - px, cy - py);
+        }
+        walked += d;
+        px = cx;
+        py = cy;
+    }
+    // Rounding can leave the last sample short of the end point
+    for (; count < kSamples; ++count) {
+        out.x[count] = static_cast<float>(xs[n - 1]);
+        out.y[count] = static_cast<float>(ys[n - 1]);
+    }
+    float mx = 0.f, my = 0.f;
+    for (int i = 0; i < kSamples; ++i) {
+        mx += out.x[i];
+        my += out.y[i];
+    }
+    mx /= kSamples;
+    my /= kSamples;
+    float norm = 0.f;
+    for (int i = 0; i < kSamples; ++i) {
+        out.x[i] -= mx;
+        out.y[i] -= my;
+        norm += out.x[i] * out.x[i] + out.y[i] * out.y[i];
+    }
+    if (norm <= 0.f)
+        return false;
+    float inv = 1.f / std::sqrt(norm);
+    for (int i = 0; i < kSamples; ++i) {
+        out.x[i] *= inv;
+        out.y[i] *= inv;
+    }
+    return true;
+}
+
+/** Equal-length segments from the origin, resampled like a recorded stroke. */
+bool shape_vector(Shape shape, Vector &out) {
+    if (shape.count == 0 || shape.count > kMaxSegments)
+        return false;
+    static const std::int32_t kDx[] = {-1, 1, 0, 0};
+    static const std::int32_t kDy[] = {0, 0, -1, 1};
+    constexpr std::int32_t kLength = 100;
+    std::int32_t xs[kMaxSegments + 1] = {}, ys[kMaxSegments + 1] = {};
+    for (int i = 0; i < shape.count; ++i) {
+        auto d = static_cast<int>(shape.at(i));
+        xs[i + 1] = xs[i] + kDx[d] * kLength;
+        ys[i + 1] = ys[i] + kDy[d] * kLength;
+    }
+    return normalize(xs, ys, shape.count + 1, out);
+}
+
+float similarity(const Vector &a, const Vector &b) {
+    float dot, cross;
+    dot_cross(a.x, a.y, b.x, b.y, dot, cross);
+    return rotated_score(dot, cross);
+}
+
+int Library::add(const Vector &v) {
+    if (count_ == kMaxTemplates)
+        return -1;
+    float *bx = x_ + (count_ / kBlock) * kSamples * kBlock + count_ % kBlock;
+    float *by = y_ + (count_ / kBlock) * kSamples * kBlock + count_ % kBlock;
+    for (int i = 0; i < kSamples; ++i) {
+        bx[i * kBlock] = v.x[i];
+        by[i * kBlock] = v.y[i];
+    }
+    return count_++;
+}
+
+/**
+ * Scores a block of kBlock templates per pass: each lane accumulates one
+ * template over the samples in order, so the lane loop is a plain vector
+ * multiply-add and each sum matches the scalar one. Lanes past count_ hold
+ * zeros or templates from before clear() and are never picked.
+ */
+Match Library::best(const Vector &v) const {
+    Match m;
+    for (int base = 0; base < count_; base += kBlock) {
+        const float *bx = x_ + base * kSamples;
+        const float *by = y_ + base * kSamples;
+        float dot[kBlock], cross[kBlock];
+        static_assert(kBlock % 4 == 0, "blocks are scored four templates at a time");
+        for (int q = 0; q < kBlock; q += 4)
+            dot_cross4(bx + q, by + q, v, dot + q, cross + q);
+        float score[kBlock];
+        for (int l = 0; l < kBlock; ++l)
+            score[l] = rotated_score(dot[l], cross[l]);
+        int lanes = count_ - base < kBlock ? count_ - base : kBlock;
+        for (int l = 0; l < lanes; ++l) {
+            if (score[l] > m.score) {
+                m.score = score[l];
+                m.index = base + l;
+            }
+        }
+    }
+    return m;
+}
+
+}  // namespace arc::stroke
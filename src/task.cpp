@@ -59,7 +59,7 @@ bool run_schtasks(const std::wstring &args) {
     std::wstring mutable_cmd = cmd;
     if (!CreateProcessW(nullptr, mutable_cmd.data(), nullptr, nullptr, FALSE, CREATE_NO_WINDOW, nullptr, nullptr, &si,
                         &pi)) {
-        arc::log::error("CreateProcessW(schtasks) failed: " + arc::log::last_error_message(GetLastError()));
+        ARC_LOG_ERROR("CreateProcessW(schtasks) failed: " + arc::log::last_error_message(GetLastError()));
         return false;
     }
     WaitForSingleObject(pi.hProcess, INFINITE);
@@ -68,7 +68,7 @@ bool run_schtasks(const std::wstring &args) {
     CloseHandle(pi.hThread);
     CloseHandle(pi.hProcess);
     if (code != 0) {
-        arc::log::error("schtasks exited with code " + std::to_string(code));
+        ARC_LOG_ERROR("schtasks exited with code " + std::to_string(code));
     }
     return code == 0;
 }
@@ -0,0 +1,210 @@
+/**
+ * @file timer_wheel.cpp
+ * @brief Hierarchical timer wheel implementation.
+ */
+
+#include "arc/timer_wheel.h"
+
+namespace arc::timer {
+
+namespace {
+
+constexpr std::uint64_t kSlotMask = Wheel::kSlots - 1;
+
+/// Farthest placement: half a top-level rotation, so a parked timer never lands in the top
+/// level's current slot. Farther timers are re-parked each time their slot comes up.
+constexpr std::uint64_t kMaxSpan = std::uint64_t{1} << (Wheel::kLevels * Wheel::kSlotBits - 1);
+
+/** Index of the highest set bit; @p v must be non-zero. */
+inline unsigned msb_index(std::uint64_t v) {
+    unsigned n = 0;
+    while (v >>= 1)
+        ++n;
+    return n;
+}
+
+/** Index of the lowest set bit; @p v must be non-zero. */
+inline unsigned lsb_index(std::uint64_t v) {
+    unsigned n = 0;
+    while (!(v & 1)) {
+        v >>= 1;
+        ++n;
+    }
+    return n;
+}
+
+/** Rotates @p v right by @p n bits (0 <= n < 64). */
+inline std::uint64_t rotr(std::uint64_t v, unsigned n) { return n ? (v >> n) | (v << (64 - n)) : v; }
+
+}  // namespace
+
+/** Builds the node pool and threads the free list through it. */
+Wheel::Wheel(std::size_t capacity, std::uint64_t now_ms) : nodes_(capacity), now_(now_ms) {
+    for (auto &level : heads_)
+        for (auto &h : level)
+            h = kNil;
+    for (std::size_t i = capacity; i-- > 0;) {
+        nodes_[i].next = free_;
+        free_ = static_cast<std::uint32_t>(i);
+    }
+}
+
+/** Returns the head of the list a linked node is on. */
+std::uint32_t &Wheel::head_of(const Node &n) { return n.level == kFiring ? due_ : heads_[n.level][n.slot]; }
+
+/**
+ * Places a node by its deadline relative to now_: the level is given by the
+ * highest 6-bit group in which the two differ, the slot by the deadline's
+ * bits in that group.
+ */
+void Wheel::link(std::uint32_t idx) {
+    Node &n = nodes_[idx];
+    std::uint64_t place = n.deadline;
+    if (place < now_)
+        place = now_;
+    else if (place - now_ > kMaxSpan)
+        place = now_ + kMaxSpan;
+    // Crossing a top-level boundary differs in bits above the wheel; that is
+    // still a top-level slot of the next rotation
+    unsigned level = msb_index((place ^ now_) | kSlotMask) / kSlotBits;
+    if (level >= kLevels)
+        level = kLevels - 1;
+    unsigned slot = static_cast<unsigned>((place >> (level * kSlotBits)) & kSlotMask);
+    n.level = static_cast<std::uint8_t>(level);
+    n.slot = static_cast<std::uint8_t>(slot);
+    n.prev = kNil;
+    n.next = heads_[level][slot];
+    if (n.next != kNil)
+        nodes_[n.next].prev = idx;
+    heads_[level][slot] = idx;
+    occupied_[level] |= std::uint64_t{1} << slot;
+}
+
+/** Removes a node from its slot or the due list. */
+void Wheel::unlink(std::uint32_t idx) {
+    Node &n = nodes_[idx];
+    if (n.prev != kNil)
+        nodes_[n.prev].next = n.next;
+    else
+        head_of(n) = n.next;
+    if (n.next != kNil)
+        nodes_[n.next].prev = n.prev;
+    if (n.level < kLevels && heads_[n.level][n.slot] == kNil)
+        occupied_[n.level] &= ~(std::uint64_t{1} << n.slot);
+}
+
+/** Returns a node to the free list, invalidating its id. */
+void Wheel::release(std::uint32_t idx) {
+    Node &n = nodes_[idx];
+    if (++n.generation == 0)
+        n.generation = 1;
+    n.level = kFree;
+    n.cb = nullptr;
+    n.ctx = nullptr;
+    n.next = free_;
+    free_ = idx;
+}
+
+/** Takes a node from the pool and links it into the wheel. */
+TimerId Wheel::schedule(std::uint64_t deadline_ms, Callback cb, void *ctx) {
+    if (free_ == kNil || !cb)
+        return 0;
+    std::uint32_t idx = free_;
+    Node &n = nodes_[idx];
+    free_ = n.next;
+    n.deadline = deadline_ms;
+    n.cb = cb;
+    n.ctx = ctx;
+    link(idx);
+    ++size_;
+    return (static_cast<TimerId>(n.generation) << 32) | idx;
+}
+
+/** Unlinks a pending timer if @p id still refers to it. */
+bool Wheel::cancel(TimerId id) {
+    std::uint32_t idx = static_cast<std::uint32_t>(id);
+    std::uint32_t gen = static_cast<std::uint32_t>(id >> 32);
+    if (idx >= nodes_.size() || nodes_[idx].generation != gen || nodes_[idx].level == kFree)
+        return false;
+    unlink(idx);
+    release(idx);
+    --size_;
+    return true;
+}
+
+/**
+ * Finds the earliest non-empty slot. Lower levels always expire first, so
+ * the first level with an occupied slot at or after the current position
+ * wins.
+ */
+bool Wheel::next_expiration(Expiration &out) const {
+    for (unsigned level = 0; level < kLevels; ++level) {
+        std::uint64_t occ = occupied_[level];
+        if (!occ)
+            continue;
+        unsigned shift = level * kSlotBits;
+        unsigned now_slot = static_cast<unsigned>((now_ >> shift) & kSlotMask);
+        unsigned slot = (now_slot + lsb_index(rotr(occ, now_slot))) & kSlotMask;
+        std::uint64_t level_range = std::uint64_t{1} << (shift + kSlotBits);
+        std::uint64_t deadline = (now_ & ~(level_range - 1)) + (static_cast<std::uint64_t>(slot) << shift);
+        if (slot < now_slot)
+            deadline += level_range;
+        out = Expiration{level, slot, deadline};
+        return true;
+    }
+    return false;
+}
+
+/** Earliest slot start, or kNever. */
+std::uint64_t Wheel::next_deadline() const {
+    Expiration e;
+    return next_expiration(e) ? e.deadline : kNever;
+}
+
+/**
+ * Processes expiring slots in time order: level-0 slots fire, higher slots
+ * cascade their timers closer. Due timers are moved to a separate list and
+ * popped one at a time so callbacks can cancel any of them.
+ */
+std::size_t Wheel::advance(std::uint64_t now_ms) {
+    if (now_ms < now_)
+        now_ms = now_;
+    std::size_t fired = 0;
+    Expiration e;
+    while (next_expiration(e) && e.deadline <= now_ms) {
+        if (e.deadline > now_)
+            now_ = e.deadline;
+        std::uint32_t idx = heads_[e.level][e.slot];
+        heads_[e.level][e.slot] = kNil;
+        occupied_[e.level] &= ~(std::uint64_t{1} << e.slot);
+        while (idx != kNil) {
+            std::uint32_t next = nodes_[idx].next;
+            if (e.level == 0 || nodes_[idx].deadline <= now_) {
+                Node &n = nodes_[idx];
+                n.level = kFiring;
+                n.prev = kNil;
+                n.next = due_;
+                if (due_ != kNil)
+                    nodes_[due_].prev = idx;
+                due_ = idx;
+            } else {
+                link(idx);
+            }
+            idx = next;
+        }
+        while (due_ != kNil) {
+            idx = due_;
+            Callback cb = nodes_[idx].cb;
+            void *ctx = nodes_[idx].ctx;
+            unlink(idx);
+            release(idx);
+            --size_;
+            cb(ctx, now_);
+            ++fired;
+        }
+    }
+    now_ = now_ms;
+    return fired;
+}
+
+}  // namespace arc::timer
@@ -0,0 +1,592 @@
+/**
+ * @file trace.cpp
+ * @brief Binary input trace encoding, recording and reading.
+ */
+
+#include "arc/trace.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace arc::trace {
+
+namespace {
+
+constexpr char kMagic[8] = {'A', 'R', 'C', 'T', 'R', 'A', 'C', 'E'};
+
+// Tag byte layout
+constexpr std::uint32_t kSettingSpeculative = 1u << 0;  ///< Settings flags: speculative click.
+constexpr std::uint8_t kCodeMask = 0x07;      ///< 0..3: EventType, 4: timer, 5: settings.
+constexpr std::uint8_t kCodeTimer = 4;
+constexpr std::uint8_t kCodeSettings = 5;
+constexpr unsigned kButtonShift = 3;          ///< Bits 3..5: button.
+constexpr std::uint8_t kSwallowBit = 0x40;    ///< Decision verdict is Swallow.
+constexpr std::uint8_t kModsBit = 0x80;       ///< Modifier mask follows (changed).
+
+constexpr std::uint8_t kMaxButton = static_cast<std::uint8_t>(arc::gesture::Button::X2);
+
+void put_u16(std::uint8_t *p, std::uint16_t v) {
+    p[0] = static_cast<std::uint8_t>(v);
+    p[1] = static_cast<std::uint8_t>(v >> 8);
+}
+
+void put_u32(std::uint8_t *p, std::uint32_t v) {
+    for (int i = 0; i < 4; ++i)
+        p[i] = static_cast<std::uint8_t>(v >> (8 * i));
+}
+
+std::uint16_t get_u16(const std::uint8_t *p) { return static_cast<std::uint16_t>(p[0] | (p[1] << 8)); }
+
+std::uint32_t get_u32(const std::uint8_t *p) {
+    return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+           (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+/** LEB128 varint, at most 5 bytes for 32-bit values. */
+std::uint8_t *put_varint(std::uint8_t *p, std::uint32_t v) {
+    while (v >= 0x80) {
+        *p++ = static_cast<std::uint8_t>(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = static_cast<std::uint8_t>(v);
+    return p;
+}
+
+bool get_varint(const std::uint8_t *&p, const std::uint8_t *end, std::uint32_t &v) {
+    v = 0;
+    for (unsigned shift = 0; shift < 35; shift += 7) {
+        if (p == end)
+            return false;
+        std::uint8_t b = *p++;
+        v |= static_cast<std::uint32_t>(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+/** Signed delta as a wrapping 32-bit difference, zigzag-mapped so small magnitudes stay short. */
+std::uint32_t zigzag(std::int32_t cur, std::int32_t prev) {
+    std::uint32_t d = static_cast<std::uint32_t>(cur) - static_cast<std::uint32_t>(prev);
+    return (d << 1) ^ (0u - (d >> 31));
+}
+
+std::int32_t unzigzag(std::uint32_t z, std::int32_t prev) {
+    std::uint32_t d = (z >> 1) ^ (0u - (z & 1));
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(prev) + d);
+}
+
+std::uint8_t *put_decision(std::uint8_t *p, const arc::gesture::Decision &d) {
+    *p++ = d.count;
+    for (int i = 0; i < d.count; ++i)
+        *p++ = static_cast<std::uint8_t>(static_cast<std::uint8_t>(d.inject[i].button) | (d.inject[i].down ? 0x08 : 0));
+    return p;
+}
+
+bool get_decision(const std::uint8_t *&p, const std::uint8_t *end, arc::gesture::Decision &d) {
+    if (p == end || *p > arc::gesture::Decision::kMaxInjections)
+        return false;
+    std::uint8_t count = *p++;
+    if (end - p < count)
+        return false;
+    for (std::uint8_t i = 0; i < count; ++i) {
+        std::uint8_t b = *p++;
+        if ((b & 0x07) > kMaxButton || (b & ~0x0F))
+            return false;
+        d.push(static_cast<arc::gesture::Button>(b & 0x07), (b & 0x08) != 0);
+    }
+    return true;
+}
+
+/** Row-presence byte, then 16 packed 4-bit cells (8 bytes) per bound button. */
+std::uint8_t *put_bindings(std::uint8_t *p, const arc::gesture::BindingTable &t) {
+    using T = arc::gesture::BindingTable;
+    std::uint8_t *rows = p++;
+    *rows = 0;
+    for (int b = 0; b < T::kButtons; ++b) {
+        std::uint8_t any = 0;
+        for (int m = 0; m < T::kMasks; ++m)
+            any |= t.cell(b * T::kMasks + m);
+        if (!any)
+            continue;
+        *rows = static_cast<std::uint8_t>(*rows | (1u << b));
+        for (int m = 0; m < T::kMasks; m += 2)
+            *p++ = static_cast<std::uint8_t>(t.cell(b * T::kMasks + m) | (t.cell(b * T::kMasks + m + 1) << 4));
+    }
+    return p;
+}
+
+bool get_bindings(const std::uint8_t *&p, const std::uint8_t *end, arc::gesture::BindingTable &t) {
+    using T = arc::gesture::BindingTable;
+    if (p == end || (*p >> T::kButtons))
+        return false;
+    std::uint8_t rows = *p++;
+    t = T{};
+    for (int b = 0; b < T::kButtons; ++b) {
+        if (!(rows & (1u << b)))
+            continue;
+        if (end - p < T::kMasks / 2)
+            return false;
+        for (int m = 0; m < T::kMasks; m += 2, ++p) {
+            t.set_cell(b * T::kMasks + m, static_cast<std::uint8_t>(*p & 0x0F));
+            t.set_cell(b * T::kMasks + m + 1, static_cast<std::uint8_t>(*p >> 4));
+        }
+    }
+    return true;
+}
+
+/** Button bits plus 0x08 for a double click, as in the binding cells. */
+std::uint8_t action_byte(const arc::gesture::Action &a) {
+    return static_cast<std::uint8_t>(static_cast<std::uint8_t>(a.button) | (a.double_click ? 0x08 : 0));
+}
+
+bool get_action(const std::uint8_t *&p, const std::uint8_t *end, arc::gesture::Action &a) {
+    if (p == end || (*p & 0x07) > kMaxButton || (*p & ~0x0F))
+        return false;
+    a.button = static_cast<arc::gesture::Button>(*p & 0x07);
+    a.double_click = (*p & 0x08) != 0;
+    ++p;
+    return true;
+}
+
+/** Recognizer windows and actions: double click, long press, chord. */
+std::uint8_t *put_recognizers(std::uint8_t *p, const arc::gesture::Settings &s) {
+    p = put_varint(p, s.double_click_ms);
+    *p++ = action_byte(s.double_action);
+    p = put_varint(p, s.long_press_ms);
+    *p++ = action_byte(s.long_press_action);
+    p = put_varint(p, s.chord_ms);
+    *p++ = static_cast<std::uint8_t>(s.chord_button);
+    *p++ = action_byte(s.chord_action);
+    return p;
+}
+
+bool get_recognizers(const std::uint8_t *&p, const std::uint8_t *end, arc::gesture::Settings &s) {
+    arc::gesture::Action button;
+    if (!get_varint(p, end, s.double_click_ms) || !get_action(p, end, s.double_action) ||
+        !get_varint(p, end, s.long_press_ms) || !get_action(p, end, s.long_press_action) ||
+        !get_varint(p, end, s.chord_ms) || !get_action(p, end, button) || button.double_click ||
+        !get_action(p, end, s.chord_action))
+        return false;
+    s.chord_button = button.button;
+    return true;
+}
+
+/**
+ * Stroke rules: count and minimum score, then per rule the segment count
+ * (high nibble) with the action byte (low nibble), and the packed directions.
+ */
+std::uint8_t *put_strokes(std::uint8_t *p, const arc::gesture::Settings &s) {
+    constexpr auto kMax = static_cast<std::uint8_t>(arc::stroke::kMaxTemplates);
+    std::uint8_t n = s.stroke_count < kMax ? s.stroke_count : kMax;
+    *p++ = n;
+    *p++ = s.stroke_min_score;
+    for (int i = 0; i < n; ++i) {
+        const arc::gesture::StrokeRule &r = s.strokes[i];
+        *p++ = static_cast<std::uint8_t>((r.shape.count << 4) | action_byte(r.action));
+        *p++ = r.shape.dirs;
+    }
+    return p;
+}
+
+bool get_strokes(const std::uint8_t *&p, const std::uint8_t *end, arc::gesture::Settings &s) {
+    if (end - p < 2 || p[0] > arc::stroke::kMaxTemplates)
+        return false;
+    s.stroke_count = *p++;
+    s.stroke_min_score = *p++;
+    for (int i = 0; i < s.stroke_count; ++i) {
+        if (end - p < 2 || (*p >> 4) > arc::stroke::kMaxSegments)
+            return false;
+        arc::gesture::StrokeRule &r = s.strokes[i];
+        r.shape.count = static_cast<std::uint8_t>(*p >> 4);
+        std::uint8_t action = static_cast<std::uint8_t>(*p & 0x0F);
+        const std::uint8_t *a = &action;
+        if (!get_action(a, a + 1, r.action))
+            return false;
+        r.shape.dirs = p[1];
+        p += 2;
+    }
+    return true;
+}
+
+}  // namespace
+
+/** Writes the tag, the time delta and the kind-specific payload. */
+std::size_t Encoder::encode(const Record &r, std::uint8_t *out) {
+    std::uint8_t *p = out + 1;
+    std::uint8_t tag = 0;
+    p = put_varint(p, r.event.time_ms - time_);
+    time_ = r.event.time_ms;
+    switch (r.kind) {
+    case Kind::Event:
+        tag = static_cast<std::uint8_t>(static_cast<std::uint8_t>(r.event.type) |
+                                        (static_cast<std::uint8_t>(r.event.button) << kButtonShift));
+        p = put_varint(p, zigzag(r.event.x, x_));
+        p = put_varint(p, zigzag(r.event.y, y_));
+        x_ = r.event.x;
+        y_ = r.event.y;
+        if (r.event.mods != mods_) {
+            tag |= kModsBit;
+            p = put_varint(p, r.event.mods);
+            mods_ = r.event.mods;
+        }
+        break;
+    case Kind::Timer:
+        tag = kCodeTimer;
+        break;
+    case Kind::Settings:
+        tag = static_cast<std::uint8_t>(kCodeSettings |
+                                        (static_cast<std::uint8_t>(r.settings.trigger) << kButtonShift));
+        p = put_varint(p, r.settings.required_mods);
+        p = put_varint(p, r.settings.click_time_ms);
+        p = put_varint(p, zigzag(r.settings.move_radius_px, 0));
+        p = put_varint(p, r.settings.predict_ms);
+        p = put_varint(p, r.settings.speculative ? kSettingSpeculative : 0u);
+        p = put_bindings(p, r.settings.bindings);
+        p = put_recognizers(p, r.settings);
+        p = put_strokes(p, r.settings);
+        p = put_varint(p, r.settings.dwell_ms);
+        *p++ = action_byte(r.settings.dwell_action);
+        break;
+    }
+    if (r.kind != Kind::Settings) {
+        if (r.decision.verdict == arc::gesture::Verdict::Swallow)
+            tag |= kSwallowBit;
+        p = put_decision(p, r.decision);
+    }
+    out[0] = tag;
+    return static_cast<std::size_t>(p - out);
+}
+
+/** Reverses Encoder::encode; rejects unknown codes and out-of-range fields. */
+bool Decoder::decode(const std::uint8_t *&p, const std::uint8_t *end, Record &out) {
+    const std::uint8_t *q = p;
+    if (q == end)
+        return false;
+    std::uint8_t tag = *q++;
+    std::uint8_t code = tag & kCodeMask;
+    std::uint8_t button = (tag >> kButtonShift) & 0x07;
+    if (code > kCodeSettings || button > kMaxButton)
+        return false;
+    std::uint32_t dt, v;
+    if (!get_varint(q, end, dt))
+        return false;
+    out = Record{};
+    time_ += dt;
+    out.event.time_ms = time_;
+    if (code == kCodeSettings) {
+        out.kind = Kind::Settings;
+        out.settings.trigger = static_cast<arc::gesture::Button>(button);
+        if (!get_varint(q, end, out.settings.required_mods) || !get_varint(q, end, out.settings.click_time_ms) ||
+            !get_varint(q, end, v))
+            return false;
+        out.settings.move_radius_px = unzigzag(v, 0);
+        if (version_ >= 2 && !get_varint(q, end, out.settings.predict_ms))
+            return false;
+        if (version_ >= 3) {
+            if (!get_varint(q, end, v))
+                return false;
+            out.settings.speculative = (v & kSettingSpeculative) != 0;
+        }
+        if (version_ >= 4 && !get_bindings(q, end, out.settings.bindings))
+            return false;
+        if (version_ >= 5 && !get_recognizers(q, end, out.settings))
+            return false;
+        if (version_ >= 6 && !get_strokes(q, end, out.settings))
+            return false;
+        if (version_ >= 7 &&
+            (!get_varint(q, end, out.settings.dwell_ms) || !get_action(q, end, out.settings.dwell_action)))
+            return false;
+        p = q;
+        return true;
+    }
+    if (code == kCodeTimer) {
+        out.kind = Kind::Timer;
+    } else {
+        out.kind = Kind::Event;
+        out.event.type = static_cast<arc::gesture::EventType>(code);
+        out.event.button = static_cast<arc::gesture::Button>(button);
+        if (!get_varint(q, end, v))
+            return false;
+        x_ = unzigzag(v, x_);
+        if (!get_varint(q, end, v))
+            return false;
+        y_ = unzigzag(v, y_);
+        if (tag & kModsBit) {
+            if (!get_varint(q, end, mods_))
+                return false;
+        }
+        out.event.x = x_;
+        out.event.y = y_;
+        out.event.mods = mods_;
+    }
+    out.decision.verdict = (tag & kSwallowBit) ? arc::gesture::Verdict::Swallow : arc::gesture::Verdict::Pass;
+    if (!get_decision(q, end, out.decision))
+        return false;
+    p = q;
+    return true;
+}
+
+Writer::Writer(std::size_t block_bytes, std::size_t blocks)
+    : block_bytes_(block_bytes < 256 ? 256 : block_bytes),
+      block_count_(blocks < 2 ? 2 : (blocks > kMaxBlocks ? kMaxBlocks : blocks)) {}
+
+Writer::~Writer() { close(); }
+
+/** Allocates the blocks up front so append() never allocates. */
+bool Writer::open(const std::string &path) {
+    if (file_)
+        return false;
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    if (!f)
+        return false;
+    std::uint8_t header[kHeaderBytes] = {};
+    std::memcpy(header, kMagic, sizeof(kMagic));
+    put_u16(header + 8, kVersion);
+    put_u16(header + 10, static_cast<std::uint16_t>(kHeaderBytes));
+    if (std::fwrite(header, 1, sizeof(header), f) != sizeof(header)) {
+        std::fclose(f);
+        return false;
+    }
+    storage_.assign(block_count_ * block_bytes_, 0);
+    // Both rings are idle here (closed or never used)
+    std::uint32_t idx;
+    Block b;
+    while (free_.try_pop(idx)) {
+    }
+    while (full_.try_pop(b)) {
+    }
+    for (std::size_t i = 0; i < block_count_; ++i)
+        free_.try_push(static_cast<std::uint32_t>(i));
+    file_ = f;
+    have_block_ = false;
+    pending_dropped_ = 0;
+    records_.store(0, std::memory_order_relaxed);
+    dropped_total_.store(0, std::memory_order_relaxed);
+    bytes_written_.store(kHeaderBytes, std::memory_order_relaxed);
+    stop_.store(false);
+    flusher_ = std::thread([this] { flush_loop(); });
+    return true;
+}
+
+/** Takes a free block and restarts the delta state. */
+bool Writer::acquire_block() {
+    std::uint32_t idx;
+    if (!free_.try_pop(idx))
+        return false;
+    current_ = Block{idx, 0, pending_dropped_};
+    pending_dropped_ = 0;
+    encoder_.reset();
+    have_block_ = true;
+    return true;
+}
+
+/** Hands the current block to the flush thread. */
+void Writer::submit_block() {
+    full_.try_push(current_);  // cannot fail: the ring holds every block
+    have_block_ = false;
+    wake_.notify_one();
+}
+
+/** Encodes into the current block; a full block is submitted first. */
+void Writer::append(const Record &r) {
+    if (!file_)
+        return;
+    if (have_block_ && block_bytes_ - current_.size < kMaxRecordBytes)
+        submit_block();
+    if (!have_block_ && !acquire_block()) {
+        ++pending_dropped_;
+        dropped_total_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::uint8_t *dst = storage_.data() + static_cast<std::size_t>(current_.index) * block_bytes_ + current_.size;
+    current_.size += static_cast<std::uint32_t>(encoder_.encode(r, dst));
+    records_.fetch_add(1, std::memory_order_relaxed);
+}
+
+/** Flush thread: writes submitted blocks in order and recycles them. */
+void Writer::flush_loop() {
+    for (;;) {
+        Block b;
+        while (full_.try_pop(b)) {
+            if (b.size || b.dropped) {
+                std::uint8_t header[kBlockHeaderBytes];
+                put_u32(header, b.size);
+                put_u32(header + 4, b.dropped);
+                std::fwrite(header, 1, sizeof(header), file_);
+                std::fwrite(storage_.data() + static_cast<std::size_t>(b.index) * block_bytes_, 1, b.size, file_);
+                std::fflush(file_);
+                bytes_written_.fetch_add(sizeof(header) + b.size, std::memory_order_relaxed);
+            }
+            free_.try_push(b.index);
+        }
+        if (stop_.load(std::memory_order_acquire) && full_.empty())
+            return;
+        std::unique_lock<std::mutex> lk(wake_mu_);
+        // The producer notifies without the lock; the timeout bounds a missed wakeup
+        wake_.wait_for(lk, std::chrono::milliseconds(50),
+                       [this] { return stop_.load(std::memory_order_acquire) || !full_.empty(); });
+    }
+}
+
+/** Submits the partial block, joins the flush thread and closes the file. */
+void Writer::close() {
+    if (!file_)
+        return;
+    if (have_block_)
+        submit_block();
+    {
+        std::lock_guard<std::mutex> lk(wake_mu_);
+        stop_.store(true, std::memory_order_release);
+    }
+    wake_.notify_one();
+    if (flusher_.joinable())
+        flusher_.join();
+    if (pending_dropped_) {
+        // Records dropped after the last block: an empty block carries the count
+        std::uint8_t header[kBlockHeaderBytes];
+        put_u32(header, 0);
+        put_u32(header + 4, pending_dropped_);
+        std::fwrite(header, 1, sizeof(header), file_);
+        bytes_written_.fetch_add(sizeof(header), std::memory_order_relaxed);
+        pending_dropped_ = 0;
+    }
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+/** Reads the file and checks the header. */
+bool Reader::open(const std::string &path, std::string *error) {
+    auto fail = [&](const char *msg) {
+        if (error)
+            *error = msg;
+        return false;
+    };
+    *this = Reader{};
+    std::FILE *f = std::fopen(path.c_str(), "rb");
+    if (!f)
+        return fail("cannot open file");
+    std::uint8_t buf[64 * 1024];
+    std::size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0)
+        data_.insert(data_.end(), buf, buf + n);
+    std::fclose(f);
+    if (data_.size() < kHeaderBytes || std::memcmp(data_.data(), kMagic, sizeof(kMagic)) != 0)
+        return fail("not an altrightclick trace");
+    std::uint16_t version = get_u16(data_.data() + 8);
+    if (version > kVersion)
+        return fail("trace version is newer than this reader");
+    decoder_ = Decoder{version};
+    std::uint16_t header = get_u16(data_.data() + 10);
+    if (header < kHeaderBytes || header > data_.size())
+        return fail("bad trace header");
+    pos_ = header;
+    return true;
+}
+
+/** Moves to the next block; a block running past the end marks the trace corrupt. */
+bool Reader::enter_block() {
+    if (data_.size() - pos_ < kBlockHeaderBytes) {
+        corrupt_ = pos_ != data_.size();
+        return false;
+    }
+    std::uint32_t size = get_u32(data_.data() + pos_);
+    std::uint32_t dropped = get_u32(data_.data() + pos_ + 4);
+    if (data_.size() - pos_ - kBlockHeaderBytes < size) {
+        corrupt_ = true;
+        return false;
+    }
+    dropped_ += dropped;
+    cur_ = data_.data() + pos_ + kBlockHeaderBytes;
+    end_ = cur_ + size;
+    pos_ += kBlockHeaderBytes + size;
+    decoder_.reset();
+    return true;
+}
+
+/** Decodes records block by block. */
+bool Reader::next(Record &out) {
+    while (cur_ == end_) {
+        if (corrupt_ || !enter_block())
+            return false;
+    }
+    if (!decoder_.decode(cur_, end_, out)) {
+        corrupt_ = true;
+        cur_ = end_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+/** Compares verdicts and injection lists. */
+bool same_decision(const arc::gesture::Decision &a, const arc::gesture::Decision &b) {
+    if (a.verdict != b.verdict || a.count != b.count)
+        return false;
+    for (int i = 0; i < a.count; ++i) {
+        if (a.inject[i].button != b.inject[i].button || a.inject[i].down != b.inject[i].down)
+            return false;
+    }
+    return true;
+}
+
+void Replayer::report(Kind kind, const arc::gesture::Event &ev, const arc::gesture::Decision &recorded,
+                      const arc::gesture::Decision &replayed) {
+    ++diffs_;
+    if (!on_diff_)
+        return;
+    Diff d;
+    d.index = records_;
+    d.kind = kind;
+    d.event = ev;
+    d.recorded = recorded;
+    d.replayed = replayed;
+    on_diff_(d, ctx_);
+}
+
+/**
+ * Resolves replayed deadlines that are due before a record the recording
+ * saw without a timer (a long press can leave a held-back click due too).
+ */
+void Replayer::fire_due(std::uint32_t now_ms) {
+    std::uint32_t at;
+    for (int i = 0; i < 4 && engine_.deadline(at) && static_cast<std::int32_t>(now_ms - at) >= 0; ++i) {
+        arc::gesture::Event ev;
+        ev.time_ms = at;
+        ++timers_;
+        report(Kind::Timer, ev, arc::gesture::Decision{}, engine_.on_timer(at));
+    }
+}
+
+/** Replays one record against the engine and compares decisions. */
+void Replayer::feed(const Record &r) {
+    switch (r.kind) {
+    case Kind::Settings: {
+        arc::gesture::Settings s = r.settings;
+        if (filter_)
+            filter_(s, fctx_);
+        engine_.configure(s);
+        break;
+    }
+    case Kind::Timer: {
+        ++timers_;
+        std::uint32_t at;
+        arc::gesture::Decision d;
+        if (engine_.deadline(at) && static_cast<std::int32_t>(r.event.time_ms - at) >= 0)
+            d = engine_.on_timer(r.event.time_ms);
+        if (!same_decision(d, r.decision))
+            report(Kind::Timer, r.event, r.decision, d);
+        break;
+    }
+    case Kind::Event: {
+        ++events_;
+        fire_due(r.event.time_ms);
+        arc::gesture::Decision d = engine_.on_event(r.event);
+        if (!same_decision(d, r.decision))
+            report(Kind::Event, r.event, r.decision, d);
+        break;
+    }
+    }
+    ++records_;
+}
+
+}  // namespace arc::trace
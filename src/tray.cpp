@@ -13,6 +13,7 @@
 #include <shellapi.h>
 
 #include <algorithm>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <filesystem>
@@ -74,6 +75,7 @@ enum MenuId : UINT {
  * The returned HMENU must be destroyed by the caller using DestroyMenu().
  *
  * @param ctx Live tray context (may be null, in which case a minimal menu is built).
+ *            The caller holds ctx->cfg_mutex.
  * @return Created popup menu handle. Caller is responsible for DestroyMenu(menu).
  */
 HMENU create_tray_menu(const arc::tray::TrayContext *ctx) {
@@ -105,12 +107,14 @@ HMENU create_tray_menu(const arc::tray::TrayContext *ctx) {
 
 /**
  * @brief Persist configuration changes driven from the tray menu.
+ *
+ * The caller holds ctx->cfg_mutex.
  */
 static void persist_config_if_possible(const arc::tray::TrayContext *ctx) {
     if (!ctx || ctx->config_path.empty())
         return;
     if (!arc::config::save(ctx->config_path, ctx->cfg)) {
-        arc::log::error("Tray: failed to save configuration to " + ctx->config_path.u8string());
+        ARC_LOG_ERROR("Tray: failed to save configuration to " + ctx->config_path.u8string());
         arc::tray::notify(L"altrightclick", L"Failed to save config. Check disk permissions.");
     }
 }
@@ -205,10 +209,17 @@ LRESULT CALLBACK TrayWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
             GetCursorPos(&pt);
             SetForegroundWindow(hwnd);
             auto *ctx = reinterpret_cast<arc::tray::TrayContext *>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
-            HMENU menu = create_tray_menu(ctx);
+            HMENU menu;
+            if (ctx) {
+                std::lock_guard<std::mutex> lock(ctx->cfg_mutex);
+                menu = create_tray_menu(ctx);
+            } else {
+                menu = create_tray_menu(nullptr);
+            }
             UINT cmd = TrackPopupMenu(menu, TPM_RETURNCMD | TPM_NONOTIFY, pt.x, pt.y, 0, hwnd, nullptr);
             DestroyMenu(menu);
             if (ctx) {
+                std::lock_guard<std::mutex> lock(ctx->cfg_mutex);
                 switch (cmd) {
                 case kMenuToggleEnabled:
                     ctx->cfg.enabled = !ctx->cfg.enabled;
@@ -342,7 +353,7 @@ HWND init(HINSTANCE hInstance, const std::wstring &tooltip, TrayContext *ctx) {
     wcsncpy_s(g_nid.szTip, tooltip.c_str(), _TRUNCATE);
 
     if (!Shell_NotifyIconW(NIM_ADD, &g_nid)) {
-        arc::log::error("Shell_NotifyIconW(NIM_ADD) failed");
+        ARC_LOG_ERROR("Shell_NotifyIconW(NIM_ADD) failed");
     }
     return hwnd;
 }
@@ -390,7 +401,7 @@ bool start(const std::wstring &tooltip, TrayContext *ctx) {
         HINSTANCE hInst = GetModuleHandleW(nullptr);
         HWND hwnd = init(hInst, tooltip, ctx);
         if (!hwnd) {
-            arc::log::error("Tray worker: failed to create tray window");
+            ARC_LOG_ERROR("Tray worker: failed to create tray window");
             return;
         }
         MSG msg;
@@ -0,0 +1,132 @@
+/**
+ * @file tuning.cpp
+ * @brief Otsu split of usage histograms and threshold suggestions.
+ */
+
+#include "arc/tuning.h"
+
+namespace arc::tuning {
+
+namespace {
+
+/** Lowest bucket at which the running count from @p from reaches @p need. */
+int bucket_at(const std::uint32_t *counts, int from, int to, std::uint64_t need) {
+    std::uint64_t seen = 0;
+    for (int b = from; b < to; ++b) {
+        seen += counts[b];
+        if (seen >= need)
+            return b;
+    }
+    return to - 1;
+}
+
+/** @p target, or half way from @p cur towards it in multiples of @p unit. */
+std::int64_t step_toward(std::int64_t cur, std::int64_t target, std::int64_t unit) {
+    std::int64_t diff = target - cur;
+    if (diff <= unit && diff >= -unit)
+        return target;
+    std::int64_t half = diff / 2 / unit * unit;
+    if (half == 0)
+        half = diff > 0 ? unit : -unit;
+    return cur + half;
+}
+
+template <int N>
+Split split_counts(const Counts<N> &c) {
+    std::uint32_t counts[N];
+    for (int b = 0; b < N; ++b)
+        counts[b] = c.at(b);
+    return split(counts, N);
+}
+
+}  // namespace
+
+/**
+ * Otsu over bucket indices: for every cut t, the lower class is [0, t] and
+ * the upper one (t, buckets); the cut maximizing w0 * w1 * (m0 - m1)^2 is
+ * kept, then checked as described in the header.
+ */
+Split split(const std::uint32_t *counts, int buckets) {
+    Split s;
+    std::uint64_t total = 0;
+    double sum = 0, sum_sq = 0;
+    for (int b = 0; b < buckets; ++b) {
+        total += counts[b];
+        sum += static_cast<double>(counts[b]) * b;
+        sum_sq += static_cast<double>(counts[b]) * b * b;
+    }
+    if (total < kMinSamples)
+        return s;
+    const double n = static_cast<double>(total);
+    double variance = sum_sq / n - (sum / n) * (sum / n);
+    if (variance <= 0)
+        return s;
+    double best = -1, w0 = 0, s0 = 0;
+    int cut = -1;
+    std::uint64_t below = 0, below_at_cut = 0;
+    for (int t = 0; t + 1 < buckets; ++t) {
+        w0 += counts[t];
+        s0 += static_cast<double>(counts[t]) * t;
+        below += counts[t];
+        double w1 = n - w0;
+        if (w0 == 0 || w1 == 0)
+            continue;
+        double m0 = s0 / w0, m1 = (sum - s0) / w1;
+        double between = w0 * w1 * (m0 - m1) * (m0 - m1);
+        if (between > best) {
+            best = between;
+            cut = t;
+            below_at_cut = below;
+        }
+    }
+    if (cut < 0)
+        return s;
+    std::uint64_t above = total - below_at_cut;
+    if (below_at_cut * 20 < total || above * 20 < total)
+        return s;  // one side is a handful of outliers
+    if (best / (n * n) < 0.8 * variance)
+        return s;  // no clear valley
+    s.low = bucket_at(counts, 0, cut + 1, (below_at_cut * 99 + 99) / 100);
+    s.high = bucket_at(counts, cut + 1, buckets, (above + 99) / 100);
+    s.found = s.high - s.low >= 2;
+    return s;
+}
+
+/**
+ * Travel: a press of travel t is a click while t <= radius, so any radius in
+ * [low + 1, high - 1] keeps both populations apart. Drags pile up in the
+ * capped last bucket, so the upper edge says little about them; the radius
+ * is the click jitter plus half of it, within the gap. Duration: a press of
+ * d ms is a click while d <= click time, so the click time is a multiple of
+ * the bucket width in [(low + 1) * step, high * step); held presses have
+ * real durations, so the middle of the gap is used.
+ */
+Thresholds suggest(const Usage &usage, const Thresholds &current) {
+    Thresholds next = current;
+    Split travel = split_counts(usage.travel);
+    if (travel.found) {
+        std::int64_t target = travel.low + 1 + (travel.low + 1) / 2;
+        if (target > (travel.low + travel.high) / 2)
+            target = (travel.low + travel.high) / 2;
+        target = target < kMinRadiusPx ? kMinRadiusPx : target > kMaxRadiusPx ? kMaxRadiusPx : target;
+        next.move_radius_px = static_cast<std::int32_t>(step_toward(current.move_radius_px, target, 1));
+    }
+    Split hold = split_counts(usage.durations);
+    if (hold.found) {
+        std::int64_t target = static_cast<std::int64_t>((hold.low + 1 + hold.high) / 2) * kDurationStepMs;
+        target = target < kMinClickTimeMs ? kMinClickTimeMs : target > kMaxClickTimeMs ? kMaxClickTimeMs : target;
+        next.click_time_ms = static_cast<std::uint32_t>(step_toward(current.click_time_ms, target, kDurationStepMs));
+    }
+    return next;
+}
+
+std::uint32_t travel_px(std::int64_t dist_sq) {
+    if (dist_sq >= static_cast<std::int64_t>(kTravelCapPx) * kTravelCapPx)
+        return kTravelCapPx;
+    std::uint32_t r = 0;
+    while (static_cast<std::int64_t>(r + 1) * (r + 1) <= dist_sq)
+        ++r;
+    return r;
+}
+
+}  // namespace arc::tuning
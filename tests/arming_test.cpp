@@ -0,0 +1,472 @@
+/**
+ * @file arming_test.cpp
+ * @brief Armed hook mode: controller rules and an arm/disarm race simulation.
+ *
+ * The simulation mirrors the Windows glue in hook.cpp: key events update the
+ * modifier tracker and the arming controller, the mouse hook is installed or
+ * removed by "posted" sync requests that run a random delay later (hook
+ * callbacks overtake posted messages), and a grace timer disarms the hook.
+ * Mouse events reach the gesture engine only while the hook is installed,
+ * idle moves skip it as in the hook's fast path, and modifier changes and
+ * installs feed dwell like note_dwell.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "arc/arming.h"
+#include "arc/gesture.h"
+#include "arc/modifiers.h"
+#include "arc/stroke.h"
+
+using arc::arming::Controller;
+using arc::gesture::Button;
+using arc::gesture::EventType;
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+constexpr unsigned int kVkLMenu = 0xA4;
+constexpr unsigned int kVkRMenu = 0xA5;
+constexpr std::uint32_t kGraceMs = 50;
+constexpr std::uint32_t kMaxDelayMs = 4;  ///< Worst-case posted-message latency in the simulation.
+
+/** Simulated hook worker thread in armed mode. */
+struct Sim {
+    arc::modifiers::Tracker mods;
+    Controller arm;
+    arc::gesture::Engine engine;
+    bool installed = false;
+    std::uint32_t now = 0;
+    std::vector<std::uint32_t> syncs;  ///< Due times of posted sync requests.
+    bool timer = false;
+    std::uint32_t timer_at = 0;
+    std::mt19937 rng;
+    std::int32_t cursor = 0;         ///< Pointer position (GetCursorPos).
+
+    // What the foreground application sees, per button
+    bool app_down[6] = {};
+    std::uint32_t combo_since = 0;   ///< Time the combo went down (valid while held).
+    std::uint32_t idle_since = 0;    ///< Time the hook stopped being pinned (combo up, no click).
+
+    // Outcomes
+    int removed_in_flight = 0;
+    int unpaired_ups = 0;   ///< Releases the application saw without their press.
+    int clicks_armed = 0;   ///< Alt+clicks pressed after the arm request had time to run.
+    int clicks_hooked = 0;  ///< ... of which the hook saw the press.
+    long long idle_events_seen = 0;
+    long long events_seen = 0;
+    long long events_total = 0;
+    int installs = 0;
+    int timed = 0;   ///< Actions injected at engine deadlines (dwell, long press).
+
+    explicit Sim(unsigned seed) : rng(seed) {
+        arm.configure(arc::gesture::kModAlt, kGraceMs);
+    }
+
+    void post_sync() { syncs.push_back(now + rng() % (kMaxDelayMs + 1)); }
+
+    /** The worker's sync_hooks(): reconcile the mouse hook with the controller. */
+    void sync() {
+        arm.on_modifiers(mods.held(), now);
+        arm.on_tracking(busy(), now);
+        bool want = arm.wanted(now);
+        if (want && !installed) {
+            installed = true;
+            ++installs;
+            dwell();
+        } else if (!want && installed) {
+            if (busy())
+                ++removed_in_flight;
+            installed = false;
+            engine.reset();
+        }
+        timer = false;
+        std::uint32_t left = installed ? arm.grace_left(now) : 0;
+        if (left) {
+            timer = true;
+            timer_at = now + left;
+        }
+    }
+
+    /** Runs due sync requests and timers up to @p t, in time order. */
+    void advance(std::uint32_t t) {
+        for (;;) {
+            std::uint32_t next = t + 1;
+            int which = -1;
+            for (std::size_t i = 0; i < syncs.size(); ++i) {
+                if (syncs[i] <= t && syncs[i] < next) {
+                    next = syncs[i];
+                    which = static_cast<int>(i);
+                }
+            }
+            if (timer && timer_at <= t && timer_at < next) {
+                now = timer_at;
+                timer = false;
+                sync();
+                continue;
+            }
+            if (which < 0)
+                break;
+            now = next;
+            syncs.erase(syncs.begin() + which);
+            sync();
+        }
+        now = t;
+    }
+
+    /** The hook's view of the engine: a gesture is in flight until it settles. */
+    bool busy() const { return !engine.settled(); }
+
+    /** The worker's note_tracking(): pin the hook while a gesture is in flight. */
+    void note_busy(bool was) {
+        if (busy() == was)
+            return;
+        arm.on_tracking(busy(), now);
+        if (!busy() && !arm.combo_held())
+            idle_since = now;
+        post_sync();
+    }
+
+    /** Applies injected events to what the application sees. */
+    void deliver(const arc::gesture::Decision &d) {
+        for (int i = 0; i < d.count; ++i)
+            app_down[static_cast<int>(d.inject[i].button)] = d.inject[i].down;
+    }
+
+    /** The worker's note_dwell(): tell the engine about held modifiers while the hook is installed. */
+    void dwell() {
+        if (!engine.settings().dwell_ms || !installed)
+            return;
+        arc::gesture::Event ev;
+        ev.type = EventType::Other;
+        ev.x = cursor;
+        ev.time_ms = now;
+        ev.mods = mods.held();
+        deliver(engine.on_event(ev));
+    }
+
+    /** The worker's timer wheel: fire an engine deadline that is due by @p t. */
+    void timers(std::uint32_t t) {
+        std::uint32_t at = 0;
+        if (installed && engine.deadline(at) && static_cast<std::int32_t>(t - at) >= 0) {
+            bool was = busy();
+            arc::gesture::Decision d = engine.on_timer(at);
+            timed += d.count ? 1 : 0;
+            deliver(d);
+            note_busy(was);
+        }
+    }
+
+    /** The keyboard hook: track modifiers, arm or start the grace period. */
+    void key(unsigned int vk, bool down) {
+        bool before = arm.combo_held();
+        if (mods.on_key(vk, down))
+            dwell();
+        arm.on_modifiers(mods.held(), now);
+        if (arm.combo_held() != before) {
+            if (arm.combo_held())
+                combo_since = now;
+            else if (!busy())
+                idle_since = now;
+            post_sync();
+        }
+    }
+
+    /** The mouse hook (if installed), then what the application receives. */
+    void mouse(EventType type, Button b, std::int32_t x) {
+        ++events_total;
+        arc::gesture::Event ev;
+        ev.type = type;
+        ev.button = b;
+        ev.x = x;
+        ev.time_ms = now;
+        ev.mods = mods.held();
+        cursor = x;
+        bool pinned = arm.combo_held() || busy();
+        if (!pinned && now - idle_since > kGraceMs + kMaxDelayMs && installed)
+            ++idle_events_seen;
+        if (type == EventType::Down && b == Button::Left && arm.combo_held() && now - combo_since > kMaxDelayMs) {
+            ++clicks_armed;
+            if (installed)
+                ++clicks_hooked;
+        }
+        arc::gesture::Decision d;
+        if (installed)
+            ++events_seen;
+        // The hook's fast path: idle moves pass without reaching the engine
+        if (installed && !(type == EventType::Move && engine.idle() && !engine.dwelling())) {
+            bool was = busy();
+            d = engine.on_event(ev);
+            note_busy(was);
+        }
+        if (d.verdict == arc::gesture::Verdict::Pass && type == EventType::Up && !app_down[static_cast<int>(b)])
+            ++unpaired_ups;
+        if (d.verdict == arc::gesture::Verdict::Pass && type != EventType::Move)
+            app_down[static_cast<int>(b)] = (type == EventType::Down);
+        deliver(d);
+    }
+
+    void at(std::uint32_t t) { advance(t); }
+};
+
+/** Random Alt+click sessions with every release order we can think of. */
+void run_session(Sim &s, std::uint32_t &t) {
+    auto r = [&](std::uint32_t n) { return static_cast<std::uint32_t>(s.rng() % n); };
+    // Idle moves: nobody holds Alt
+    for (std::uint32_t i = 0, n = r(20); i < n; ++i) {
+        s.at(t += 1 + r(8));
+        s.mouse(EventType::Move, Button::None, static_cast<std::int32_t>(r(500)));
+    }
+    // Plain click without modifier (must pass through untouched)
+    if (r(3) == 0) {
+        s.at(t += 1 + r(5));
+        s.mouse(EventType::Down, Button::Left, 0);
+        s.at(t += 1 + r(50));
+        s.mouse(EventType::Up, Button::Left, 0);
+    }
+    unsigned int alt = r(2) ? kVkLMenu : kVkRMenu;
+    s.at(t += 1 + r(5));
+    s.key(alt, true);
+    // Auto-repeat while held
+    for (std::uint32_t i = 0, n = r(3); i < n; ++i) {
+        s.at(t += r(3));
+        s.key(alt, true);
+    }
+    s.at(t += r(12));  // may click before the posted arm request ran
+    s.mouse(EventType::Down, Button::Left, 0);
+    bool drag = r(4) == 0;
+    bool release_alt_mid = r(3) == 0;
+    for (std::uint32_t i = 0, n = 1 + r(4); i < n; ++i) {
+        s.at(t += 1 + r(20));
+        s.mouse(EventType::Move, Button::None, drag ? static_cast<std::int32_t>(20 * (i + 1)) : 1);
+        if (release_alt_mid && i == 0) {
+            s.key(alt, false);
+            // Grace can expire while the click is still in flight
+            s.at(t += r(2 * kGraceMs));
+        }
+    }
+    s.at(t += 1 + r(3 * kGraceMs));  // long press may outlast the grace period
+    s.mouse(EventType::Up, Button::Left, 0);
+    if (!release_alt_mid) {
+        s.at(t += r(20));
+        s.key(alt, false);
+    }
+    // Re-press within the grace period sometimes
+    if (r(4) == 0) {
+        s.at(t += r(kGraceMs));
+        s.key(alt, true);
+        s.at(t += r(10));
+        s.key(alt, false);
+    }
+}
+
+}  // namespace
+
+/** @brief Entry point for armed hook mode tests. */
+int main() {
+    // Controller rules
+    {
+        Controller c;
+        c.configure(arc::gesture::kModAlt | arc::gesture::kModCtrl, 100);
+        expect(!c.wanted(0), "idle: not wanted");
+        c.on_modifiers(arc::gesture::kModAlt, 10);
+        expect(!c.wanted(10), "partial combo: not wanted");
+        c.on_modifiers(arc::gesture::kModAlt | arc::gesture::kModCtrl, 20);
+        expect(c.wanted(20) && c.combo_held(), "combo held: wanted");
+        expect(c.grace_left(20) == 0, "no grace while held");
+        c.on_modifiers(arc::gesture::kModAlt, 30);
+        expect(c.wanted(129) && c.grace_left(129) == 1, "grace running");
+        expect(!c.wanted(130) && c.grace_left(130) == 0, "grace expired");
+
+        c.on_modifiers(arc::gesture::kModAlt | arc::gesture::kModCtrl, 200);
+        c.on_tracking(true, 210);
+        c.on_modifiers(0, 220);
+        expect(c.wanted(10000), "tracked click pins the hook past the grace period");
+        c.on_tracking(false, 10000);
+        expect(c.wanted(10099) && !c.wanted(10100), "grace restarts when the click ends");
+
+        c.reset();
+        c.configure(0, 100);
+        expect(c.wanted(0), "no modifier configured: always wanted");
+
+        // Several bindings: Alt or Ctrl+Shift arm, Ctrl or Shift alone do not
+        c.reset();
+        c.configure_sets(static_cast<std::uint16_t>(0xAAAA | (1u << (arc::gesture::kModCtrl | arc::gesture::kModShift))),
+                         100);
+        c.on_modifiers(arc::gesture::kModCtrl, 0);
+        expect(!c.wanted(0), "partial binding modifiers do not arm");
+        c.on_modifiers(arc::gesture::kModCtrl | arc::gesture::kModShift, 1);
+        expect(c.combo_held() && c.wanted(1), "second binding's modifiers arm");
+        c.on_modifiers(arc::gesture::kModAlt, 2);
+        expect(c.combo_held(), "first binding's modifier arms");
+
+        c.reset();
+        c.configure(arc::gesture::kModAlt, 100);
+        c.on_modifiers(arc::gesture::kModAlt, 0xFFFFFFF0u);
+        c.on_modifiers(0, 0xFFFFFFF0u);
+        expect(c.wanted(0x20) && c.grace_left(0x20) == 52, "grace across tick wrap");
+    }
+
+    // Armed dwell: the combo goes down while the hook is out, so the engine
+    // hears of it only through the install
+    {
+        Sim s(1);
+        arc::gesture::Settings dwell;
+        dwell.dwell_ms = 500;
+        dwell.dwell_action = arc::gesture::Action{Button::Right, false};
+        s.engine.configure(dwell);
+        std::uint32_t t = 1000;
+        s.now = t;
+        s.key(kVkLMenu, true);
+        expect(!s.installed && !s.engine.dwelling(), "combo held before the hook is installed");
+        s.at(t += kMaxDelayMs);
+        expect(s.installed && s.engine.dwelling(), "installing the hook starts the dwell");
+        s.at(t += 100);
+        s.mouse(EventType::Move, Button::None, 2);
+        s.timers(t += 300);
+        expect(s.timed == 0, "no dwell before its time");
+        s.timers(t += 200);
+        expect(s.timed == 1, "armed dwell injects its action");
+        for (int b = 0; b < 6; ++b)
+            expect(!s.app_down[b], "dwell click released");
+        s.at(t += 10);
+        s.key(kVkLMenu, false);
+        expect(!s.engine.dwelling(), "releasing the combo stops dwelling");
+        s.at(t += kGraceMs + kMaxDelayMs + 1);
+        expect(!s.installed, "hook disarmed after the dwell");
+    }
+
+    // Stroke drawn past the grace period: the modifier goes up mid-stroke,
+    // the hook stays until the release ends the stroke
+    {
+        Sim s(1);
+        arc::gesture::Settings strokes;
+        expect(arc::stroke::parse_shape("L", strokes.strokes[0].shape), "stroke shape parses");
+        strokes.strokes[0].action = arc::gesture::Action{Button::X1, false};
+        strokes.stroke_count = 1;
+        s.engine.configure(strokes);
+        std::uint32_t t = 1000;
+        s.now = t;
+        s.key(kVkLMenu, true);
+        s.at(t += kMaxDelayMs);
+        s.mouse(EventType::Down, Button::Left, 500);
+        for (int i = 1; i <= 5; ++i) {
+            s.at(t += 10);
+            s.mouse(EventType::Move, Button::None, 500 - 10 * i);
+        }
+        expect(s.engine.stroking(), "press records a stroke");
+        s.key(kVkLMenu, false);
+        for (int i = 6; i <= 20; ++i) {
+            s.at(t += 10);
+            s.mouse(EventType::Move, Button::None, 500 - 10 * i);
+        }
+        expect(t - 1000 > kGraceMs + 2 * kMaxDelayMs && s.installed, "stroke keeps the hook past the grace period");
+        s.mouse(EventType::Up, Button::Left, 300);
+        expect(s.engine.settled() && s.unpaired_ups == 0, "stroke release swallowed");
+        for (int b = 0; b < 6; ++b)
+            expect(!s.app_down[b], "stroke action released");
+        s.at(t += kGraceMs + kMaxDelayMs + 1);
+        expect(!s.installed && s.removed_in_flight == 0, "hook disarmed after the stroke");
+    }
+
+    // Long press held past the grace period: the injected action's press is
+    // resolved, but its release must still be swallowed by an installed hook
+    {
+        Sim s(1);
+        arc::gesture::Settings held;
+        held.long_press_ms = 600;
+        s.engine.configure(held);
+        std::uint32_t t = 1000;
+        s.now = t;
+        s.key(kVkLMenu, true);
+        s.at(t += kMaxDelayMs);
+        s.mouse(EventType::Down, Button::Left, 500);
+        s.at(t += 10);
+        s.key(kVkLMenu, false);
+        s.at(t += 600);
+        s.timers(t);
+        expect(s.timed == 1 && s.engine.idle() && !s.engine.settled(), "long press injected, release owed");
+        s.at(t += kGraceMs + kMaxDelayMs + 10);
+        expect(s.installed, "owed release keeps the hook past the grace period");
+        s.mouse(EventType::Up, Button::Left, 500);
+        expect(s.engine.settled() && s.unpaired_ups == 0, "long-press release swallowed");
+        for (int b = 0; b < 6; ++b)
+            expect(!s.app_down[b], "long-press action released");
+        s.at(t += kGraceMs + kMaxDelayMs + 1);
+        expect(!s.installed && s.removed_in_flight == 0, "hook disarmed after the long press");
+    }
+
+    // Click held back for a double click: the window outlasts the grace
+    // period, and the click is delivered at its end, not flushed by a removal
+    {
+        Sim s(1);
+        arc::gesture::Settings twice;
+        twice.double_click_ms = 300;
+        s.engine.configure(twice);
+        std::uint32_t t = 1000;
+        s.now = t;
+        s.key(kVkLMenu, true);
+        s.at(t += kMaxDelayMs);
+        s.mouse(EventType::Down, Button::Left, 500);
+        s.at(t += 20);
+        s.mouse(EventType::Up, Button::Left, 500);
+        s.key(kVkLMenu, false);
+        s.at(t += kGraceMs + kMaxDelayMs + 10);
+        expect(s.installed && !s.engine.settled() && s.timed == 0, "held-back click keeps the hook");
+        s.at(t += 300);
+        s.timers(t);
+        expect(s.timed == 1 && s.engine.settled(), "held-back click delivered at the end of its window");
+        s.at(t += kGraceMs + kMaxDelayMs + 1);
+        expect(!s.installed && s.removed_in_flight == 0, "hook disarmed after the click");
+    }
+
+    // Arm/disarm race simulation
+    {
+        long long armed = 0, idle_seen = 0, seen = 0, total = 0;
+        int installs = 0;
+        for (unsigned seed = 1; seed <= 200; ++seed) {
+            Sim s(seed);
+            std::uint32_t t = seed * 1000u;  // exercise different absolute times
+            s.now = t;
+            s.idle_since = t;
+            for (int i = 0; i < 50; ++i)
+                run_session(s, t);
+            s.at(t += kGraceMs + kMaxDelayMs + 1);
+
+            expect(s.removed_in_flight == 0, "hook never removed while a gesture is in flight");
+            expect(s.engine.settled(), "every tracked press saw its release");
+            expect(s.unpaired_ups == 0, "no release reaches the application without its press");
+            for (int b = 0; b < 6; ++b)
+                expect(!s.app_down[b], "no button stuck down in the application");
+            expect(!s.installed, "hook disarmed after the grace period");
+            expect(s.clicks_hooked == s.clicks_armed, "hook armed in time for every Alt+click");
+            armed += s.clicks_armed;
+            idle_seen += s.idle_events_seen;
+            seen += s.events_seen;
+            total += s.events_total;
+            installs += s.installs;
+        }
+        expect(idle_seen == 0, "idle input never reaches the disarmed hook");
+        std::printf("simulation: %lld/%lld events hooked, %d arms, %lld armed clicks\n", seen, total, installs,
+                    armed);
+    }
+
+    std::printf("[OK] arming tests passed\n");
+    return 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file clock_test.cpp
+ * @brief Monotonic and virtual clocks, and click classification from event
+ *        timestamps under delivery delay.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+#include "arc/clock.h"
+#include "arc/gesture.h"
+
+#include "gesture_events.h"
+
+using arc::clock::Clock;
+using arc::clock::VirtualClock;
+using arc::gesture::Button;
+using arc::gesture::EventType;
+using arc::test::ev;
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+/** True if the decision is the translated right click. */
+bool translated(const arc::gesture::Decision &d) { return d.count == 2 && d.inject[0].button == Button::Right; }
+
+}  // namespace
+
+/** @brief Entry point for clock tests. */
+int main() {
+    // Platform monotonic clock
+    {
+        Clock c = arc::clock::monotonic();
+        std::uint64_t prev = c.now_us();
+        for (int i = 0; i < 100000; ++i) {
+            std::uint64_t t = c.now_us();
+            expect(t >= prev, "monotonic clock never goes backwards");
+            prev = t;
+        }
+        std::uint64_t before = arc::clock::monotonic_us();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        std::uint64_t elapsed = c.now_us() - before;
+        expect(elapsed >= 5000 && elapsed < 5000000, "monotonic clock measures a sleep in microseconds");
+    }
+
+    // Virtual clock through the generic handle
+    {
+        VirtualClock v(1000);
+        Clock c = v.clock();
+        expect(c.now_us() == 1000 && c.now_ms() == 1, "starts at the given time");
+        v.advance_ms(250);
+        expect(c.now_us() == 251000, "advance_ms");
+        v.advance_us(999);
+        expect(c.now_ms() == 251, "sub-millisecond advance");
+        v.set_us(10);
+        expect(c.now_us() == 251999, "set_us never goes backwards");
+        v.set_us(300000);
+        expect(v.now_us() == 300000 && c.now_ms() == 300, "set_us forward");
+    }
+
+    // Replay under load: presses reach the hook late by a random delay. The
+    // engine classifies by the event's own timestamp, so the delay must not
+    // change any decision; stamping at delivery time (the old behavior)
+    // does.
+    {
+        std::mt19937 rng(9);
+        VirtualClock delivery;
+        const std::uint32_t alt = arc::gesture::kModAlt;
+        arc::gesture::Engine by_event, by_delivery;
+        int presses = 0, correct = 0, drifted = 0;
+        std::uint64_t t = 0xFFF00000u;  // event stamps cross the 32-bit tick wrap on the way
+        for (int i = 0; i < 5000; ++i) {
+            t += 100 + rng() % 400;
+            std::uint32_t stamp = static_cast<std::uint32_t>(t);
+            std::uint32_t hold = 150 + rng() % 200;  // around the 250 ms click time
+            bool is_click = hold <= by_event.settings().click_time_ms;
+            // Delivery = event time + scheduling delay on a loaded machine
+            std::uint32_t down_delay = rng() % 60, up_delay = rng() % 60;
+
+            delivery.set_us((t + down_delay) * 1000);
+            by_event.on_event(ev(EventType::Down, Button::Left, 0, 0, stamp, alt));
+            by_delivery.on_event(
+                ev(EventType::Down, Button::Left, 0, 0, static_cast<std::uint32_t>(delivery.clock().now_ms()), alt));
+
+            delivery.set_us((t + hold + up_delay) * 1000);
+            bool a = translated(by_event.on_event(ev(EventType::Up, Button::Left, 0, 0, stamp + hold, 0)));
+            bool b = translated(
+                by_delivery.on_event(ev(EventType::Up, Button::Left, 0, 0,
+                                        static_cast<std::uint32_t>(delivery.clock().now_ms()), 0)));
+            ++presses;
+            correct += (a == is_click);
+            drifted += (b != is_click);
+            t += hold;
+        }
+        expect(correct == presses, "event timestamps classify every press correctly under delay");
+        expect(drifted > 0, "delivery-time stamping drifts under delay (control)");
+        std::printf("replay: %d presses, %d misclassified with delivery-time stamps\n", presses, drifted);
+    }
+
+    std::printf("[OK] clock tests passed\n");
+    return 0;
+}
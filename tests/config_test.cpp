@@ -54,7 +54,11 @@ int main() {
         expect(defaults.ignore_injected == true, "ignore_injected default true");
         expect(defaults.click_time_ms == 250u, "click_time_ms default 250");
         expect(defaults.move_radius_px == 6, "move_radius_px default 6");
+        expect(defaults.armed_hook == false, "armed_hook default false");
+        expect(defaults.arm_grace_ms == 300u, "arm_grace_ms default 300");
         expect(defaults.log_thread_id == false, "log_thread_id default false");
+        expect(defaults.log_flush_ms == 0u && defaults.log_flush_bytes == 0u, "log flush defaults to immediate");
+        expect(defaults.log_time_digits == 0u, "log timestamps default to seconds");
     }
 
     // Parse a custom config
@@ -66,9 +70,40 @@ int main() {
                           "ignore_injected=false\n"
                           "click_time_ms=333\n"
                           "move_radius_px=9\n"
+                          "drag_predict_ms=24\n"
+                          "speculative_click=yes\n"
+                          "auto_tune=true\n"
+                          "bind=ALT+MIDDLE -> DOUBLE\n"
+                          "bind = ctrl+x1->middle\n"
+                          "bind=ALT+SHIFT+LEFT -> RIGHT\n"
+                          "bind=ALT+BOGUS -> RIGHT\n"
+                          "double_click_ms=280\n"
+                          "double_click_action=x2\n"
+                          "long_press_ms=700\n"
+                          "long_press_action=DOUBLE\n"
+                          "chord_ms=60\n"
+                          "chord_button=DOUBLE\n"
+                          "chord_action=LEFT\n"
+                          "dwell_ms=50\n"
+                          "dwell_action=middle\n"
+                          "stroke=l -> x1\n"
+                          "stroke = DR->middle\n"
+                          "stroke=LL -> X2\n"
+                          "stroke_min_score=90\n"
+                          "device=*Touchpad* -> left\n"
+                          "device = Wacom*Pen -> LEFT+x2,left\n"
+                          "device=*VID_046D* -> none\n"
+                          "device=* -> all\n"
+                          "device=*Mouse* -> RIGHT\n"
+                          "device= -> LEFT\n"
+                          "armed_hook=true\n"
+                          "arm_grace_ms=150\n"
                           "trigger=X2\n"
                           "log_level=debug\n"
                           "log_thread_id=true\n"
+                          "log_flush_ms=20000\n"
+                          "log_flush_bytes=65536\n"
+                          "log_time_digits=4\n"
                           "watch_config=true\n";
         std::string path = write_temp_file("config_test.ini", cfg);
         Config c = arc::config::load(path);
@@ -80,9 +115,47 @@ int main() {
         expect(c.ignore_injected == false, "ignore_injected parsed false");
         expect(c.click_time_ms == 333u, "click_time_ms parsed 333");
         expect(c.move_radius_px == 9, "move_radius_px parsed 9");
+        expect(c.drag_predict_ms == 24u, "drag_predict_ms parsed 24");
+        expect(c.speculative_click == true, "speculative_click parsed true");
+        expect(c.auto_tune == true, "auto_tune parsed true");
+        expect(c.bindings.size() == 3, "three valid bindings, malformed one skipped");
+        expect(c.bindings[0].source == Config::Trigger::Middle &&
+                   c.bindings[0].action == Config::Binding::Action::DoubleLeft &&
+                   c.bindings[0].modifier_vks.size() == 1,
+               "Alt+Middle -> double parsed");
+        expect(c.bindings[1].source == Config::Trigger::X1 && c.bindings[1].action == Config::Binding::Action::Middle,
+               "Ctrl+X1 -> middle parsed (case and spacing tolerant)");
+        expect(c.bindings[2].modifier_vks.size() == 2, "Alt+Shift+Left modifiers parsed");
+        expect(c.double_click_ms == 280u, "double_click_ms parsed 280");
+        expect(c.double_click_action == Config::Binding::Action::X2, "double_click_action parsed x2");
+        expect(c.long_press_ms == 700u, "long_press_ms parsed 700");
+        expect(c.long_press_action == Config::Binding::Action::DoubleLeft, "long_press_action parsed DOUBLE");
+        expect(c.chord_ms == 60u, "chord_ms parsed 60");
+        expect(c.chord_button == Config::Binding::Action::Right, "chord_button DOUBLE rejected, default kept");
+        expect(c.chord_action == Config::Binding::Action::Left, "chord_action parsed LEFT");
+        expect(c.dwell_ms == 0u, "dwell_ms below 100 rejected");
+        expect(c.dwell_action == Config::Binding::Action::Middle, "dwell_action parsed middle");
+        expect(c.strokes.size() == 2 && c.strokes[0].shape == "L" && c.strokes[0].action == Config::Binding::Action::X1,
+               "stroke L -> X1 parsed, malformed one skipped");
+        expect(c.strokes[1].shape == "DR" && c.strokes[1].action == Config::Binding::Action::Middle,
+               "stroke DR -> MIDDLE parsed");
+        expect(c.stroke_min_score == 90u, "stroke_min_score parsed 90");
+        expect(c.devices.size() == 4, "four valid device rules, malformed ones skipped");
+        expect(c.devices[0].pattern == "*Touchpad*" && c.devices[0].buttons.size() == 1 &&
+                   c.devices[0].buttons[0] == Config::Trigger::Left,
+               "device *Touchpad* -> LEFT parsed");
+        expect(c.devices[1].pattern == "Wacom*Pen" && c.devices[1].buttons.size() == 2 &&
+                   c.devices[1].buttons[1] == Config::Trigger::X2,
+               "device button list parsed without duplicates");
+        expect(c.devices[2].buttons.empty() && c.devices[3].buttons.size() == 4, "NONE and ALL parsed");
+        expect(c.armed_hook == true, "armed_hook parsed true");
+        expect(c.arm_grace_ms == 150u, "arm_grace_ms parsed 150");
         expect(c.trigger == Config::Trigger::X2, "trigger parsed X2");
         expect(c.log_level == std::string("debug"), "log_level parsed debug");
         expect(c.log_thread_id == true, "log_thread_id parsed true");
+        expect(c.log_flush_ms == 0u, "log_flush_ms above 10000 rejected");
+        expect(c.log_flush_bytes == 65536u, "log_flush_bytes parsed");
+        expect(c.log_time_digits == 0u, "log_time_digits other than 0/3/6 rejected");
         expect(c.watch_config == true, "watch_config parsed true");
         std::remove(path.c_str());
     }
@@ -98,10 +171,36 @@ int main() {
         w.ignore_injected = true;
         w.click_time_ms = 123;
         w.move_radius_px = 7;
+        w.drag_predict_ms = 16;
+        w.speculative_click = true;
+        w.auto_tune = true;
+        Config::Binding b;
+        b.source = Config::Trigger::X2;
+        b.modifier_vks = {0x11, 0x10};
+        b.action = Config::Binding::Action::DoubleLeft;
+        w.bindings = {b};
+        w.double_click_ms = 320;
+        w.double_click_action = Config::Binding::Action::X1;
+        w.long_press_ms = 900;
+        w.long_press_action = Config::Binding::Action::DoubleLeft;
+        w.chord_ms = 45;
+        w.chord_button = Config::Binding::Action::Middle;
+        w.chord_action = Config::Binding::Action::Right;
+        w.dwell_ms = 800;
+        w.dwell_action = Config::Binding::Action::X2;
+        w.strokes = {Config::Stroke{"URD", Config::Binding::Action::DoubleLeft}};
+        w.stroke_min_score = 75;
+        w.devices = {Config::DeviceRule{"*Touchpad*", {Config::Trigger::Left, Config::Trigger::X1}},
+                     Config::DeviceRule{"\\\\?\\HID#VID_046D&PID_C077*", {}}};
+        w.armed_hook = true;
+        w.arm_grace_ms = 450;
         w.trigger = Config::Trigger::Middle;
         w.log_level = "warn";
         w.watch_config = false;
         w.log_thread_id = true;
+        w.log_flush_ms = 50;
+        w.log_flush_bytes = 4096;
+        w.log_time_digits = 6;
         std::string out = "config_roundtrip.ini";
         expect(arc::config::save(out, w), "save_config success");
         Config r = arc::config::load(out);
@@ -112,9 +211,33 @@ int main() {
         expect(r.ignore_injected == w.ignore_injected, "roundtrip ignore_injected");
         expect(r.click_time_ms == w.click_time_ms, "roundtrip click_time_ms");
         expect(r.move_radius_px == w.move_radius_px, "roundtrip move_radius_px");
+        expect(r.drag_predict_ms == w.drag_predict_ms, "roundtrip drag_predict_ms");
+        expect(r.speculative_click == w.speculative_click, "roundtrip speculative_click");
+        expect(r.auto_tune == w.auto_tune, "roundtrip auto_tune");
+        expect(r.bindings.size() == 1 && r.bindings[0].source == b.source && r.bindings[0].action == b.action &&
+                   r.bindings[0].modifier_vks == b.modifier_vks,
+               "roundtrip bindings");
+        expect(r.double_click_ms == w.double_click_ms && r.double_click_action == w.double_click_action,
+               "roundtrip double click");
+        expect(r.long_press_ms == w.long_press_ms && r.long_press_action == w.long_press_action,
+               "roundtrip long press");
+        expect(r.chord_ms == w.chord_ms && r.chord_button == w.chord_button && r.chord_action == w.chord_action,
+               "roundtrip chord");
+        expect(r.dwell_ms == w.dwell_ms && r.dwell_action == w.dwell_action, "roundtrip dwell");
+        expect(r.strokes.size() == 1 && r.strokes[0].shape == "URD" && r.strokes[0].action == w.strokes[0].action &&
+                   r.stroke_min_score == w.stroke_min_score,
+               "roundtrip strokes");
+        expect(r.devices.size() == 2 && r.devices[0].pattern == w.devices[0].pattern &&
+                   r.devices[0].buttons == w.devices[0].buttons && r.devices[1].pattern == w.devices[1].pattern &&
+                   r.devices[1].buttons.empty(),
+               "roundtrip device rules");
+        expect(r.armed_hook == w.armed_hook, "roundtrip armed_hook");
+        expect(r.arm_grace_ms == w.arm_grace_ms, "roundtrip arm_grace_ms");
         expect(r.trigger == w.trigger, "roundtrip trigger");
         expect(r.log_level == w.log_level, "roundtrip log_level");
         expect(r.log_thread_id == w.log_thread_id, "roundtrip log_thread_id");
+        expect(r.log_flush_ms == w.log_flush_ms && r.log_flush_bytes == w.log_flush_bytes, "roundtrip log flush");
+        expect(r.log_time_digits == w.log_time_digits, "roundtrip log_time_digits");
         std::remove(out.c_str());
     }
 
@@ -0,0 +1,352 @@
+/**
+ * @file device_test.cpp
+ * @brief Per-device routing: name patterns, the device table, evdev discovery
+ *        and decoding, and routed sessions from fake devices through the engine.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "arc/device.h"
+#include "arc/evdev.h"
+#include "arc/gesture.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/input.h>
+#include <unistd.h>
+#endif
+
+using arc::device::Descriptor;
+using arc::device::Id;
+using arc::device::Kind;
+using arc::device::Rule;
+using arc::device::Table;
+using arc::device::Tagged;
+using arc::evdev::Input;
+using arc::gesture::Button;
+using arc::gesture::Decision;
+using arc::gesture::Engine;
+using arc::gesture::Event;
+using arc::gesture::EventType;
+using arc::gesture::Verdict;
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+/** /proc/bus/input/devices of a laptop with a touchpad, a USB mouse, a pen and a keyboard. */
+const char *kProcDevices =
+    "I: Bus=0011 Vendor=0001 Product=0001 Version=ab83\n"
+    "N: Name=\"AT Translated Set 2 keyboard\"\n"
+    "P: Phys=isa0060/serio0/input0\n"
+    "H: Handlers=sysrq kbd leds event3 \n"
+    "B: PROP=0\n"
+    "B: EV=120013\n"
+    "B: KEY=402000000 3803078f800d001 feffffdfffefffff fffffffffffffffe\n"
+    "\n"
+    "I: Bus=0019 Vendor=0000 Product=0001 Version=0000\n"
+    "N: Name=\"Power Button\"\n"
+    "H: Handlers=kbd event0 \n"
+    "B: EV=3\n"
+    "B: KEY=10000000000000 0\n"
+    "\n"
+    "I: Bus=0018 Vendor=04f3 Product=311c Version=0100\n"
+    "N: Name=\"ELAN0670:00 04F3:311C Touchpad\"\n"
+    "H: Handlers=mouse0 event5 \n"
+    "B: PROP=5\n"
+    "B: EV=1b\n"
+    "B: KEY=e520 10000 0 0 0 0\n"
+    "B: ABS=2e0800000000003\n"
+    "\n"
+    "I: Bus=0003 Vendor=046d Product=c077 Version=0111\n"
+    "N: Name=\"Logitech USB Optical Mouse\"\n"
+    "H: Handlers=mouse1 event7 \n"
+    "B: EV=17\n"
+    "B: KEY=ff0000 0 0 0 0\n"
+    "B: REL=903\n"
+    "\n"
+    "I: Bus=0018 Vendor=2d1f Product=0163 Version=0100\n"
+    "N: Name=\"Wacom HID 163 Pen\"\n"
+    "H: Handlers=mouse2 event9 \n"
+    "B: EV=1b\n"
+    "B: KEY=1c03 0 0 0 0 0\n"
+    "B: ABS=1000d000003\n";
+
+Rule rule(const char *pattern, std::uint8_t buttons) {
+    Rule r;
+    arc::device::set_pattern(r, pattern);
+    r.buttons = buttons;
+    return r;
+}
+
+Input in(std::uint32_t t, std::uint16_t type, std::uint16_t code, std::int32_t value) {
+    Input i;
+    i.time_ms = t;
+    i.type = type;
+    i.code = code;
+    i.value = value;
+    return i;
+}
+
+/** Feeds a stream to a decoder, collecting the events it yields. */
+std::vector<Tagged> decode(arc::evdev::Decoder &dec, const std::vector<Input> &stream) {
+    std::vector<Tagged> out;
+    for (const Input &i : stream) {
+        Tagged t;
+        if (dec.feed(i, t))
+            out.push_back(t);
+    }
+    return out;
+}
+
+/** Alt held on the keyboard, then a quick still click of BTN_LEFT, then Alt released. */
+std::vector<Input> alt_click(std::uint32_t t) {
+    using namespace arc::evdev;
+    return {in(t, kEvKey, kKeyLeftAlt, 1),  in(t, kEvSyn, kSynReport, 0),      in(t + 10, kEvKey, kBtnLeft, 1),
+            in(t + 10, kEvSyn, kSynReport, 0), in(t + 60, kEvKey, kBtnLeft, 0), in(t + 60, kEvSyn, kSynReport, 0),
+            in(t + 80, kEvKey, kKeyLeftAlt, 0), in(t + 80, kEvSyn, kSynReport, 0)};
+}
+
+/** Routed engine: what the hook does with each tagged event. */
+struct Routed {
+    Table table;
+    Engine engine;
+    int bypassed = 0;
+    int right_clicks = 0;
+    int swallowed = 0;
+
+    void feed(const Tagged &t) {
+        if (table.routing() && table.bypass(t.device, t.event, engine.idle())) {
+            ++bypassed;
+            return;
+        }
+        Decision d = engine.on_event(t.event);
+        if (d.verdict == Verdict::Swallow)
+            ++swallowed;
+        for (int i = 0; i < d.count; ++i)
+            if (d.inject[i].button == Button::Right && d.inject[i].down)
+                ++right_clicks;
+    }
+};
+
+}  // namespace
+
+int main() {
+    using namespace arc::evdev;
+    const std::uint8_t kLeft = arc::device::button_bit(Button::Left);
+
+    // Name patterns
+    {
+        expect(arc::device::match("*touchpad*", "ELAN0670:00 04F3:311C Touchpad"), "star and case-insensitive");
+        expect(arc::device::match("elan????:*", "ELAN0670:00 04F3:311C Touchpad"), "question marks");
+        expect(!arc::device::match("*touchpad", "Touchpad Left Button"), "anchored at the end");
+        expect(!arc::device::match("mouse", "Logitech USB Optical Mouse"), "anchored at the start");
+        expect(arc::device::match("*", "") && arc::device::match("", ""), "empty text");
+        expect(!arc::device::match("?", ""), "question mark needs a character");
+        expect(arc::device::match("*VID_046D*", "\\\\?\\HID#VID_046D&PID_C077#7&1b2&0&0000#{378de44c}"),
+               "Windows interface path");
+        expect(arc::device::match("a*b*c", "aXbYbZc") && !arc::device::match("a*b*c", "aXbYbZ"), "backtracking");
+        Rule r;
+        std::string longname(300, 'x');
+        arc::device::set_pattern(r, longname.c_str());
+        expect(std::string(r.pattern).size() == arc::device::kMaxPattern - 1, "pattern truncated");
+    }
+
+    // Device table
+    {
+        Table t;
+        expect(!t.routing() && t.size() == 0, "empty table does not route");
+        Descriptor pad{5, "ELAN0670:00 04F3:311C Touchpad", Kind::Touchpad, 0x04f3, 0x311c};
+        Descriptor mouse{7, "Logitech USB Optical Mouse", Kind::Mouse, 0x046d, 0xc077};
+        Descriptor pen{9, "Wacom HID 163 Pen", Kind::Pen, 0x2d1f, 0x0163};
+        Id p = t.add(pad), m = t.add(mouse);
+        expect(p == 1 && m == 2 && t.add(pad) == p, "dense ids, stable per key");
+        expect(t.find(7) == m && t.find(42) == arc::device::kUnknown, "find by key");
+        expect(t.descriptor(m)->vendor == 0x046d && !t.descriptor(arc::device::kUnknown), "descriptors by id");
+
+        Rule rules[] = {rule("*touchpad*", kLeft), rule("pen", kLeft | arc::device::button_bit(Button::X1))};
+        t.configure(rules, 2);
+        Id n = t.add(pen);
+        expect(t.routing(), "rules turn routing on");
+        expect(t.buttons(p) == kLeft && t.buttons(m) == 0, "existing devices re-evaluated");
+        expect(t.buttons(n) == (kLeft | arc::device::button_bit(Button::X1)), "kind name matches a new device");
+        expect(t.buttons(arc::device::kUnknown) == 0 && t.buttons(99) == 0, "unknown ids use no button");
+
+        Event down;
+        down.type = EventType::Down;
+        down.button = Button::Left;
+        expect(!t.bypass(p, down, true) && t.bypass(m, down, true), "presses routed by device");
+        expect(!t.bypass(m, down, false), "a gesture in progress sees every press");
+        down.button = Button::X1;
+        expect(t.bypass(p, down, true) && !t.bypass(n, down, true), "per-button masks");
+        Event move;
+        move.type = EventType::Move;
+        expect(!t.bypass(m, move, true), "moves always reach the engine");
+
+        Rule first[] = {rule("*", arc::device::kAllButtons), rule("*touchpad*", 0)};
+        t.configure(first, 2);
+        expect(t.buttons(p) == arc::device::kAllButtons, "first matching rule wins");
+        t.configure(nullptr, 0);
+        expect(!t.routing(), "no rules, no routing");
+    }
+
+    // Discovery from /proc/bus/input/devices
+    {
+        std::vector<Descriptor> found = parse_devices(kProcDevices);
+        expect(found.size() == 4, "pointing devices and keyboards listed, power button left out");
+        expect(found[0].kind == Kind::Keyboard && found[0].key == 3, "keyboard");
+        expect(found[1].kind == Kind::Touchpad && found[1].key == 5 && found[1].vendor == 0x04f3 &&
+                   found[1].product == 0x311c && found[1].name == "ELAN0670:00 04F3:311C Touchpad",
+               "touchpad");
+        expect(found[2].kind == Kind::Mouse && found[2].key == 7, "mouse");
+        expect(found[3].kind == Kind::Pen && found[3].key == 9, "pen");
+        expect(parse_devices("").empty() && parse_devices("garbage\n\n").empty(), "nothing to list");
+        expect(parse_devices("I: Vendor=zz\nN: Name=\"x\"\nH: Handlers=event1\nB: KEY=10000 0 0 0 0\nB: REL=3\n")
+                   .empty(),
+               "malformed numbers skip the device");
+    }
+
+    // Decoding
+    {
+        Seat seat;
+        seat.x = 100;
+        seat.y = 100;
+        Decoder mouse(2, Kind::Mouse, &seat);
+        std::vector<Tagged> ev = decode(mouse, {in(1, kEvRel, kRelX, 3), in(1, kEvRel, kRelY, -2),
+                                                in(1, kEvSyn, kSynReport, 0), in(2, kEvKey, kBtnSide, 1),
+                                                in(3, kEvKey, kBtnSide, 2), in(4, kEvKey, kBtnSide, 0),
+                                                in(5, kEvSyn, kSynReport, 0)});
+        expect(ev.size() == 3, "move, down, up (repeat and empty report dropped)");
+        expect(ev[0].event.type == EventType::Move && ev[0].event.x == 103 && ev[0].event.y == 98 &&
+                   ev[0].device == 2,
+               "relative motion moves the seat pointer");
+        expect(ev[1].event.type == EventType::Down && ev[1].event.button == Button::X1 && ev[1].event.x == 103,
+               "side button is X1");
+
+        Decoder pad(1, Kind::Touchpad, &seat);
+        ev = decode(pad, {in(10, kEvKey, kBtnTouch, 1), in(10, kEvAbs, kRelX, 500), in(10, kEvAbs, kRelY, 300),
+                          in(10, kEvSyn, kSynReport, 0), in(20, kEvAbs, kRelX, 510), in(20, kEvSyn, kSynReport, 0),
+                          in(30, kEvKey, kBtnTouch, 0), in(40, kEvKey, kBtnTouch, 1), in(40, kEvAbs, kRelX, 900),
+                          in(40, kEvSyn, kSynReport, 0)});
+        expect(ev.size() == 1 && ev[0].event.x == 113 && ev[0].event.y == 98 && ev[0].device == 1,
+               "touchpad moves by position changes; touch is not a click; a new contact does not jump");
+
+        Decoder pen(3, Kind::Pen, &seat);
+        ev = decode(pen, {in(50, kEvKey, kBtnTouch, 1), in(60, kEvKey, kBtnTouch, 0)});
+        expect(ev.size() == 2 && ev[0].event.button == Button::Left && ev[0].event.type == EventType::Down,
+               "pen contact is the left button");
+
+        Decoder kbd(4, Kind::Keyboard, &seat);
+        decode(kbd, {in(70, kEvKey, kKeyRightAlt, 1)});
+        ev = decode(mouse, {in(71, kEvKey, kBtnLeft, 1)});
+        expect(ev.size() == 1 && ev[0].event.mods == arc::gesture::kModAlt, "modifiers shared across the seat");
+        decode(kbd, {in(72, kEvKey, kKeyRightAlt, 0)});
+        expect(seat.modifiers.held() == 0, "modifier released");
+    }
+
+    // Routed session: Alt+Left translated on the touchpad only
+    {
+        Routed r;
+        Seat seat;
+        std::vector<Descriptor> found = parse_devices(kProcDevices);
+        std::vector<Decoder> decoders;
+        for (const Descriptor &d : found)
+            decoders.emplace_back(r.table.add(d), d.kind, &seat);
+        Rule rules[] = {rule("*Touchpad*", kLeft)};
+        r.table.configure(rules, 1);
+        Decoder &kbd = decoders[0], &pad = decoders[1], &mouse = decoders[2];
+
+        auto run = [&](Decoder &pointer, std::uint32_t t) {
+            for (const Input &i : alt_click(t)) {
+                Tagged tg;
+                Decoder &dec = (i.code == kKeyLeftAlt) ? kbd : pointer;
+                if (dec.feed(i, tg))
+                    r.feed(tg);
+            }
+        };
+        run(pad, 1000);
+        expect(r.right_clicks == 1 && r.bypassed == 0, "touchpad Alt+Left becomes a right click");
+        run(mouse, 2000);
+        expect(r.right_clicks == 1 && r.bypassed == 1, "mouse Alt+Left bypasses the engine");
+        expect(r.engine.idle() && !r.engine.tracking(), "the bypassed release leaves the engine idle");
+        run(pad, 3000);
+        expect(r.right_clicks == 2 && r.bypassed == 1, "touchpad still translated afterwards");
+
+        Tagged unknown;
+        unknown.event.type = EventType::Down;
+        unknown.event.button = Button::Left;
+        unknown.event.mods = arc::gesture::kModAlt;
+        r.feed(unknown);
+        expect(r.bypassed == 2, "unattributed presses pass through");
+
+        Routed off;
+        Tagged tg;
+        tg.event = unknown.event;
+        off.feed(tg);
+        expect(off.bypassed == 0 && off.engine.tracking(), "without rules every device is translated");
+    }
+
+#if defined(__linux__)
+    // Source over fake evdev nodes (pipes carrying input_event records)
+    {
+        Table table;
+        Source src;
+        int mouse_fds[2], pad_fds[2];
+        expect(pipe(mouse_fds) == 0 && pipe(pad_fds) == 0, "pipes");
+        fcntl(mouse_fds[0], F_SETFL, O_NONBLOCK);
+        fcntl(pad_fds[0], F_SETFL, O_NONBLOCK);
+        Id m = table.add(Descriptor{7, "Logitech USB Optical Mouse", Kind::Mouse, 0, 0});
+        Id p = table.add(Descriptor{5, "Touchpad", Kind::Touchpad, 0, 0});
+        src.attach(mouse_fds[0], m, Kind::Mouse);
+        src.attach(pad_fds[0], p, Kind::Touchpad);
+        auto put = [](int fd, std::uint16_t type, std::uint16_t code, std::int32_t value, long ms) {
+            input_event ie{};
+            ie.time.tv_sec = ms / 1000;
+            ie.time.tv_usec = (ms % 1000) * 1000;
+            ie.type = type;
+            ie.code = code;
+            ie.value = value;
+            expect(write(fd, &ie, sizeof(ie)) == static_cast<ssize_t>(sizeof(ie)), "write event");
+        };
+        put(mouse_fds[1], kEvRel, kRelX, 5, 1001);
+        put(mouse_fds[1], kEvSyn, kSynReport, 0, 1001);
+        put(mouse_fds[1], kEvKey, kBtnLeft, 1, 1002);
+        put(pad_fds[1], kEvKey, kBtnLeft, 1, 1003);
+        Tagged out[8];
+        int n = src.poll(100, out, 8);
+        expect(n == 3, "three events from two nodes");
+        expect(out[0].event.type == EventType::Move && out[0].device == m && out[0].event.x == 5 &&
+                   out[0].event.time_ms == 1001,
+               "mouse move tagged and timed");
+        expect(out[1].event.type == EventType::Down && out[1].device == m, "mouse press tagged");
+        expect(out[2].event.type == EventType::Down && out[2].device == p, "touchpad press tagged");
+        put(pad_fds[1], kEvKey, kBtnLeft, 0, 1004);
+        put(pad_fds[1], kEvKey, kBtnRight, 1, 1005);
+        n = src.poll(100, out, 1);
+        expect(n == 1 && out[0].event.type == EventType::Up, "output capacity respected");
+        n = src.poll(100, out, 8);
+        expect(n == 1 && out[0].event.button == Button::Right, "the rest stays queued");
+        expect(src.poll(0, out, 8) == 0, "nothing left");
+        close(mouse_fds[1]);
+        close(pad_fds[1]);
+    }
+#endif
+
+    std::puts("[OK] device tests passed");
+    return 0;
+}
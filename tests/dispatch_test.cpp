@@ -0,0 +1,243 @@
+/**
+ * @file dispatch_test.cpp
+ * @brief Generic vs. per-trigger message translation: decoding, instance
+ *        selection, and identical engine decisions on random streams.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "arc/dispatch.h"
+#include "arc/gesture.h"
+#include "arc/stroke.h"
+
+using arc::dispatch::Kind;
+using arc::dispatch::TranslateFn;
+using arc::gesture::Button;
+using arc::gesture::EventType;
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+const unsigned int kMessages[] = {
+    arc::dispatch::kMouseMove,    arc::dispatch::kLButtonDown, arc::dispatch::kLButtonUp,
+    arc::dispatch::kRButtonDown,  arc::dispatch::kRButtonUp,   arc::dispatch::kMButtonDown,
+    arc::dispatch::kMButtonUp,    arc::dispatch::kMouseWheel,  arc::dispatch::kXButtonDown,
+    arc::dispatch::kXButtonUp,
+};
+
+const Button kTriggers[] = {Button::Left, Button::Middle, Button::X1, Button::X2};
+
+TranslateFn instance(Button b) {
+    switch (b) {
+    case Button::Left:
+        return &arc::dispatch::translate_for<Button::Left>;
+    case Button::Middle:
+        return &arc::dispatch::translate_for<Button::Middle>;
+    case Button::X1:
+        return &arc::dispatch::translate_for<Button::X1>;
+    case Button::X2:
+        return &arc::dispatch::translate_for<Button::X2>;
+    default:
+        return nullptr;
+    }
+}
+
+arc::gesture::Settings with_rules(const arc::gesture::Binding *rules, std::size_t n) {
+    arc::gesture::Settings s;
+    s.bindings = arc::gesture::compile_bindings(rules, n);
+    return s;
+}
+
+bool same(const arc::gesture::Decision &a, const arc::gesture::Decision &b) {
+    if (a.verdict != b.verdict || a.count != b.count || a.path_count != b.path_count)
+        return false;
+    for (int i = 0; i < a.count; ++i)
+        if (a.inject[i].button != b.inject[i].button || a.inject[i].down != b.inject[i].down)
+            return false;
+    return true;
+}
+
+/** The hook's translation handling: swaps to the wanted instance only once the engine settles. */
+struct Hook {
+    arc::gesture::Engine engine;
+    TranslateFn current;
+    TranslateFn wanted;
+
+    explicit Hook(const arc::gesture::Settings &s)
+        : engine(s), current(arc::dispatch::select(s)), wanted(current) {}
+
+    void reload(const arc::gesture::Settings &s) {
+        wanted = arc::dispatch::select(s);
+        engine.configure(s);
+    }
+
+    arc::gesture::Decision feed(unsigned int msg, std::int32_t x, std::uint32_t t) {
+        if (current != wanted)
+            current = arc::dispatch::translation_for(wanted, engine);
+        Kind k = current(msg, 0);
+        return engine.on_event(arc::gesture::Event{k.type, k.button, x, 500, t, arc::gesture::kModAlt});
+    }
+};
+
+}  // namespace
+
+/** @brief Entry point for dispatch tests. */
+int main() {
+    // Generic decoding
+    {
+        Kind k = arc::dispatch::translate(arc::dispatch::kMouseMove, 0);
+        expect(k.type == EventType::Move && k.button == Button::None, "move");
+        k = arc::dispatch::translate(arc::dispatch::kRButtonUp, 0);
+        expect(k.type == EventType::Up && k.button == Button::Right, "right up");
+        k = arc::dispatch::translate(arc::dispatch::kXButtonDown, arc::dispatch::kXButton1);
+        expect(k.type == EventType::Down && k.button == Button::X1, "x1 down");
+        k = arc::dispatch::translate(arc::dispatch::kXButtonUp, 2);
+        expect(k.type == EventType::Up && k.button == Button::X2, "x2 up");
+        k = arc::dispatch::translate(arc::dispatch::kMouseWheel, 0);
+        expect(k.type == EventType::Other, "wheel is other");
+        k = arc::dispatch::translate(0x0100, 0);
+        expect(k.type == EventType::Other, "unknown message is other");
+    }
+
+    // Each instance matches the generic decoding on moves and its own
+    // button, and reports everything else as Other
+    for (Button t : kTriggers) {
+        TranslateFn f = instance(t);
+        for (unsigned int msg : kMessages) {
+            for (unsigned int xb = 1; xb <= 2; ++xb) {
+                Kind g = arc::dispatch::translate(msg, xb);
+                Kind s = f(msg, xb);
+                if (g.type == EventType::Move || (g.button == t && g.type != EventType::Other))
+                    expect(s.type == g.type && s.button == g.button, "instance decodes its trigger like translate");
+                else
+                    expect(s.type == EventType::Other && s.button == Button::None, "other buttons are Other");
+            }
+        }
+    }
+
+    // Instance selection
+    {
+        arc::gesture::Settings legacy;
+        expect(arc::dispatch::select(legacy) == instance(Button::Left), "legacy Alt+Left selects the Left instance");
+        for (Button t : kTriggers) {
+            legacy.trigger = t;
+            expect(arc::dispatch::select(legacy) == instance(t), "legacy trigger selects its instance");
+        }
+        arc::gesture::Binding rules[2];
+        rules[0].source = Button::X1;
+        rules[0].mods = arc::gesture::kModCtrl;
+        rules[1].source = Button::X1;
+        rules[1].mods = arc::gesture::kModAlt;
+        expect(arc::dispatch::select(with_rules(rules, 2)) == instance(Button::X1),
+               "several rules on one source select its instance");
+        rules[1].source = Button::Middle;
+        expect(arc::dispatch::select(with_rules(rules, 2)) == &arc::dispatch::translate,
+               "two sources select translate");
+        rules[0].source = Button::Right;
+        expect(arc::dispatch::select(with_rules(rules, 1)) == &arc::dispatch::translate,
+               "a Right source selects translate");
+        arc::gesture::Settings chord;
+        chord.chord_ms = 50;
+        expect(arc::dispatch::select(chord) == &arc::dispatch::translate, "chords watch every button");
+        arc::gesture::Settings twice;
+        twice.double_click_ms = 300;
+        expect(arc::dispatch::select(twice) == &arc::dispatch::translate, "double clicks watch every button");
+        arc::gesture::Settings held;
+        held.long_press_ms = 600;
+        expect(arc::dispatch::select(held) == instance(Button::Left), "long presses keep the instance");
+    }
+
+    // Same decisions: random raw streams through both translations into two
+    // engines, for every trigger with and without speculative clicks
+    {
+        std::mt19937 rng(15);
+        int compared = 0;
+        for (Button t : kTriggers) {
+            for (int spec = 0; spec < 2; ++spec) {
+                arc::gesture::Settings s;
+                s.trigger = t;
+                s.speculative = spec != 0;
+                TranslateFn f = arc::dispatch::select(s);
+                expect(f == instance(t), "selected instance");
+                arc::gesture::Engine generic(s), specialized(s);
+                std::uint32_t time = 1000;
+                std::int32_t x = 500, y = 500;
+                for (int i = 0; i < 20000; ++i) {
+                    unsigned int r = rng() % 16;
+                    unsigned int msg = r < 8 ? arc::dispatch::kMouseMove : kMessages[rng() % 10];
+                    unsigned int xb = 1 + rng() % 2;
+                    time += rng() % 120;
+                    x += static_cast<std::int32_t>(rng() % 9) - 4;
+                    y += static_cast<std::int32_t>(rng() % 9) - 4;
+                    std::uint32_t mods = rng() % 4 ? static_cast<std::uint32_t>(arc::gesture::kModAlt) : rng() % 16;
+                    Kind g = arc::dispatch::translate(msg, xb);
+                    Kind k = f(msg, xb);
+                    arc::gesture::Event a{g.type, g.button, x, y, time, mods};
+                    arc::gesture::Event b{k.type, k.button, x, y, time, mods};
+                    expect(same(generic.on_event(a), specialized.on_event(b)), "same decision");
+                    ++compared;
+                }
+            }
+        }
+        std::printf("compared %d decisions\n", compared);
+    }
+
+    // Config reloads between a press and its release: the release still
+    // decodes and is swallowed, and the new instance takes over afterwards
+    {
+        arc::gesture::Settings other;
+        other.trigger = Button::X1;
+
+        arc::gesture::Settings strokes;
+        expect(arc::stroke::parse_shape("L", strokes.strokes[0].shape), "stroke shape parses");
+        strokes.strokes[0].action = arc::gesture::Action{Button::X2, false};
+        strokes.stroke_count = 1;
+        Hook h(strokes);
+        expect(h.current == instance(Button::Left), "stroke config selects Left");
+        h.feed(arc::dispatch::kLButtonDown, 500, 1000);
+        for (int i = 1; i <= 10; ++i)
+            h.feed(arc::dispatch::kMouseMove, 500 - 10 * i, 1000 + 10 * static_cast<std::uint32_t>(i));
+        expect(h.engine.stroking(), "press records a stroke");
+        h.reload(other);
+        arc::gesture::Decision d = h.feed(arc::dispatch::kLButtonUp, 400, 1110);
+        expect(d.verdict == arc::gesture::Verdict::Swallow, "stroke release swallowed after reload");
+        expect(!h.engine.stroking() && h.engine.settled(), "stroke ended after reload");
+        h.feed(arc::dispatch::kMouseMove, 400, 1120);
+        expect(h.current == instance(Button::X1), "new instance once the stroke ended");
+
+        arc::gesture::Settings held;
+        held.long_press_ms = 600;
+        Hook l(held);
+        expect(l.current == instance(Button::Left), "long-press config selects Left");
+        l.feed(arc::dispatch::kLButtonDown, 500, 1000);
+        d = l.engine.on_timer(1600);
+        expect(d.count > 0, "long press injected");
+        expect(l.engine.idle() && !l.engine.settled(), "release still to swallow");
+        l.reload(other);
+        l.feed(arc::dispatch::kMouseMove, 500, 1700);
+        expect(l.current == &arc::dispatch::translate, "no swap while a release is owed");
+        d = l.feed(arc::dispatch::kLButtonUp, 500, 1800);
+        expect(d.verdict == arc::gesture::Verdict::Swallow, "long-press release swallowed after reload");
+        expect(l.engine.settled(), "settled after the release");
+        l.feed(arc::dispatch::kMouseMove, 500, 1810);
+        expect(l.current == instance(Button::X1), "new instance once the release was swallowed");
+    }
+
+    std::printf("[OK] dispatch tests passed\n");
+    return 0;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file gesture_events.h
+ * @brief Event builder shared by the gesture engine tests.
+ */
+#pragma once
+
+#include <cstdint>
+
+#include "arc/gesture.h"
+
+namespace arc { namespace test {
+
+/** @brief Builds an event with the given fields. */
+inline arc::gesture::Event ev(arc::gesture::EventType type, arc::gesture::Button b, std::int32_t x, std::int32_t y,
+                              std::uint32_t t, std::uint32_t mods = 0) {
+    arc::gesture::Event e;
+    e.type = type;
+    e.button = b;
+    e.x = x;
+    e.y = y;
+    e.time_ms = t;
+    e.mods = mods;
+    return e;
+}
+
+}  // namespace test
+
+}  // namespace arc
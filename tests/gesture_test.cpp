@@ -0,0 +1,281 @@
+/**
+ * @file gesture_test.cpp
+ * @brief Regression tests for the portable arc::gesture engine.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "arc/gesture.h"
+
+#include "gesture_events.h"
+
+using arc::gesture::Button;
+using arc::gesture::Decision;
+using arc::gesture::Engine;
+using arc::gesture::Event;
+using arc::gesture::EventType;
+using arc::gesture::Settings;
+using arc::gesture::Verdict;
+using arc::test::ev;
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+/** @brief Entry point for gesture engine tests. */
+int main() {
+    const unsigned int alt = arc::gesture::kModAlt;
+
+    // Quick Alt+Left click inside the radius becomes a right click
+    {
+        Engine e;
+        Decision d = e.on_event(ev(EventType::Down, Button::Left, 100, 100, 1000, alt));
+        expect(d.verdict == Verdict::Swallow, "trigger down swallowed");
+        expect(d.count == 0, "no injection on down");
+        expect(e.tracking(), "tracking after down");
+        d = e.on_event(ev(EventType::Move, Button::None, 102, 101, 1010));
+        expect(d.verdict == Verdict::Pass && d.count == 0, "small move passes without injection");
+        d = e.on_event(ev(EventType::Up, Button::Left, 102, 101, 1100));
+        expect(d.verdict == Verdict::Swallow, "trigger up swallowed");
+        expect(d.count == 2, "right click injected");
+        expect(d.inject[0].button == Button::Right && d.inject[0].down, "right down first");
+        expect(d.inject[1].button == Button::Right && !d.inject[1].down, "right up second");
+        expect(!e.tracking(), "tracking cleared after up");
+    }
+
+    // Without the modifier the click is untouched
+    {
+        Engine e;
+        Decision d = e.on_event(ev(EventType::Down, Button::Left, 0, 0, 0, 0));
+        expect(d.verdict == Verdict::Pass && !e.tracking(), "plain left down passes");
+        d = e.on_event(ev(EventType::Up, Button::Left, 0, 0, 10, 0));
+        expect(d.verdict == Verdict::Pass && d.count == 0, "plain left up passes");
+    }
+
+    // Leaving the radius turns the gesture into a native drag
+    {
+        Engine e;
+        e.on_event(ev(EventType::Down, Button::Left, 10, 10, 0, alt));
+        Decision d = e.on_event(ev(EventType::Move, Button::None, 30, 10, 20));
+        expect(d.verdict == Verdict::Swallow, "drag move swallowed and replayed");
+        expect(d.count == 1 && d.inject[0].button == Button::Left && d.inject[0].down, "source down injected on drag");
+        expect(d.path_count == 2 && d.path[0].x == 10 && d.path[0].y == 10 && d.path[1].x == 30,
+               "down at the origin, then move to the exit point");
+        expect(!e.tracking(), "tracking stops on drag");
+        d = e.on_event(ev(EventType::Up, Button::Left, 30, 10, 40));
+        expect(d.verdict == Verdict::Pass && d.count == 0, "drag up passes through");
+    }
+
+    // A long press resolves at the click time into a native press
+    {
+        Engine e;
+        e.on_event(ev(EventType::Down, Button::Left, 0, 0, 0, alt));
+        std::uint32_t at = 0;
+        expect(e.deadline(at) && at == 251, "deadline just past click time");
+        Decision d = e.on_timer(250);
+        expect(d.count == 0 && e.tracking(), "timer before the deadline is a no-op");
+        d = e.on_timer(at);
+        expect(d.count == 1 && d.inject[0].button == Button::Left && d.inject[0].down, "long press injects source down");
+        expect(!e.tracking() && !e.deadline(at), "long press resolved");
+        d = e.on_event(ev(EventType::Up, Button::Left, 0, 0, 1000));
+        expect(d.verdict == Verdict::Pass && d.count == 0, "release of a resolved long press passes");
+    }
+
+    // A long press whose timer never ran replays the source click on release
+    {
+        Engine e;
+        e.on_event(ev(EventType::Down, Button::Left, 0, 0, 0, alt));
+        Decision d = e.on_event(ev(EventType::Up, Button::Left, 0, 0, 1000));
+        expect(d.verdict == Verdict::Swallow && d.count == 2 && d.inject[0].button == Button::Left &&
+                   d.inject[0].down && !d.inject[1].down,
+               "late long press replays the source click");
+    }
+
+    // Drag prediction: a fast outward move starts the drag inside the radius
+    {
+        Settings s;
+        s.move_radius_px = 20;
+        s.predict_ms = 16;
+        Engine e(s);
+        e.on_event(ev(EventType::Down, Button::Left, 0, 0, 1000, arc::gesture::kModAlt));
+        Decision d;
+        int x = 0;
+        unsigned int t = 1000;
+        for (; x <= 20 && d.count == 0; ) {
+            x += 2;
+            t += 1;
+            d = e.on_event(ev(EventType::Move, Button::None, x, 0, t));
+        }
+        expect(d.count == 1 && d.inject[0].button == Button::Left && d.inject[0].down, "predicted drag injects source down");
+        expect(x < 20 && d.verdict == Verdict::Swallow, "drag predicted before the radius is crossed");
+        expect(d.path_count >= 2 && d.path[0].x == 0 && d.path[d.path_count - 1].x == x, "predicted drag replays the path");
+
+        // Slow creep to the edge of the radius and back stays a click
+        Engine slow(s);
+        slow.on_event(ev(EventType::Down, Button::Left, 0, 0, 0, arc::gesture::kModAlt));
+        for (int i = 1; i <= 18; ++i) {
+            d = slow.on_event(ev(EventType::Move, Button::None, i, 0, static_cast<unsigned int>(i * 10)));
+            expect(d.count == 0, "slow motion is not predicted as a drag");
+        }
+        slow.on_event(ev(EventType::Move, Button::None, 2, 0, 190));
+        d = slow.on_event(ev(EventType::Up, Button::Left, 2, 0, 200));
+        expect(d.count == 2 && d.inject[0].button == Button::Right, "slow press still clicks");
+
+        // Fast move back toward the origin is never a predicted drag
+        Engine back(s);
+        back.on_event(ev(EventType::Down, Button::Left, 0, 0, 0, arc::gesture::kModAlt));
+        back.on_event(ev(EventType::Move, Button::None, 15, 0, 100));
+        d = back.on_event(ev(EventType::Move, Button::None, 11, 0, 104));
+        expect(d.count == 0, "inward motion not predicted");
+
+        // Disabled prediction waits for the radius
+        s.predict_ms = 0;
+        Engine off(s);
+        off.on_event(ev(EventType::Down, Button::Left, 0, 0, 0, arc::gesture::kModAlt));
+        for (int i = 1; i <= 10; ++i) {
+            d = off.on_event(ev(EventType::Move, Button::None, 2 * i, 0, static_cast<unsigned int>(i)));
+            expect(d.count == 0, "no prediction when disabled");
+        }
+    }
+
+    // Timestamps wrap like GetTickCount
+    {
+        Engine e;
+        e.on_event(ev(EventType::Down, Button::Left, 0, 0, 0xFFFFFFF0u, alt));
+        Decision d = e.on_event(ev(EventType::Up, Button::Left, 0, 0, 0x00000010u));
+        expect(d.count == 2, "click across tick wrap translated");
+    }
+
+    // Binding table: several rules, most specific wins, one press per button
+    {
+        using arc::gesture::Binding;
+        const std::uint32_t alt = arc::gesture::kModAlt, ctrl = arc::gesture::kModCtrl,
+                            shift = arc::gesture::kModShift;
+        Binding rules[4];
+        rules[0] = Binding{Button::Middle, alt, {Button::Left, true}};
+        rules[1] = Binding{Button::X1, ctrl, {Button::Middle, false}};
+        rules[2] = Binding{Button::Left, alt | shift, {Button::Right, false}};
+        rules[3] = Binding{Button::Left, alt, {Button::Middle, false}};
+        Settings s;
+        s.bindings = arc::gesture::compile_bindings(rules, 4);
+        expect(s.bindings.modifier_sets() & (1u << alt), "Alt alone completes a binding");
+        expect(!(s.bindings.modifier_sets() & (1u << shift)), "Shift alone does not");
+        Engine e(s);
+
+        e.on_event(ev(EventType::Down, Button::Middle, 5, 5, 0, alt));
+        Decision d = e.on_event(ev(EventType::Up, Button::Middle, 5, 5, 50));
+        expect(d.count == 4 && d.inject[0].button == Button::Left && d.inject[0].down && !d.inject[1].down &&
+                   d.inject[2].down && !d.inject[3].down,
+               "Alt+Middle -> double left click");
+
+        d = e.on_event(ev(EventType::Down, Button::X1, 5, 5, 100, ctrl | alt));
+        expect(d.verdict == Verdict::Swallow, "Ctrl+X1 tracked with an extra modifier held");
+        d = e.on_event(ev(EventType::Up, Button::X1, 5, 5, 150));
+        expect(d.count == 2 && d.inject[0].button == Button::Middle, "Ctrl+X1 -> middle click");
+
+        e.on_event(ev(EventType::Down, Button::Left, 5, 5, 200, alt | shift));
+        d = e.on_event(ev(EventType::Up, Button::Left, 5, 5, 250));
+        expect(d.count == 2 && d.inject[0].button == Button::Right, "Alt+Shift+Left -> right (more specific)");
+        e.on_event(ev(EventType::Down, Button::Left, 5, 5, 300, alt));
+        d = e.on_event(ev(EventType::Up, Button::Left, 5, 5, 350));
+        expect(d.count == 2 && d.inject[0].button == Button::Middle, "Alt+Left -> middle");
+
+        d = e.on_event(ev(EventType::Down, Button::Left, 5, 5, 400, ctrl));
+        expect(d.verdict == Verdict::Pass, "unbound combination passes");
+        d = e.on_event(ev(EventType::Down, Button::Middle, 5, 5, 500, alt));
+        d = e.on_event(ev(EventType::Up, Button::Left, 5, 5, 510));
+        expect(d.verdict == Verdict::Pass && d.count == 0, "release of another button ignored");
+        d = e.on_event(ev(EventType::Move, Button::None, 50, 5, 520));
+        expect(d.count == 1 && d.inject[0].button == Button::Middle && d.inject[0].down,
+               "drag replays the tracked source button");
+
+        // Equal specificity: the earlier rule wins; the legacy fallback only applies to an empty table
+        Binding tie[2] = {Binding{Button::Left, ctrl, {Button::X1, false}},
+                          Binding{Button::Left, ctrl, {Button::X2, false}}};
+        expect(arc::gesture::compile_bindings(tie, 2).at(Button::Left, ctrl).button == Button::X1, "earlier rule wins");
+        expect(arc::gesture::effective_bindings(Settings{}).at(Button::Left, alt).button == Button::Right,
+               "empty table falls back to the trigger rule");
+    }
+
+    // Alternate trigger and modifier combo
+    {
+        Settings s;
+        s.trigger = Button::X2;
+        s.required_mods = arc::gesture::kModAlt | arc::gesture::kModCtrl;
+        Engine e(s);
+        Decision d = e.on_event(ev(EventType::Down, Button::X2, 0, 0, 0, alt));
+        expect(d.verdict == Verdict::Pass, "incomplete combo passes");
+        d = e.on_event(ev(EventType::Down, Button::X1, 0, 0, 0, s.required_mods));
+        expect(d.verdict == Verdict::Pass, "other X button passes");
+        d = e.on_event(ev(EventType::Down, Button::X2, 0, 0, 0, s.required_mods | arc::gesture::kModShift));
+        expect(d.verdict == Verdict::Swallow, "superset of combo accepted");
+        d = e.on_event(ev(EventType::Move, Button::None, 50, 0, 5));
+        expect(d.count == 1 && d.inject[0].button == Button::X2, "X2 drag injects X2 down");
+    }
+
+    // No required modifiers: every trigger press is tracked
+    {
+        Settings s;
+        s.required_mods = 0;
+        Engine e(s);
+        Decision d = e.on_event(ev(EventType::Down, Button::Left, 0, 0, 0, 0));
+        expect(d.verdict == Verdict::Swallow, "no modifier requirement tracks plain press");
+    }
+
+    // The inscribed-square prefilter never changes the radius test: every
+    // offset around the press, for every radius, drags exactly when it is
+    // outside the circle (also after a radius change mid-press)
+    {
+        for (int r = 0; r <= 60; ++r) {
+            Settings s;
+            s.move_radius_px = r;
+            Engine e(s);
+            for (int dy = -r - 2; dy <= r + 2; ++dy) {
+                for (int dx = -r - 2; dx <= r + 2; ++dx) {
+                    e.on_event(ev(EventType::Down, Button::Left, 100, 100, 0, alt));
+                    Decision d = e.on_event(ev(EventType::Move, Button::None, 100 + dx, 100 + dy, 1));
+                    bool outside = dx * dx + dy * dy > r * r;
+                    expect((d.verdict == Verdict::Swallow) == outside, "prefilter agrees with the radius");
+                    e.reset();
+                }
+            }
+        }
+        Settings s;
+        s.move_radius_px = 40;
+        Engine e(s);
+        e.on_event(ev(EventType::Down, Button::Left, 0, 0, 0, alt));
+        s.move_radius_px = 5;
+        e.configure(s);
+        Decision d = e.on_event(ev(EventType::Move, Button::None, 6, 0, 1));
+        expect(d.verdict == Verdict::Swallow, "shrunk radius applies to the tracked press");
+    }
+
+    // Idle moves pass without touching the engine state
+    {
+        Engine e;
+        Decision d = e.on_event(ev(EventType::Move, Button::None, 5000, 5000, 1));
+        expect(d.verdict == Verdict::Pass && d.count == 0 && !e.tracking(), "idle move passes");
+    }
+
+    // Virtual-key mapping
+    {
+        expect(arc::gesture::modifier_from_vk(0x12) == arc::gesture::kModAlt, "VK_MENU -> alt");
+        expect(arc::gesture::modifier_from_vk(0xA3) == arc::gesture::kModCtrl, "VK_RCONTROL -> ctrl");
+        expect(arc::gesture::modifier_from_vk(0xA0) == arc::gesture::kModShift, "VK_LSHIFT -> shift");
+        expect(arc::gesture::modifier_from_vk(0x5C) == arc::gesture::kModWin, "VK_RWIN -> win");
+        expect(arc::gesture::modifier_from_vk(0x1B) == 0u, "VK_ESCAPE is not a modifier");
+    }
+
+    std::printf("[OK] gesture tests passed\n");
+    return 0;
+}
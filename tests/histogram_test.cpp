@@ -0,0 +1,103 @@
+/**
+ * @file histogram_test.cpp
+ * @brief Bucket math and quantile tests for arc::metrics::LatencyHistogram.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arc/histogram.h"
+#include "arc/metrics.h"
+
+using arc::metrics::LatencyHistogram;
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+/** @brief Entry point for histogram tests. */
+int main() {
+    // Bucket boundaries are contiguous and invertible
+    {
+        for (std::uint64_t v = 0; v < 100000; ++v) {
+            std::size_t b = LatencyHistogram::bucket_of(v);
+            expect(b < LatencyHistogram::kBuckets, "bucket in range");
+            expect(v <= LatencyHistogram::bucket_upper(b), "value not above its bucket bound");
+            if (b > 0)
+                expect(v > LatencyHistogram::bucket_upper(b - 1), "value above previous bucket bound");
+        }
+        expect(LatencyHistogram::bucket_of(~std::uint64_t{0}) == LatencyHistogram::kBuckets - 1, "max maps to last");
+        expect(LatencyHistogram::bucket_upper(LatencyHistogram::kBuckets - 1) == ~std::uint64_t{0}, "last bound max");
+    }
+
+    // Small values are exact
+    {
+        LatencyHistogram h;
+        for (int i = 1; i <= 10; ++i)
+            h.record(static_cast<std::uint64_t>(i));
+        auto s = h.summarize();
+        expect(s.count == 10, "count");
+        expect(s.max == 10, "max exact");
+        expect(s.mean == 5, "mean");
+        expect(s.p50 == 5, "p50 exact for small values");
+        expect(h.quantile(1.0) == 10, "p100 equals max");
+    }
+
+    // Relative error bounded for large values
+    {
+        LatencyHistogram h;
+        for (std::uint64_t i = 1; i <= 100000; ++i)
+            h.record(i * 100);  // 100 ns .. 10 ms uniform
+        auto s = h.summarize();
+        double p50 = static_cast<double>(s.p50), p99 = static_cast<double>(s.p99);
+        expect(p50 >= 5000000.0 && p50 <= 5000000.0 * 1.125, "p50 within bucket error");
+        expect(p99 >= 9900000.0 && p99 <= 9900000.0 * 1.125, "p99 within bucket error");
+        expect(s.p999 <= s.max && s.max == 10000000, "p999 capped by exact max");
+        h.reset();
+        expect(h.summarize().count == 0 && h.quantile(0.5) == 0, "reset clears");
+    }
+
+    // Concurrent recording loses nothing
+    {
+        LatencyHistogram h;
+        std::vector<std::thread> ts;
+        for (int t = 0; t < 4; ++t)
+            ts.emplace_back([&h, t]() {
+                for (int i = 0; i < 100000; ++i)
+                    h.record(static_cast<std::uint64_t>(i + t));
+            });
+        for (auto &t : ts)
+            t.join();
+        auto s = h.summarize();
+        expect(s.count == 400000, "concurrent count");
+        expect(s.max == 100002, "concurrent max");
+    }
+
+    // Metrics block counts events by type
+    {
+        static arc::metrics::HookMetrics m;
+        m.count_event(arc::metrics::kEventMove);
+        m.count_event(arc::metrics::kEventMove);
+        m.count_event(arc::metrics::kEventUp);
+        m.count_event(99);  // ignored
+        expect(m.events[arc::metrics::kEventMove].load() == 2, "move counted");
+        expect(m.events[arc::metrics::kEventUp].load() == 1, "up counted");
+        expect(std::string(arc::metrics::event_type_name(arc::metrics::kEventWheel)) == "wheel", "type name");
+    }
+
+    std::printf("[OK] histogram tests passed\n");
+    return 0;
+}
@@ -0,0 +1,280 @@
+/**
+ * @file hook_snapshot_test.cpp
+ * @brief Snapshot construction, RCU reclamation and a config-swap stress test.
+ *
+ * The stress case mirrors the hook: one reader replays an event stream
+ * through a gesture engine, reading one snapshot per event, while writer
+ * threads publish new configurations as fast as they can. Build with
+ * -DARC_SANITIZE=thread to have ThreadSanitizer check it for races.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arc/config.h"
+#include "arc/gesture.h"
+#include "arc/hook_snapshot.h"
+#include "arc/rcu.h"
+
+using arc::hook::HookSnapshot;
+using arc::hook::make_snapshot;
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+/// Snapshot type that counts live instances.
+struct Counted {
+    static std::atomic<int> live;
+    int value = 0;
+    Counted() { live.fetch_add(1); }
+    explicit Counted(int v) : value(v) { live.fetch_add(1); }
+    Counted(const Counted &o) : value(o.value) { live.fetch_add(1); }
+    ~Counted() { live.fetch_sub(1); }
+};
+std::atomic<int> Counted::live{0};
+
+/**
+ * Config number @p k of the stress set. Every field is derived from @p k so
+ * a reader can tell a torn (half old, half new) snapshot from a whole one.
+ */
+arc::config::Config stress_config(unsigned int k) {
+    static const arc::config::Config::Trigger kTriggers[] = {
+        arc::config::Config::Trigger::Left, arc::config::Config::Trigger::Middle,
+        arc::config::Config::Trigger::X1, arc::config::Config::Trigger::X2};
+    arc::config::Config c;
+    c.click_time_ms = 100 + k;
+    c.move_radius_px = static_cast<int>(k);
+    c.trigger = kTriggers[k % 4];
+    c.enabled = (k % 7) != 0;
+    c.modifier_combo_vks.clear();
+    if (k % 2)
+        c.modifier_combo_vks = {0xA2, 0xA4};  // LCTRL+LALT
+    return c;
+}
+
+/** Returns true if @p s is exactly what stress_config produced for some k. */
+bool consistent(const HookSnapshot &s) {
+    static const arc::gesture::Button kButtons[] = {arc::gesture::Button::Left, arc::gesture::Button::Middle,
+                                                    arc::gesture::Button::X1, arc::gesture::Button::X2};
+    if (s.generation == 0)
+        return true;  // built-in defaults
+    unsigned int k = static_cast<unsigned int>(s.gesture.move_radius_px);
+    std::uint32_t mods = (k % 2) ? (arc::gesture::kModCtrl | arc::gesture::kModAlt) : arc::gesture::kModAlt;
+    return s.gesture.click_time_ms == 100 + k && s.gesture.trigger == kButtons[k % 4] &&
+           s.enabled == ((k % 7) != 0) && s.gesture.required_mods == mods && s.poll_count == ((k % 2) ? 2 : 1);
+}
+
+}  // namespace
+
+/** @brief Entry point for hook snapshot tests. */
+int main() {
+    // Snapshot construction
+    {
+        arc::config::Config c;
+        HookSnapshot s = make_snapshot(c, 3);
+        expect(s.generation == 3, "generation stored");
+        expect(s.gesture.required_mods == arc::gesture::kModAlt, "legacy modifier mask");
+        expect(s.poll_count == 1 && s.poll_vks[0] == 0x12, "legacy modifier polled");
+        expect(s.gesture.click_time_ms == 250 && s.gesture.move_radius_px == 6, "thresholds copied");
+        expect(!s.armed && s.arm_grace_ms == 300, "armed mode off by default");
+        expect(!s.auto_tune, "auto_tune off by default");
+
+        c.modifier_combo_vks = {0x11, 0x10};
+        c.trigger = arc::config::Config::Trigger::X2;
+        c.ignore_injected = false;
+        c.auto_tune = true;
+        s = make_snapshot(c, 4);
+        expect(s.gesture.required_mods == (arc::gesture::kModCtrl | arc::gesture::kModShift), "combo mask");
+        expect(s.poll_count == 2 && s.poll_vks[1] == 0x10, "combo keys polled");
+        expect(s.gesture.trigger == arc::gesture::Button::X2, "trigger mapped");
+        expect(!s.ignore_injected, "ignore_injected copied");
+        expect(s.auto_tune, "auto_tune copied");
+
+        c.modifier_combo_vks.clear();
+        c.modifier_vk = 0;
+        s = make_snapshot(c, 5);
+        expect(s.gesture.required_mods == 0 && s.poll_count == 0, "no modifier");
+        expect(alignof(HookSnapshot) == 64, "snapshot cache-line aligned");
+    }
+
+    // Binding rules compile into the snapshot, legacy rule last
+    {
+        using Binding = arc::config::Config::Binding;
+        using arc::gesture::Button;
+        arc::config::Config c;
+        expect(make_snapshot(c, 1).gesture.bindings.empty(), "no rules: table left to the legacy fallback");
+        Binding dbl;
+        dbl.source = arc::config::Config::Trigger::Middle;
+        dbl.modifier_vks = {0x12};
+        dbl.action = Binding::Action::DoubleLeft;
+        Binding mid;
+        mid.source = arc::config::Config::Trigger::X1;
+        mid.modifier_vks = {0x11};
+        mid.action = Binding::Action::Middle;
+        Binding rs;
+        rs.source = arc::config::Config::Trigger::Left;
+        rs.modifier_vks = {0x12, 0x10};
+        rs.action = Binding::Action::X2;
+        c.bindings = {dbl, mid, rs};
+        HookSnapshot s = make_snapshot(c, 2);
+        const auto &t = s.gesture.bindings;
+        const std::uint32_t alt = arc::gesture::kModAlt, ctrl = arc::gesture::kModCtrl,
+                            shift = arc::gesture::kModShift;
+        expect(t.at(Button::Middle, alt).button == Button::Left && t.at(Button::Middle, alt).double_click,
+               "Alt+Middle -> double click");
+        expect(t.at(Button::X1, ctrl | shift).button == Button::Middle, "Ctrl+X1 (superset held) -> middle");
+        expect(t.at(Button::Left, alt | shift).button == Button::X2, "Alt+Shift+Left -> X2 (most specific)");
+        expect(t.at(Button::Left, alt).button == Button::Right, "legacy Alt+Left -> right still bound");
+        expect(t.at(Button::Left, ctrl).button == Button::None, "unbound combination");
+        expect(s.poll_count == 3, "rule modifiers polled once each");
+    }
+
+    // Stroke rules convert to shapes; malformed ones are dropped
+    {
+        using Stroke = arc::config::Config::Stroke;
+        arc::config::Config c;
+        Stroke back{"L", arc::config::Config::Binding::Action::X1};
+        Stroke bad{"LL", arc::config::Config::Binding::Action::X2};
+        Stroke close{"DR", arc::config::Config::Binding::Action::Middle};
+        c.strokes = {back, bad, close};
+        c.stroke_min_score = 90;
+        HookSnapshot s = make_snapshot(c, 1);
+        expect(s.gesture.stroke_count == 2 && s.gesture.stroke_min_score == 90, "two valid stroke rules");
+        const arc::gesture::StrokeRule &close_rule = s.gesture.strokes[1];
+        expect(close_rule.shape.count == 2 && close_rule.action.button == arc::gesture::Button::Middle, "DR -> middle");
+    }
+
+    // Dwell time and action are copied
+    {
+        arc::config::Config c;
+        c.dwell_ms = 700;
+        c.dwell_action = arc::config::Config::Binding::Action::DoubleLeft;
+        HookSnapshot s = make_snapshot(c, 1);
+        expect(s.gesture.dwell_ms == 700 && s.gesture.dwell_action.button == arc::gesture::Button::Left &&
+                   s.gesture.dwell_action.double_click,
+               "dwell settings");
+    }
+
+    // Device rules convert to fixed-size patterns and button masks
+    {
+        using Config = arc::config::Config;
+        Config c;
+        expect(make_snapshot(c, 1).device_count == 0, "no device rules, no routing");
+        c.devices = {Config::DeviceRule{"*Touchpad*", {Config::Trigger::Left}},
+                     Config::DeviceRule{"pen", {Config::Trigger::Left, Config::Trigger::X2}},
+                     Config::DeviceRule{"*VID_046D*", {}}};
+        HookSnapshot s = make_snapshot(c, 2);
+        expect(s.device_count == 3, "three device rules");
+        expect(std::string(s.devices[0].pattern) == "*Touchpad*" &&
+                   s.devices[0].buttons == arc::device::button_bit(arc::gesture::Button::Left),
+               "touchpad rule");
+        expect(s.devices[1].buttons == (arc::device::button_bit(arc::gesture::Button::Left) |
+                                        arc::device::button_bit(arc::gesture::Button::X2)),
+               "pen rule");
+        expect(s.devices[2].buttons == 0, "pass-through rule");
+        c.devices.assign(arc::device::kMaxRules + 4, Config::DeviceRule{"*", {}});
+        expect(make_snapshot(c, 3).device_count == arc::device::kMaxRules, "rules capped");
+    }
+
+    // Deferred reclamation: a held snapshot survives publishes
+    {
+        {
+            arc::rcu::Cell<Counted> cell(Counted(1));
+            {
+                auto g = cell.read();
+                cell.publish(Counted(2));
+                cell.publish(Counted(3));
+                expect(g->value == 1, "reader keeps its snapshot");
+                expect(cell.retired() == 2, "both replaced snapshots deferred");
+            }
+            cell.reclaim();
+            expect(cell.retired() == 0, "reclaimed after reader left");
+            expect(Counted::live.load() == 1, "only the current snapshot alive");
+            {
+                auto g = cell.read();
+                expect(g->value == 3, "reader sees latest");
+                cell.publish(Counted(4));
+                expect(g->value == 3 && cell.retired() == 1, "pinned while reading");
+            }
+            cell.publish(Counted(5));
+            expect(cell.retired() == 0, "publish reclaims once the reader left");
+        }
+        expect(Counted::live.load() == 0, "destructor frees everything");
+    }
+
+    // Stress: config swaps against a replayed event stream
+    {
+        arc::rcu::Cell<HookSnapshot> cell;
+        std::atomic<bool> done{false};
+        std::atomic<std::uint64_t> generation{0};
+        std::vector<std::thread> writers;
+        for (int w = 0; w < 2; ++w) {
+            writers.emplace_back([&, w]() {
+                unsigned int k = static_cast<unsigned int>(w);
+                while (!done.load(std::memory_order_relaxed)) {
+                    cell.publish(make_snapshot(stress_config(k % 64), generation.fetch_add(1) + 1));
+                    k += 2;
+                    std::this_thread::yield();
+                }
+            });
+        }
+
+        arc::gesture::Engine engine;
+        std::uint64_t applied = 0, changes = 0, torn = 0, decisions = 0;
+        const int kEvents = 200000;
+        for (int i = 0; i < kEvents; ++i) {
+            auto snap = cell.read();
+            if (!consistent(*snap))
+                ++torn;
+            if (snap->generation != applied) {
+                engine.configure(snap->gesture);
+                applied = snap->generation;
+                ++changes;
+            }
+            // Replayed stream: press, short wiggle, release, cycling buttons
+            arc::gesture::Event ev;
+            int phase = i % 4;
+            ev.type = phase == 0 ? arc::gesture::EventType::Down
+                      : phase == 3 ? arc::gesture::EventType::Up
+                                   : arc::gesture::EventType::Move;
+            ev.button = phase == 1 || phase == 2 ? arc::gesture::Button::None
+                                                 : static_cast<arc::gesture::Button>(1 + (i / 4) % 5);
+            ev.x = (i % 4) * 3;
+            ev.time_ms = static_cast<std::uint32_t>(i);
+            ev.mods = arc::gesture::kModAlt | arc::gesture::kModCtrl;
+            if (snap->enabled && engine.on_event(ev).count)
+                ++decisions;
+        }
+        done.store(true);
+        for (auto &t : writers)
+            t.join();
+
+        expect(torn == 0, "no torn snapshot observed");
+        expect(generation.load() > 0, "writers published");
+        cell.reclaim();
+        expect(cell.retired() == 0, "all retired snapshots reclaimed");
+        std::printf("stress: %d events, %llu config changes seen, %llu publishes, %llu injecting decisions\n",
+                    kEvents, static_cast<unsigned long long>(changes),
+                    static_cast<unsigned long long>(generation.load()), static_cast<unsigned long long>(decisions));
+    }
+
+    std::printf("[OK] hook snapshot tests passed\n");
+    return 0;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file log_batch_test.cpp
+ * @brief Flush policy of arc::log::Batch on a virtual clock.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "arc/log_batch.h"
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+void add(arc::log::Batch &b, const std::string &line, std::int64_t now) {
+    b.text() += line;
+    b.appended(now);
+}
+
+}  // namespace
+
+/** @brief Entry point for log batch tests. */
+int main() {
+    using arc::log::Batch;
+    using arc::log::FlushPolicy;
+
+    // Default policy: anything buffered is due at once
+    {
+        Batch b;
+        expect(b.empty() && !b.due(0) && b.wait_ms(0) == -1, "empty batch is never due");
+        add(b, "a\n", 100);
+        expect(b.due(100) && b.wait_ms(100) == 0, "immediate policy flushes every drain");
+        b.clear();
+        expect(b.empty() && !b.due(100), "clear empties the batch");
+    }
+
+    // Interval: held from the first line until interval_ms have passed
+    {
+        Batch b;
+        b.set_policy(FlushPolicy{50, 0});
+        add(b, "a\n", 1000);
+        add(b, "b\n", 1030);
+        expect(!b.due(1030) && b.wait_ms(1030) == 20, "interval counts from the oldest line");
+        expect(b.due(1050) && b.wait_ms(1060) == 0, "interval elapsed");
+        b.clear();
+        add(b, "c\n", 2000);
+        expect(b.wait_ms(2000) == 50, "hold restarts after a flush");
+    }
+
+    // Bytes: due at the threshold, or after kMaxHoldMs when left alone
+    {
+        Batch b;
+        b.set_policy(FlushPolicy{0, 8});
+        add(b, "abc\n", 0);
+        expect(!b.due(10), "below the byte threshold");
+        expect(b.wait_ms(10) == static_cast<std::int64_t>(arc::log::kMaxHoldMs) - 10,
+               "bytes-only holds at most kMaxHoldMs");
+        add(b, "defg\n", 20);
+        expect(b.due(20), "byte threshold reached");
+        b.clear();
+        add(b, "x\n", 0);
+        expect(b.due(arc::log::kMaxHoldMs), "bytes-only text goes out after kMaxHoldMs");
+    }
+
+    // Both limits: whichever comes first
+    {
+        Batch b;
+        b.set_policy(FlushPolicy{100, 4});
+        add(b, "ab\n", 0);
+        expect(!b.due(50) && b.due(100), "time limit with few bytes");
+        add(b, "cd\n", 60);
+        expect(b.due(60), "size limit before the time limit");
+    }
+
+    // An urgent line forces the next flush
+    {
+        Batch b;
+        b.set_policy(FlushPolicy{5000, 1 << 16});
+        add(b, "info\n", 0);
+        expect(!b.due(1), "held under a long policy");
+        b.force();
+        add(b, "error\n", 1);
+        expect(b.due(1) && b.wait_ms(1) == 0, "forced flush is due at once");
+        b.clear();
+        add(b, "info\n", 2);
+        expect(!b.due(3), "force lasts one flush");
+    }
+
+    std::printf("[OK] log batch tests passed\n");
+    return 0;
+}
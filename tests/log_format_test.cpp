@@ -0,0 +1,99 @@
+/**
+ * @file log_format_test.cpp
+ * @brief arc::log::TimestampCache against strftime, and log line assembly.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+#include "arc/log_format.h"
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+using arc::log::Precision;
+
+std::string stamp(arc::log::TimestampCache &c, std::int64_t us, Precision p) {
+    char buf[arc::log::kTimestampBytes];
+    return std::string(buf, c.format(us, p, buf));
+}
+
+/** Reference: the seconds part formatted directly. */
+std::string reference(std::int64_t second) {
+    std::time_t t = static_cast<std::time_t>(second);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    char buf[32];
+    return std::string(buf, std::strftime(buf, sizeof buf, "%Y-%m-%d %H:%M:%S", &tm));
+}
+
+std::string line(std::size_t cap, bool with_tid, std::uint32_t tid, const std::string &msg, std::size_t *full) {
+    std::string out(cap, '#');
+    *full = arc::log::format_line(out.data(), cap, "2024-01-02 03:04:05", "INFO", with_tid, tid, msg);
+    return out.substr(0, *full < cap ? *full : cap);
+}
+
+}  // namespace
+
+/** @brief Entry point for log format tests. */
+int main() {
+    // Seconds match strftime; precision digits come from the fraction
+    {
+        arc::log::TimestampCache c;
+        const std::int64_t base = 1700000000;  // Nov 2023
+        std::string secs = reference(base);
+        expect(stamp(c, base * 1000000 + 123456, Precision::Seconds) == secs, "seconds match strftime");
+        expect(stamp(c, base * 1000000 + 123456, Precision::Millis) == secs + ".123", "milliseconds truncated");
+        expect(stamp(c, base * 1000000 + 7, Precision::Micros) == secs + ".000007", "microseconds zero-padded");
+        expect(stamp(c, base * 1000000 + 999999, Precision::Millis) == secs + ".999", "millisecond rounding down");
+        expect(c.conversions() == 1, "one conversion within a second");
+        expect(stamp(c, (base + 1) * 1000000, Precision::Millis) == reference(base + 1) + ".000", "next second");
+        expect(c.conversions() == 2, "converted again when the second changes");
+        for (std::int64_t i = 0; i < 86400 * 3; i += 3599)
+            expect(stamp(c, (base + i) * 1000000, Precision::Seconds) == reference(base + i), "across hours and days");
+    }
+
+    // Times before the epoch split into the previous second
+    {
+        arc::log::TimestampCache c;
+        expect(stamp(c, -1, Precision::Micros) == reference(-1) + ".999999", "pre-epoch fraction");
+    }
+
+    // Line assembly, with and without thread id, and truncation reporting
+    {
+        std::size_t full = 0;
+        expect(line(128, false, 0, "hello", &full) == "[2024-01-02 03:04:05] [INFO] hello\n" && full == 35,
+               "line without thread id");
+        expect(line(128, true, 4072, "hi", &full) == "[2024-01-02 03:04:05] [INFO] [T:4072] hi\n",
+               "line with thread id");
+        expect(line(128, true, 0, "", &full) == "[2024-01-02 03:04:05] [INFO] [T:0] \n", "thread id zero");
+        expect(line(128, true, 4294967295u, "x", &full).find("[T:4294967295]") != std::string::npos,
+               "largest thread id");
+        std::string longmsg(300, 'm');
+        std::string cut = line(64, false, 0, longmsg, &full);
+        expect(full == 29 + 300 + 1 && cut.size() == 64 && cut.compare(0, 29, "[2024-01-02 03:04:05] [INFO] ") == 0,
+               "too small a buffer: filled, full length returned");
+        expect(arc::log::format_line(nullptr, 0, "s", "L", false, 0, "m") == 10, "zero capacity only measures");
+    }
+
+    std::printf("[OK] log format tests passed\n");
+    return 0;
+}
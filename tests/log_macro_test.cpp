@@ -0,0 +1,117 @@
+/**
+ * @file log_macro_test.cpp
+ * @brief ARC_LOG_* macros: filtered levels evaluate nothing and allocate
+ *        nothing, levels above ARC_LOG_MIN_LEVEL are compiled out, and
+ *        enabled levels still reach the log file.
+ */
+
+// Compile this test as a release build that strips debug logging
+#undef ARC_LOG_MIN_LEVEL
+#define ARC_LOG_MIN_LEVEL 2
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <string>
+
+#include "arc/log.h"
+
+namespace {
+
+std::size_t g_allocs = 0;  ///< operator new calls so far (single-threaded test).
+
+}  // namespace
+
+void *operator new(std::size_t n) {
+    ++g_allocs;
+    if (void *p = std::malloc(n ? n : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+const char *kLogPath = "log_macro_test.log";
+
+/** Builds a heap-allocated message and counts how often it was asked for. */
+std::string message(int &built, const char *what) {
+    ++built;
+    return std::string(what) + " " + std::string(64, 'x');
+}
+
+std::string read_file(const char *path) {
+    std::ifstream in(path);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+/** @brief Entry point for log macro tests. */
+int main() {
+    using arc::log::LogLevel;
+    std::remove(kLogPath);
+
+    // Filtered at run time: the argument is never evaluated, nothing allocates
+    {
+        arc::log::set_level(LogLevel::Warn);
+        int built = 0;
+        std::size_t before = g_allocs;
+        ARC_LOG_INFO(message(built, "info"));
+        ARC_LOG_INFO("literal " + std::to_string(42));
+        { arc::log::LogScope scope("filtered scope", LogLevel::Info); }
+        expect(built == 0, "filtered message not built");
+        expect(g_allocs == before, "filtered levels allocate nothing");
+        expect(!arc::log::enabled(LogLevel::Info) && arc::log::enabled(LogLevel::Warn), "enabled follows set_level");
+    }
+
+    // Above ARC_LOG_MIN_LEVEL: compiled out even with debug enabled at run time
+    {
+        arc::log::set_level(LogLevel::Debug);
+        int built = 0;
+        std::size_t before = g_allocs;
+        ARC_LOG_DEBUG(message(built, "debug"));
+        ARC_LOG_SCOPE("stripped scope");
+        expect(built == 0 && g_allocs == before, "debug logging compiled out");
+    }
+
+    // Enabled levels are evaluated once and written
+    {
+        arc::log::set_file(kLogPath);
+        arc::log::set_level_by_name("info");
+        int built = 0;
+        ARC_LOG_INFO(message(built, "info-enabled"));
+        ARC_LOG_WARN(message(built, "warn-enabled"));
+        ARC_LOG_DEBUG(message(built, "debug-disabled"));
+        { arc::log::LogScope scope("traced", LogLevel::Info); }
+        arc::log::set_file("");
+        expect(built == 2, "enabled messages built once each");
+        std::string text = read_file(kLogPath);
+        expect(text.find("[INFO] info-enabled xxx") != std::string::npos, "info line written");
+        expect(text.find("[WARN] warn-enabled xxx") != std::string::npos, "warn line written");
+        expect(text.find("debug-disabled") == std::string::npos, "debug line not written");
+        expect(text.find("[INFO] traced begin") != std::string::npos &&
+                   text.find("[INFO] traced end") != std::string::npos,
+               "scope begin and end written");
+    }
+
+    std::remove(kLogPath);
+    std::printf("[OK] log macro tests passed\n");
+    return 0;
+}
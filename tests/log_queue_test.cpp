@@ -0,0 +1,235 @@
+/**
+ * @file log_queue_test.cpp
+ * @brief arc::log::Queue: slot lines, spill and drop on overflow, consumer
+ *        wake-up under concurrent producers, pushes racing stop, and
+ *        urgent lines.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arc/log_queue.h"
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+bool push(arc::log::Queue &q, const std::string &s) {
+    return q.push(s.data(), s.size()) == arc::log::Pushed::Queued;
+}
+
+/** Pops one ring line into a fresh string ("" if none). */
+std::string pop(arc::log::Queue &q) {
+    std::string s;
+    q.pop(s);
+    return s;
+}
+
+/** Counts newline-terminated lines in @p s. */
+std::size_t lines_in(const std::string &s) {
+    std::size_t n = 0;
+    for (char c : s)
+        n += c == '\n';
+    return n;
+}
+
+/** Empties the ring and the side buffer; returns the lines taken. */
+std::size_t drain(arc::log::Queue &q) {
+    std::size_t n = 0;
+    std::string l, spill;
+    while (q.pop(l))
+        ++n;
+    if (q.take_spill(spill))
+        n += lines_in(spill);
+    return n;
+}
+
+}  // namespace
+
+/** @brief Entry point for log queue tests. */
+int main() {
+    using arc::log::Queue;
+
+    // Short lines go through the ring in order; long ones spill
+    {
+        static Queue q;
+        std::string spill;
+        expect(!q.pop(spill) && !q.take_spill(spill), "new queue is empty");
+        expect(push(q, "first\n") && push(q, "second\n"), "short lines queued");
+        std::string long_line(arc::log::kLineBytes + 1, 'x');
+        expect(push(q, long_line), "long line queued");
+        expect(pop(q) == "first\n", "ring line 1");
+        expect(pop(q) == "second\n", "ring line 2");
+        expect(pop(q).empty(), "long line not in the ring");
+        expect(q.take_spill(spill) && spill == long_line, "long line spilled");
+        expect(q.spilled() == 1 && q.dropped() == 0, "spill counted");
+        spill.clear();
+        expect(!q.take_spill(spill) && spill.empty(), "spill emptied");
+        std::string exact(arc::log::kLineBytes, 'y');
+        expect(push(q, exact) && pop(q) == exact, "a line filling a slot exactly stays in the ring");
+    }
+
+    // A full ring spills; a full side buffer drops
+    {
+        static Queue q;
+        for (std::size_t i = 0; i < arc::log::kQueueSlots + 10; ++i)
+            push(q, "line " + std::to_string(i) + "\n");
+        expect(q.spilled() == 10, "lines beyond the ring spill");
+        expect(pop(q) == "line 0\n", "ring keeps the oldest lines");
+        std::string big(arc::log::kLineBytes * 4, 'z');
+        std::size_t accepted = 0;
+        while (push(q, big))
+            ++accepted;
+        expect(q.dropped() == 1 && accepted > 0, "side buffer full: line dropped");
+        std::string spill;
+        expect(q.take_spill(spill) && spill.size() <= arc::log::kSpillBytes && spill.compare(0, 9, "line 1024") == 0,
+               "spill keeps its first lines and stays bounded");
+        expect(push(q, big) && q.dropped() == 1, "room again after the consumer took the spill");
+    }
+
+    // Concurrent producers with a sleeping consumer: every line accounted for
+    {
+        static Queue q;
+        constexpr int kProducers = 4;
+        constexpr int kLines = 50000;
+        std::size_t received = 0;
+        std::uint64_t wakes = 0;
+        std::thread consumer([&]() {
+            std::string l, spill;
+            for (;;) {
+                bool stopping = q.stopping();  // before draining: lines queued before stop() are seen
+                bool any = false;
+                while (q.pop(l)) {
+                    expect(l.size() > 5 && l.back() == '\n' && l.find('\n') == l.size() - 1, "ring line intact");
+                    l.clear();
+                    ++received;
+                    any = true;
+                }
+                spill.clear();
+                if (q.take_spill(spill)) {
+                    received += lines_in(spill);
+                    any = true;
+                }
+                if (any)
+                    continue;
+                if (stopping)
+                    break;
+                q.wait();
+                ++wakes;
+            }
+        });
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; ++p) {
+            producers.emplace_back([p]() {
+                char buf[64];
+                for (int i = 0; i < kLines; ++i) {
+                    int n = std::snprintf(buf, sizeof buf, "[P%d] line %d\n", p, i);
+                    q.push(buf, static_cast<std::size_t>(n));
+                    if (i % 1000 == 0)
+                        std::this_thread::yield();  // let the consumer fall asleep now and then
+                }
+            });
+        }
+        for (auto &t : producers)
+            t.join();
+        q.stop();
+        consumer.join();
+        expect(received + q.dropped() == static_cast<std::size_t>(kProducers) * kLines,
+               "every line delivered or counted as dropped");
+        std::printf("[INFO] %zu lines received, %llu spilled, %llu dropped, %llu wake-ups\n", received,
+                    static_cast<unsigned long long>(q.spilled()), static_cast<unsigned long long>(q.dropped()),
+                    static_cast<unsigned long long>(wakes));
+    }
+
+    // Stop wakes a consumer waiting on an empty queue
+    {
+        static Queue q;
+        std::thread consumer([]() { q.wait(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        q.stop();
+        consumer.join();
+        expect(q.stopping(), "stop wakes the consumer");
+        q.restart();
+        expect(!q.stopping(), "restart clears stop");
+    }
+
+    // Pushes racing stop(): once stop() returns, every line is either in the
+    // queue for the final drain or refused, never queued after that drain
+    {
+        static Queue q;
+        using arc::log::Pushed;
+        for (int round = 0; round < 200; ++round) {
+            q.restart();
+            drain(q);
+            std::atomic<bool> go{false};
+            std::size_t queued[2] = {};
+            bool closed[2] = {};
+            std::vector<std::thread> producers;
+            for (int p = 0; p < 2; ++p) {
+                producers.emplace_back([&, p]() {
+                    while (!go.load())
+                        std::this_thread::yield();
+                    for (;;) {
+                        Pushed r = q.push("racing line\n", 12);
+                        if (r == Pushed::Closed)
+                            break;
+                        queued[p] += r == Pushed::Queued;
+                        if (queued[p] % 64 == 0)
+                            std::this_thread::yield();
+                    }
+                    closed[p] = true;
+                });
+            }
+            go = true;
+            std::this_thread::sleep_for(std::chrono::microseconds(50 * (round % 8)));
+            q.stop();
+            std::size_t drained = drain(q);  // the final drain: nothing may arrive after it
+            expect(q.push("late\n", 5) == Pushed::Closed, "a stopped queue refuses lines");
+            for (auto &t : producers)
+                t.join();
+            expect(closed[0] && closed[1], "producers see the stop");
+            expect(drained == queued[0] + queued[1] && drain(q) == 0, "no line queued after stop returned");
+        }
+    }
+
+    // Urgent lines raise a one-shot flag; wait_for times out on an idle queue
+    {
+        static Queue q;
+        expect(!q.take_urgent(), "no urgent line yet");
+        push(q, "info\n");
+        expect(!q.take_urgent(), "ordinary lines are not urgent");
+        const char err[] = "error\n";
+        q.push(err, sizeof err - 1, true);
+        expect(q.take_urgent() && !q.take_urgent(), "urgent flag taken once");
+        expect(pop(q) == "info\n" && pop(q) == "error\n", "urgent line queued in order");
+        auto t0 = std::chrono::steady_clock::now();
+        q.wait_for(30);
+        auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0);
+        expect(waited.count() >= 25, "wait_for sleeps on an empty queue");
+        push(q, "late\n");
+        t0 = std::chrono::steady_clock::now();
+        q.wait_for(5000);
+        waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0);
+        expect(waited.count() < 1000, "wait_for returns at once with a line queued");
+    }
+
+    std::printf("[OK] log queue tests passed\n");
+    return 0;
+}
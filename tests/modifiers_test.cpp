@@ -0,0 +1,151 @@
+/**
+ * @file modifiers_test.cpp
+ * @brief Drives arc::modifiers::Tracker with synthetic key sequences.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "arc/gesture.h"
+#include "arc/modifiers.h"
+
+using arc::modifiers::Tracker;
+
+namespace {
+
+// Virtual-key codes (plain integers; no windows.h on the test host)
+constexpr unsigned int kVkShift = 0x10, kVkControl = 0x11, kVkMenu = 0x12;
+constexpr unsigned int kVkLShift = 0xA0, kVkLControl = 0xA2, kVkRControl = 0xA3;
+constexpr unsigned int kVkLMenu = 0xA4, kVkRMenu = 0xA5, kVkLWin = 0x5B;
+
+constexpr std::uint32_t kAlt = arc::gesture::kModAlt;
+constexpr std::uint32_t kCtrl = arc::gesture::kModCtrl;
+constexpr std::uint32_t kShift = arc::gesture::kModShift;
+constexpr std::uint32_t kWin = arc::gesture::kModWin;
+
+/// Fake physical key state consulted by resync().
+bool g_physical[256] = {};
+
+bool fake_is_down(unsigned int vk) { return vk < 256 && g_physical[vk]; }
+
+}  // namespace
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+/** @brief Entry point for modifier tracker tests. */
+int main() {
+    // Basic press/release and non-modifier keys
+    {
+        Tracker t;
+        expect(t.held() == 0, "nothing held initially");
+        expect(t.on_key(kVkLMenu, true), "LMENU is a modifier");
+        expect(t.held() == kAlt, "alt held");
+        expect(!t.on_key(0x41, true), "'A' is not a modifier");
+        expect(t.held() == kAlt, "non-modifier leaves mask unchanged");
+        t.on_key(kVkLMenu, false);
+        expect(t.held() == 0, "alt released");
+    }
+
+    // Auto-repeat downs are idempotent
+    {
+        Tracker t;
+        for (int i = 0; i < 10; ++i)
+            t.on_key(kVkLControl, true);
+        t.on_key(kVkLControl, false);
+        expect(t.held() == 0, "single up clears after repeated downs");
+    }
+
+    // Left/right keys tracked independently
+    {
+        Tracker t;
+        t.on_key(kVkLMenu, true);
+        t.on_key(kVkRMenu, true);
+        t.on_key(kVkLMenu, false);
+        expect(t.held() == kAlt, "alt still held via right key");
+        t.on_key(kVkRMenu, false);
+        expect(t.held() == 0, "alt released after both sides");
+    }
+
+    // Chords combine and match a required mask with one compare
+    {
+        Tracker t;
+        t.on_key(kVkLMenu, true);
+        t.on_key(kVkRControl, true);
+        t.on_key(kVkLShift, true);
+        t.on_key(kVkLWin, true);
+        expect(t.held() == (kAlt | kCtrl | kShift | kWin), "all four modifiers held");
+        std::uint32_t required = kAlt | kCtrl;
+        expect((t.held() & required) == required, "combo satisfied");
+        t.on_key(kVkRControl, false);
+        expect((t.held() & required) != required, "combo broken by ctrl release");
+    }
+
+    // Generic codes map to the left key
+    {
+        Tracker t;
+        t.on_key(kVkMenu, true);
+        t.on_key(kVkControl, true);
+        t.on_key(kVkShift, true);
+        expect(t.held() == (kAlt | kCtrl | kShift), "generic codes tracked");
+        t.on_key(kVkLMenu, false);
+        expect(t.held() == (kCtrl | kShift), "generic alt released via LMENU");
+    }
+
+    // Stuck key: the up was missed (e.g. Win+L, UAC prompt); resync on
+    // focus/desktop change restores the real state
+    {
+        Tracker t;
+        g_physical[kVkLMenu] = true;
+        t.on_key(kVkLMenu, true);
+        g_physical[kVkLMenu] = false;  // released while we could not observe it
+        expect(t.held() == kAlt, "alt appears stuck before resync");
+        t.resync(fake_is_down);
+        expect(t.held() == 0, "resync clears stuck alt");
+
+        // Keys pressed while unobserved are picked up too
+        g_physical[kVkRControl] = true;
+        t.resync(fake_is_down);
+        expect(t.held() == kCtrl, "resync picks up held ctrl");
+        g_physical[kVkRControl] = false;
+        t.on_key(kVkRControl, false);
+        expect(t.held() == 0, "normal tracking continues after resync");
+    }
+
+    // Session change: reset drops everything
+    {
+        Tracker t;
+        t.on_key(kVkLMenu, true);
+        t.on_key(kVkLShift, true);
+        t.reset();
+        expect(t.held() == 0 && t.keys() == 0, "reset clears all");
+    }
+
+    // End to end: tracker output drives the gesture engine
+    {
+        Tracker t;
+        arc::gesture::Engine e;
+        arc::gesture::Event ev;
+        ev.type = arc::gesture::EventType::Down;
+        ev.button = arc::gesture::Button::Left;
+        ev.mods = t.held();
+        expect(e.on_event(ev).verdict == arc::gesture::Verdict::Pass, "no alt: click passes");
+        t.on_key(kVkLMenu, true);
+        ev.mods = t.held();
+        expect(e.on_event(ev).verdict == arc::gesture::Verdict::Swallow, "alt held: click tracked");
+    }
+
+    std::printf("[OK] modifier tracker tests passed\n");
+    return 0;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file motion_test.cpp
+ * @brief Drag path replay: the buffered motion starts at the press origin,
+ *        ends at the drag exit point and stays close to the real pointer path
+ *        when a long jiggle overflows the buffer.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "arc/gesture.h"
+
+#include "gesture_events.h"
+
+using arc::gesture::Button;
+using arc::gesture::Decision;
+using arc::gesture::Engine;
+using arc::gesture::Event;
+using arc::gesture::EventType;
+using arc::gesture::Point;
+using arc::test::ev;
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+/** Distance from @p p to the segment a-b. */
+double segment_distance(const Point &p, const Point &a, const Point &b) {
+    double vx = b.x - a.x, vy = b.y - a.y;
+    double wx = p.x - a.x, wy = p.y - a.y;
+    double len = vx * vx + vy * vy;
+    double t = len > 0 ? (wx * vx + wy * vy) / len : 0.0;
+    t = t < 0 ? 0 : (t > 1 ? 1 : t);
+    double dx = wx - t * vx, dy = wy - t * vy;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+/** Largest distance from any real position to the replayed polyline. */
+double max_deviation(const std::vector<Point> &real, const Point *path, int n) {
+    double worst = 0;
+    for (const Point &p : real) {
+        double best = 1e9;
+        for (int i = 0; i + 1 < n; ++i)
+            best = std::fmin(best, segment_distance(p, path[i], path[i + 1]));
+        worst = std::fmax(worst, best);
+    }
+    return worst;
+}
+
+/**
+ * Presses Alt+Left at a random spot, jiggles @p moves times inside the radius,
+ * then leaves it. Returns the drag decision; @p real receives every pointer
+ * position from the press to the exit.
+ */
+Decision press_and_drag(Engine &e, std::mt19937 &rng, int moves, std::vector<Point> &real) {
+    const std::int32_t r = e.settings().move_radius_px;
+    std::int32_t ox = 200 + static_cast<std::int32_t>(rng() % 1000), oy = 200 + static_cast<std::int32_t>(rng() % 600);
+    std::uint32_t t = rng();
+    real.assign(1, Point{ox, oy});
+    e.on_event(ev(EventType::Down, Button::Left, ox, oy, t, arc::gesture::kModAlt));
+    for (int i = 0; i < moves; ++i) {
+        Point p{ox + static_cast<std::int32_t>(rng() % (2 * r + 1)) - r, oy};
+        p.y += static_cast<std::int32_t>(rng() % 3) - 1;
+        while ((p.x - ox) * (p.x - ox) + (p.y - oy) * (p.y - oy) > r * r)
+            p.x += p.x > ox ? -1 : 1;
+        real.push_back(p);
+        Decision d = e.on_event(ev(EventType::Move, Button::None, p.x, p.y, t, 0));
+        expect(d.verdict == arc::gesture::Verdict::Pass && d.count == 0 && d.path_count == 0, "jiggle inside the radius passes");
+    }
+    Point exit{ox + r + 1 + static_cast<std::int32_t>(rng() % 20), oy};
+    real.push_back(exit);
+    return e.on_event(ev(EventType::Move, Button::None, exit.x, exit.y, t + 1, 0));
+}
+
+}  // namespace
+
+/** @brief Entry point for motion buffer tests. */
+int main() {
+    std::mt19937 rng(11);
+    Engine e;
+    const int cap = Engine::kMotionCapacity;
+
+    // Up to capacity the replay is exact: every position, in order
+    {
+        for (int moves = 0; moves <= cap - 1; ++moves) {
+            std::vector<Point> real;
+            Decision d = press_and_drag(e, rng, moves, real);
+            expect(d.verdict == arc::gesture::Verdict::Swallow, "drag move swallowed for replay");
+            expect(d.count == 1 && d.inject[0].button == Button::Left && d.inject[0].down, "source down on drag");
+            expect(d.path_count == real.size(), "every position replayed below capacity");
+            for (std::size_t i = 0; i < real.size(); ++i)
+                expect(d.path[i].x == real[i].x && d.path[i].y == real[i].y, "replayed position matches");
+            e.on_event(ev(EventType::Up, Button::Left, real.back().x, real.back().y, 0, 0));
+        }
+    }
+
+    // Past capacity: bounded, anchored at both ends, evenly thinned
+    {
+        double worst = 0, retained = 0;
+        int runs = 0;
+        for (int moves : {cap, cap + 1, 2 * cap, 5 * cap, 40 * cap, 1000 * cap}) {
+            for (int rep = 0; rep < 20; ++rep) {
+                std::vector<Point> real;
+                Decision d = press_and_drag(e, rng, moves, real);
+                expect(d.path_count >= 2 && d.path_count <= cap + 1, "path stays within the buffer");
+                expect(d.path[0].x == real.front().x && d.path[0].y == real.front().y, "path starts at the press");
+                expect(d.path[d.path_count - 1].x == real.back().x && d.path[d.path_count - 1].y == real.back().y,
+                       "path ends at the exit point");
+                expect(d.path_count > cap / 2, "thinning keeps at least half the buffer");
+                double dev = max_deviation(real, d.path, d.path_count);
+                expect(dev <= 2.0 * e.settings().move_radius_px + 1, "path stays within the press area");
+                worst = std::fmax(worst, dev);
+                retained += static_cast<double>(d.path_count) / static_cast<double>(real.size());
+                ++runs;
+                e.on_event(ev(EventType::Up, Button::Left, real.back().x, real.back().y, 0, 0));
+            }
+        }
+        std::printf("fidelity: %d overflowing drags, worst deviation %.2f px, mean retained %.1f%%\n", runs, worst,
+                    100.0 * retained / runs);
+    }
+
+    // A straight slow drag-out stays on its line after thinning
+    {
+        Engine s;
+        s.on_event(ev(EventType::Down, Button::Left, 100, 100, 0, arc::gesture::kModAlt));
+        std::int32_t r = s.settings().move_radius_px;
+        std::vector<Point> real(1, Point{100, 100});
+        for (int i = 0; i < 5 * cap; ++i) {
+            Point p{100 + (i * r) / (5 * cap), 100};
+            real.push_back(p);
+            s.on_event(ev(EventType::Move, Button::None, p.x, p.y, 0, 0));
+        }
+        real.push_back(Point{100 + r + 1, 100});
+        Decision d = s.on_event(ev(EventType::Move, Button::None, 100 + r + 1, 100, 1, 0));
+        expect(max_deviation(real, d.path, d.path_count) == 0.0, "straight path replayed exactly");
+        for (int i = 1; i < d.path_count; ++i)
+            expect(d.path[i].x >= d.path[i - 1].x, "replay keeps the original order");
+    }
+
+    // Released or reset presses carry no path
+    {
+        Engine s;
+        s.on_event(ev(EventType::Down, Button::Left, 10, 10, 0, arc::gesture::kModAlt));
+        s.on_event(ev(EventType::Move, Button::None, 12, 10, 1, 0));
+        s.reset();
+        Decision d = s.on_event(ev(EventType::Move, Button::None, 100, 10, 2, 0));
+        expect(d.path_count == 0 && d.count == 0 && d.verdict == arc::gesture::Verdict::Pass, "reset drops the path");
+        s.on_event(ev(EventType::Down, Button::Left, 10, 10, 3, arc::gesture::kModAlt));
+        d = s.on_event(ev(EventType::Up, Button::Left, 10, 10, 4, 0));
+        expect(d.path_count == 0 && d.count == 2, "click carries no path");
+    }
+
+    std::printf("[OK] motion tests passed\n");
+    return 0;
+}
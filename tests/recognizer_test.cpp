@@ -0,0 +1,515 @@
+/**
+ * @file recognizer_test.cpp
+ * @brief Double-click, long-press, chord and dwell recognizers driven by a
+ *        timer wheel on a virtual clock, as the hook worker drives them,
+ *        plus deterministic replay of recorded recognizer sessions.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "arc/gesture.h"
+#include "arc/timer_wheel.h"
+#include "arc/trace.h"
+
+using arc::gesture::Action;
+using arc::gesture::Button;
+using arc::gesture::Decision;
+using arc::gesture::Engine;
+using arc::gesture::Event;
+using arc::gesture::EventType;
+using arc::gesture::Settings;
+using arc::gesture::Verdict;
+using arc::trace::Kind;
+using arc::trace::Record;
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+const char *kTracePath = "recognizer_test.arctrace";
+
+/**
+ * The hook around an engine on a virtual clock: one wheel timer follows
+ * Engine::deadline (as sync_deadline/on_deadline do), every decision is
+ * recorded as trace records, and the application's view of the buttons
+ * (passed physical events plus injections) is kept.
+ */
+struct Session {
+    Engine engine;
+    arc::timer::Wheel wheel{8, 1000};
+    arc::timer::TimerId timer = 0;
+    std::uint32_t timer_at = 0;
+    std::uint32_t t = 1000;
+    std::vector<Record> log;
+    std::vector<Decision> fired;  ///< Decisions of the timer, in order.
+    bool held[6] = {};            ///< Physical buttons.
+    bool app_down[6] = {};        ///< Application view.
+    std::int32_t x = 500, y = 500;
+    std::uint32_t mods = 0;       ///< Held modifiers, carried by moves.
+    int clicks[6] = {};           ///< Completed injected clicks per button.
+    int scheduled = 0;            ///< Deadlines put on the wheel.
+
+    explicit Session(const Settings &s) : engine(s) {
+        Record r;
+        r.kind = Kind::Settings;
+        r.event.time_ms = t;
+        r.settings = s;
+        log.push_back(r);
+    }
+
+    void apply(const Decision &d) {
+        for (int i = 0; i < d.count; ++i) {
+            int b = static_cast<int>(d.inject[i].button);
+            if (!d.inject[i].down && app_down[b])
+                ++clicks[b];
+            app_down[b] = d.inject[i].down;
+        }
+    }
+
+    static void on_deadline(void *ctx, std::uint64_t) {
+        Session &s = *static_cast<Session *>(ctx);
+        s.timer = 0;
+        std::uint32_t at;
+        if (!s.engine.deadline(at))
+            return;
+        Record r;
+        r.kind = Kind::Timer;
+        r.event.time_ms = at;
+        r.decision = s.engine.on_timer(at);
+        s.log.push_back(r);
+        s.fired.push_back(r.decision);
+        s.apply(r.decision);
+        s.sync();
+    }
+
+    void sync() {
+        std::uint32_t at = 0;
+        bool want = engine.deadline(at);
+        if (want == (timer != 0) && (!want || at == timer_at))
+            return;
+        if (timer) {
+            expect(wheel.cancel(timer), "pending deadline cancelled");
+            timer = 0;
+        }
+        if (want) {
+            timer = wheel.schedule(at, on_deadline, this);
+            timer_at = at;
+            ++scheduled;
+            expect(timer != 0, "deadline scheduled");
+        }
+    }
+
+    /** Lets the clock run @p ms; due deadlines fire. */
+    void wait(std::uint32_t ms) {
+        t += ms;
+        wheel.advance(t);
+    }
+
+    Decision feed(EventType type, Button b, std::uint32_t mods = 0) {
+        wheel.advance(t);
+        Record r;
+        r.event.type = type;
+        r.event.button = b;
+        r.event.x = x;
+        r.event.y = y;
+        r.event.time_ms = t;
+        r.event.mods = mods;
+        r.decision = engine.on_event(r.event);
+        log.push_back(r);
+        if (r.decision.verdict == Verdict::Pass && (type == EventType::Down || type == EventType::Up)) {
+            int i = static_cast<int>(b);
+            if (type == EventType::Up && app_down[i])
+                ++clicks[i];
+            app_down[i] = type == EventType::Down;
+        }
+        apply(r.decision);
+        sync();
+        return r.decision;
+    }
+
+    Decision down(Button b, std::uint32_t mods = arc::gesture::kModAlt) {
+        held[static_cast<int>(b)] = true;
+        return feed(EventType::Down, b, mods);
+    }
+
+    Decision up(Button b) {
+        held[static_cast<int>(b)] = false;
+        return feed(EventType::Up, b);
+    }
+
+    Decision move(std::int32_t nx, std::int32_t ny) {
+        x = nx;
+        y = ny;
+        return feed(EventType::Move, Button::None, mods);
+    }
+
+    /** Modifiers go down or up (the keyboard hook's Other event). */
+    Decision modifiers(std::uint32_t m) {
+        mods = m;
+        return feed(EventType::Other, Button::None, m);
+    }
+
+    /** Releases everything physically held and lets every deadline pass. */
+    void settle() {
+        for (int b = 1; b < 6; ++b)
+            if (held[b])
+                up(static_cast<Button>(b));
+        wait(20000);
+    }
+
+    bool clean() const {
+        for (bool b : app_down)
+            if (b)
+                return false;
+        return engine.idle() && timer == 0 && wheel.size() == 0;
+    }
+};
+
+/** True if @p d injects exactly one click of @p b. */
+bool clicks_once(const Decision &d, Button b) {
+    return d.count == 2 && d.inject[0].button == b && d.inject[0].down && d.inject[1].button == b &&
+           !d.inject[1].down;
+}
+
+Settings double_clicks() {
+    Settings s;
+    s.double_click_ms = 300;
+    s.double_action = Action{Button::Middle, false};
+    return s;
+}
+
+Settings long_presses() {
+    Settings s;
+    s.long_press_ms = 600;
+    s.long_press_action = Action{Button::X1, false};
+    return s;
+}
+
+Settings chords() {
+    Settings s;
+    s.chord_ms = 80;
+    s.chord_button = Button::Right;
+    s.chord_action = Action{Button::Middle, false};
+    return s;
+}
+
+Settings dwells() {
+    Settings s;
+    s.dwell_ms = 500;
+    s.dwell_action = Action{Button::Right, false};
+    return s;
+}
+
+void count_diff(const arc::trace::Diff &, void *ctx) { ++*static_cast<int *>(ctx); }
+
+void shorter_window(Settings &s, void *) { s.double_click_ms = 120; }
+
+/** Random session exercising all recognizers at once. */
+Session random_session(unsigned seed) {
+    Settings s;
+    s.double_click_ms = 250;
+    s.long_press_ms = 500;
+    s.long_press_action = Action{Button::X2, false};
+    s.chord_ms = 60;
+    Session ses(s);
+    std::mt19937 rng(seed);
+    for (int i = 0; i < 3000; ++i) {
+        switch (rng() % 8) {
+        case 0:
+        case 1:
+            if (!ses.held[1])
+                ses.down(Button::Left, rng() % 4 ? static_cast<std::uint32_t>(arc::gesture::kModAlt) : 0u);
+            break;
+        case 2:
+        case 3:
+            if (ses.held[1])
+                ses.up(Button::Left);
+            break;
+        case 4:
+            if (ses.held[2])
+                ses.up(Button::Right);
+            else
+                ses.down(Button::Right, 0);
+            break;
+        case 5:
+            ses.move(ses.x + static_cast<std::int32_t>(rng() % 5) - 2,
+                     ses.y + static_cast<std::int32_t>(rng() % 5) - 2);
+            break;
+        case 6:
+            ses.move(ses.x + static_cast<std::int32_t>(rng() % 3) * 6, ses.y);
+            break;
+        default:
+            ses.wait(rng() % 400);
+            continue;
+        }
+        ses.t += rng() % 120;
+    }
+    ses.settle();
+    return ses;
+}
+
+}  // namespace
+
+/** @brief Entry point for recognizer tests. */
+int main() {
+    // Double click: the first click is held back, the second one becomes the action
+    {
+        Session s(double_clicks());
+        Decision d = s.down(Button::Left);
+        expect(d.verdict == Verdict::Swallow && d.count == 0, "first press swallowed");
+        s.t += 60;
+        d = s.up(Button::Left);
+        expect(d.verdict == Verdict::Swallow && d.count == 0, "first click held back");
+        expect(!s.engine.idle() && s.wheel.size() == 1, "window deadline on the wheel");
+        s.t += 100;
+        d = s.down(Button::Left);
+        expect(d.verdict == Verdict::Swallow && d.count == 0, "second press swallowed");
+        s.t += 60;
+        d = s.up(Button::Left);
+        expect(clicks_once(d, Button::Middle), "double click injects the double action once");
+        s.wait(1000);
+        expect(s.fired.empty(), "no timer after a completed double click");
+        expect(s.clicks[static_cast<int>(Button::Right)] == 0, "held-back click replaced");
+        expect(s.clean(), "double click leaves nothing pending");
+    }
+
+    // Single click: delivered by the wheel once the window closes
+    {
+        Session s(double_clicks());
+        s.down(Button::Left);
+        s.t += 50;
+        s.up(Button::Left);
+        std::uint32_t released = s.t;
+        s.wait(300);
+        expect(s.fired.empty(), "window still open at its last ms");
+        s.wait(1);
+        expect(s.fired.size() == 1 && clicks_once(s.fired[0], Button::Right), "window closing delivers the click");
+        expect(s.log.back().kind == Kind::Timer && s.log.back().event.time_ms == released + 301,
+               "timer resolved at the engine's deadline");
+        expect(s.clean(), "single click leaves nothing pending");
+    }
+
+    // Second press too far away, or of another bound button: the held click comes first
+    {
+        Session s(double_clicks());
+        s.down(Button::Left);
+        s.t += 50;
+        s.up(Button::Left);
+        s.t += 50;
+        Decision d = s.move(s.x + 20, s.y);
+        expect(clicks_once(d, Button::Right) && d.verdict == Verdict::Swallow, "leaving the radius delivers the click");
+        expect(d.path_count == 2 && d.path[0].x == 500 && d.path[1].x == 520, "move replayed from the click position");
+        expect(s.clean(), "flushed by a move");
+
+        s.down(Button::Left);
+        s.t += 50;
+        s.up(Button::Left);
+        s.t += 50;
+        d = s.down(Button::Right, 0);
+        expect(d.verdict == Verdict::Swallow && d.count == 3 && d.inject[2].button == Button::Right &&
+                   d.inject[2].down,
+               "unbound press replayed after the held click");
+        s.up(Button::Right);
+        s.settle();
+        expect(s.clicks[static_cast<int>(Button::Right)] == 3 && s.clean(), "every right click delivered");
+    }
+
+    // Reset hands back the held-back click
+    {
+        Session s(double_clicks());
+        s.down(Button::Left);
+        s.t += 50;
+        s.up(Button::Left);
+        Decision d = s.engine.reset();
+        expect(clicks_once(d, Button::Right), "reset delivers the held click");
+        expect(s.engine.idle(), "reset clears the window");
+    }
+
+    // Long press: the action fires on the wheel and the release is swallowed
+    {
+        Session s(long_presses());
+        s.down(Button::Left);
+        s.wait(599);
+        expect(s.fired.empty(), "no long press before its time");
+        s.wait(1);
+        expect(s.fired.size() == 1 && clicks_once(s.fired[0], Button::X1), "long press injects its action");
+        s.t += 300;
+        Decision d = s.up(Button::Left);
+        expect(d.verdict == Verdict::Swallow && d.count == 0, "long-press release swallowed");
+        s.down(Button::Left, 0);
+        d = s.up(Button::Left);
+        expect(d.verdict == Verdict::Pass, "next plain release passes");
+        expect(s.clean(), "long press leaves nothing pressed");
+
+        // Released between the click time and the long-press time: native click
+        s.down(Button::Left);
+        s.wait(400);
+        expect(s.fired.size() == 1, "no native press at the click time with long presses on");
+        d = s.up(Button::Left);
+        expect(d.count == 2 && d.inject[0].button == Button::Left && d.inject[0].down,
+               "slow release replays the source click");
+        expect(s.clean(), "slow release leaves nothing pressed");
+    }
+
+    // Chord: right within the window after a bound press
+    {
+        Session s(chords());
+        s.down(Button::Left);
+        s.t += 40;
+        Decision d = s.down(Button::Right, arc::gesture::kModAlt);
+        expect(d.verdict == Verdict::Swallow && clicks_once(d, Button::Middle), "chord injects its action");
+        s.t += 30;
+        expect(s.up(Button::Left).verdict == Verdict::Swallow, "trigger release swallowed");
+        s.t += 30;
+        expect(s.up(Button::Right).verdict == Verdict::Swallow, "partner release swallowed");
+        s.settle();
+        expect(s.clicks[static_cast<int>(Button::Right)] == 0 && s.clean(), "chord leaves nothing pressed");
+
+        // Outside the window the partner is an ordinary press
+        s.down(Button::Left);
+        s.t += 100;
+        d = s.down(Button::Right, arc::gesture::kModAlt);
+        expect(d.verdict == Verdict::Pass && d.count == 0, "late partner passes");
+        s.settle();
+        expect(s.clean(), "late partner leaves nothing pressed");
+    }
+
+    // Dwell: holding the modifier with the pointer still injects the action once
+    {
+        Session s(dwells());
+        Decision d = s.modifiers(arc::gesture::kModAlt);
+        expect(d.verdict == Verdict::Pass && d.count == 0, "modifier event passes");
+        expect(s.engine.dwelling() && s.wheel.size() == 1, "dwell deadline armed without a move");
+        s.wait(499);
+        expect(s.fired.empty(), "no dwell before its time");
+        s.wait(1);
+        expect(s.fired.size() == 1 && clicks_once(s.fired[0], Button::Right), "dwell injects its action");
+        s.wait(5000);
+        expect(s.fired.size() == 1 && s.clean(), "a resting pointer fires once");
+
+        // Jitter inside the radius keeps the anchor
+        s.move(s.x + 10, s.y);
+        std::uint32_t anchored = s.t;
+        for (int i = 0; i < 10; ++i) {
+            s.t += 40;
+            s.move(s.x + (i % 2 ? 3 : -3), s.y + 2);
+        }
+        s.wait(anchored + 500 - s.t);
+        expect(s.fired.size() == 2 && s.log.back().event.time_ms == anchored + 500, "jitter does not delay the dwell");
+
+        // Released modifier: nothing fires
+        s.move(s.x + 20, s.y);
+        s.t += 100;
+        s.modifiers(0);
+        expect(!s.engine.dwelling() && s.clean(), "releasing the modifier stops dwelling");
+        s.wait(2000);
+        expect(s.fired.size() == 2, "no dwell without the modifier");
+    }
+
+    // Continuous motion: one deadline per dwell time, not one per move
+    {
+        Session s(dwells());
+        s.modifiers(arc::gesture::kModAlt);
+        std::uint32_t last = s.t;
+        for (int i = 0; i < 400; ++i) {
+            s.t += 5;
+            s.move(s.x + 7, s.y);  // leaves the radius every move
+            last = s.t;
+        }
+        expect(s.fired.size() <= 5 && s.scheduled <= 6, "lazy re-arming while the pointer keeps moving");
+        s.wait(last + 500 - s.t);
+        std::size_t decisions = s.fired.size();
+        expect(clicks_once(s.fired.back(), Button::Right), "dwell fires once the pointer stops");
+        expect(s.log.back().event.time_ms == last + 500, "dwell timed from the last re-anchor");
+        std::size_t clicks = 0;
+        for (const Decision &d : s.fired)
+            clicks += d.count;
+        expect(clicks == 2 && decisions >= 2, "only the final rest fires");
+        std::printf("dwell: 400 moves, %d deadlines scheduled\n", s.scheduled);
+
+        // The recording replays exactly
+        int diffs = 0;
+        arc::trace::Replayer replay(count_diff, &diffs);
+        for (const Record &rec : s.log)
+            replay.feed(rec);
+        expect(diffs == 0, "dwell session replays without diffs");
+    }
+
+    // A press re-anchors without firing; no dwell without a required modifier
+    {
+        Session s(dwells());
+        s.modifiers(arc::gesture::kModAlt);
+        s.t += 100;
+        s.down(Button::Left);
+        s.t += 50;
+        Decision d = s.up(Button::Left);
+        expect(clicks_once(d, Button::Right), "bound click still translated");
+        s.wait(3000);
+        expect(s.fired.empty(), "a click does not dwell at its own spot");
+        s.move(s.x + 30, s.y);
+        s.wait(500);
+        expect(s.fired.size() == 1, "dwell resumes after the pointer moves on");
+
+        Settings none = dwells();
+        none.required_mods = 0;
+        Session n(none);
+        n.modifiers(0);
+        n.move(n.x + 30, n.y);
+        n.wait(3000);
+        expect(n.fired.empty() && !n.engine.dwelling(), "dwell needs a required modifier");
+    }
+
+    // Random sessions: nothing stays pressed, and the recording replays exactly
+    {
+        for (unsigned seed = 1; seed <= 20; ++seed) {
+            Session s = random_session(seed);
+            expect(s.clean(), "no button left pressed after a random session");
+        }
+
+        Session s = random_session(17);
+        arc::trace::Writer w;
+        expect(w.open(kTracePath), "trace file created");
+        for (const Record &rec : s.log)
+            w.append(rec);
+        w.close();
+
+        int diffs = 0;
+        arc::trace::Reader r;
+        expect(r.open(kTracePath), "session trace opens");
+        arc::trace::Replayer same(count_diff, &diffs);
+        Record rec;
+        while (r.next(rec))
+            same.feed(rec);
+        expect(same.records() == s.log.size(), "whole session replayed");
+        expect(same.timers() == s.fired.size() && !s.fired.empty(), "session contains timer resolutions");
+        expect(diffs == 0 && same.diffs() == 0, "replay reproduces every recognizer decision");
+
+        int changed = 0;
+        expect(r.open(kTracePath), "session trace reopens");
+        arc::trace::Replayer shorter(count_diff, &changed, shorter_window, nullptr);
+        while (r.next(rec))
+            shorter.feed(rec);
+        expect(changed > 0, "a shorter double-click window shows up as diffs");
+        std::printf("replay: %zu records, %zu timers, %d diffs at double_click_ms=120\n", s.log.size(),
+                    s.fired.size(), changed);
+    }
+
+    std::remove(kTracePath);
+    std::printf("[OK] recognizer tests passed\n");
+    return 0;
+}
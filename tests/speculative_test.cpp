@@ -0,0 +1,259 @@
+/**
+ * @file speculative_test.cpp
+ * @brief Speculative click: right press at trigger down, and no button left
+ *        pressed under any interleaving of presses, moves, timers, resets
+ *        and setting changes.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "arc/gesture.h"
+
+#include "gesture_events.h"
+
+using arc::gesture::Button;
+using arc::gesture::Decision;
+using arc::gesture::Engine;
+using arc::gesture::Event;
+using arc::gesture::EventType;
+using arc::gesture::Settings;
+using arc::gesture::Verdict;
+using arc::test::ev;
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+/** Steps of an interleaving. */
+enum Step : int {
+    kAltDown,     ///< Physical Alt+Left press.
+    kPlainDown,   ///< Physical Left press without the modifier.
+    kLeftUp,      ///< Physical Left release.
+    kMoveNear,    ///< Move inside the radius.
+    kMoveFar,     ///< Move far outside the radius.
+    kWait,        ///< Time passes; a due long-press timer fires.
+    kReset,       ///< Hook reinstalled: engine reset.
+    kRightToggle, ///< Physical right press or release (passes through).
+    kToggleMode,  ///< Speculative mode switched at runtime.
+    kStepCount
+};
+
+/**
+ * Simulates the hook around an engine and tracks which buttons the
+ * application believes are pressed: passed physical events plus injections.
+ */
+struct Harness {
+    Engine engine;
+    Settings settings;
+    bool held[6] = {};      ///< Physical buttons.
+    bool app_down[6] = {};  ///< Application view.
+    std::int32_t x = 100;
+    std::uint32_t t = 0xFFFFFF00u;  // cross the tick wrap
+
+    explicit Harness(bool speculative) {
+        settings.speculative = speculative;
+        engine.configure(settings);
+    }
+
+    void apply(const Decision &d) {
+        for (int i = 0; i < d.count; ++i)
+            app_down[static_cast<int>(d.inject[i].button)] = d.inject[i].down;
+    }
+
+    void fire_due() {
+        std::uint32_t at;
+        if (engine.deadline(at) && static_cast<std::int32_t>(t - at) >= 0)
+            apply(engine.on_timer(at));
+    }
+
+    void feed(const Event &ev) {
+        fire_due();
+        Decision d = engine.on_event(ev);
+        if (d.verdict == Verdict::Pass && (ev.type == EventType::Down || ev.type == EventType::Up))
+            app_down[static_cast<int>(ev.button)] = ev.type == EventType::Down;
+        apply(d);
+    }
+
+    /** Applies a step if it is physically possible; returns false otherwise. */
+    bool step(int s) {
+        const int L = static_cast<int>(Button::Left), R = static_cast<int>(Button::Right);
+        t += 10;
+        switch (s) {
+        case kAltDown:
+        case kPlainDown:
+            if (held[L])
+                return false;
+            held[L] = true;
+            x = 100;
+            feed(ev(EventType::Down, Button::Left, x, 0, t,
+                    s == kAltDown ? static_cast<std::uint32_t>(arc::gesture::kModAlt) : 0u));
+            return true;
+        case kLeftUp:
+            if (!held[L])
+                return false;
+            held[L] = false;
+            feed(ev(EventType::Up, Button::Left, x, 0, t));
+            return true;
+        case kMoveNear:
+            x = 102;
+            feed(ev(EventType::Move, Button::None, x, 0, t));
+            return true;
+        case kMoveFar:
+            x = 160;
+            feed(ev(EventType::Move, Button::None, x, 0, t));
+            return true;
+        case kWait:
+            t += 400;
+            fire_due();
+            return true;
+        case kReset:
+            apply(engine.reset());
+            return true;
+        case kRightToggle:
+            held[R] = !held[R];
+            feed(ev(held[R] ? EventType::Down : EventType::Up, Button::Right, x, 0, t));
+            return true;
+        case kToggleMode:
+            settings.speculative = !settings.speculative;
+            engine.configure(settings);
+            return true;
+        }
+        return false;
+    }
+
+    /** Releases everything physically held and lets timers run out. */
+    void settle() {
+        if (held[static_cast<int>(Button::Left)])
+            step(kLeftUp);
+        if (held[static_cast<int>(Button::Right)])
+            step(kRightToggle);
+        step(kWait);
+    }
+
+    bool clean() const {
+        for (bool b : app_down)
+            if (b)
+                return false;
+        return !engine.tracking();
+    }
+};
+
+/** Runs every interleaving of @p len steps; returns the number simulated. */
+long exhaustive(int len, bool speculative) {
+    std::vector<int> seq(static_cast<std::size_t>(len), 0);
+    long runs = 0;
+    for (;;) {
+        Harness h(speculative);
+        bool possible = true;
+        for (int s : seq)
+            possible = possible && h.step(s);
+        if (possible) {
+            h.settle();
+            expect(h.clean(), "no button left pressed after an exhaustive interleaving");
+            ++runs;
+        }
+        int i = 0;
+        while (i < len && ++seq[static_cast<std::size_t>(i)] == kStepCount)
+            seq[static_cast<std::size_t>(i++)] = 0;
+        if (i == len)
+            return runs;
+    }
+}
+
+}  // namespace
+
+/** @brief Entry point for speculative click tests. */
+int main() {
+    Settings spec;
+    spec.speculative = true;
+
+    // Quick click: right down with the trigger down, right up with its release
+    {
+        Engine e(spec);
+        Decision d = e.on_event(ev(EventType::Down, Button::Left, 10, 0, 0, arc::gesture::kModAlt));
+        expect(d.verdict == Verdict::Swallow, "trigger down swallowed");
+        expect(d.count == 1 && d.inject[0].button == Button::Right && d.inject[0].down, "right down injected at once");
+        d = e.on_event(ev(EventType::Up, Button::Left, 10, 0, 100));
+        expect(d.verdict == Verdict::Swallow, "trigger up swallowed");
+        expect(d.count == 1 && d.inject[0].button == Button::Right && !d.inject[0].down, "quick release: right up");
+    }
+
+    // Drag: cancel the speculation, then the normal source drag
+    {
+        Engine e(spec);
+        e.on_event(ev(EventType::Down, Button::Left, 10, 0, 0, arc::gesture::kModAlt));
+        Decision d = e.on_event(ev(EventType::Move, Button::None, 40, 0, 5));
+        expect(d.count == 2, "drag injects cancel and source down");
+        expect(d.inject[0].button == Button::Right && !d.inject[0].down, "right released first");
+        expect(d.inject[1].button == Button::Left && d.inject[1].down, "then the source down");
+        expect(d.path_count >= 2 && d.path[0].x == 10, "drag still replays from the origin");
+        d = e.on_event(ev(EventType::Up, Button::Left, 40, 0, 50));
+        expect(d.verdict == Verdict::Pass && d.count == 0, "drag release passes");
+    }
+
+    // Long press via the timer, late release, and reset all cancel first
+    {
+        Engine e(spec);
+        e.on_event(ev(EventType::Down, Button::Left, 10, 0, 0, arc::gesture::kModAlt));
+        Decision d = e.on_timer(251);
+        expect(d.count == 2 && d.inject[0].button == Button::Right && !d.inject[0].down &&
+                   d.inject[1].button == Button::Left && d.inject[1].down,
+               "long press cancels, then presses the source");
+
+        e.on_event(ev(EventType::Down, Button::Left, 10, 0, 1000, arc::gesture::kModAlt));
+        d = e.on_event(ev(EventType::Up, Button::Left, 10, 0, 1400));
+        expect(d.count == 3 && d.inject[0].button == Button::Right && !d.inject[0].down &&
+                   d.inject[1].button == Button::Left && d.inject[2].button == Button::Left,
+               "late release cancels, then replays the source click");
+
+        e.on_event(ev(EventType::Down, Button::Left, 10, 0, 2000, arc::gesture::kModAlt));
+        d = e.reset();
+        expect(d.count == 1 && d.inject[0].button == Button::Right && !d.inject[0].down, "reset releases right");
+        d = e.reset();
+        expect(d.count == 0, "second reset has nothing to release");
+    }
+
+    // Non-speculative presses inject nothing on the down
+    {
+        Engine e;
+        Decision d = e.on_event(ev(EventType::Down, Button::Left, 10, 0, 0, arc::gesture::kModAlt));
+        expect(d.count == 0 && e.reset().count == 0, "plain mode: no speculative press");
+    }
+
+    // Every interleaving of up to 6 steps, starting in either mode
+    long runs = 0;
+    for (int len = 1; len <= 6; ++len)
+        runs += exhaustive(len, true) + exhaustive(len, false);
+
+    // Long random interleavings
+    {
+        std::mt19937 rng(13);
+        for (int i = 0; i < 100000; ++i) {
+            Harness h(rng() % 2 != 0);
+            for (int n = 0; n < 40; ++n)
+                h.step(static_cast<int>(rng() % kStepCount));
+            h.settle();
+            expect(h.clean(), "no button left pressed after a random interleaving");
+            ++runs;
+        }
+    }
+    std::printf("interleavings: %ld checked\n", runs);
+
+    std::printf("[OK] speculative tests passed\n");
+    return 0;
+}
@@ -0,0 +1,337 @@
+/**
+ * @file stroke_test.cpp
+ * @brief Stroke recognizer: shapes, resampling, matching invariants, a
+ *        corpus of synthetic hand-drawn strokes, and strokes in the engine.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "arc/gesture.h"
+#include "arc/stroke.h"
+
+#include "gesture_events.h"
+
+using arc::gesture::Button;
+using arc::gesture::Decision;
+using arc::gesture::Engine;
+using arc::gesture::Event;
+using arc::gesture::EventType;
+using arc::gesture::Settings;
+using arc::gesture::Verdict;
+using arc::stroke::Shape;
+using arc::stroke::Vector;
+using arc::test::ev;
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+/// @brief A recorded stroke as the engine buffers it.
+struct Path {
+    std::vector<std::int32_t> x, y;
+    void add(double px, double py) {
+        x.push_back(static_cast<std::int32_t>(std::lround(px)));
+        y.push_back(static_cast<std::int32_t>(std::lround(py)));
+    }
+};
+
+/**
+ * A hand-drawn rendition of @p shape: random start, size and overall tilt,
+ * segments of uneven length and direction, a pointer sampled every few
+ * pixels with a little jitter.
+ */
+Path draw(Shape shape, std::mt19937 &rng) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto range = [&](double lo, double hi) { return lo + (hi - lo) * unit(rng); };
+    static const double kAngle[] = {kPi, 0.0, -kPi / 2, kPi / 2};  // L, R, U, D (y down)
+    Path p;
+    double x = range(200, 1600), y = range(200, 900);
+    double tilt = range(-0.14, 0.14);  // about +-8 degrees
+    double scale = range(0.5, 2.0);
+    p.add(x, y);
+    for (int s = 0; s < shape.count; ++s) {
+        double a = kAngle[static_cast<int>(shape.at(s))] + tilt + range(-0.2, 0.2);
+        double len = scale * range(70, 160);
+        for (double done = 0; done < len;) {
+            double step = std::min(len - done, range(1, 8));
+            x += step * std::cos(a);
+            y += step * std::sin(a);
+            done += step;
+            p.add(x + range(-1.5, 1.5), y + range(-1.5, 1.5));
+        }
+    }
+    return p;
+}
+
+Shape shape_of(const char *text) {
+    Shape s;
+    expect(arc::stroke::parse_shape(text, s), "shape parses");
+    return s;
+}
+
+/** Every shape of @p segments segments; with @p retrace also those reversing a segment ("LR"). */
+void shapes_with(int segments, bool retrace, std::vector<Shape> &out) {
+    static const char kLetters[] = "LRUD";  // opposite directions pair up as 0/1 and 2/3
+    std::vector<int> d(static_cast<std::size_t>(segments), 0);
+    for (;;) {
+        char text[arc::stroke::kMaxSegments + 1] = {};
+        bool ok = true;
+        for (int i = 0; i < segments; ++i) {
+            int cur = d[static_cast<std::size_t>(i)];
+            text[i] = kLetters[cur];
+            if (i > 0 && !retrace && (d[static_cast<std::size_t>(i - 1)] ^ 1) == cur)
+                ok = false;
+        }
+        Shape s;
+        if (ok && arc::stroke::parse_shape(text, s))
+            out.push_back(s);
+        int i = 0;
+        while (i < segments && ++d[static_cast<std::size_t>(i)] == 4)
+            d[static_cast<std::size_t>(i++)] = 0;
+        if (i == segments)
+            return;
+    }
+}
+
+/// @brief Recognition counts by segment count (index 0: all).
+struct Corpus {
+    int total[arc::stroke::kMaxSegments + 1] = {};
+    int ok[arc::stroke::kMaxSegments + 1] = {};
+    float worst = 1.f;  ///< Lowest score of a correctly recognized stroke.
+};
+
+/** Draws 40 renditions of each shape and matches them against a library of all of them. */
+Corpus recognize(const std::vector<Shape> &shapes, unsigned seed) {
+    arc::stroke::Library lib;
+    for (Shape s : shapes) {
+        Vector v;
+        expect(arc::stroke::shape_vector(s, v), "template built");
+        expect(lib.add(v) >= 0, "template added");
+    }
+    std::mt19937 rng(seed);
+    Corpus c;
+    for (std::size_t i = 0; i < shapes.size(); ++i) {
+        for (int k = 0; k < 40; ++k) {
+            Path p = draw(shapes[i], rng);
+            Vector v;
+            expect(arc::stroke::normalize(p.x.data(), p.y.data(), static_cast<int>(p.x.size()), v),
+                   "drawn stroke normalizes");
+            arc::stroke::Match m = lib.best(v);
+            ++c.total[0];
+            ++c.total[shapes[i].count];
+            if (m.index == static_cast<int>(i)) {
+                ++c.ok[0];
+                ++c.ok[shapes[i].count];
+                c.worst = std::min(c.worst, m.score);
+            }
+        }
+    }
+    return c;
+}
+
+Settings with_strokes() {
+    Settings s;
+    const char *shapes[] = {"L", "R", "DR"};
+    const Button actions[] = {Button::X1, Button::X2, Button::Middle};
+    for (int i = 0; i < 3; ++i) {
+        s.strokes[i].shape = shape_of(shapes[i]);
+        s.strokes[i].action = arc::gesture::Action{actions[i], false};
+    }
+    s.stroke_count = 3;
+    return s;
+}
+
+/** Presses Alt+Left at the first point, moves along @p p, releases at the last; returns the release decision. */
+Decision stroke_through(Engine &e, const Path &p, std::uint32_t &t, bool &moves_passed) {
+    Decision d = e.on_event(ev(EventType::Down, Button::Left, p.x[0], p.y[0], t, arc::gesture::kModAlt));
+    expect(d.verdict == Verdict::Swallow, "stroke press swallowed");
+    moves_passed = true;
+    for (std::size_t i = 1; i < p.x.size(); ++i) {
+        d = e.on_event(ev(EventType::Move, Button::None, p.x[i], p.y[i], ++t));
+        moves_passed = moves_passed && d.verdict == Verdict::Pass && d.count == 0;
+    }
+    return e.on_event(ev(EventType::Up, Button::Left, p.x.back(), p.y.back(), ++t));
+}
+
+}  // namespace
+
+/** @brief Entry point for stroke tests. */
+int main() {
+    // Shapes
+    {
+        Shape s;
+        char text[arc::stroke::kMaxSegments + 1];
+        expect(arc::stroke::parse_shape("dR", s) && s.count == 2, "mixed case parses");
+        arc::stroke::format_shape(s, text);
+        expect(std::strcmp(text, "DR") == 0, "shape formats back");
+        expect(arc::stroke::parse_shape("LURD", s) && s.count == 4, "four segments parse");
+        expect(!arc::stroke::parse_shape("", s), "empty shape rejected");
+        expect(!arc::stroke::parse_shape("LL", s), "repeated direction rejected");
+        expect(!arc::stroke::parse_shape("LRLRL", s), "five segments rejected");
+        expect(!arc::stroke::parse_shape("LX", s), "unknown letter rejected");
+        arc::stroke::format_shape(Shape{}, text);
+        expect(text[0] == '\0', "no shape formats empty");
+    }
+
+    // Resampling: centred unit vector, even spacing, degenerate input rejected
+    {
+        std::int32_t xs[] = {0, 10, 300}, ys[] = {0, 0, 0};
+        Vector v;
+        expect(arc::stroke::normalize(xs, ys, 3, v), "line normalizes");
+        double mx = 0, my = 0, norm = 0;
+        for (int i = 0; i < arc::stroke::kSamples; ++i) {
+            mx += v.x[i];
+            my += v.y[i];
+            norm += v.x[i] * v.x[i] + v.y[i] * v.y[i];
+        }
+        expect(std::fabs(mx) < 1e-4 && std::fabs(my) < 1e-4, "centroid at the origin");
+        expect(std::fabs(norm - 1.0) < 1e-4, "unit length");
+        double gap = v.x[1] - v.x[0];
+        for (int i = 1; i < arc::stroke::kSamples; ++i)
+            expect(std::fabs((v.x[i] - v.x[i - 1]) - gap) < 1e-4 && v.y[i] == 0.f, "samples evenly spaced");
+        std::int32_t px[] = {5, 5, 5}, py[] = {7, 7, 7};
+        expect(!arc::stroke::normalize(px, py, 3, v), "stroke without length rejected");
+        expect(!arc::stroke::normalize(px, py, 1, v), "single point rejected");
+    }
+
+    // Similarity: invariant to position and size, bounded rotation
+    {
+        Vector left, right, up, a, b;
+        expect(arc::stroke::shape_vector(shape_of("L"), left), "L template");
+        expect(arc::stroke::shape_vector(shape_of("R"), right), "R template");
+        expect(arc::stroke::shape_vector(shape_of("U"), up), "U template");
+        expect(!arc::stroke::shape_vector(Shape{}, a), "empty shape has no template");
+        std::int32_t xs[] = {900, 850, 700}, ys[] = {300, 300, 300};
+        expect(arc::stroke::normalize(xs, ys, 3, a), "drawn left stroke");
+        expect(arc::stroke::similarity(a, left) > 0.999f, "same stroke elsewhere and larger scores 1");
+        expect(arc::stroke::similarity(a, right) < -0.9f, "opposite stroke scores near -1");
+        std::int32_t tx[] = {0, -100}, ty[] = {0, -27};  // 15 degrees off left, towards up
+        expect(arc::stroke::normalize(tx, ty, 2, b), "tilted stroke");
+        expect(arc::stroke::similarity(b, left) > 0.999f, "tilt within the rotation limit is free");
+        expect(arc::stroke::similarity(b, up) < 0.75f, "left stroke is far from up");
+    }
+
+    // Corpus: hand-drawn renditions of every shape of one to three segments.
+    // Shapes that turn are told apart reliably; shapes that retrace a
+    // segment (e.g. "LR") resemble each other once segment lengths vary.
+    {
+        std::vector<Shape> turns, all;
+        for (int n = 1; n <= 3; ++n) {
+            shapes_with(n, false, turns);
+            shapes_with(n, true, all);
+        }
+        expect(turns.size() == 4 + 8 + 16 && all.size() == 4 + 12 + 36, "every shape enumerated");
+        Corpus c = recognize(turns, 18);
+        std::printf("turning shapes: %d/%d recognized (1 seg %d/%d, 2 seg %d/%d, 3 seg %d/%d), lowest score %.3f\n",
+                    c.ok[0], c.total[0], c.ok[1], c.total[1], c.ok[2], c.total[2], c.ok[3], c.total[3],
+                    static_cast<double>(c.worst));
+        expect(c.ok[1] == c.total[1] && c.ok[2] == c.total[2], "every one- and two-segment stroke recognized");
+        expect(c.ok[3] * 100 >= c.total[3] * 95, "three-segment strokes recognized at least 95% of the time");
+        expect(c.worst >= 0.8f, "recognized strokes clear the default minimum score");
+        Corpus a = recognize(all, 19);
+        std::printf("all shapes: %d/%d recognized with %zu templates\n", a.ok[0], a.total[0], all.size());
+        expect(a.ok[1] == a.total[1], "straight strokes recognized among every shape");
+        expect(a.ok[0] * 100 >= a.total[0] * 85, "strokes recognized at least 85% of the time among every shape");
+
+        Vector v;
+        arc::stroke::shape_vector(all[0], v);
+        arc::stroke::Library full;
+        for (int i = 0; i < arc::stroke::kMaxTemplates; ++i)
+            expect(full.add(v) == i, "template indices in order");
+        expect(full.add(v) == -1 && full.size() == arc::stroke::kMaxTemplates, "full library rejects templates");
+        expect(arc::stroke::Library{}.best(v).index == -1, "empty library matches nothing");
+    }
+
+    // Engine: bound drags become strokes, matched at the release
+    {
+        std::mt19937 rng(7);
+        std::uint32_t t = 1000;
+        Engine e(with_strokes());
+        bool passed = false;
+        Path back = draw(shape_of("L"), rng);
+        Decision d = stroke_through(e, back, t, passed);
+        expect(passed, "stroke moves pass without injections");
+        expect(d.verdict == Verdict::Swallow && d.count == 2 && d.inject[0].button == Button::X1 && d.inject[0].down &&
+                   !d.inject[1].down,
+               "left stroke clicks back (X1)");
+        expect(e.idle(), "engine idle after the stroke");
+
+        Path close = draw(shape_of("DR"), rng);
+        d = stroke_through(e, close, t, passed);
+        expect(d.count == 2 && d.inject[0].button == Button::Middle, "down-right stroke clicks middle");
+
+        Path unknown = draw(shape_of("ULD"), rng);
+        d = stroke_through(e, unknown, t, passed);
+        expect(d.verdict == Verdict::Swallow && d.count == 0, "unmatched stroke injects nothing");
+
+        // A long, slow stroke overflows the buffer and is still recognized
+        Path slow;
+        for (int i = 0; i <= 1500; ++i)
+            slow.add(1500 - i / 5.0, 400 + (i % 3));
+        d = stroke_through(e, slow, t, passed);
+        expect(d.count == 2 && d.inject[0].button == Button::X1, "long stroke recognized after compaction");
+
+        // Mid-stroke: another button passes, the engine is busy
+        e.on_event(ev(EventType::Down, Button::Left, 500, 500, ++t, arc::gesture::kModAlt));
+        e.on_event(ev(EventType::Move, Button::None, 560, 500, ++t));
+        expect(e.stroking() && !e.idle(), "stroking after leaving the radius");
+        Event right = ev(EventType::Down, Button::Right, 560, 500, ++t);
+        expect(e.on_event(right).verdict == Verdict::Pass, "other button passes during a stroke");
+        Decision r = e.reset();
+        expect(r.count == 0 && !e.stroking(), "reset drops the stroke");
+
+        // Minimum score above anything reachable: nothing is recognized
+        Settings strict = with_strokes();
+        strict.stroke_min_score = 101;
+        Engine picky(strict);
+        d = stroke_through(picky, back, t, passed);
+        expect(d.count == 0, "minimum score gates recognition");
+    }
+
+    // Without stroke rules a bound drag is still a native drag
+    {
+        Engine e;
+        std::uint32_t t = 0;
+        e.on_event(ev(EventType::Down, Button::Left, 500, 500, t, arc::gesture::kModAlt));
+        Decision d = e.on_event(ev(EventType::Move, Button::None, 540, 500, ++t));
+        expect(d.path_count > 0 && d.count == 1 && d.inject[0].button == Button::Left, "drag without strokes");
+    }
+
+    // A held-back click is delivered at its position before the stroke starts
+    {
+        Settings s = with_strokes();
+        s.double_click_ms = 300;
+        Engine e(s);
+        std::uint32_t t = 0;
+        e.on_event(ev(EventType::Down, Button::Left, 500, 500, t, arc::gesture::kModAlt));
+        e.on_event(ev(EventType::Up, Button::Left, 500, 500, t += 40));
+        e.on_event(ev(EventType::Down, Button::Left, 501, 500, t += 60, arc::gesture::kModAlt));
+        Decision d = e.on_event(ev(EventType::Move, Button::None, 460, 500, t += 10));
+        expect(d.count == 2 && d.inject[0].button == Button::Right, "held click delivered");
+        expect(d.path_count == 2 && d.path[0].x == 500 && d.path[1].x == 460, "pointer replayed to the stroke");
+        expect(e.stroking(), "second press strokes");
+    }
+
+    std::printf("[OK] stroke tests passed\n");
+    return 0;
+}
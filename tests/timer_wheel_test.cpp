@@ -0,0 +1,319 @@
+/**
+ * @file timer_wheel_test.cpp
+ * @brief Timer wheel ordering, cancellation and cascading on a virtual clock,
+ *        plus long-press resolution of the gesture engine driven by the wheel.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "arc/gesture.h"
+#include "arc/timer_wheel.h"
+
+using arc::timer::TimerId;
+using arc::timer::Wheel;
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+/** Records (tag, fire time) of every callback. */
+struct Log {
+    struct Hit {
+        std::uint64_t tag;
+        std::uint64_t at;
+    };
+    std::vector<Hit> hits;
+};
+
+struct Tagged {
+    Log *log;
+    std::uint64_t tag;
+};
+
+void record(void *ctx, std::uint64_t now_ms) {
+    auto *t = static_cast<Tagged *>(ctx);
+    t->log->hits.push_back({t->tag, now_ms});
+}
+
+/** Context for callbacks that manipulate the wheel from inside advance(). */
+struct Reentrant {
+    Wheel *wheel;
+    Log *log;
+    TimerId victim = 0;
+    Tagged follow_up{nullptr, 0};
+};
+
+void cancel_victim(void *ctx, std::uint64_t now_ms) {
+    auto *r = static_cast<Reentrant *>(ctx);
+    r->log->hits.push_back({1, now_ms});
+    r->wheel->cancel(r->victim);
+    r->wheel->schedule(now_ms, record, &r->follow_up);
+}
+
+/** Gesture engine plus wheel, wired like the hook worker. */
+struct Worker {
+    arc::gesture::Engine engine;
+    Wheel wheel{4};
+    TimerId long_press = 0;
+    arc::gesture::Decision last_timer;
+
+    static void on_long_press(void *ctx, std::uint64_t now_ms) {
+        auto *w = static_cast<Worker *>(ctx);
+        w->long_press = 0;
+        w->last_timer = w->engine.on_timer(static_cast<std::uint32_t>(now_ms));
+    }
+
+    arc::gesture::Decision event(arc::gesture::EventType type, arc::gesture::Button b, std::int32_t x,
+                                 std::uint32_t mods) {
+        wheel.advance(wheel.now());
+        arc::gesture::Event ev;
+        ev.type = type;
+        ev.button = b;
+        ev.x = x;
+        ev.time_ms = static_cast<std::uint32_t>(wheel.now());
+        ev.mods = mods;
+        bool was = engine.tracking();
+        arc::gesture::Decision d = engine.on_event(ev);
+        if (engine.tracking() != was) {
+            wheel.cancel(long_press);
+            long_press = 0;
+            std::uint32_t at;
+            if (engine.deadline(at))
+                long_press = wheel.schedule(wheel.now() + (at - ev.time_ms), on_long_press, this);
+        }
+        return d;
+    }
+};
+
+}  // namespace
+
+/** @brief Entry point for timer wheel tests. */
+int main() {
+    // Deadline order, including ties and deadlines in the past
+    {
+        Log log;
+        Wheel w(16, 1000);
+        Tagged a{&log, 1}, b{&log, 2}, c{&log, 3}, d{&log, 4};
+        w.schedule(1030, record, &c);
+        w.schedule(1005, record, &a);
+        w.schedule(1030, record, &d);
+        w.schedule(900, record, &b);  // already due
+        expect(w.size() == 4, "four pending");
+        expect(w.next_deadline() == 1000, "past deadline is due now");
+        expect(w.advance(1004) == 1, "only the past deadline fired");
+        expect(log.hits[0].tag == 2 && log.hits[0].at == 1000, "past deadline fires at the current time");
+        expect(w.next_deadline() == 1005, "exact next deadline in level 0");
+        expect(w.advance(1029) == 1 && log.hits[1].tag == 1 && log.hits[1].at == 1005, "fires at its deadline");
+        expect(w.advance(1030) == 2 && w.size() == 0, "ties fire together");
+        expect(w.next_deadline() == arc::timer::kNever, "nothing pending");
+        expect(w.now() == 1030, "clock advanced");
+        w.advance(10);
+        expect(w.now() == 1030, "backwards clock ignored");
+    }
+
+    // Cancel: pending, already fired, stale and invalid ids
+    {
+        Log log;
+        Wheel w(2);
+        Tagged a{&log, 1};
+        TimerId id = w.schedule(10, record, &a);
+        expect(id != 0, "valid id");
+        expect(w.cancel(id), "cancel pending");
+        expect(!w.cancel(id), "double cancel rejected");
+        expect(w.advance(100) == 0 && log.hits.empty(), "cancelled timer never fires");
+        TimerId reused = w.schedule(200, record, &a);
+        expect(reused != id, "slot reuse changes the id");
+        expect(!w.cancel(id), "stale id does not cancel the new timer");
+        expect(w.advance(200) == 1, "new timer still fires");
+        expect(!w.cancel(reused), "fired timer cannot be cancelled");
+        expect(!w.cancel(0) && !w.cancel(~TimerId{0}), "invalid ids rejected");
+    }
+
+    // Pool exhaustion and recovery
+    {
+        Log log;
+        Wheel w(3);
+        Tagged a{&log, 1};
+        expect(w.schedule(1, record, &a) && w.schedule(2, record, &a) && w.schedule(3, record, &a), "fill pool");
+        expect(w.schedule(4, record, &a) == 0, "full pool rejects");
+        w.advance(1);
+        expect(w.schedule(4, record, &a) != 0, "fired timer frees a node");
+    }
+
+    // Cascading across levels and far deadlines
+    {
+        Log log;
+        const std::uint64_t start = 0x123456789ull;
+        Wheel w(16, start);
+        const std::uint64_t offs[] = {63, 64, 65, 4095, 4096, 300000, 20000000, 1ull << 40};
+        Tagged tags[8];
+        for (int i = 0; i < 8; ++i) {
+            tags[i] = Tagged{&log, static_cast<std::uint64_t>(i)};
+            w.schedule(start + offs[i], record, &tags[i]);
+        }
+        // Step through the next deadlines like the OS timer would
+        int wakeups = 0;
+        while (w.size()) {
+            std::uint64_t next = w.next_deadline();
+            expect(next > w.now() || next == w.now(), "next deadline not in the past");
+            w.advance(next);
+            ++wakeups;
+        }
+        expect(log.hits.size() == 8, "all far timers fired");
+        for (int i = 0; i < 8; ++i)
+            expect(log.hits[i].tag == static_cast<std::uint64_t>(i) && log.hits[i].at == start + offs[i],
+                   "far timer fires exactly at its deadline, in order");
+        expect(wakeups < 8 * static_cast<int>(Wheel::kLevels) + 8, "wakeups bounded by levels");
+    }
+
+    // One big jump fires everything in deadline order
+    {
+        Log log;
+        Wheel w(8, 5);
+        Tagged tags[4] = {{&log, 0}, {&log, 1}, {&log, 2}, {&log, 3}};
+        w.schedule(5 + 70000, record, &tags[3]);
+        w.schedule(5 + 70, record, &tags[1]);
+        w.schedule(5 + 7, record, &tags[0]);
+        w.schedule(5 + 7000, record, &tags[2]);
+        expect(w.advance(1000000) == 4, "jump fires all");
+        for (int i = 0; i < 4; ++i)
+            expect(log.hits[i].tag == static_cast<std::uint64_t>(i), "jump keeps deadline order");
+        expect(log.hits[3].at == 5 + 70000, "callback sees its own deadline during a jump");
+    }
+
+    // Callbacks may cancel a timer due in the same call and schedule new ones
+    {
+        Log log;
+        Wheel w(8);
+        Reentrant r{&w, &log};
+        Tagged victim{&log, 2};
+        r.follow_up = Tagged{&log, 3};
+        w.schedule(10, cancel_victim, &r);
+        r.victim = w.schedule(10, record, &victim);
+        w.schedule(10, cancel_victim, &r);  // second canceller hits a stale id
+        w.advance(50);
+        bool victim_fired = false;
+        int follow_ups = 0;
+        for (auto &h : log.hits) {
+            if (h.tag == 2)
+                victim_fired = true;
+            if (h.tag == 3)
+                ++follow_ups;
+        }
+        expect(!victim_fired, "timer cancelled while due in the same advance does not fire");
+        expect(follow_ups == 2, "timers scheduled from callbacks fire in the same advance");
+        expect(w.size() == 0, "nothing left");
+    }
+
+    // Randomized comparison with a sorted reference
+    {
+        std::mt19937_64 rng(42);
+        Log log;
+        Wheel w(256, 77);
+        struct Ref {
+            std::uint64_t deadline;
+            std::uint64_t tag;
+            TimerId id;
+        };
+        std::vector<Ref> ref;
+        std::vector<Tagged> tags(100000);
+        std::uint64_t next_tag = 0;
+        std::vector<Log::Hit> expected;
+        for (int step = 0; step < 20000; ++step) {
+            int op = static_cast<int>(rng() % 10);
+            if (op < 5 && ref.size() < 256) {
+                std::uint64_t span = std::uint64_t{1} << (rng() % 30);
+                std::uint64_t dl = w.now() + rng() % span;
+                tags[next_tag] = Tagged{&log, next_tag};
+                TimerId id = w.schedule(dl, record, &tags[next_tag]);
+                expect(id != 0, "schedule within capacity");
+                ref.push_back({dl, next_tag++, id});
+            } else if (op < 7 && !ref.empty()) {
+                std::size_t i = rng() % ref.size();
+                expect(w.cancel(ref[i].id), "cancel pending timer");
+                ref.erase(ref.begin() + static_cast<std::ptrdiff_t>(i));
+            } else {
+                std::uint64_t to = w.now() + rng() % (std::uint64_t{1} << (rng() % 24));
+                std::stable_sort(ref.begin(), ref.end(),
+                                 [](const Ref &a, const Ref &b) { return a.deadline < b.deadline; });
+                std::size_t n = 0;
+                while (n < ref.size() && ref[n].deadline <= to) {
+                    std::uint64_t at = ref[n].deadline < w.now() ? w.now() : ref[n].deadline;
+                    expected.push_back({ref[n].tag, at});
+                    ++n;
+                }
+                ref.erase(ref.begin(), ref.begin() + static_cast<std::ptrdiff_t>(n));
+                std::size_t before = log.hits.size();
+                expect(w.advance(to) == n, "fired count matches reference");
+                // Same deadline may fire in any order: compare per deadline
+                std::vector<Log::Hit> got(log.hits.begin() + static_cast<std::ptrdiff_t>(before), log.hits.end());
+                std::vector<Log::Hit> want(expected.end() - static_cast<std::ptrdiff_t>(n), expected.end());
+                auto by_time = [](const Log::Hit &a, const Log::Hit &b) {
+                    return a.at != b.at ? a.at < b.at : a.tag < b.tag;
+                };
+                for (std::size_t i = 1; i < got.size(); ++i)
+                    expect(got[i - 1].at <= got[i].at, "fire times never go backwards");
+                std::sort(got.begin(), got.end(), by_time);
+                std::sort(want.begin(), want.end(), by_time);
+                for (std::size_t i = 0; i < n; ++i)
+                    expect(got[i].tag == want[i].tag && got[i].at == want[i].at, "fired set matches reference");
+            }
+            expect(w.size() == ref.size(), "size matches reference");
+        }
+    }
+
+    // Long press resolved by the wheel at the click time, not at release
+    {
+        using arc::gesture::Button;
+        using arc::gesture::EventType;
+        Worker wk;
+        wk.wheel.advance(10000);
+        wk.event(EventType::Down, Button::Left, 0, arc::gesture::kModAlt);
+        expect(wk.wheel.size() == 1 && wk.wheel.next_deadline() <= 10251, "long-press timer armed");
+        wk.wheel.advance(10250);
+        expect(wk.engine.tracking() && wk.last_timer.count == 0, "still a click at the click time");
+        wk.wheel.advance(10251);
+        expect(!wk.engine.tracking(), "long press resolved by the timer");
+        expect(wk.last_timer.count == 1 && wk.last_timer.inject[0].button == Button::Left &&
+                   wk.last_timer.inject[0].down,
+               "timer injects the source-button down");
+        wk.wheel.advance(12000);
+        arc::gesture::Decision d = wk.event(EventType::Up, Button::Left, 0, 0);
+        expect(d.verdict == arc::gesture::Verdict::Pass && d.count == 0, "native release passes");
+
+        // A quick click cancels the timer
+        wk.last_timer = arc::gesture::Decision{};
+        wk.event(EventType::Down, Button::Left, 0, arc::gesture::kModAlt);
+        wk.wheel.advance(12100);
+        d = wk.event(EventType::Up, Button::Left, 0, 0);
+        expect(d.count == 2 && d.inject[0].button == Button::Right, "quick click translated");
+        expect(wk.wheel.size() == 0, "click cancelled the long-press timer");
+        wk.wheel.advance(20000);
+        expect(wk.last_timer.count == 0, "cancelled timer never fired");
+
+        // A drag cancels it too
+        wk.event(EventType::Down, Button::Left, 0, arc::gesture::kModAlt);
+        wk.wheel.advance(20010);
+        d = wk.event(EventType::Move, Button::None, 50, arc::gesture::kModAlt);
+        expect(d.count == 1 && wk.wheel.size() == 0, "drag cancelled the long-press timer");
+    }
+
+    std::printf("[OK] timer wheel tests passed\n");
+    return 0;
+}
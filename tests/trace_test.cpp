@@ -0,0 +1,355 @@
+/**
+ * @file trace_test.cpp
+ * @brief Trace encoding round trips, recorder/reader file round trips and
+ *        deterministic replay of a simulated session.
+ */
+
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "arc/trace.h"
+
+using arc::gesture::Button;
+using arc::gesture::EventType;
+using arc::trace::Kind;
+using arc::trace::Record;
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+const char *kTracePath = "trace_test.arctrace";
+
+bool same_bindings(const arc::gesture::BindingTable &a, const arc::gesture::BindingTable &b) {
+    for (int i = 0; i < arc::gesture::BindingTable::kCells; ++i)
+        if (a.cell(i) != b.cell(i))
+            return false;
+    return true;
+}
+
+bool same_action(const arc::gesture::Action &a, const arc::gesture::Action &b) {
+    return a.button == b.button && a.double_click == b.double_click;
+}
+
+/** Random action over every button, single or double. */
+arc::gesture::Action random_action(std::mt19937 &rng) {
+    return arc::gesture::Action{static_cast<Button>(rng() % 6), rng() % 2 != 0};
+}
+
+bool same_strokes(const arc::gesture::Settings &a, const arc::gesture::Settings &b) {
+    if (a.stroke_count != b.stroke_count || a.stroke_min_score != b.stroke_min_score)
+        return false;
+    for (int i = 0; i < a.stroke_count; ++i) {
+        const arc::gesture::StrokeRule &x = a.strokes[i], &y = b.strokes[i];
+        if (x.shape.count != y.shape.count || x.shape.dirs != y.shape.dirs || !same_action(x.action, y.action))
+            return false;
+    }
+    return true;
+}
+
+bool same_record(const Record &a, const Record &b) {
+    if (a.kind != b.kind || a.event.time_ms != b.event.time_ms)
+        return false;
+    switch (a.kind) {
+    case Kind::Event:
+        return a.event.type == b.event.type && a.event.button == b.event.button && a.event.x == b.event.x &&
+               a.event.y == b.event.y && a.event.mods == b.event.mods &&
+               arc::trace::same_decision(a.decision, b.decision);
+    case Kind::Timer:
+        return arc::trace::same_decision(a.decision, b.decision);
+    case Kind::Settings:
+        return a.settings.trigger == b.settings.trigger && a.settings.required_mods == b.settings.required_mods &&
+               a.settings.click_time_ms == b.settings.click_time_ms &&
+               a.settings.move_radius_px == b.settings.move_radius_px &&
+               a.settings.predict_ms == b.settings.predict_ms && a.settings.speculative == b.settings.speculative &&
+               same_bindings(a.settings.bindings, b.settings.bindings) &&
+               a.settings.double_click_ms == b.settings.double_click_ms &&
+               same_action(a.settings.double_action, b.settings.double_action) &&
+               a.settings.long_press_ms == b.settings.long_press_ms &&
+               same_action(a.settings.long_press_action, b.settings.long_press_action) &&
+               a.settings.chord_ms == b.settings.chord_ms && a.settings.chord_button == b.settings.chord_button &&
+               same_action(a.settings.chord_action, b.settings.chord_action) && same_strokes(a.settings, b.settings) &&
+               a.settings.dwell_ms == b.settings.dwell_ms &&
+               same_action(a.settings.dwell_action, b.settings.dwell_action);
+    }
+    return false;
+}
+
+/** Random record covering every field range, including extremes. */
+Record random_record(std::mt19937 &rng, std::uint32_t &t) {
+    Record r;
+    t += rng() % 4 == 0 ? static_cast<std::uint32_t>(rng()) : rng() % 20;  // occasional huge jumps (wrap)
+    r.event.time_ms = t;
+    int kind = static_cast<int>(rng() % 10);
+    if (kind == 0) {
+        r.kind = Kind::Settings;
+        r.settings.trigger = static_cast<Button>(rng() % 6);
+        r.settings.required_mods = static_cast<std::uint32_t>(rng());
+        r.settings.click_time_ms = static_cast<std::uint32_t>(rng());
+        r.settings.move_radius_px = static_cast<std::int32_t>(rng());
+        r.settings.predict_ms = static_cast<std::uint32_t>(rng());
+        r.settings.speculative = rng() % 2 != 0;
+        std::uint32_t rows = rng() % 3 ? 0u : rng();  // mostly empty; sometimes every button bound
+        for (int i = 0; i < arc::gesture::BindingTable::kCells; ++i)
+            if (rows & (1u << (i / arc::gesture::BindingTable::kMasks)))
+                r.settings.bindings.set_cell(i, static_cast<std::uint8_t>(rng() % 6 | (rng() % 2 ? 0x8 : 0)));
+        r.settings.double_click_ms = rng() % 2 ? static_cast<std::uint32_t>(rng()) : 0u;
+        r.settings.double_action = random_action(rng);
+        r.settings.long_press_ms = rng() % 2 ? static_cast<std::uint32_t>(rng()) : 0u;
+        r.settings.long_press_action = random_action(rng);
+        r.settings.chord_ms = rng() % 2 ? static_cast<std::uint32_t>(rng()) : 0u;
+        r.settings.chord_button = static_cast<Button>(rng() % 6);
+        r.settings.chord_action = random_action(rng);
+        r.settings.stroke_count = static_cast<std::uint8_t>(rng() % 2 ? rng() % (arc::stroke::kMaxTemplates + 1) : 0);
+        r.settings.stroke_min_score = static_cast<std::uint8_t>(rng());
+        for (int i = 0; i < r.settings.stroke_count; ++i) {
+            r.settings.strokes[i].shape.count = static_cast<std::uint8_t>(rng() % (arc::stroke::kMaxSegments + 1));
+            r.settings.strokes[i].shape.dirs = static_cast<std::uint8_t>(rng());
+            r.settings.strokes[i].action = random_action(rng);
+        }
+        r.settings.dwell_ms = rng() % 2 ? static_cast<std::uint32_t>(rng()) : 0u;
+        r.settings.dwell_action = random_action(rng);
+        return r;
+    }
+    if (kind == 1) {
+        r.kind = Kind::Timer;
+    } else {
+        r.event.type = static_cast<EventType>(rng() % 4);
+        r.event.button = static_cast<Button>(rng() % 6);
+        static const std::int32_t extremes[] = {INT_MIN, INT_MAX, 0, -1, 1};
+        r.event.x = rng() % 8 == 0 ? extremes[rng() % 5] : static_cast<std::int32_t>(rng() % 4000) - 1000;
+        r.event.y = rng() % 8 == 0 ? extremes[rng() % 5] : static_cast<std::int32_t>(rng() % 3000) - 500;
+        r.event.mods = rng() % 3 == 0 ? static_cast<std::uint32_t>(rng() % 16) : 0;
+    }
+    if (rng() % 2)
+        r.decision.verdict = arc::gesture::Verdict::Swallow;
+    for (unsigned i = 0, n = rng() % (arc::gesture::Decision::kMaxInjections + 1); i < n; ++i)
+        r.decision.push(static_cast<Button>(rng() % 6), rng() % 2 != 0);
+    return r;
+}
+
+/** Simulated session: Alt+clicks, drags and long presses as the hook would record them. */
+std::vector<Record> simulate_session(unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<Record> out;
+    arc::gesture::Engine engine;
+    std::uint32_t t = 0xFFFF0000u + seed;  // cross the tick wrap
+    Record s;
+    s.kind = Kind::Settings;
+    s.event.time_ms = t;
+    s.settings = engine.settings();
+    out.push_back(s);
+    std::int32_t x = 500, y = 500;
+    auto feed = [&](EventType type, Button b, std::uint32_t mods) {
+        // Long-press timer, as the hook's wheel would fire it before this event
+        std::uint32_t at;
+        if (engine.deadline(at) && static_cast<std::int32_t>(t - at) >= 0) {
+            Record tr;
+            tr.kind = Kind::Timer;
+            tr.event.time_ms = at;
+            tr.decision = engine.on_timer(at);
+            out.push_back(tr);
+        }
+        Record r;
+        r.event.type = type;
+        r.event.button = b;
+        r.event.x = x;
+        r.event.y = y;
+        r.event.time_ms = t;
+        r.event.mods = mods;
+        r.decision = engine.on_event(r.event);
+        out.push_back(r);
+    };
+    for (int i = 0; i < 400; ++i) {
+        std::uint32_t mods = rng() % 4 ? static_cast<std::uint32_t>(arc::gesture::kModAlt) : 0u;
+        t += 50 + rng() % 500;
+        feed(EventType::Down, Button::Left, mods);
+        int moves = static_cast<int>(rng() % 6);
+        bool drag = rng() % 4 == 0;
+        for (int m = 0; m < moves; ++m) {
+            t += 1 + rng() % 60;
+            x += drag ? 5 : static_cast<std::int32_t>(rng() % 3) - 1;
+            y += static_cast<std::int32_t>(rng() % 3) - 1;
+            feed(EventType::Move, Button::None, mods);
+        }
+        t += rng() % 300;
+        feed(EventType::Up, Button::Left, 0);
+    }
+    return out;
+}
+
+void count_diff(const arc::trace::Diff &, void *ctx) { ++*static_cast<int *>(ctx); }
+
+void short_click_time(arc::gesture::Settings &s, void *) { s.click_time_ms = 100; }
+
+}  // namespace
+
+/** @brief Entry point for trace tests. */
+int main() {
+    // Encode/decode round trip over random records
+    {
+        std::mt19937 rng(1);
+        std::vector<std::uint8_t> buf(200000 * arc::trace::kMaxRecordBytes);
+        std::vector<Record> in;
+        arc::trace::Encoder enc;
+        std::size_t used = 0;
+        std::uint32_t t = 0;
+        for (int i = 0; i < 200000; ++i) {
+            in.push_back(random_record(rng, t));
+            std::size_t n = enc.encode(in.back(), buf.data() + used);
+            expect(n <= arc::trace::kMaxRecordBytes, "record within the size bound");
+            used += n;
+        }
+        arc::trace::Decoder dec;
+        const std::uint8_t *p = buf.data();
+        const std::uint8_t *end = buf.data() + used;
+        for (const Record &want : in) {
+            Record got;
+            expect(dec.decode(p, end, got), "record decodes");
+            expect(same_record(got, want), "decoded record matches");
+        }
+        expect(p == end, "payload fully consumed");
+    }
+
+    // Compactness and malformed input
+    {
+        arc::trace::Encoder enc;
+        std::uint8_t buf[arc::trace::kMaxRecordBytes];
+        Record r;
+        r.event.type = EventType::Move;
+        r.event.x = 1000;
+        r.event.y = 700;
+        r.event.time_ms = 123456;
+        enc.encode(r, buf);
+        r.event.x += 3;
+        r.event.y -= 2;
+        r.event.time_ms += 8;
+        std::size_t n = enc.encode(r, buf);
+        expect(n == 5, "small move without decision takes 5 bytes");
+
+        arc::trace::Decoder dec;
+        const std::uint8_t *p = buf;
+        Record out;
+        expect(!dec.decode(p, buf + n - 1, out) && p == buf, "truncated record rejected without consuming");
+        std::uint8_t bad[] = {0x07, 0x00};  // unknown record code
+        p = bad;
+        expect(!dec.decode(p, bad + sizeof(bad), out), "unknown code rejected");
+    }
+
+    // Recorder/reader file round trip across many small blocks
+    {
+        std::mt19937 rng(2);
+        std::vector<Record> in;
+        std::uint32_t t = 0;
+        arc::trace::Writer w(256, 64);
+        expect(w.open(kTracePath), "trace file created");
+        expect(!w.open(kTracePath), "second open rejected while recording");
+        for (int i = 0; i < 50000; ++i) {
+            in.push_back(random_record(rng, t));
+            in.back().event.time_ms = static_cast<std::uint32_t>(i);  // unique, to match after drops
+            w.append(in.back());
+        }
+        w.close();
+        expect(w.records() + w.dropped() == in.size(), "every record accepted or counted as dropped");
+
+        arc::trace::Reader r;
+        std::string err;
+        expect(r.open(kTracePath, &err), "trace file opens");
+        std::size_t j = 0, read = 0;
+        Record got;
+        while (r.next(got)) {
+            while (j < in.size() && in[j].event.time_ms != got.event.time_ms)
+                ++j;
+            expect(j < in.size() && same_record(got, in[j]), "file records match, in order");
+            ++read;
+        }
+        expect(!r.corrupt(), "clean trace not corrupt");
+        expect(read == w.records(), "all accepted records read back");
+        expect(r.dropped() == w.dropped(), "dropped count carried in the file");
+        std::printf("file: %zu records, %llu dropped, %.2f bytes/record\n", read,
+                    static_cast<unsigned long long>(w.dropped()),
+                    static_cast<double>(w.bytes_written()) / static_cast<double>(read ? read : 1));
+    }
+
+    // Truncated file: records up to the damaged block are still readable
+    {
+        arc::trace::Writer w(256, 64);
+        expect(w.open(kTracePath), "trace file created");
+        std::mt19937 rng(3);
+        std::uint32_t t = 0;
+        for (int i = 0; i < 1000; ++i)
+            w.append(random_record(rng, t));
+        w.close();
+        std::FILE *f = std::fopen(kTracePath, "rb");
+        std::vector<std::uint8_t> data(static_cast<std::size_t>(w.bytes_written()));
+        expect(f && std::fread(data.data(), 1, data.size(), f) == data.size(), "trace read back");
+        std::fclose(f);
+        f = std::fopen(kTracePath, "wb");
+        std::fwrite(data.data(), 1, data.size() - 10, f);
+        std::fclose(f);
+        arc::trace::Reader r;
+        expect(r.open(kTracePath), "truncated trace opens");
+        Record got;
+        std::size_t n = 0;
+        while (r.next(got))
+            ++n;
+        expect(r.corrupt() && n > 0 && n < 1000, "truncation detected after the intact blocks");
+
+        f = std::fopen(kTracePath, "wb");
+        std::fputs("not a trace at all", f);
+        std::fclose(f);
+        std::string err;
+        expect(!r.open(kTracePath, &err) && !err.empty(), "foreign file rejected");
+    }
+
+    // Deterministic replay of a recorded session
+    {
+        std::vector<Record> session = simulate_session(7);
+        arc::trace::Writer w;
+        expect(w.open(kTracePath), "trace file created");
+        for (const Record &rec : session)
+            w.append(rec);
+        w.close();
+
+        int diffs = 0;
+        arc::trace::Reader r;
+        expect(r.open(kTracePath), "session trace opens");
+        arc::trace::Replayer same(count_diff, &diffs);
+        Record rec;
+        while (r.next(rec))
+            same.feed(rec);
+        expect(same.records() == session.size(), "whole session replayed");
+        expect(same.timers() > 0, "session contains long presses");
+        expect(diffs == 0 && same.diffs() == 0, "replay reproduces every recorded decision");
+
+        int changed = 0;
+        expect(r.open(kTracePath), "session trace reopens");
+        arc::trace::Replayer shorter(count_diff, &changed, short_click_time, nullptr);
+        while (r.next(rec))
+            shorter.feed(rec);
+        expect(changed > 0 && shorter.diffs() == static_cast<std::uint64_t>(changed),
+               "other thresholds show up as diffs");
+        std::printf("replay: %zu records, %llu timers, %d diffs at click_time_ms=100\n", session.size(),
+                    static_cast<unsigned long long>(same.timers()), changed);
+    }
+
+    std::remove(kTracePath);
+    std::printf("[OK] trace tests passed\n");
+    return 0;
+}
@@ -0,0 +1,321 @@
+/**
+ * @file tuning_test.cpp
+ * @brief Usage histograms and threshold suggestions: the engine's press
+ *        reports, the Otsu split, and tuning offline from a recorded trace.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "arc/gesture.h"
+#include "arc/trace.h"
+#include "arc/tuning.h"
+
+#include "gesture_events.h"
+
+using arc::gesture::Button;
+using arc::gesture::Decision;
+using arc::gesture::Engine;
+using arc::gesture::Event;
+using arc::gesture::EventType;
+using arc::gesture::Settings;
+using arc::trace::Kind;
+using arc::trace::Record;
+using arc::tuning::Thresholds;
+using arc::tuning::Usage;
+using arc::test::ev;
+
+/**
+ * @brief Minimal assertion helper printing failures to stderr.
+ *
+ * @param cond Condition that must hold.
+ * @param msg Description printed on failure.
+ */
+static void expect(bool cond, const char *msg) {
+    if (!cond) {
+        std::fprintf(stderr, "[FAIL] %s\n", msg);
+        std::exit(1);
+    }
+}
+
+namespace {
+
+const char *kTracePath = "tuning_test.arctrace";
+constexpr std::uint32_t kAlt = arc::gesture::kModAlt;  ///< Modifier of the default binding.
+
+/**
+ * @brief Synthetic session recorded like the hook does.
+ *
+ * Intended clicks are still (0-5 px of jitter) and quick (60-140 ms);
+ * intended drags travel 30-300 px; holds stay still for 500-900 ms.
+ * Presses go through an engine with the given settings, and the records
+ * (settings, events, timer resolutions) form the trace.
+ */
+struct Session {
+    std::vector<Record> log;
+    int clicks = 0;  ///< Presses meant as clicks.
+
+    void event(Engine &e, const Event &ev) {
+        std::uint32_t at;
+        while (e.deadline(at) && static_cast<std::int32_t>(ev.time_ms - at) >= 0) {
+            Record r;
+            r.kind = Kind::Timer;
+            r.event.time_ms = at;
+            r.decision = e.on_timer(at);
+            log.push_back(r);
+        }
+        Record r;
+        r.event = ev;
+        r.decision = e.on_event(ev);
+        log.push_back(r);
+    }
+};
+
+Session record_session(const Settings &s, unsigned seed, int presses) {
+    Session out;
+    Engine e(s);
+    Record set;
+    set.kind = Kind::Settings;
+    set.settings = s;
+    out.log.push_back(set);
+    std::mt19937 rng(seed);
+    std::uint32_t t = 1000;
+    for (int i = 0; i < presses; ++i) {
+        std::int32_t x = 400 + static_cast<std::int32_t>(rng() % 800), y = 300 + static_cast<std::int32_t>(rng() % 400);
+        unsigned kind = rng() % 10;  // 0-5 click, 6-7 drag, 8-9 hold
+        out.event(e, ev(EventType::Down, Button::Left, x, y, t, kAlt));
+        std::uint32_t held;
+        if (kind < 6) {
+            ++out.clicks;
+            held = 60 + rng() % 81;
+            std::int32_t jx = static_cast<std::int32_t>(rng() % 5), jy = static_cast<std::int32_t>(rng() % 3);
+            out.event(e, ev(EventType::Move, Button::None, x + jx / 2, y + jy / 2, t + held / 3, kAlt));
+            out.event(e, ev(EventType::Move, Button::None, x + jx, y + jy, t + held / 2, kAlt));
+        } else if (kind < 8) {
+            held = 200 + rng() % 600;
+            std::int32_t len = 30 + static_cast<std::int32_t>(rng() % 270);
+            for (std::uint32_t k = 1; k <= 20; ++k)
+                out.event(e, ev(EventType::Move, Button::None, x + len * static_cast<std::int32_t>(k) / 20, y,
+                                t + held * k / 21, kAlt));
+        } else {
+            held = 500 + rng() % 401;
+        }
+        out.event(e, ev(EventType::Up, Button::Left, x, y, t + held, kAlt));
+        t += held + 300 + rng() % 700;
+    }
+    return out;
+}
+
+void write_trace(const Session &s) {
+    arc::trace::Writer w;
+    expect(w.open(kTracePath), "trace file created");
+    for (const Record &r : s.log)
+        w.append(r);
+    w.close();
+}
+
+/** Right clicks an engine with settings @p s injects over the session's events. */
+int right_clicks(const Session &session, const Settings &s) {
+    Engine e(s);
+    int n = 0;
+    for (const Record &r : session.log) {
+        Decision d;
+        if (r.kind == Kind::Timer)
+            d = e.on_timer(r.event.time_ms);
+        else if (r.kind == Kind::Event)
+            d = e.on_event(r.event);
+        for (int i = 0; i < d.count; ++i)
+            n += d.inject[i].button == Button::Right && d.inject[i].down;
+    }
+    return n;
+}
+
+}  // namespace
+
+/** @brief Entry point for tuning tests. */
+int main() {
+    using arc::tuning::kDurationBuckets;
+    using arc::tuning::kTravelBuckets;
+
+    // Building blocks
+    {
+        expect(arc::tuning::travel_px(0) == 0 && arc::tuning::travel_px(24) == 4 && arc::tuning::travel_px(25) == 5,
+               "travel is the floor of the distance");
+        expect(arc::tuning::travel_px(1000000) == arc::tuning::kTravelCapPx, "travel is capped");
+        Usage u;
+        u.record(85, 2, true);
+        u.record(3000, 200, false);
+        expect(u.travel.at(2) == 1 && u.travel.at(kTravelBuckets - 1) == 1, "travel counted for every press");
+        expect(u.durations.at(8) == 1 && u.durations.total() == 1, "duration counted for still presses only");
+        for (int i = 0; i < 99; ++i)
+            u.record(85, 2, true);
+        u.age(1000);
+        expect(u.durations.at(8) == 100, "no aging below the limit");
+        u.age(50);
+        expect(u.durations.at(8) == 50 && u.travel.at(2) == 50, "aging halves the buckets");
+        u.reset();
+        expect(u.travel.total() == 0 && u.durations.total() == 0, "reset clears");
+    }
+
+    // Otsu split
+    {
+        std::uint32_t h[kTravelBuckets] = {};
+        h[1] = 30;
+        h[2] = 50;
+        h[3] = 20;
+        h[63] = 40;
+        arc::tuning::Split s = arc::tuning::split(h, kTravelBuckets);
+        expect(s.found && s.low == 3 && s.high == 63, "clicks and drags split");
+
+        std::uint32_t bell[kTravelBuckets] = {};
+        const std::uint32_t kBell[] = {2, 8, 20, 40, 60, 70, 60, 40, 20, 8, 2};
+        for (int i = 0; i < 11; ++i)
+            bell[10 + i] = kBell[i];
+        expect(!arc::tuning::split(bell, kTravelBuckets).found, "a single bell curve does not split");
+
+        std::uint32_t few[kTravelBuckets] = {};
+        few[2] = 20;
+        few[63] = 10;
+        expect(!arc::tuning::split(few, kTravelBuckets).found, "too few samples do not split");
+
+        std::uint32_t stray[kTravelBuckets] = {};
+        stray[2] = 200;
+        stray[63] = 3;
+        expect(!arc::tuning::split(stray, kTravelBuckets).found, "a few outliers do not split");
+
+        std::uint32_t touching[kTravelBuckets] = {};
+        touching[2] = 100;
+        touching[3] = 100;
+        expect(!arc::tuning::split(touching, kTravelBuckets).found, "adjacent buckets leave no gap");
+    }
+
+    // Suggestions move half way towards the gap and stay within bounds
+    {
+        Usage u;
+        for (int i = 0; i < 60; ++i)
+            u.record(60 + static_cast<std::uint32_t>(i % 9) * 10, static_cast<std::uint32_t>(i % 5), true);
+        for (int i = 0; i < 30; ++i)
+            u.record(300, 200, false);
+        for (int i = 0; i < 20; ++i)
+            u.record(600 + static_cast<std::uint32_t>(i) * 10, 1, true);
+        // Clicks travel 0-4 px: radius 4 + 1 + 2; durations 60-140 ms vs 600+: (15 + 60) / 2 buckets
+        Thresholds cur{250, 2};
+        Thresholds next = arc::tuning::suggest(u, cur);
+        expect(next.move_radius_px == 4 && next.click_time_ms == 310, "first step goes half way");
+        for (int i = 0; i < 8; ++i)
+            next = arc::tuning::suggest(u, next);
+        expect(next.move_radius_px == 7 && next.click_time_ms == 370, "suggestions converge on the gap");
+        expect(arc::tuning::suggest(u, next).move_radius_px == 7, "converged suggestion is stable");
+
+        Usage none;
+        Thresholds same = arc::tuning::suggest(none, Thresholds{180, 9});
+        expect(same.click_time_ms == 180 && same.move_radius_px == 9, "no data keeps the thresholds");
+
+        Usage slow;
+        for (int i = 0; i < 50; ++i)
+            slow.record(1000, 0, true);
+        for (int i = 0; i < 50; ++i)
+            slow.record(1270 + static_cast<std::uint32_t>(i) * 10, 0, true);
+        Thresholds capped{900, 6};
+        for (int i = 0; i < 8; ++i)
+            capped = arc::tuning::suggest(slow, capped);
+        expect(capped.click_time_ms == arc::tuning::kMaxClickTimeMs, "click time clamped to the upper bound");
+    }
+
+    // Engine reports
+    {
+        Settings s;
+        Engine e(s);
+        Usage u;
+        e.observe(&u);
+
+        // Quick click with a little jitter
+        e.on_event(ev(EventType::Down, Button::Left, 100, 100, 1000, kAlt));
+        e.on_event(ev(EventType::Move, Button::None, 102, 101, 1030, kAlt));
+        e.on_event(ev(EventType::Up, Button::Left, 101, 101, 1085, kAlt));
+        expect(u.travel.at(2) == 1 && u.durations.at(8) == 1, "click reported with travel and duration");
+
+        // Drag: travel keeps being measured past the radius, up to the cap
+        e.on_event(ev(EventType::Down, Button::Left, 100, 100, 2000, kAlt));
+        Decision d = e.on_event(ev(EventType::Move, Button::None, 120, 100, 2020, kAlt));
+        expect(d.path_count > 0 && !e.tracking(), "drag started");
+        expect(!e.idle(), "moves still matter while travel is below the cap");
+        e.on_event(ev(EventType::Move, Button::None, 150, 100, 2040, kAlt));
+        expect(!e.idle(), "still measuring at 50 px");
+        e.on_event(ev(EventType::Move, Button::None, 170, 100, 2060, kAlt));
+        expect(e.idle(), "idle again once travel reaches the cap");
+        e.on_event(ev(EventType::Up, Button::Left, 170, 100, 2400, kAlt));
+        expect(u.travel.at(kTravelBuckets - 1) == 1 && u.durations.total() == 1, "drag reported by travel only");
+
+        // Hold past the click time: the native press's release is reported
+        e.on_event(ev(EventType::Down, Button::Left, 300, 300, 3000, kAlt));
+        d = e.on_timer(3251);
+        expect(d.count == 1 && d.inject[0].down, "hold becomes a native press");
+        d = e.on_event(ev(EventType::Up, Button::Left, 300, 300, 3700, kAlt));
+        expect(d.verdict == arc::gesture::Verdict::Pass, "native release passes");
+        expect(u.durations.at(70) == 1 && u.travel.at(0) == 1, "hold reported");
+
+        // Unbound presses and chords are not reported
+        e.on_event(ev(EventType::Down, Button::Left, 0, 0, 4000, 0));
+        e.on_event(ev(EventType::Up, Button::Left, 0, 0, 4050, 0));
+        Settings cs;
+        cs.chord_ms = 100;
+        e.configure(cs);
+        e.on_event(ev(EventType::Down, Button::Left, 0, 0, 5000, kAlt));
+        e.on_event(ev(EventType::Down, Button::Right, 0, 0, 5030, kAlt));
+        e.on_event(ev(EventType::Up, Button::Left, 0, 0, 5080, kAlt));
+        e.on_event(ev(EventType::Up, Button::Right, 0, 0, 5090, kAlt));
+        expect(u.travel.total() == 3, "unbound presses and chords not reported");
+
+        // Detached: nothing reported, idle right after a drag starts
+        e.observe(nullptr);
+        e.on_event(ev(EventType::Down, Button::Left, 100, 100, 6000, kAlt));
+        e.on_event(ev(EventType::Move, Button::None, 120, 100, 6020, kAlt));
+        expect(e.idle(), "no measuring without a sink");
+        e.on_event(ev(EventType::Up, Button::Left, 120, 100, 6100, kAlt));
+        expect(u.travel.total() == 3, "no reports without a sink");
+    }
+
+    // Offline: tune from a recorded trace whose radius was too small for the user's jitter
+    {
+        Settings narrow;
+        narrow.move_radius_px = 2;
+        narrow.click_time_ms = 100;
+        Session session = record_session(narrow, 5, 400);
+        write_trace(session);
+
+        Usage u;
+        arc::trace::Reader reader;
+        expect(reader.open(kTracePath), "session trace opens");
+        arc::trace::Replayer replayer;
+        replayer.observe(&u);
+        Record rec;
+        while (reader.next(rec))
+            replayer.feed(rec);
+        expect(replayer.diffs() == 0, "observing does not change decisions");
+        expect(u.travel.total() == 400, "every press reported");
+
+        Thresholds t{replayer.settings().click_time_ms, replayer.settings().move_radius_px};
+        for (int i = 0; i < 8; ++i)
+            t = arc::tuning::suggest(u, t);
+        expect(t.move_radius_px >= 5 && t.move_radius_px <= 8, "radius covers the click jitter");
+        expect(t.click_time_ms > 140 && t.click_time_ms < 500, "click time between clicks and holds");
+
+        Settings tuned = narrow;
+        tuned.move_radius_px = t.move_radius_px;
+        tuned.click_time_ms = t.click_time_ms;
+        int before = right_clicks(session, narrow), after = right_clicks(session, tuned);
+        expect(after == session.clicks, "tuned thresholds turn every intended click into a click");
+        expect(before < after, "the recorded thresholds missed clicks");
+        std::printf("trace: %d of %d clicks recognized at %d px / %u ms, %d at %d px / %u ms\n", before,
+                    session.clicks, narrow.move_radius_px, narrow.click_time_ms, after, t.move_radius_px,
+                    t.click_time_ms);
+    }
+
+    std::remove(kTracePath);
+    std::printf("[OK] tuning tests passed\n");
+    return 0;
+}